@@ -28,6 +28,7 @@
 #include <vulkan/utility/vk_dispatch_table.h>
 
 #include <vulkan/layer/vk_layer_settings.hpp>
+#include <vulkan/vk_enum_string_helper.h>
 
 // Include the video headers so we can print types that come from them
 #include "vk_video/vulkan_video_codecs_common.h"
@@ -41,8 +42,13 @@
 #include "vk_video/vulkan_video_codec_av1std_decode.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <deque>
 #include <fstream>
 #include <mutex>
 #include <iomanip>
@@ -51,9 +57,11 @@
 #include <sstream>
 #include <string.h>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <map>
 #include <set>
+#include <shared_mutex>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -71,6 +79,28 @@
 
 #endif  // ANDROID
 
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+#if defined(API_DUMP_USE_ZLIB)
+#include <zlib.h>
+#endif
+
+// The TSC can be used as the timestamp source, calibrated against the steady clock when the layer is initialized
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define API_DUMP_TSC_AVAILABLE 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#endif
+
 #if defined(WIN32)
 // Disable warning about bitshift precedence
 #pragma warning(disable : 4554)
@@ -94,6 +124,17 @@
 #define kSettingsKeyUseSpaces "use_spaces"
 #define kSettingsKeyShowShader "show_shader"
 #define kSettingsKeyShowThreadAndFrame "show_thread_and_frame"
+#define kSettingsKeyTriggerCapture "trigger_capture"
+#define kSettingsKeyTriggerPreFrames "trigger_pre_frames"
+#define kSettingsKeyTriggerPostFrames "trigger_post_frames"
+#define kSettingsKeyTriggerFile "trigger_file"
+#define kSettingsKeyTriggerLabel "trigger_label"
+#define kSettingsKeyRotateSize "rotate_size"
+#define kSettingsKeyRotateFrames "rotate_frames"
+#define kSettingsKeyCompress "compress"
+#define kSettingsKeyPerThread "per_thread"
+#define kSettingsKeyTimestampClock "timestamp_clock"
+#define kSettingsKeyHandleIndex "handle_index"
 
 // We want to dump all extensions even beta extensions.
 #ifndef VK_ENABLE_BETA_EXTENSIONS
@@ -128,10 +169,16 @@
 
 #endif  // __APPLE__
 
+enum class ApiDumpClock {
+    Steady,
+    Tsc,
+};
+
 enum class ApiDumpFormat {
     Text,
     Html,
     Json,
+    TraceEvent,
 };
 
 static const uint64_t OUTPUT_RANGE_UNLIMITED = 0;
@@ -282,6 +329,255 @@ class ConditionalFrameOutput {
         }
         return false;
     }
+
+    // Return the first frame after frame_number where isFrameInRange may return a different value, so that the frame ranges
+    // only need to be evaluated again when that frame is reached
+    uint64_t nextTransitionFrame(uint64_t frame_number) const {
+        uint64_t next_frame = UINT64_MAX;
+        if (!use_conditional_output) return next_frame;
+        for (auto &range : ranges) {
+            if (range.start_frame > frame_number) {
+                next_frame = std::min(next_frame, range.start_frame);
+            } else if (range.frame_count == OUTPUT_RANGE_UNLIMITED || range.start_frame + range.frame_count > frame_number) {
+                if (range.interval != OUTPUT_RANGE_INTERVAL_DEFAULT) {
+                    next_frame = std::min(next_frame, frame_number + 1);
+                } else if (range.frame_count != OUTPUT_RANGE_UNLIMITED) {
+                    next_frame = std::min(next_frame, range.start_frame + range.frame_count);
+                }
+            }
+        }
+        if (frames.count(frame_number) > 0) {
+            next_frame = std::min(next_frame, frame_number + 1);
+        }
+        auto next_single_frame = frames.upper_bound(frame_number);
+        if (next_single_frame != frames.end()) {
+            next_frame = std::min(next_frame, *next_single_frame);
+        }
+        return next_frame;
+    }
+};
+
+// Index of the handles of a dump file, written next to it as "<file>.handles": for each handle, the dumped calls that created,
+// destroyed and referenced it, with the offsets of the calls in the file so that query_api_dump.py reads them without parsing
+// the whole dump. The references are those of the dumped parameters, nested structures included.
+class HandleIndex {
+   public:
+    static const uint64_t NO_CALL = UINT64_MAX;
+
+    // Called before the head of each dumped call, at its offset in the dump file
+    void beginCall(uint64_t sequence, uint64_t offset) {
+        endCall(offset);
+        current_sequence = sequence;
+        current_offset = offset;
+        current_call = NO_CALL;
+        created_type = nullptr;
+        destroyed_type = nullptr;
+    }
+
+    // Called at the offset following the last dumped call, before anything else is written to the dump file
+    void endCall(uint64_t offset) {
+        if (current_call != NO_CALL) {
+            calls[current_call].size = offset - calls[current_call].offset;
+            current_call = NO_CALL;
+        }
+        current_sequence = NO_CALL;
+    }
+
+    // The handle types created and destroyed by the current call, if any
+    void setLifetime(const char *created, const char *destroyed) {
+        created_type = created[0] != '\0' ? created : nullptr;
+        destroyed_type = destroyed[0] != '\0' ? destroyed : nullptr;
+    }
+
+    // Called for each handle dumped by the current call, the type is the generated handle type name
+    void reference(const char *type, uint64_t handle) {
+        if (current_sequence == NO_CALL || handle == 0) return;
+
+        if (current_call == NO_CALL) {
+            current_call = calls.size();
+            calls.push_back(CallRecord{current_sequence, current_offset, 0});
+        }
+
+        // Non-dispatchable handles of different types may share a value, each type has its own lifetimes
+        const HandleKey key{type, handle};
+        auto it = handles.find(key);
+        if (it == handles.end()) {
+            it = handles.emplace(key, HandleRecord{type}).first;
+        } else if (it->second.destroyed != NO_CALL && created_type != nullptr && strcmp(type, created_type) == 0) {
+            // The handle value was reused by the driver, the previous lifetime is kept apart
+            retired.emplace_back(handle, std::move(it->second));
+            it->second = HandleRecord{type};
+        }
+
+        HandleRecord &record = it->second;
+        if (!record.calls.empty() && record.calls.back() == current_call) return;
+
+        // A handle created before it was first dumped, before the output range or the layer, has no creation call
+        if (record.calls.empty() && record.created == NO_CALL && created_type != nullptr && strcmp(type, created_type) == 0) {
+            record.created = current_sequence;
+        }
+        if (destroyed_type != nullptr && strcmp(type, destroyed_type) == 0) {
+            record.destroyed = current_sequence;
+        }
+        record.calls.push_back(static_cast<uint32_t>(current_call));
+    }
+
+    // Write the index of the calls dumped to the file since the last call to startNextFile
+    void write(const std::string &dump_filename) const {
+        std::ofstream file(dump_filename + ".handles", std::ofstream::out | std::ostream::trunc);
+        if (file.is_open()) {
+            const std::size_t directory = dump_filename.find_last_of("/\\");
+            file << "# api_dump handle index\n";
+            file << "# call <sequence> <offset> <size>\n";
+            file << "# handle <type> <handle> <created sequence or -> <destroyed sequence or -> <referencing sequence>...\n";
+            file << "dump " << (directory == std::string::npos ? dump_filename : dump_filename.substr(directory + 1)) << "\n";
+
+            for (const CallRecord &call : calls) {
+                file << "call " << call.sequence << " " << call.offset << " " << call.size << "\n";
+            }
+            for (const auto &entry : retired) {
+                writeHandle(file, entry.first, entry.second);
+            }
+            for (const auto &entry : handles) {
+                if (!entry.second.calls.empty()) writeHandle(file, entry.first.value, entry.second);
+            }
+        }
+    }
+
+    // Called once a rotated file is indexed, only the lifetimes of the live handles are kept for the next file
+    void startNextFile() {
+        calls.clear();
+        retired.clear();
+        for (auto it = handles.begin(); it != handles.end();) {
+            if (it->second.destroyed != NO_CALL) {
+                it = handles.erase(it);
+            } else {
+                it->second.calls.clear();
+                ++it;
+            }
+        }
+    }
+
+   private:
+    // The type is the generated handle type name, the names are compared rather than their addresses
+    struct HandleKey {
+        const char *type;
+        uint64_t value;
+
+        bool operator==(const HandleKey &other) const { return value == other.value && strcmp(type, other.type) == 0; }
+    };
+
+    struct HandleKeyHash {
+        std::size_t operator()(const HandleKey &key) const {
+            return std::hash<uint64_t>()(key.value) ^ std::hash<std::string_view>()(key.type);
+        }
+    };
+
+    struct CallRecord {
+        uint64_t sequence;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    struct HandleRecord {
+        explicit HandleRecord(const char *type) : type(type) {}
+
+        const char *type;
+        uint64_t created = NO_CALL;
+        uint64_t destroyed = NO_CALL;
+        std::vector<uint32_t> calls;  // Indices in calls
+    };
+
+    void writeHandle(std::ofstream &file, uint64_t handle, const HandleRecord &record) const {
+        char value[32];
+        snprintf(value, sizeof(value), "0x%llx", static_cast<unsigned long long>(handle));
+
+        file << "handle " << record.type << " " << value;
+        if (record.created == NO_CALL) {
+            file << " -";
+        } else {
+            file << " " << record.created;
+        }
+        if (record.destroyed == NO_CALL) {
+            file << " -";
+        } else {
+            file << " " << record.destroyed;
+        }
+        for (uint32_t call : record.calls) {
+            file << " " << calls[call].sequence;
+        }
+        file << "\n";
+    }
+
+    std::vector<CallRecord> calls;  // The dumped calls that referenced at least one handle
+    std::unordered_map<HandleKey, HandleRecord, HandleKeyHash> handles;
+    std::vector<std::pair<uint64_t, HandleRecord>> retired;  // Lifetimes ended before their handle value was reused
+
+    uint64_t current_sequence = NO_CALL;
+    uint64_t current_offset = 0;
+    uint64_t current_call = NO_CALL;
+    const char *created_type = nullptr;
+    const char *destroyed_type = nullptr;
+};
+
+// The calls recorded by trigger capture are formatted with their parameters up to this size, in bytes
+static const std::size_t kCapturedCallMaxSize = 64 * 1024;
+
+// The buffer a call is formatted into while recording a trigger capture. It stops accepting characters at its limit: the stream
+// then fails and the rest of the call isn't formatted.
+class CapturedCallBuffer : public std::streambuf {
+   public:
+    void reset(std::size_t size_limit) {
+        text.clear();
+        limit = size_limit;
+        exceeded = false;
+    }
+
+    const std::string &str() const { return text; }
+
+    bool limitExceeded() const { return exceeded; }
+
+   protected:
+    int_type overflow(int_type c) override {
+        if (traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+        if (text.size() >= limit) {
+            exceeded = true;
+            return traits_type::eof();
+        }
+        text.push_back(traits_type::to_char_type(c));
+        return c;
+    }
+
+    std::streamsize xsputn(const char *s, std::streamsize n) override {
+        const std::size_t room = limit - std::min(text.size(), limit);
+        if (static_cast<std::size_t>(n) > room) {
+            exceeded = true;
+            n = static_cast<std::streamsize>(room);
+        }
+        text.append(s, static_cast<std::size_t>(n));
+        return n;
+    }
+
+   private:
+    std::string text;
+    std::size_t limit = 0;
+    bool exceeded = false;
+};
+
+// A call recorded by trigger capture that didn't fit in its CapturedCallBuffer, only formatted when its frame is written out.
+// The parameters point to the memory of the application which is gone by then, only the VkResult of the call is kept.
+struct CapturedCall {
+    std::size_t offset;  // Where the call goes in the text recorded for the frame
+    const char *name;
+    const char *named_params;
+    const char *return_type;
+    bool has_result;
+    VkResult result;
+    bool separator;  // The JSON or trace event separator from the previous call
+    uint64_t thread_id;
+    uint64_t frame;
+    uint64_t time;
+    uint64_t duration;
 };
 
 #ifdef __ANDROID__
@@ -385,23 +681,70 @@ class ApiDumpSettings {
     }
 
     ~ApiDumpSettings() {
-        if (output_format == ApiDumpFormat::Html) {
-            // Close off html
-            output_stream << "</div></body></html>";
-        } else if (output_format == ApiDumpFormat::Json) {
-            // Close off json
-            output_stream << "\n]" << std::endl;
+        writeDocumentEnding();
+
+        // The last rotated file is closed, indexed and compressed like the others
+        if (rotate_output) {
+            closeOutputFile(current_frame);
+        } else if (index_handles) {
+            output_file_stream.close();
+            handle_index.write(output_filename);
+        }
+
+        // The compression thread is only still running when the application didn't destroy its instances
+        stopCompression();
+    }
+
+    // Called when the last instance is destroyed, so that nothing is left running or unwritten when the application unloads the
+    // layer: the compression thread is stopped once the closed files are compressed, the output is flushed and the handle
+    // index of the calls dumped so far is written. The document is only ended when the layer is unloaded, the application may
+    // create another instance.
+    void finishInstances() {
+        stopCompression();
+
+        endIndexedCall();
+        output_stream.flush();
+        if (index_handles && !rotate_output) {
+            handle_index.write(output_filename);
+        }
+
+        std::lock_guard<std::mutex> lg(thread_outputs_mutex);
+        for (const std::unique_ptr<ThreadOutput> &output : thread_outputs) {
+            output->file.flush();
         }
     }
 
     void setupInterFrameOutputFormatting(uint64_t frame_count) const /*name change? */
     {
-        static bool hasPrintedAFrame = false;
+        if (frame_count > 0) {
+            endFrameOutputFormatting(frame_count - 1);
+        }
+        beginFrameOutputFormatting(frame_count);
+    }
+
+    void endFrameOutputFormatting(uint64_t frame_count) const {
+        endIndexedCall();
+        if (!condFrameOutput.isFrameInRange(frame_count)) return;
+        if (per_thread_output) return;
+        switch (format()) {
+            case (ApiDumpFormat::Html):
+                output_stream << "</details>";
+                break;
+            case (ApiDumpFormat::Json):
+                output_stream << "\n" << indentation(1) << "]\n}";
+                break;
+            case (ApiDumpFormat::Text):
+            case (ApiDumpFormat::TraceEvent):
+                break;
+            default:
+                break;
+        }
+    }
+
+    void beginFrameOutputFormatting(uint64_t frame_count) const {
+        if (per_thread_output) return;
         switch (format()) {
             case (ApiDumpFormat::Html):
-                if (frame_count > 0) {
-                    if (condFrameOutput.isFrameInRange(frame_count - 1)) output_stream << "</details>";
-                }
                 if (condFrameOutput.isFrameInRange(frame_count)) {
                     output_stream << "<details class='frm'><summary>Frame ";
                     if (show_thread_and_frame) {
@@ -412,13 +755,9 @@ class ApiDumpSettings {
                 break;
 
             case (ApiDumpFormat::Json):
-
-                if (frame_count > 0) {
-                    if (condFrameOutput.isFrameInRange(frame_count - 1)) output_stream << "\n" << indentation(1) << "]\n}";
-                }
                 if (condFrameOutput.isFrameInRange(frame_count)) {
-                    if (!hasPrintedAFrame) {
-                        hasPrintedAFrame = true;
+                    if (!json_frame_written) {
+                        json_frame_written = true;
                     } else {
                         output_stream << ",\n";
                     }
@@ -430,6 +769,13 @@ class ApiDumpSettings {
                     output_stream << indentation(1) << "[\n";
                 }
                 break;
+            case (ApiDumpFormat::TraceEvent):
+                // The frame boundaries are global instant events, the calls are not nested in the frames
+                if (condFrameOutput.isFrameInRange(frame_count)) {
+                    writeTraceEventHeading("Frame", "frame", 'i', 0, timestamp());
+                    output_stream << ",\"s\":\"g\",\"args\":{\"frame\":" << frame_count << "}}";
+                }
+                break;
             case (ApiDumpFormat::Text):
                 break;
             default:
@@ -438,6 +784,8 @@ class ApiDumpSettings {
     }
 
     void closeFrameOutput() const {
+        endIndexedCall();
+        if (per_thread_output) return;
         switch (format()) {
             case (ApiDumpFormat::Html):
                 output_stream << "</details>";
@@ -446,36 +794,188 @@ class ApiDumpSettings {
                 output_stream << "\n" << indentation(1) << "]\n}";
                 break;
             case (ApiDumpFormat::Text):
+            case (ApiDumpFormat::TraceEvent):
                 break;
             default:
                 break;
         }
     }
 
+    bool triggerCapture() const { return trigger_capture; }
+
+    const std::string &triggerFile() const { return trigger_file; }
+
+    const std::string &triggerLabel() const { return trigger_label; }
+
+    // True while the frames are only recorded in the capture ring, false while the frames following a trigger are written out
+    bool isRecordingCapture() const { return capture_post_frames_left == 0; }
+
+    // True while the dumped calls are formatted into the capture ring instead of the output
+    bool isRecordingCalls() const { return trigger_capture && capture_post_frames_left == 0; }
+
+    // While recording, each call is formatted into a buffer bounded by kCapturedCallMaxSize before it is added to the frame
+    void beginCapturedCall() {
+        captured_call_json_frame_written = json_frame_written;
+        captured_call_buffer.reset(kCapturedCallMaxSize);
+        output_stream.rdbuf(&captured_call_buffer);
+    }
+
+    // Return false when the call exceeded its buffer, it is then dropped and recorded as a CapturedCall. For the JSON output,
+    // json_separator is set when the dropped call started with the separator from the previous call.
+    bool endCapturedCall(bool &json_separator) {
+        output_stream.rdbuf(&capture_buffer);
+
+        const std::string &text = captured_call_buffer.str();
+        if (captured_call_buffer.limitExceeded()) {
+            json_frame_written = captured_call_json_frame_written;
+            json_separator = output_format == ApiDumpFormat::Json && text.compare(0, 2, ",\n") == 0;
+            return false;
+        }
+
+        capture_buffer.sputn(text.data(), static_cast<std::streamsize>(text.size()));
+        return true;
+    }
+
+    // The frame formatting and the trace event labels are still recorded as text, the call goes at the current end of the text
+    void recordCapturedCall(CapturedCall call) {
+        call.offset = static_cast<std::size_t>(capture_buffer.pubseekoff(0, std::ios_base::cur, std::ios_base::out));
+        if (output_format == ApiDumpFormat::TraceEvent) {
+            call.separator = json_frame_written;
+            json_frame_written = true;
+        }
+        capture_calls.push_back(call);
+    }
+
+    // Called once the frame has ended: the frame is moved to the ring of the last frames, and on a trigger the ring is written
+    // to the output followed by the next trigger_post_frames frames
+    void captureFrame(bool triggered) {
+        if (capture_post_frames_left > 0) {
+            if (--capture_post_frames_left == 0) {
+                capture_written = json_frame_written;
+                output_stream.flush();
+                output_stream.rdbuf(&capture_buffer);
+            }
+            return;
+        }
+
+        capture_ring.push_back(CapturedFrame{capture_buffer.str(), std::move(capture_calls)});
+        capture_buffer.str(std::string());
+        capture_calls.clear();
+        while (capture_ring.size() > static_cast<std::size_t>(trigger_pre_frames)) {
+            capture_ring.pop_front();
+        }
+
+        if (!triggered) return;
+
+        std::vector<std::string> frames;
+        for (const CapturedFrame &captured_frame : capture_ring) {
+            frames.push_back(formatCapturedFrame(captured_frame));
+        }
+
+        output_stream.rdbuf(capture_output_buffer);
+        for (const std::string &frame : frames) {
+            // The JSON frames were recorded with a separator that depends on the frames before them, not on what was written
+            if ((output_format == ApiDumpFormat::Json || output_format == ApiDumpFormat::TraceEvent) && !frame.empty()) {
+                const bool separator = frame.compare(0, 2, ",\n") == 0;
+                if (capture_written && !separator) {
+                    output_stream << ",\n";
+                } else if (!capture_written && separator) {
+                    output_stream << frame.substr(2);
+                    capture_written = true;
+                    continue;
+                }
+            }
+            output_stream << frame;
+            capture_written = capture_written || !frame.empty();
+        }
+        capture_ring.clear();
+        json_frame_written = capture_written;
+
+        capture_post_frames_left = trigger_post_frames;
+        if (capture_post_frames_left == 0) {
+            output_stream.flush();
+            output_stream.rdbuf(&capture_buffer);
+        }
+    }
+
+    // Stop recording and restore the output, return false when the current frame was only recorded in the ring
+    bool finishCapture() {
+        if (!trigger_capture) return true;
+        trigger_capture = false;
+
+        const bool recording = isRecordingCapture();
+        output_stream.rdbuf(capture_output_buffer);
+        capture_ring.clear();
+        capture_buffer.str(std::string());
+        capture_calls.clear();
+        return !recording;
+    }
+
+    // Called between frames, once the previous frame is closed: when the current file reached rotate_size or rotate_frames,
+    // it is closed as a complete document and the output continues in the next numbered file
+    void rotateOutput(uint64_t frame_count) {
+        current_frame = frame_count;
+        if (!rotate_output) return;
+
+        const std::streamoff size = output_file_stream.tellp();
+        const bool size_reached = rotate_size > 0 && size >= rotate_size;
+        const bool frames_reached = rotate_frames > 0 && frame_count - segment_first_frame >= static_cast<uint64_t>(rotate_frames);
+        segment_written = size > segment_heading_size;
+        if (!size_reached && !frames_reached) return;
+        if (!segment_written) return;  // Nothing was written to this file yet
+
+        // While recording a trigger capture, the output stream doesn't point to the file
+        std::streambuf *current_buffer = output_stream.rdbuf(output_file_stream.rdbuf());
+
+        writeDocumentEnding();
+        closeOutputFile(frame_count - 1);
+
+        ++segment_index;
+        segment_first_frame = frame_count;
+        output_file_stream.open(segmentFilename(segment_index), std::ofstream::out | std::ostream::trunc);
+        json_frame_written = false;
+        writeDocumentHeading();
+        segment_heading_size = output_file_stream.tellp();
+        segment_written = false;
+        capture_written = json_frame_written;
+
+        output_stream.rdbuf(current_buffer);
+    }
+
+    // Outside of the dumped frames nothing is written to the output: its size doesn't change and the output is only rotated
+    // when the frame count of a file that was written to is reached. Called while holding the frame mutex, like rotateOutput.
+    bool rotatesOutputAt(uint64_t frame_count) const {
+        return rotate_output && rotate_frames > 0 && segment_written &&
+               frame_count - segment_first_frame >= static_cast<uint64_t>(rotate_frames);
+    }
+
+    // A frame that doesn't change the output, only its number is kept to close the last rotated file
+    void skipFrame(uint64_t frame_count) { current_frame = frame_count; }
+
     ApiDumpFormat format() const { return output_format; }
 
     void formatNameType(int indents, const char *name, const char *type) const {
-        output_stream << indentation(indents) << name << ": ";
+        std::ostream &output = stream();
+        output << indentation(indents) << name << ": ";
         // We have to 'print' an empty string for the setw to actually add the desired padding.
         if (use_spaces)
-            output_stream << std::setw(name_size - (int)strlen(name) - 2) << "";
+            output << std::setw(name_size - (int)strlen(name) - 2) << "";
         else
-            output_stream << std::setw((name_size - (int)strlen(name) - 3 + tab_size) / tab_size) << "";
+            output << std::setw((name_size - (int)strlen(name) - 3 + tab_size) / tab_size) << "";
 
         if (show_type) {
             if (use_spaces)
-                output_stream << std::left << std::setw(type_size) << type << " = ";
+                output << std::left << std::setw(type_size) << type << " = ";
             else
-                output_stream << type << std::setw((type_size - (int)strlen(type) - 1 + tab_size) / tab_size) << ""
-                              << " = ";
+                output << type << std::setw((type_size - (int)strlen(type) - 1 + tab_size) / tab_size) << "" << " = ";
         } else {
-            output_stream << " = ";
+            output << " = ";
         }
     }
 
     inline const char *indentation(int indents) const {
         // We have to 'print' an empty string for the setw to actually add the desired padding.
-        output_stream << std::setw(indents * indent_size) << "";
+        stream() << std::setw(indents * indent_size) << "";
         return "";
     }
 
@@ -491,21 +991,141 @@ class ApiDumpSettings {
 
     bool showTimestamp() const { return show_timestamp; }
 
+    // The calls to the next layer are timed for the timestamp setting and for the trace event output
+    bool measureCalls() const { return show_timestamp || output_format == ApiDumpFormat::TraceEvent; }
+
+    // Nanoseconds since the layer was initialized, from the steady clock or from the TSC calibrated against it
+    uint64_t timestamp() const {
+#if defined(API_DUMP_TSC_AVAILABLE)
+        if (timestamp_clock == ApiDumpClock::Tsc) {
+            return static_cast<uint64_t>(static_cast<double>(__rdtsc() - clock_start_tsc) * tsc_ns_per_tick);
+        }
+#endif
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - clock_start).count();
+    }
+
+    // The calibration of the timestamps, set once per process by calibrateClock
+    std::chrono::steady_clock::time_point clockStart() const { return clock_start; }
+
+    uint64_t clockStartTsc() const { return clock_start_tsc; }
+
+    double tscNsPerTick() const { return tsc_ns_per_tick; }
+
     bool showThreadAndFrame() const { return show_thread_and_frame; }
 
+    // True when each thread writes its API calls to its own file, without taking the output mutex
+    bool perThreadOutput() const { return per_thread_output.load(std::memory_order_acquire); }
+
     // The const cast is necessary because everyone who 'writes' to the stream necessarily must be able to modify it.
     // Since basically every function in this struct is const, we have to work around that.
-    std::ostream &stream() const { return output_stream; }
+    std::ostream &stream() const {
+        if (!per_thread_output) return output_stream;
+
+        // A call dumped without its record heading, when the output range starts during the call, is dropped
+        static thread_local std::ostream discarded_stream(nullptr);
+        std::ostream *thread_stream = ThreadStream();
+        return thread_stream != nullptr ? *thread_stream : discarded_stream;
+    }
+
+    // Each record of the per-thread output starts with a "@@apidump <sequence> <frame> <time>" line: the global order of the
+    // call, its frame and its timestamp in ns. merge_api_dump.py uses it to rebuild a single ordered dump.
+    void writeThreadRecordHeading(uint64_t thread_id, uint64_t frame) const {
+        std::ostream *&thread_stream = ThreadStream();
+        if (thread_stream == nullptr) {
+            thread_stream = &openThreadOutput(thread_id);
+        } else if (output_format == ApiDumpFormat::Json) {
+            *thread_stream << "\n";  // The JSON calls don't end with a new line
+        }
+
+        const uint64_t sequence = record_sequence.fetch_add(1, std::memory_order_relaxed);
+        *thread_stream << "@@apidump " << sequence << " " << frame << " " << timestamp() << "\n";
+    }
+
+    // Start an event of the trace_event output, a JSON object of the Trace Event Format array with its timestamp in us. The
+    // caller writes the remaining members of the event and closes it.
+    void writeTraceEventHeading(const char *name, const char *category, char phase, uint64_t thread_id, uint64_t time) const {
+        if (json_frame_written) output_stream << ",\n";
+        json_frame_written = true;
+        writeTraceEventName(name, category, phase, thread_id, time);
+    }
+
+    // The event without the separator from the previous event
+    void writeTraceEventName(const char *name, const char *category, char phase, uint64_t thread_id, uint64_t time) const {
+        output_stream << "{\"name\":";
+        writeJsonString(name);
+        output_stream << ",\"cat\":\"" << category << "\",\"ph\":\"" << phase << "\",\"pid\":" << process_id
+                      << ",\"tid\":" << thread_id << ",\"ts\":";
+        writeTraceEventTime(time);
+    }
+
+    // The nanoseconds are written as microseconds with a fractional part
+    void writeTraceEventTime(uint64_t time) const {
+        char us[32];
+        snprintf(us, sizeof(us), "%llu.%03llu", static_cast<unsigned long long>(time / 1000),
+                 static_cast<unsigned long long>(time % 1000));
+        output_stream << us;
+    }
+
+    // The label names are application strings, they are escaped
+    void writeJsonString(const char *value) const {
+        output_stream << '"';
+        for (const char *c = value != nullptr ? value : ""; *c != '\0'; ++c) {
+            if (*c == '"' || *c == '\\') {
+                output_stream << '\\' << *c;
+            } else if (static_cast<unsigned char>(*c) < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(*c));
+                output_stream << escaped;
+            } else {
+                output_stream << *c;
+            }
+        }
+        output_stream << '"';
+    }
+
+    bool indexHandles() const { return index_handles; }
+
+    // Called before the head of each dumped call, the handles dumped until the next call are indexed with it
+    void beginIndexedCall() const {
+        if (index_handles) handle_index.beginCall(index_sequence++, static_cast<uint64_t>(output_stream.tellp()));
+    }
+
+    // Called before anything that isn't part of a call is written to the output
+    void endIndexedCall() const {
+        if (index_handles) handle_index.endCall(static_cast<uint64_t>(output_stream.tellp()));
+    }
+
+    void indexLifetime(const char *created_type, const char *destroyed_type) const {
+        if (index_handles) handle_index.setLifetime(created_type, destroyed_type);
+    }
+
+    void indexHandle(const char *type, uint64_t handle) const {
+        if (index_handles) handle_index.reference(type, handle);
+    }
 
     bool isFrameInRange(uint64_t frame) const { return condFrameOutput.isFrameInRange(frame); }
 
+    uint64_t nextTransitionFrame(uint64_t frame) const { return condFrameOutput.nextTransitionFrame(frame); }
+
     void init(const VkInstanceCreateInfo *pCreateInfo, const VkAllocationCallbacks *pAllocator) {
+        // The compression thread is restarted by the next rotation after the previous instances were destroyed
+        {
+            std::lock_guard<std::mutex> lg(compress_mutex);
+            compress_stop = false;
+        }
+
         VkuLayerSettingSet layerSettingSet = VK_NULL_HANDLE;
         vkuCreateLayerSettingSet("VK_LAYER_LUNARG_api_dump", vkuFindLayerSettingsCreateInfo(pCreateInfo), pAllocator, nullptr,
                                  &layerSettingSet);
 
         vkuSetLayerSettingCompatibilityNamespace(layerSettingSet, GetDefaultPrefix());
 
+#if defined(_WIN32)
+        process_id = static_cast<uint64_t>(_getpid());
+#else
+        process_id = static_cast<uint64_t>(getpid());
+#endif
+
         // Read the format type first as it may be used in the output file extension
         output_format = ApiDumpFormat::Text;
         if (vkuHasLayerSetting(layerSettingSet, kSettingsKeyOutputFormat)) {
@@ -516,6 +1136,8 @@ class ApiDumpSettings {
                 output_format = ApiDumpFormat::Html;
             } else if (value == "json") {
                 output_format = ApiDumpFormat::Json;
+            } else if (value == "trace_event") {
+                output_format = ApiDumpFormat::TraceEvent;
             } else {
                 output_format = ApiDumpFormat::Text;
             }
@@ -531,7 +1153,7 @@ class ApiDumpSettings {
             if (file) {
                 if (output_format == ApiDumpFormat::Html) {
                     filename_string = "vk_apidump.html";
-                } else if (output_format == ApiDumpFormat::Json) {
+                } else if (output_format == ApiDumpFormat::Json || output_format == ApiDumpFormat::TraceEvent) {
                     filename_string = "vk_apidump.json";
                 } else {
                     filename_string = "vk_apidump.txt";
@@ -554,7 +1176,7 @@ class ApiDumpSettings {
                 if (json_pos != std::string::npos) filename_string.erase(json_pos);
                 if (txt_pos != std::string::npos) filename_string.erase(txt_pos);
                 if (html_pos == std::string::npos) filename_string.append(".html");
-            } else if (output_format == ApiDumpFormat::Json) {
+            } else if (output_format == ApiDumpFormat::Json || output_format == ApiDumpFormat::TraceEvent) {
                 if (html_pos != std::string::npos) filename_string.erase(html_pos);
                 if (txt_pos != std::string::npos) filename_string.erase(txt_pos);
                 if (json_pos == std::string::npos) filename_string.append(".json");
@@ -565,10 +1187,58 @@ class ApiDumpSettings {
             }
         }
 
+        int rotate_size_mb = 0;
+        if (vkuHasLayerSetting(layerSettingSet, kSettingsKeyRotateSize)) {
+            vkuGetLayerSettingValue(layerSettingSet, kSettingsKeyRotateSize, rotate_size_mb);
+        }
+        rotate_size = static_cast<std::streamoff>(std::max(rotate_size_mb, 0)) * 1024 * 1024;
+
+        rotate_frames = 0;
+        if (vkuHasLayerSetting(layerSettingSet, kSettingsKeyRotateFrames)) {
+            vkuGetLayerSettingValue(layerSettingSet, kSettingsKeyRotateFrames, rotate_frames);
+            rotate_frames = std::max(rotate_frames, 0);
+        }
+
+        bool per_thread = false;
+        if (vkuHasLayerSetting(layerSettingSet, kSettingsKeyPerThread)) {
+            vkuGetLayerSettingValue(layerSettingSet, kSettingsKeyPerThread, per_thread);
+        }
+
+        compress_output = false;
+#if defined(API_DUMP_USE_ZLIB)
+        if (vkuHasLayerSetting(layerSettingSet, kSettingsKeyCompress)) {
+            vkuGetLayerSettingValue(layerSettingSet, kSettingsKeyCompress, compress_output);
+        }
+#endif
+
+        // The per-thread files are only ordered by merge_api_dump.py, which doesn't handle the HTML and trace event outputs. The
+        // mode is latched by the first instance: the calls dumped by other threads meanwhile decide from it whether they take
+        // the output mutex.
+        if (!output_mode_latched) {
+            per_thread_output.store(!filename_string.empty() && per_thread && output_format != ApiDumpFormat::Html &&
+                                        output_format != ApiDumpFormat::TraceEvent,
+                                    std::memory_order_release);
+            output_mode_latched = true;
+        }
+
         // If one of the above has set a filename, open the file as an output stream.
         if (!filename_string.empty()) {
-            output_file_stream.open(filename_string, std::ofstream::out | std::ostream::trunc);
-            output_stream.rdbuf(output_file_stream.rdbuf());
+            output_filename = filename_string;
+
+            rotate_output = !per_thread_output && (rotate_size > 0 || rotate_frames > 0);
+            compress_output = compress_output && rotate_output;
+
+            if (rotate_output) {
+                index_file_stream.open(indexFilename(), std::ofstream::out | std::ostream::trunc);
+                index_file_stream << "# first_frame-last_frame file" << std::endl;
+            }
+
+            // The per-thread files are opened by the first call of each thread
+            if (!per_thread_output) {
+                output_file_stream.open(rotate_output ? segmentFilename(segment_index) : filename_string,
+                                        std::ofstream::out | std::ostream::trunc);
+                output_stream.rdbuf(output_file_stream.rdbuf());
+            }
         }
 
         show_params = true;
@@ -594,6 +1264,18 @@ class ApiDumpSettings {
             vkuGetLayerSettingValue(layerSettingSet, kSettingsKeyTimestamp, show_timestamp);
         }
 
+        timestamp_clock = ApiDumpClock::Steady;
+        if (vkuHasLayerSetting(layerSettingSet, kSettingsKeyTimestampClock)) {
+            std::string value;
+            vkuGetLayerSettingValue(layerSettingSet, kSettingsKeyTimestampClock, value);
+#if defined(API_DUMP_TSC_AVAILABLE)
+            if (ToLowerString(value) == "tsc") {
+                timestamp_clock = ApiDumpClock::Tsc;
+            }
+#endif
+        }
+        calibrateClock();
+
         indent_size = 4;
         if (vkuHasLayerSetting(layerSettingSet, kSettingsKeyIndentSize)) {
             vkuGetLayerSettingValue(layerSettingSet, kSettingsKeyIndentSize, indent_size);
@@ -633,6 +1315,40 @@ class ApiDumpSettings {
             vkuGetLayerSettingValue(layerSettingSet, kSettingsKeyShowThreadAndFrame, show_thread_and_frame);
         }
 
+        // The frames of the per-thread output can't be captured, they are only ordered once the files are merged
+        trigger_capture = false;
+        if (!per_thread_output && vkuHasLayerSetting(layerSettingSet, kSettingsKeyTriggerCapture)) {
+            vkuGetLayerSettingValue(layerSettingSet, kSettingsKeyTriggerCapture, trigger_capture);
+        }
+
+        trigger_pre_frames = 10;
+        if (vkuHasLayerSetting(layerSettingSet, kSettingsKeyTriggerPreFrames)) {
+            vkuGetLayerSettingValue(layerSettingSet, kSettingsKeyTriggerPreFrames, trigger_pre_frames);
+            trigger_pre_frames = std::max(trigger_pre_frames, 1);
+        }
+
+        trigger_post_frames = 10;
+        if (vkuHasLayerSetting(layerSettingSet, kSettingsKeyTriggerPostFrames)) {
+            vkuGetLayerSettingValue(layerSettingSet, kSettingsKeyTriggerPostFrames, trigger_post_frames);
+            trigger_post_frames = std::max(trigger_post_frames, 0);
+        }
+
+        if (vkuHasLayerSetting(layerSettingSet, kSettingsKeyTriggerFile)) {
+            vkuGetLayerSettingValue(layerSettingSet, kSettingsKeyTriggerFile, trigger_file);
+        }
+
+        if (vkuHasLayerSetting(layerSettingSet, kSettingsKeyTriggerLabel)) {
+            vkuGetLayerSettingValue(layerSettingSet, kSettingsKeyTriggerLabel, trigger_label);
+        }
+
+        // The offsets of the calls are only known when they are written directly to a single file. The trace events are
+        // not calls of the text, html or json output that query_api_dump.py reads back.
+        index_handles = false;
+        if (!filename_string.empty() && !per_thread_output && !trigger_capture && output_format != ApiDumpFormat::TraceEvent &&
+            vkuHasLayerSetting(layerSettingSet, kSettingsKeyHandleIndex)) {
+            vkuGetLayerSettingValue(layerSettingSet, kSettingsKeyHandleIndex, index_handles);
+        }
+
         std::string cond_range_string;
         if (vkuHasLayerSetting(layerSettingSet, kSettingsKeyOutputRange)) {
             vkuGetLayerSettingValue(layerSettingSet, kSettingsKeyOutputRange, cond_range_string);
@@ -655,7 +1371,366 @@ class ApiDumpSettings {
             indent_size = 1;  // setting this allows indentation to not need a branch on use_spaces
         }
 
-        // Generate HTML heading if specified
+        writeDocumentHeading();
+        if (rotate_output) {
+            segment_heading_size = output_file_stream.tellp();
+        }
+
+        // With trigger capture, the frames are recorded in memory until a trigger, only the heading is written out directly
+        if (trigger_capture) {
+            capture_output_buffer = output_stream.rdbuf();
+            output_stream.rdbuf(&capture_buffer);
+            capture_written = json_frame_written;
+        }
+
+        if (isFrameInRange(0)) {
+            setupInterFrameOutputFormatting(0);
+        }
+
+        vkuDestroyLayerSettingSet(layerSettingSet, pAllocator);
+    }
+
+   private:
+    // The output of a thread in per-thread mode, each thread writes through its own buffer
+    struct ThreadOutput {
+        std::vector<char> buffer;
+        std::ofstream file;
+    };
+
+    // A frame of the capture ring
+    struct CapturedFrame {
+        std::string text;
+        std::vector<CapturedCall> calls;
+    };
+
+    static std::ostream *&ThreadStream() {
+        static thread_local std::ostream *thread_stream = nullptr;
+        return thread_stream;
+    }
+
+    // Called once per thread, on its first dumped call
+    std::ostream &openThreadOutput(uint64_t thread_id) const {
+        char number[32];
+        snprintf(number, sizeof(number), ".thread%llu", static_cast<unsigned long long>(thread_id));
+
+        std::unique_ptr<ThreadOutput> output = std::make_unique<ThreadOutput>();
+        output->buffer.resize(1024 * 1024);
+        output->file.rdbuf()->pubsetbuf(output->buffer.data(), output->buffer.size());
+        output->file.open(insertInFilename(number), std::ofstream::out | std::ostream::trunc);
+        output->file << std::setfill(use_spaces ? ' ' : '\t');
+
+        std::ostream &thread_stream = output->file;
+        std::lock_guard<std::mutex> lg(thread_outputs_mutex);
+        thread_outputs.push_back(std::move(output));
+        return thread_stream;
+    }
+
+    // The calls that exceeded their buffer are formatted in the text of their frame when a capture is triggered
+    std::string formatCapturedFrame(const CapturedFrame &frame) const {
+        std::stringbuf buffer;
+        std::streambuf *current_buffer = output_stream.rdbuf(&buffer);
+
+        std::size_t written = 0;
+        for (const CapturedCall &call : frame.calls) {
+            output_stream.write(frame.text.data() + written, call.offset - written);
+            written = call.offset;
+            writeCapturedCall(call);
+        }
+        output_stream.write(frame.text.data() + written, frame.text.size() - written);
+
+        output_stream.rdbuf(current_buffer);
+        return buffer.str();
+    }
+
+    // Written like the dumped calls with show_params disabled
+    void writeCapturedCall(const CapturedCall &call) const {
+        switch (output_format) {
+            case ApiDumpFormat::Text:
+                if (show_thread_and_frame) output_stream << "Thread " << call.thread_id << ", Frame " << call.frame;
+                if (show_timestamp && show_thread_and_frame) output_stream << ", ";
+                if (show_timestamp) output_stream << "Time " << call.time << " ns";
+                if (show_timestamp || show_thread_and_frame) output_stream << ":\n";
+                output_stream << call.name << "(" << call.named_params << ") returns " << call.return_type;
+                if (call.has_result) output_stream << " " << string_VkResult(call.result) << " (" << call.result << ")";
+                if (show_timestamp) output_stream << ", Duration " << call.duration << " ns";
+                output_stream << ":\n\n";
+                break;
+            case ApiDumpFormat::Html:
+                if (show_thread_and_frame) output_stream << "<div class='thd'>Thread: " << call.thread_id << "</div>";
+                if (show_timestamp) output_stream << "<div class='time'>Time: " << call.time << " ns</div>";
+                output_stream << "<details class='fn'><summary><div class='var'>" << call.name << "(" << call.named_params
+                              << ")</div>";
+                if (show_type) output_stream << "<div class='type'>" << call.return_type << "</div>";
+                if (call.has_result) {
+                    output_stream << "<div class='val'>" << string_VkResult(call.result) << " (" << call.result << ")</div>";
+                }
+                if (show_timestamp) output_stream << "<div class='time'>Duration: " << call.duration << " ns</div>";
+                output_stream << "</summary>\n</details>";
+                break;
+            case ApiDumpFormat::Json:
+                if (call.separator) output_stream << ",\n";
+                output_stream << indentation(2) << "{\n";
+                output_stream << indentation(3) << "\"name\" : \"" << call.name << "\",\n";
+                if (show_thread_and_frame) output_stream << indentation(3) << "\"thread\" : \"Thread " << call.thread_id << "\",\n";
+                if (show_timestamp) output_stream << indentation(3) << "\"time\" : \"" << call.time << " ns\",\n";
+                output_stream << indentation(3) << "\"returnType\" : \"" << call.return_type << "\"";
+                output_stream << (call.has_result || show_timestamp ? ",\n" : "\n");
+                if (show_timestamp) {
+                    output_stream << indentation(3) << "\"duration\" : \"" << call.duration << " ns\"";
+                    output_stream << (call.has_result ? ",\n" : "\n");
+                }
+                if (call.has_result) {
+                    output_stream << indentation(3) << "\"returnValue\" : \"" << string_VkResult(call.result) << "\"\n";
+                }
+                output_stream << indentation(2) << "}";
+                break;
+            case ApiDumpFormat::TraceEvent:
+                if (call.separator) output_stream << ",\n";
+                writeTraceEventName(call.name, "vulkan", 'X', call.thread_id, call.time);
+                output_stream << ",\"dur\":";
+                writeTraceEventTime(call.duration);
+                output_stream << ",\"args\":{\"frame\":" << call.frame;
+                if (call.has_result) output_stream << ",\"result\":\"" << string_VkResult(call.result) << "\"";
+                output_stream << "}}";
+                break;
+        }
+    }
+
+    // Insert text before the extension of the output filename
+    std::string insertInFilename(const char *text) const {
+        std::string filename = output_filename;
+        const std::size_t extension = filename.find_last_of('.');
+        const std::size_t directory = filename.find_last_of("/\\");
+        if (extension == std::string::npos || (directory != std::string::npos && extension < directory)) {
+            return filename + text;
+        }
+        return filename.insert(extension, text);
+    }
+
+    // "vk_apidump.json" is written to "vk_apidump.0001.json", "vk_apidump.0002.json"... when the output is rotated
+    std::string segmentFilename(int index) const {
+        char number[16];
+        snprintf(number, sizeof(number), ".%04d", index);
+        return insertInFilename(number);
+    }
+
+    // "vk_apidump.json" is indexed in "vk_apidump.index.txt", one line per file with the range of frames it covers
+    std::string indexFilename() const {
+        const std::size_t extension = output_filename.find_last_of('.');
+        const std::size_t directory = output_filename.find_last_of("/\\");
+        if (extension == std::string::npos || (directory != std::string::npos && extension < directory)) {
+            return output_filename + ".index.txt";
+        }
+        return output_filename.substr(0, extension) + ".index.txt";
+    }
+
+    void closeOutputFile(uint64_t last_frame) {
+        output_file_stream.close();
+
+        std::string filename = segmentFilename(segment_index);
+        if (index_handles) {
+            handle_index.write(filename);
+            handle_index.startNextFile();
+        }
+        if (compress_output) {
+            queueCompression(filename);
+            filename += ".gz";
+        }
+
+        const std::size_t directory = filename.find_last_of("/\\");
+        index_file_stream << segment_first_frame << "-" << last_frame << " "
+                          << (directory == std::string::npos ? filename : filename.substr(directory + 1)) << std::endl;
+    }
+
+    void queueCompression(const std::string &filename) {
+        // Once the last instance is destroyed, the files are compressed on the calling thread
+        if (compress_stop) {
+            CompressFile(filename);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lg(compress_mutex);
+            compress_queue.push_back(filename);
+            if (!compress_thread.joinable()) {
+                compress_thread = std::thread(&ApiDumpSettings::compressFiles, this);
+            }
+        }
+        compress_condition.notify_one();
+    }
+
+    // Join the compression thread once the queued files are compressed
+    void stopCompression() {
+        if (compress_thread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lg(compress_mutex);
+                compress_stop = true;
+            }
+            compress_condition.notify_one();
+            compress_thread.join();
+        }
+        compress_stop = true;
+
+        // The compression thread may already have been terminated when the process exits
+        for (const std::string &filename : compress_queue) {
+            CompressFile(filename);
+        }
+        compress_queue.clear();
+    }
+
+    // Compress the closed files on a background thread so that the application isn't stalled by a rotation
+    void compressFiles() {
+        std::unique_lock<std::mutex> lock(compress_mutex);
+        for (;;) {
+            compress_condition.wait(lock, [this] { return compress_stop || !compress_queue.empty(); });
+            if (compress_queue.empty()) return;
+
+            const std::string filename = compress_queue.front();
+            compress_queue.pop_front();
+
+            lock.unlock();
+            CompressFile(filename);
+            lock.lock();
+        }
+    }
+
+    // Write "filename.gz" and remove "filename" once it succeeded
+    static bool CompressFile(const std::string &filename) {
+#if defined(API_DUMP_USE_ZLIB)
+        FILE *input = fopen(filename.c_str(), "rb");
+        if (input == nullptr) return false;
+
+        gzFile output = gzopen((filename + ".gz").c_str(), "wb");
+        if (output == nullptr) {
+            fclose(input);
+            return false;
+        }
+
+        bool result = true;
+        std::vector<char> buffer(1024 * 1024);
+        std::size_t size = 0;
+        while ((size = fread(buffer.data(), 1, buffer.size(), input)) > 0) {
+            if (gzwrite(output, buffer.data(), static_cast<unsigned>(size)) != static_cast<int>(size)) {
+                result = false;
+                break;
+            }
+        }
+        fclose(input);
+
+        if (gzclose(output) != Z_OK) result = false;
+        if (result) remove(filename.c_str());
+        return result;
+#else
+        (void)filename;
+        return false;
+#endif
+    }
+
+    // The start of the timestamps in the steady clock, the system clock and the TSC, so that the timestamps can be correlated
+    // with the traces of other tools. The clock is calibrated once per process: the output continues across instances and
+    // the timestamps stay on the same origin. The TSC frequency is measured over 10 ms against the steady clock, the first
+    // time the TSC is selected.
+    void calibrateClock() {
+        if (!clock_calibrated) {
+            clock_start = std::chrono::steady_clock::now();
+            clock_start_system = std::chrono::system_clock::now();
+            clock_calibrated = true;
+        }
+
+#if defined(API_DUMP_TSC_AVAILABLE)
+        // A TSC that doesn't run at a constant rate in every power state can't be converted to time
+        if (timestamp_clock == ApiDumpClock::Tsc && !invariantTsc()) {
+            timestamp_clock = ApiDumpClock::Steady;
+        }
+
+        if (timestamp_clock == ApiDumpClock::Tsc && tsc_ns_per_tick == 0.0) {
+            const std::chrono::steady_clock::time_point steady_begin = std::chrono::steady_clock::now();
+            const uint64_t tsc_begin = __rdtsc();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            const uint64_t tsc_end = __rdtsc();
+            const std::chrono::steady_clock::time_point steady_end = std::chrono::steady_clock::now();
+
+            const std::chrono::nanoseconds elapsed =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(steady_end - steady_begin);
+            tsc_ns_per_tick = static_cast<double>(elapsed.count()) / static_cast<double>(tsc_end - tsc_begin);
+
+            // The TSC value at the start of the steady clock timestamps
+            const std::chrono::nanoseconds since_start =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(steady_begin - clock_start);
+            clock_start_tsc = tsc_begin - static_cast<uint64_t>(static_cast<double>(since_start.count()) / tsc_ns_per_tick);
+        }
+#endif
+    }
+
+#if defined(API_DUMP_TSC_AVAILABLE)
+    // CPUID 0x80000007 EDX bit 8: the TSC runs at a constant rate in all ACPI P-, C- and T-states
+    static bool invariantTsc() {
+#if defined(_MSC_VER)
+        int registers[4] = {};
+        __cpuid(registers, 0x80000000);
+        if (static_cast<unsigned int>(registers[0]) < 0x80000007) return false;
+        __cpuid(registers, 0x80000007);
+        return (registers[3] & (1 << 8)) != 0;
+#else
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0) return false;
+        return (edx & (1 << 8)) != 0;
+#endif
+    }
+#endif
+
+    // Written at the start of the output when the timestamps are shown
+    void writeClockCalibration() const {
+        const long long steady_ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(clock_start.time_since_epoch()).count();
+        const long long system_ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(clock_start_system.time_since_epoch()).count();
+        const char *source = timestamp_clock == ApiDumpClock::Tsc ? "tsc" : "steady";
+        const long long tsc_frequency = tsc_ns_per_tick > 0.0 ? static_cast<long long>(1.0e9 / tsc_ns_per_tick) : 0;
+
+        switch (output_format) {
+            case ApiDumpFormat::Text:
+                output_stream << "Clock: " << source << ", Start: " << steady_ns << " ns steady clock, " << system_ns
+                              << " ns system clock";
+                if (timestamp_clock == ApiDumpClock::Tsc) {
+                    output_stream << ", " << clock_start_tsc << " TSC at " << tsc_frequency << " Hz";
+                }
+                output_stream << "\n\n";
+                break;
+            case ApiDumpFormat::Html:
+                output_stream << "<div class='time'>Clock: " << source << ", Start: " << steady_ns << " ns steady clock, "
+                              << system_ns << " ns system clock";
+                if (timestamp_clock == ApiDumpClock::Tsc) {
+                    output_stream << ", " << clock_start_tsc << " TSC at " << tsc_frequency << " Hz";
+                }
+                output_stream << "</div>";
+                break;
+            case ApiDumpFormat::Json:
+                // The first element of the document, followed by the frames
+                output_stream << "{\n" << indentation(1) << "\"clock\" :\n" << indentation(1) << "{\n";
+                output_stream << indentation(2) << "\"source\" : \"" << source << "\",\n";
+                output_stream << indentation(2) << "\"startSteadyNs\" : \"" << steady_ns << "\",\n";
+                output_stream << indentation(2) << "\"startSystemNs\" : \"" << system_ns << "\"";
+                if (timestamp_clock == ApiDumpClock::Tsc) {
+                    output_stream << ",\n" << indentation(2) << "\"startTsc\" : \"" << clock_start_tsc << "\",\n";
+                    output_stream << indentation(2) << "\"tscFrequency\" : \"" << tsc_frequency << "\"";
+                }
+                output_stream << "\n" << indentation(1) << "}\n}";
+                json_frame_written = true;
+                break;
+            case ApiDumpFormat::TraceEvent:
+                // The clock is described by a metadata event, all the events are timestamped
+                writeTraceEventHeading("clock", "__metadata", 'M', 0, 0);
+                output_stream << ",\"args\":{\"source\":\"" << source << "\",\"startSteadyNs\":" << steady_ns
+                              << ",\"startSystemNs\":" << system_ns << "}}";
+                break;
+        }
+    }
+
+    // Write the start of the HTML or JSON document, at the beginning of the output and of each rotated file
+    void writeDocumentHeading() const {
+        if (per_thread_output) return;
+
         if (output_format == ApiDumpFormat::Html) {
             // clang-format off
             // Insert html heading
@@ -760,16 +1835,29 @@ class ApiDumpSettings {
             // clang-format on
         } else if (output_format == ApiDumpFormat::Json) {
             output_stream << "[\n";
+        } else if (output_format == ApiDumpFormat::TraceEvent) {
+            output_stream << "[\n";
+            writeTraceEventHeading("process_name", "__metadata", 'M', 0, 0);
+            output_stream << ",\"args\":{\"name\":\"Vulkan API Dump\"}}";
         }
 
-        if (isFrameInRange(0)) {
-            setupInterFrameOutputFormatting(0);
+        if (show_timestamp) {
+            writeClockCalibration();
         }
+    }
 
-        vkuDestroyLayerSettingSet(layerSettingSet, pAllocator);
+    // Close off the HTML or JSON document
+    void writeDocumentEnding() const {
+        endIndexedCall();
+        if (per_thread_output) return;
+
+        if (output_format == ApiDumpFormat::Html) {
+            output_stream << "</div></body></html>";
+        } else if (output_format == ApiDumpFormat::Json || output_format == ApiDumpFormat::TraceEvent) {
+            output_stream << "\n]" << std::endl;
+        }
     }
 
-   private:
     // Utility member to enable easier comparison by forcing a string to all lower-case
     static std::string ToLowerString(const std::string &value) {
         std::string lower_value = value;
@@ -789,6 +1877,13 @@ class ApiDumpSettings {
     bool show_address;
     bool should_flush;
     bool show_timestamp;
+    ApiDumpClock timestamp_clock = ApiDumpClock::Steady;
+    uint64_t process_id = 0;  // The "pid" of the trace events
+    std::chrono::steady_clock::time_point clock_start;
+    std::chrono::system_clock::time_point clock_start_system;
+    uint64_t clock_start_tsc = 0;
+    double tsc_ns_per_tick = 0.0;
+    bool clock_calibrated = false;
 
     bool show_type;
     int indent_size;  // how many indent levels to use - also sets the tab_size
@@ -801,12 +1896,63 @@ class ApiDumpSettings {
     bool use_conditional_output = false;
     ConditionalFrameOutput condFrameOutput;
 
+    bool trigger_capture = false;
+    int trigger_pre_frames;
+    int trigger_post_frames;
+    std::string trigger_file;
+    std::string trigger_label;
+    std::stringbuf capture_buffer;                    // The current frame while recording
+    std::deque<CapturedFrame> capture_ring;           // The last trigger_pre_frames frames
+    std::vector<CapturedCall> capture_calls;          // The calls of the current frame that exceeded their buffer
+    CapturedCallBuffer captured_call_buffer;          // The call being recorded
+    bool captured_call_json_frame_written = false;    // json_frame_written before the call being recorded
+    std::streambuf *capture_output_buffer = nullptr;  // Where the captured frames are written to
+    int capture_post_frames_left = 0;
+    bool capture_written = false;
+
+    bool index_handles = false;
+    mutable HandleIndex handle_index;
+    mutable uint64_t index_sequence = 0;  // The order of the dumped calls, the sequence numbers of the handle index
+
+    mutable bool json_frame_written = false;  // False until the first frame of the JSON document or the first trace event
+
+    std::string output_filename;
+    bool rotate_output = false;
+    std::streamoff rotate_size;  // In bytes, 0 when the output isn't rotated by size
+    int rotate_frames;           // 0 when the output isn't rotated by frame count
+    bool compress_output;
+    int segment_index = 1;
+    uint64_t segment_first_frame = 0;
+    std::streamoff segment_heading_size = 0;
+    bool segment_written = false;  // Something was written to the current file when the frame last ended
+    uint64_t current_frame = 0;
+    std::ofstream index_file_stream;
+
+    std::thread compress_thread;
+    std::mutex compress_mutex;
+    std::condition_variable compress_condition;
+    std::deque<std::string> compress_queue;
+    bool compress_stop = false;
+
+    std::atomic<bool> per_thread_output{false};
+    bool output_mode_latched = false;  // Set by the first initialization
+    mutable std::atomic<uint64_t> record_sequence{0};
+    mutable std::mutex thread_outputs_mutex;
+    mutable std::vector<std::unique_ptr<ThreadOutput>> thread_outputs;
+
     int tab_size;  // equal to the indent size if using spaces, otherwise is equal to 1
 };
 
+#if !defined(_WIN32)
+// Set by SIGUSR1 when trigger capture is enabled, polled at the end of each frame
+static volatile sig_atomic_t capture_signal_received = 0;
+
+static void CaptureSignalHandler(int) { capture_signal_received = 1; }
+#endif
+
 class ApiDumpInstance {
    public:
-    ApiDumpInstance() noexcept : frame_count(0) { program_start = std::chrono::system_clock::now(); }
+    ApiDumpInstance() noexcept : frame_count(0) {}
     // Can't copy or move this type
     ApiDumpInstance(const ApiDumpInstance &) = delete;
     ApiDumpInstance &operator=(const ApiDumpInstance &) = delete;
@@ -814,36 +1960,95 @@ class ApiDumpInstance {
     ApiDumpInstance &operator=(ApiDumpInstance &&) = delete;
 
     ~ApiDumpInstance() {
-        if (!first_func_call_on_frame) settings().closeFrameOutput();
+        const bool frame_written = settings().finishCapture();
+        if (!first_func_call_on_frame && frame_written) settings().closeFrameOutput();
+    }
+
+    // Called by vkCreateInstance and vkDestroyInstance, the background work of the output stops with the last instance
+    void addInstance() {
+        std::lock_guard<std::recursive_mutex> lo(output_mutex);
+        ++instance_count;
+    }
+
+    void removeInstance() {
+        std::lock_guard<std::recursive_mutex> lo(output_mutex);
+        if (instance_count == 0 || --instance_count > 0) return;
+        settings().finishInstances();
     }
 
     void initLayerSettings(const VkInstanceCreateInfo *pCreateInfo, const VkAllocationCallbacks *pAllocator) {
         this->dump_settings.init(pCreateInfo, pAllocator);
-    }
 
-    uint64_t frameCount() {
+#if !defined(_WIN32)
+        // Don't replace a handler installed by the application
+        if (settings().triggerCapture()) {
+            struct sigaction previous_action = {};
+            if (sigaction(SIGUSR1, nullptr, &previous_action) == 0 && previous_action.sa_handler == SIG_DFL) {
+                struct sigaction action = {};
+                action.sa_handler = CaptureSignalHandler;
+                sigemptyset(&action.sa_mask);
+                action.sa_flags = SA_RESTART;
+                sigaction(SIGUSR1, &action, nullptr);
+            }
+        }
+#endif
+
         std::lock_guard<std::recursive_mutex> lg(frame_mutex);
-        uint64_t count = frame_count;
-        return count;
+        updateDumpingEnabled();
     }
 
+    uint64_t frameCount() const { return frame_count.load(std::memory_order_relaxed); }
+
     void nextFrame() {
+        {
+            // Outside of the dumped frames, a present only counts the frame until the next transition or rotation, without
+            // waiting for the threads holding the output mutex
+            std::lock_guard<std::recursive_mutex> lg(frame_mutex);
+            const uint64_t next_frame = frame_count + 1;
+            if (!shouldDumpOutput() && next_frame < next_transition_frame && !settings().triggerCapture() &&
+                !settings().rotatesOutputAt(next_frame)) {
+                frame_count = next_frame;
+                settings().skipFrame(next_frame);
+                first_func_call_on_frame = true;
+                return;
+            }
+        }
+
+        // The frame formatting, the capture ring and the output rotation write to the output stream
+        std::lock_guard<std::recursive_mutex> lo(output_mutex);
         std::lock_guard<std::recursive_mutex> lg(frame_mutex);
         ++frame_count;
 
-        should_dump_output = settings().isFrameInRange(frame_count);
-        settings().setupInterFrameOutputFormatting(frame_count);
+        if (frame_count >= next_transition_frame) {
+            updateDumpingEnabled();
+        }
+        settings().endFrameOutputFormatting(frame_count - 1);
+        if (settings().triggerCapture()) {
+            settings().captureFrame(settings().isRecordingCapture() && pollCaptureTrigger());
+        }
+        settings().rotateOutput(frame_count);
+        settings().beginFrameOutputFormatting(frame_count);
         first_func_call_on_frame = true;
     }
 
-    bool shouldDumpOutput() {
-        if (!conditional_initialized) {
-            should_dump_output = settings().isFrameInRange(frame_count);
-            conditional_initialized = true;
+    // Called by vkCmdInsertDebugUtilsLabelEXT and vkQueueInsertDebugUtilsLabelEXT, the capture is triggered at the end of the frame
+    void checkCaptureLabel(const VkDebugUtilsLabelEXT *pLabelInfo) {
+        if (!settings().triggerCapture() || settings().triggerLabel().empty()) return;
+        if (pLabelInfo != nullptr && pLabelInfo->pLabelName != nullptr && settings().triggerLabel() == pLabelInfo->pLabelName) {
+            capture_triggered.store(true, std::memory_order_relaxed);
         }
-        return should_dump_output;
     }
 
+    // The trigger file is checked at the end of the current frame, without waiting for kTriggerFilePollInterval
+    void resetTriggerFilePoll() {
+        std::lock_guard<std::recursive_mutex> lg(output_mutex);
+        next_trigger_file_poll = std::chrono::steady_clock::time_point();
+    }
+
+    // Called by every entry point before taking the output mutex: outside of the dumped frames, the calls go straight to the
+    // next layer after a single atomic load.
+    bool shouldDumpOutput() const { return dumping_enabled.load(std::memory_order_relaxed); }
+
     bool firstFunctionCallOnFrame() {
         if (first_func_call_on_frame) {
             first_func_call_on_frame = false;
@@ -854,26 +2059,42 @@ class ApiDumpInstance {
 
     std::recursive_mutex *outputMutex() { return &output_mutex; }
 
+    // Taken by every dumped call, unless each thread writes to its own file. The call unlocks the output with the value
+    // returned here rather than reading the mode again.
+    bool lockOutput() {
+        const bool locked = !settings().perThreadOutput();
+        if (locked) output_mutex.lock();
+        return locked;
+    }
+
+    void unlockOutput(bool locked) {
+        if (locked) output_mutex.unlock();
+    }
+
     ApiDumpSettings &settings() { return dump_settings; }
 
     uint64_t threadID() {
+        // Only the first call of each thread takes the thread mutex
+        static thread_local uint64_t thread_id = UINT64_MAX;
+        if (thread_id != UINT64_MAX) return thread_id;
+
         std::thread::id this_id = std::this_thread::get_id();
         std::lock_guard<std::recursive_mutex> lg(thread_mutex);
 
         auto it = thread_map.find(this_id);
-        if (it != thread_map.end()) {
-            return it->second;
+        if (it == thread_map.end()) {
+            it = thread_map.insert({this_id, thread_map.size()}).first;
         }
 
-        thread_map.insert({this_id, thread_map.size()});
-        return thread_map.size() - 1;
+        thread_id = it->second;
+        return thread_id;
     }
 
-    void setCmdBuffer(VkCommandBuffer cmd_buffer) { this->cmd_buffer = cmd_buffer; }
+    void setCmdBuffer(VkCommandBuffer cmd_buffer) { callState().cmd_buffer = cmd_buffer; }
 
     VkCommandBufferLevel getCmdBufferLevel() {
         std::lock_guard<std::recursive_mutex> lg(cmd_buffer_state_mutex);
-        const auto level_iter = cmd_buffer_level.find(cmd_buffer);
+        const auto level_iter = cmd_buffer_level.find(callState().cmd_buffer);
         assert(level_iter != cmd_buffer_level.end());
         const auto level = level_iter->second;
         return level;
@@ -923,22 +2144,32 @@ class ApiDumpInstance {
         }
     }
 
-    void setIsDynamicScissor(bool is_dynamic_scissor) { this->is_dynamic_scissor = is_dynamic_scissor; }
-    void setIsDynamicViewport(bool is_dynamic_viewport) { this->is_dynamic_viewport = is_dynamic_viewport; }
-    bool getIsDynamicScissor() const { return is_dynamic_scissor; }
-    bool getIsDynamicViewport() const { return is_dynamic_viewport; }
-    void setMemoryHeapCount(uint32_t memory_heap_count) { this->memory_heap_count = memory_heap_count; }
-    uint32_t getMemoryHeapCount() { return memory_heap_count; }
-    void setDescriptorType(VkDescriptorType type) { this->descriptor_type = type; }
-    VkDescriptorType getDescriptorType() { return this->descriptor_type; }
-    void setIsGPLPreRasterOrFragmentShader(bool in) { this->GPLPreRasterOrFragmentShader = in; }
-    bool getIsGPLPreRasterOrFragmentShader() { return this->GPLPreRasterOrFragmentShader; }
+    void setIsDynamicScissor(bool is_dynamic_scissor) { callState().is_dynamic_scissor = is_dynamic_scissor; }
+    void setIsDynamicViewport(bool is_dynamic_viewport) { callState().is_dynamic_viewport = is_dynamic_viewport; }
+    bool getIsDynamicScissor() const { return callState().is_dynamic_scissor; }
+    bool getIsDynamicViewport() const { return callState().is_dynamic_viewport; }
+    void setMemoryHeapCount(uint32_t memory_heap_count) { callState().memory_heap_count = memory_heap_count; }
+    uint32_t getMemoryHeapCount() { return callState().memory_heap_count; }
+    void setDescriptorType(VkDescriptorType type) { callState().descriptor_type = type; }
+    VkDescriptorType getDescriptorType() { return callState().descriptor_type; }
+    void setIsGPLPreRasterOrFragmentShader(bool in) { callState().GPLPreRasterOrFragmentShader = in; }
+    bool getIsGPLPreRasterOrFragmentShader() { return callState().GPLPreRasterOrFragmentShader; }
 
-    std::chrono::microseconds current_time_since_start() {
-        std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
-        return std::chrono::duration_cast<std::chrono::microseconds>(now - program_start);
+    std::chrono::nanoseconds current_time_since_start() { return std::chrono::nanoseconds(settings().timestamp()); }
+
+    // Called around the call to the next layer, the entry timestamp and the duration are output with the timestamp setting and
+    // by the trace event output
+    void beginCall() {
+        if (settings().measureCalls()) callState().call_start = settings().timestamp();
+    }
+
+    void endCall() {
+        if (settings().measureCalls()) callState().call_duration = settings().timestamp() - callState().call_start;
     }
 
+    uint64_t callStart() const { return callState().call_start; }
+    uint64_t callDuration() const { return callState().call_duration; }
+
     static ApiDumpInstance &current() {
         // Because ApiDumpInstance is a static variable in a static function, there will only be one instance of it.
         // Additionally, the object will be constructed on the *first* call to current(), rather than at process startup time.
@@ -946,21 +2177,33 @@ class ApiDumpInstance {
         return current_instance;
     }
 
-    std::unordered_map<uint64_t, std::string> object_name_map;
-
-    void set_vk_instance(VkPhysicalDevice phys_dev, VkInstance instance) { vk_instance_map.insert({phys_dev, instance}); }
+    void set_vk_instance(VkPhysicalDevice phys_dev, VkInstance instance) {
+        std::lock_guard<std::mutex> lg(vk_instance_mutex);
+        vk_instance_map.insert({phys_dev, instance});
+    }
     VkInstance get_vk_instance(VkPhysicalDevice phys_dev) const {
+        std::lock_guard<std::mutex> lg(vk_instance_mutex);
         if (vk_instance_map.count(phys_dev) == 0) return VK_NULL_HANDLE;
         return vk_instance_map.at(phys_dev);
     }
 
+    // The object names are read while dumping the handles, possibly concurrently with the per-thread output
+    bool find_object_name(uint64_t object, std::string &name) const {
+        std::shared_lock<std::shared_mutex> lock(object_name_mutex);
+        const auto it = object_name_map.find(object);
+        if (it == object_name_map.end()) return false;
+        name = it->second;
+        return true;
+    }
     void update_object_name_map(const VkDebugMarkerObjectNameInfoEXT *pNameInfo) {
+        std::unique_lock<std::shared_mutex> lock(object_name_mutex);
         if (pNameInfo->pObjectName)
             object_name_map[pNameInfo->object] = pNameInfo->pObjectName;
         else
             object_name_map.erase(pNameInfo->object);
     }
     void update_object_name_map(const VkDebugUtilsObjectNameInfoEXT *pNameInfo) {
+        std::unique_lock<std::shared_mutex> lock(object_name_mutex);
         if (pNameInfo->pObjectName)
             object_name_map[pNameInfo->objectHandle] = pNameInfo->pObjectName;
         else
@@ -968,10 +2211,76 @@ class ApiDumpInstance {
     }
 
    private:
+    // State carried between the parts of the dump of a single call. Each thread dumps its own calls, the output mutex isn't
+    // taken in per-thread mode.
+    struct CallState {
+        // Storage for getCmdBufferLevel() which is called in a place where it needs access to the cmd_buffer but it isn't
+        // present in the current structure.
+        VkCommandBuffer cmd_buffer = VK_NULL_HANDLE;
+
+        // Storage for VkPipelineViewportStateCreateInfo which needs to ignore the scissor and viewport pipeline state if their
+        // respective dynamic state is set.
+        bool is_dynamic_scissor = false;
+        bool is_dynamic_viewport = false;
+
+        // Storage for VkPhysicalDeviceMemoryBudgetPropertiesEXT which needs the number of heaps from
+        // VkPhysicalDeviceMemoryProperties
+        uint32_t memory_heap_count = 0;
+
+        // Storage for the VkDescriptorDataEXT union to know what is the active element
+        VkDescriptorType descriptor_type = VK_DESCRIPTOR_TYPE_SAMPLER;
+
+        // True when creating a graphics pipeline library with VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT or
+        // VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT set in the VkGraphicsPipelineLibraryCreateInfoEXT struct.
+        bool GPLPreRasterOrFragmentShader = false;
+
+        // Timestamp of the call to the next layer and its duration, in ns
+        uint64_t call_start = 0;
+        uint64_t call_duration = 0;
+    };
+
+    static CallState &callState() {
+        static thread_local CallState call_state;
+        return call_state;
+    }
+
+    bool pollCaptureTrigger() {
+        bool triggered = capture_triggered.exchange(false, std::memory_order_relaxed);
+
+#if !defined(_WIN32)
+        if (capture_signal_received != 0) {
+            capture_signal_received = 0;
+            triggered = true;
+        }
+#endif
+
+        // The trigger file is removed so that creating it again triggers another capture. It is checked at most every
+        // kTriggerFilePollInterval rather than on every frame.
+        const std::string &trigger_file = settings().triggerFile();
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (!trigger_file.empty() && now >= next_trigger_file_poll) {
+            next_trigger_file_poll = now + kTriggerFilePollInterval;
+            FILE *file = fopen(trigger_file.c_str(), "r");
+            if (file != nullptr) {
+                fclose(file);
+                remove(trigger_file.c_str());
+                triggered = true;
+            }
+        }
+
+        return triggered;
+    }
+
+    void updateDumpingEnabled() {
+        dumping_enabled.store(settings().isFrameInRange(frame_count), std::memory_order_relaxed);
+        next_transition_frame = settings().nextTransitionFrame(frame_count);
+    }
+
     ApiDumpSettings dump_settings;
     std::recursive_mutex output_mutex;
+    uint32_t instance_count = 0;  // Only accessed while holding output_mutex
     std::recursive_mutex frame_mutex;
-    uint64_t frame_count;
+    std::atomic<uint64_t> frame_count;  // Only written while holding frame_mutex
 
     std::recursive_mutex thread_mutex;
     std::unordered_map<std::thread::id, uint64_t> thread_map;
@@ -980,34 +2289,23 @@ class ApiDumpInstance {
     std::map<std::pair<VkDevice, VkCommandPool>, std::unordered_set<VkCommandBuffer>> cmd_buffer_pools;
     std::unordered_map<VkCommandBuffer, VkCommandBufferLevel> cmd_buffer_level;
 
-    bool conditional_initialized = false;
-    bool should_dump_output = true;
+    // Only written while holding frame_mutex, when the current frame reaches next_transition_frame
+    std::atomic<bool> dumping_enabled{true};
+    uint64_t next_transition_frame = 0;
     bool first_func_call_on_frame = true;
 
-    std::chrono::system_clock::time_point program_start;
+    // Set by the debug label matching trigger_label, polled at the end of each frame
+    std::atomic<bool> capture_triggered{false};
+    std::chrono::steady_clock::time_point next_trigger_file_poll;  // Only accessed while holding output_mutex
+    static constexpr std::chrono::milliseconds kTriggerFilePollInterval{100};
 
     // Store the VkInstance handle so we don't use null in the call to
     // vkGetInstanceProcAddr(instance_handle, "vkCreateDevice");
+    mutable std::mutex vk_instance_mutex;
     std::unordered_map<VkPhysicalDevice, VkInstance> vk_instance_map;
 
-    // Storage for getCmdBufferLevel() which is called in a place where it needs access to the cmd_buffer but it isn't present in
-    // the current structure.
-    VkCommandBuffer cmd_buffer;
-
-    // Storage for VkPipelineViewportStateCreateInfo which needs to ignore the scissor and viewport pipeline state if their
-    // respective dynamic state is set.
-    bool is_dynamic_scissor;
-    bool is_dynamic_viewport;
-
-    // Storage for VkPhysicalDeviceMemoryBudgetPropertiesEXT which needs the number of heaps from VkPhysicalDeviceMemoryProperties
-    uint32_t memory_heap_count;
-
-    // Storage for the VkDescriptorDataEXT union to know what is the active element
-    VkDescriptorType descriptor_type;
-
-    // True when creating a graphics pipeline library with VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT or
-    // VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT set in the VkGraphicsPipelineLibraryCreateInfoEXT struct.
-    bool GPLPreRasterOrFragmentShader;
+    mutable std::shared_mutex object_name_mutex;
+    std::unordered_map<uint64_t, std::string> object_name_map;
 };
 
 // Helper function to determine the value of GPLPreRasterOrFragmentShader;
@@ -1046,8 +2344,8 @@ void OutputAddressJSON(const ApiDumpSettings &settings, const void *addr) {
 
 //==================================== Text Backend Helpers ======================================//
 
-void dump_text_function_head(ApiDumpInstance &dump_inst, const char *funcName, const char *funcNamedParams,
-                             const char *funcReturn) {
+void dump_text_function_head(ApiDumpInstance &dump_inst, const char *funcName, const char *funcNamedParams, const char *funcReturn,
+                             uint64_t entry_time) {
     const ApiDumpSettings &settings(dump_inst.settings());
     if (settings.showThreadAndFrame()) {
         settings.stream() << "Thread " << dump_inst.threadID() << ", Frame " << dump_inst.frameCount();
@@ -1056,7 +2354,7 @@ void dump_text_function_head(ApiDumpInstance &dump_inst, const char *funcName, c
         settings.stream() << ", ";
     }
     if (settings.showTimestamp()) {
-        settings.stream() << "Time " << dump_inst.current_time_since_start().count() << " us";
+        settings.stream() << "Time " << entry_time << " ns";
     }
     if (settings.showTimestamp() || settings.showThreadAndFrame()) {
         settings.stream() << ":\n";
@@ -1181,14 +2479,14 @@ void dump_html_nametype(std::ostream &stream, bool showType, const char *name, c
     }
 }
 
-void dump_html_function_head(ApiDumpInstance &dump_inst, const char *funcName, const char *funcNamedParams,
-                             const char *funcReturn) {
+void dump_html_function_head(ApiDumpInstance &dump_inst, const char *funcName, const char *funcNamedParams, const char *funcReturn,
+                             uint64_t entry_time) {
     const ApiDumpSettings &settings(dump_inst.settings());
     if (settings.showThreadAndFrame()) {
         settings.stream() << "<div class='thd'>Thread: " << dump_inst.threadID() << "</div>";
     }
     if (settings.showTimestamp())
-        settings.stream() << "<div class='time'>Time: " << dump_inst.current_time_since_start().count() << " us</div>";
+        settings.stream() << "<div class='time'>Time: " << entry_time << " ns</div>";
     settings.stream() << "<details class='fn'><summary>";
     settings.stream() << "<div class='var'>" << funcName << "(" << funcNamedParams << ")</div>";
     if (settings.showType()) {
@@ -1328,10 +2626,11 @@ void dump_html_pNext(const T *object, const ApiDumpSettings &settings, const cha
 
 //==================================== Json Backend Helpers ======================================//
 
-void dump_json_function_head(ApiDumpInstance &dump_inst, const char *funcName, const char *funcReturn) {
+void dump_json_function_head(ApiDumpInstance &dump_inst, const char *funcName, const char *funcReturn, uint64_t entry_time) {
     const ApiDumpSettings &settings(dump_inst.settings());
 
-    if (!dump_inst.firstFunctionCallOnFrame()) settings.stream() << ",\n";
+    // The calls of the per-thread output are separated by merge_api_dump.py
+    if (!settings.perThreadOutput() && !dump_inst.firstFunctionCallOnFrame()) settings.stream() << ",\n";
 
     // Display api call name
     settings.stream() << settings.indentation(2) << "{\n";
@@ -1344,14 +2643,13 @@ void dump_json_function_head(ApiDumpInstance &dump_inst, const char *funcName, c
 
     // Display elapsed time
     if (settings.showTimestamp()) {
-        settings.stream() << settings.indentation(3) << "\"time\" : \"" << dump_inst.current_time_since_start().count()
-                          << " us\",\n";
+        settings.stream() << settings.indentation(3) << "\"time\" : \"" << entry_time << " ns\",\n";
     }
 
     // Display return value
     settings.stream() << settings.indentation(3) << "\"returnType\" : \"" << funcReturn << "\"";
-    // Add a trailing comma if the return type isn't void or detailed mode is false - JSON doesn't allow trailing commas in object
-    if (strcmp("void", funcReturn) != 0 || settings.showParams()) {
+    // Add a trailing comma if the duration, return value or parameters follow - JSON doesn't allow trailing commas in object
+    if (strcmp("void", funcReturn) != 0 || settings.showParams() || settings.showTimestamp()) {
         settings.stream() << ",";
     }
     settings.stream() << "\n";
@@ -1586,20 +2884,150 @@ void dump_json_pNext(const T *object, const ApiDumpSettings &settings, const cha
     }
 }
 
+//==================================== Trace Event Backend Helpers ======================================//
+
+// Each call is a complete event of its thread, starting and lasting as the call to the next layer
+void dump_trace_event_call(ApiDumpInstance &dump_inst, const char *funcName, const VkResult *result = nullptr) {
+    const ApiDumpSettings &settings(dump_inst.settings());
+    settings.writeTraceEventHeading(funcName, "vulkan", 'X', dump_inst.threadID(), dump_inst.callStart());
+    settings.stream() << ",\"dur\":";
+    settings.writeTraceEventTime(dump_inst.callDuration());
+    settings.stream() << ",\"args\":{\"frame\":" << dump_inst.frameCount();
+    if (result != nullptr) {
+        settings.stream() << ",\"result\":\"" << string_VkResult(*result) << "\"";
+    }
+    settings.stream() << "}}";
+
+    settings.shouldFlush() ? settings.stream() << std::flush : settings.stream();
+}
+
+CapturedCall make_captured_call(ApiDumpInstance &dump_inst, const char *funcName, const char *funcNamedParams,
+                                const char *funcReturn, const VkResult *result) {
+    CapturedCall call = {};
+    call.name = funcName;
+    call.named_params = funcNamedParams;
+    call.return_type = funcReturn;
+    call.has_result = result != nullptr;
+    call.result = result != nullptr ? *result : VK_SUCCESS;
+    call.thread_id = dump_inst.threadID();
+    call.frame = dump_inst.frameCount();
+    call.time = dump_inst.callStart();
+    call.duration = dump_inst.callDuration();
+    return call;
+}
+
+// While recording a trigger capture, a compact record of the call is kept instead of its formatted output
+void dump_captured_call(ApiDumpInstance &dump_inst, const char *funcName, const char *funcNamedParams, const char *funcReturn,
+                        const VkResult *result = nullptr) {
+    CapturedCall call = make_captured_call(dump_inst, funcName, funcNamedParams, funcReturn, result);
+    call.separator = dump_inst.settings().format() == ApiDumpFormat::Json && !dump_inst.firstFunctionCallOnFrame();
+    dump_inst.settings().recordCapturedCall(call);
+}
+
+// The queue labels are slices of the submitting thread: 'B' begins a slice when the begin label call returned, 'E' ends the
+// innermost slice when the end label call started, 'i' is an insert. A command buffer is recorded on any thread and its
+// labels may end on another one, its labels are async events with the handle as id, 'b', 'e' and 'n', on its own track.
+void dump_trace_event_label(ApiDumpInstance &dump_inst, char phase, const VkDebugUtilsLabelEXT *pLabelInfo,
+                            VkCommandBuffer commandBuffer = VK_NULL_HANDLE) {
+    const ApiDumpSettings &settings(dump_inst.settings());
+    const char *name = pLabelInfo != nullptr ? pLabelInfo->pLabelName : nullptr;
+    const bool ends = phase == 'E' || phase == 'e';
+    const uint64_t time = ends ? dump_inst.callStart() : dump_inst.callStart() + dump_inst.callDuration();
+
+    settings.writeTraceEventHeading(name != nullptr ? name : "", "label", phase, dump_inst.threadID(), time);
+    if (phase == 'i') {
+        settings.stream() << ",\"s\":\"t\"";
+    } else if (phase == 'b' || phase == 'e' || phase == 'n') {
+        char id[32];
+        snprintf(id, sizeof(id), "0x%llx", static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(commandBuffer)));
+        settings.stream() << ",\"id\":\"" << id << "\"";
+    }
+    settings.stream() << "}";
+
+    settings.shouldFlush() ? settings.stream() << std::flush : settings.stream();
+}
+
 //==================================== Common Helpers ======================================//
 
+void dump_format_function_head(ApiDumpInstance &dump_inst, const char *funcName, const char *funcNamedParams,
+                               const char *funcReturn, uint64_t entry_time) {
+    switch (dump_inst.settings().format()) {
+        case ApiDumpFormat::Text:
+            dump_text_function_head(dump_inst, funcName, funcNamedParams, funcReturn, entry_time);
+            break;
+        case ApiDumpFormat::Html:
+            dump_html_function_head(dump_inst, funcName, funcNamedParams, funcReturn, entry_time);
+            break;
+        case ApiDumpFormat::Json:
+            dump_json_function_head(dump_inst, funcName, funcReturn, entry_time);
+            break;
+        case ApiDumpFormat::TraceEvent:
+            break;  // The event of the call is written once the call returned
+    }
+}
+
+// The head of the call is output with the timestamp taken by beginCall(), the start of its duration
 void dump_function_head(ApiDumpInstance &dump_inst, const char *funcName, const char *funcNamedParams, const char *funcReturn) {
-    if (dump_inst.shouldDumpOutput()) {
-        switch (dump_inst.settings().format()) {
-            case ApiDumpFormat::Text:
-                dump_text_function_head(dump_inst, funcName, funcNamedParams, funcReturn);
-                break;
-            case ApiDumpFormat::Html:
-                dump_html_function_head(dump_inst, funcName, funcNamedParams, funcReturn);
-                break;
-            case ApiDumpFormat::Json:
-                dump_json_function_head(dump_inst, funcName, funcReturn);
-                break;
+    // The recorded calls are formatted by begin_captured_call once they returned
+    if (dump_inst.shouldDumpOutput() && !dump_inst.settings().isRecordingCalls()) {
+        dump_inst.settings().beginIndexedCall();
+        if (dump_inst.settings().perThreadOutput()) {
+            dump_inst.settings().writeThreadRecordHeading(dump_inst.threadID(), dump_inst.frameCount());
         }
+        dump_format_function_head(dump_inst, funcName, funcNamedParams, funcReturn, dump_inst.callStart());
+    }
+}
+
+// vkQueuePresentKHR outside of the dumped frames: the present goes straight to the next layer and only counts the frame, without
+// taking the output mutex
+VkResult dump_skipped_present(ApiDumpInstance &dump_inst, PFN_vkQueuePresentKHR present, VkQueue queue,
+                              const VkPresentInfoKHR *pPresentInfo) {
+    const VkResult result = present(queue, pPresentInfo);
+    dump_inst.nextFrame();
+    return result;
+}
+
+// While recording a trigger capture, the returned call is formatted with its parameters into a bounded buffer, its head is
+// written here and the caller writes the rest of the call. Return false when the calls aren't recorded.
+bool begin_captured_call(ApiDumpInstance &dump_inst, const char *funcName, const char *funcNamedParams, const char *funcReturn) {
+    if (!dump_inst.settings().isRecordingCalls()) return false;
+
+    dump_inst.settings().beginCapturedCall();
+    dump_format_function_head(dump_inst, funcName, funcNamedParams, funcReturn, dump_inst.callStart());
+    return true;
+}
+
+// The formatted call is added to the recorded frame, a call that exceeded its buffer is recorded without its parameters
+void end_captured_call(ApiDumpInstance &dump_inst, const char *funcName, const char *funcNamedParams, const char *funcReturn,
+                       const VkResult *result = nullptr) {
+    bool json_separator = false;
+    if (dump_inst.settings().endCapturedCall(json_separator)) return;
+
+    CapturedCall call = make_captured_call(dump_inst, funcName, funcNamedParams, funcReturn, result);
+    call.separator = json_separator;
+    dump_inst.settings().recordCapturedCall(call);
+}
+
+// Written after the return value of the call, with the timestamp setting
+void dump_text_call_duration(ApiDumpInstance &dump_inst) {
+    const ApiDumpSettings &settings(dump_inst.settings());
+    if (settings.showTimestamp()) {
+        settings.stream() << ", Duration " << dump_inst.callDuration() << " ns";
+    }
+}
+
+void dump_html_call_duration(ApiDumpInstance &dump_inst) {
+    const ApiDumpSettings &settings(dump_inst.settings());
+    if (settings.showTimestamp()) {
+        settings.stream() << "<div class='time'>Duration: " << dump_inst.callDuration() << " ns</div>";
+    }
+}
+
+// Follows the "returnType" of the head, with a trailing comma when the return value or the parameters follow
+void dump_json_call_duration(ApiDumpInstance &dump_inst, bool trailing_comma) {
+    const ApiDumpSettings &settings(dump_inst.settings());
+    if (settings.showTimestamp()) {
+        settings.stream() << settings.indentation(3) << "\"duration\" : \"" << dump_inst.callDuration() << " ns\"";
+        settings.stream() << (trailing_comma ? ",\n" : "\n");
     }
 }
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024 Valve Corporation
+# Copyright (c) 2024 LunarG, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Merge the files written by the api_dump layer with the per_thread setting into a single dump, with the API calls in the order
+# they were made. For "vk_apidump.json", each thread writes "vk_apidump.thread<N>.json".
+#
+# Each API call of a per-thread file is preceded by a "@@apidump <sequence> <frame> <time>" line, where the sequence is the
+# global order of the call and the time is its timestamp in ns since the layer was initialized.
+#
+# Usage: merge_api_dump.py [-o <outputfile>] [--format text|json] <inputfile>...
+#
+# The format is deduced from the extension of the first input file. The merged dump is output to stdout by default.
+
+import argparse
+import heapq
+import sys
+
+RECORD_HEADING = '@@apidump '
+
+
+def read_records(path):
+    """Yield (sequence, frame, time, text) for each API call of a per-thread file, in the order they were written"""
+    with open(path, 'r', encoding='utf-8', errors='replace', newline='') as file:
+        heading = None
+        lines = []
+        for line in file:
+            if line.startswith(RECORD_HEADING):
+                if heading is not None:
+                    yield heading + (''.join(lines),)
+                fields = line[len(RECORD_HEADING):].split()
+                heading = (int(fields[0]), int(fields[1]), int(fields[2]))
+                lines = []
+            elif heading is not None:
+                lines.append(line)
+        # The last call may be truncated when the application didn't exit cleanly
+        if heading is not None:
+            yield heading + (''.join(lines),)
+
+
+def write_text(records, output):
+    for _, _, _, text in records:
+        output.write(text)
+
+
+def write_json(records, output, indent):
+    """Rebuild the JSON document written by the layer without the per_thread setting, one object per frame"""
+    output.write('[\n')
+    frame = None
+    for _, record_frame, _, text in records:
+        if record_frame != frame:
+            if frame is not None:
+                output.write('\n%s]\n},\n' % indent)
+            output.write('{\n%s"frameNumber" : "%d",\n%s"apiCalls" :\n%s[\n' % (indent, record_frame, indent, indent))
+            frame = record_frame
+        else:
+            output.write(',\n')
+        output.write(text.rstrip('\n'))
+    if frame is not None:
+        output.write('\n%s]\n}' % indent)
+    output.write('\n]\n')
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description='Merge the per-thread files of the api_dump layer into a single dump.')
+    parser.add_argument('inputs', metavar='inputfile', nargs='+', help='the per-thread files written by the api_dump layer')
+    parser.add_argument('-o', '--output', help='the merged dump, stdout by default')
+    parser.add_argument('--format', choices=['text', 'json'], help='deduced from the extension of the first input by default')
+    parser.add_argument('--indent-size', type=int, default=4, help='the indent_size setting of the layer, 4 by default')
+    args = parser.parse_args(argv)
+
+    output_format = args.format
+    if output_format is None:
+        output_format = 'json' if args.inputs[0].endswith('.json') else 'text'
+
+    # Each file is already in sequence order, only the heads of the files are compared
+    records = heapq.merge(*[read_records(path) for path in args.inputs])
+
+    output = open(args.output, 'w', encoding='utf-8', newline='') if args.output else sys.stdout
+    try:
+        if output_format == 'json':
+            write_json(records, output, ' ' * args.indent_size)
+        else:
+            write_text(records, output)
+    finally:
+        if output is not sys.stdout:
+            output.close()
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
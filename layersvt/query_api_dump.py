@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024 Valve Corporation
+# Copyright (c) 2024 LunarG, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Print the API calls of a dump written by the api_dump layer that involve a handle, using the index written with the
+# handle_index setting. For "vk_apidump.txt", the index is "vk_apidump.txt.handles": the calls are read at their offsets
+# without parsing the whole dump.
+#
+# Usage: query_api_dump.py [-o <outputfile>] [--type <handle type>] [--summary] <handle> <dumpfile>...
+#
+# With output rotation, the files of the dump are given in any order, each rotated file has its own index. Compressed
+# rotated files are decompressed up to the offsets of the calls.
+
+import argparse
+import gzip
+import sys
+
+
+class Lifetime:
+    def __init__(self, handle_type, handle, created, destroyed, calls):
+        self.type = handle_type
+        self.handle = handle
+        self.created = created
+        self.destroyed = destroyed
+        self.calls = calls
+
+
+def read_index(path):
+    """Return the calls, {sequence: (offset, size)}, and the handle lifetimes of an index file"""
+    calls = {}
+    lifetimes = []
+    with open(path, 'r', encoding='utf-8') as file:
+        for line in file:
+            fields = line.split()
+            if not fields or fields[0].startswith('#'):
+                continue
+            if fields[0] == 'call':
+                calls[int(fields[1])] = (int(fields[2]), int(fields[3]))
+            elif fields[0] == 'handle':
+                created = None if fields[3] == '-' else int(fields[3])
+                destroyed = None if fields[4] == '-' else int(fields[4])
+                lifetimes.append(Lifetime(fields[1], int(fields[2], 0), created, destroyed, [int(f) for f in fields[5:]]))
+    return calls, lifetimes
+
+
+def index_path(dump_path):
+    # The index of a compressed rotated file is written before the compression
+    if dump_path.endswith('.gz'):
+        dump_path = dump_path[:-len('.gz')]
+    return dump_path + '.handles'
+
+
+def open_dump(dump_path):
+    if dump_path.endswith('.gz'):
+        return gzip.open(dump_path, 'rb')
+    return open(dump_path, 'rb')
+
+
+def read_call(file, offset, size, json):
+    file.seek(offset)
+    text = file.read(size).decode('utf-8', errors='replace')
+    # The JSON calls start with the separator from the previous call
+    if json:
+        text = text.lstrip(',\n')
+    return text.rstrip('\n') + '\n'
+
+
+def describe(lifetime):
+    created = 'created before the dump' if lifetime.created is None else 'created by call %d' % lifetime.created
+    destroyed = 'not destroyed in the dump' if lifetime.destroyed is None else 'destroyed by call %d' % lifetime.destroyed
+    return '%s 0x%x: %s, %s, referenced by %d calls' % (lifetime.type, lifetime.handle, created, destroyed, len(lifetime.calls))
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description='Print the calls of an api_dump file that involve a handle.')
+    parser.add_argument('handle', help='the handle value, 0x prefixed for hexadecimal')
+    parser.add_argument('dumps', metavar='dumpfile', nargs='+', help='the files written by the api_dump layer')
+    parser.add_argument('-o', '--output', help='the calls, stdout by default')
+    parser.add_argument('--type', help='only the handles of this type, VkBuffer for example')
+    parser.add_argument('--summary', action='store_true', help='only print the lifetimes of the handle')
+    args = parser.parse_args(argv)
+
+    handle = int(args.handle, 0)
+
+    # The calls to read in each file, in sequence order
+    lifetimes = {}
+    reads = []
+    for dump_path in args.dumps:
+        try:
+            calls, file_lifetimes = read_index(index_path(dump_path))
+        except OSError as error:
+            print('%s: %s' % (dump_path, error), file=sys.stderr)
+            return 1
+        for lifetime in file_lifetimes:
+            if lifetime.handle != handle or (args.type is not None and lifetime.type != args.type):
+                continue
+            for sequence in lifetime.calls:
+                offset, size = calls[sequence]
+                reads.append((sequence, dump_path, offset, size))
+
+            # The lifetime of a handle used in several rotated files is in the index of each file
+            key = (lifetime.type, lifetime.created)
+            if key in lifetimes:
+                lifetimes[key].calls.extend(lifetime.calls)
+                if lifetime.destroyed is not None:
+                    lifetimes[key].destroyed = lifetime.destroyed
+            else:
+                lifetimes[key] = lifetime
+
+    # A call referencing several lifetimes of the handle is printed once
+    reads = sorted(set(reads))
+
+    output = open(args.output, 'w', encoding='utf-8', newline='') if args.output else sys.stdout
+    try:
+        for lifetime in sorted(lifetimes.values(), key=lambda lifetime: min(lifetime.calls)):
+            output.write('# %s\n' % describe(lifetime))
+        if not lifetimes:
+            output.write('# 0x%x is not referenced by the dumped calls\n' % handle)
+
+        if not args.summary:
+            files = {}
+            try:
+                for sequence, dump_path, offset, size in reads:
+                    if dump_path not in files:
+                        files[dump_path] = open_dump(dump_path)
+                    json = dump_path.endswith('.json') or dump_path.endswith('.json.gz')
+                    output.write('\n# call %d\n' % sequence)
+                    output.write(read_call(files[dump_path], offset, size, json))
+            finally:
+                for file in files.values():
+                    file.close()
+    finally:
+        if output is not sys.stdout:
+            output.close()
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
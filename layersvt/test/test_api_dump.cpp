@@ -63,3 +63,36 @@ TEST_F(ApiDumpTests, init_layer) {
 
     EXPECT_STREQ(file_start_content_read.c_str(), file_start_content_expected);
 }
+
+TEST_F(ApiDumpTests, per_thread_output) {
+    TEST_DESCRIPTION("Test each thread writing its API calls to its own file");
+
+    VkBool32 use_file = VK_TRUE;
+    VkBool32 per_thread = VK_TRUE;
+    const char* filename_string = "api_dump_per_thread.txt";
+    const char* output_format = "text";
+
+    const std::vector<VkLayerSettingEXT> settings = {
+        {kLayerName, "file", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &use_file},
+        {kLayerName, "log_filename", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &filename_string},
+        {kLayerName, "output_format", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &output_format},
+        {kLayerName, "per_thread", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &per_thread}};
+
+    layer_test::VulkanInstanceBuilder inst_builder;
+    VkResult err = inst_builder.Init(settings);
+    EXPECT_EQ(err, VK_SUCCESS);
+
+    // vkCreateInstance is dumped by the first thread, its file starts with the heading of the record
+    const std::string path = std::string(TEST_BINARY_PATH) + "/test/api_dump_per_thread.thread0.txt";
+    FILE* file = fopen(path.c_str(), "r");
+    ASSERT_TRUE(file != NULL);
+
+    const char* file_start_content_expected = "@@apidump ";
+    std::string file_start_content_read;
+    file_start_content_read.resize(std::strlen(file_start_content_expected));
+
+    fread(&file_start_content_read[0], 1, file_start_content_read.size(), file);
+    fclose(file);
+
+    EXPECT_STREQ(file_start_content_read.c_str(), file_start_content_expected);
+}
@@ -0,0 +1,623 @@
+/*
+ * Copyright (c) 2024 Valve Corporation
+ * Copyright (c) 2024 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+// The output files of the api_dump layer are tested without a Vulkan driver: the calls are written to the output the way the
+// generated entry points do. The output state is global to the process, each test runs in its own process.
+
+#include "api_dump.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const char* kLayerName = "VK_LAYER_LUNARG_api_dump";
+
+static void InitLayer(const std::vector<VkLayerSettingEXT>& settings) {
+    VkLayerSettingsCreateInfoEXT settings_info = {};
+    settings_info.sType = VK_STRUCTURE_TYPE_LAYER_SETTINGS_CREATE_INFO_EXT;
+    settings_info.settingCount = static_cast<uint32_t>(settings.size());
+    settings_info.pSettings = settings.data();
+
+    VkInstanceCreateInfo create_info = {};
+    create_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+    create_info.pNext = &settings_info;
+
+    ApiDumpInstance::current().initLayerSettings(&create_info, nullptr);
+    ApiDumpInstance::current().addInstance();
+}
+
+struct DumpedHandle {
+    const char* type;
+    uint64_t value;
+};
+
+// Write a call the way the generated text functions do, with the handles indexed while they are dumped
+static void DumpCall(const char* name, const char* created_type, const char* destroyed_type,
+                     const std::vector<DumpedHandle>& handles) {
+    ApiDumpSettings& settings = ApiDumpInstance::current().settings();
+
+    settings.beginIndexedCall();
+    settings.stream() << name << ":\n";
+    settings.indexLifetime(created_type, destroyed_type);
+    for (const DumpedHandle& handle : handles) {
+        settings.indexHandle(handle.type, handle.value);
+        settings.stream() << "    " << handle.type << " = 0x" << std::hex << handle.value << std::dec << "\n";
+    }
+    settings.stream() << "\n";
+}
+
+static bool FileExists(const std::string& path) {
+    std::ifstream file(path);
+    return file.is_open();
+}
+
+static std::vector<std::string> ReadLines(const std::string& path) {
+    std::vector<std::string> lines;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line[0] != '#') lines.push_back(line);
+    }
+    return lines;
+}
+
+TEST(test_api_dump_output, rotate_frames) {
+    VkBool32 use_file = VK_TRUE;
+    const char* filename_string = "api_dump_rotate.txt";
+    const char* output_format = "text";
+    int32_t rotate_frames = 1;
+
+    InitLayer({{kLayerName, "file", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &use_file},
+               {kLayerName, "log_filename", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &filename_string},
+               {kLayerName, "output_format", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &output_format},
+               {kLayerName, "rotate_frames", VK_LAYER_SETTING_TYPE_INT32_EXT, 1, &rotate_frames}});
+
+    DumpCall("vkCreateDevice", "VkDevice", "", {{"VkDevice", 0x20}});
+    ApiDumpInstance::current().nextFrame();
+    DumpCall("vkQueuePresentKHR", "", "", {{"VkQueue", 0x40}});
+    ApiDumpInstance::current().nextFrame();
+    DumpCall("vkDestroyDevice", "", "VkDevice", {{"VkDevice", 0x20}});
+    ApiDumpInstance::current().removeInstance();
+
+    // Each frame is written to its own file, the file of the current frame is only closed when the layer is unloaded
+    EXPECT_TRUE(FileExists("api_dump_rotate.0001.txt"));
+    EXPECT_TRUE(FileExists("api_dump_rotate.0002.txt"));
+    EXPECT_TRUE(FileExists("api_dump_rotate.0003.txt"));
+
+    const std::vector<std::string>& index = ReadLines("api_dump_rotate.index.txt");
+    ASSERT_EQ(2, index.size());
+    EXPECT_STREQ("0-0 api_dump_rotate.0001.txt", index[0].c_str());
+    EXPECT_STREQ("1-1 api_dump_rotate.0002.txt", index[1].c_str());
+}
+
+static int g_present_count = 0;
+
+// The next layer of the presents
+static VKAPI_ATTR VkResult VKAPI_CALL CountPresent(VkQueue, const VkPresentInfoKHR*) {
+    ++g_present_count;
+    return VK_SUCCESS;
+}
+
+TEST(test_api_dump_output, present_outside_range) {
+    VkBool32 use_file = VK_TRUE;
+    const char* filename_string = "api_dump_range.txt";
+    const char* output_format = "text";
+    const char* output_range = "3-1";
+    int32_t rotate_frames = 1;
+
+    InitLayer({{kLayerName, "file", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &use_file},
+               {kLayerName, "log_filename", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &filename_string},
+               {kLayerName, "output_format", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &output_format},
+               {kLayerName, "output_range", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &output_range},
+               {kLayerName, "rotate_frames", VK_LAYER_SETTING_TYPE_INT32_EXT, 1, &rotate_frames}});
+
+    // Before the output range, the presents don't wait for a thread writing to the output
+    std::promise<void> locked;
+    std::promise<void> unlock;
+    std::thread writer([&locked, &unlock]() {
+        std::lock_guard<std::recursive_mutex> lock(*ApiDumpInstance::current().outputMutex());
+        locked.set_value();
+        unlock.get_future().wait();
+    });
+    locked.get_future().wait();
+
+    // The presents go through the path of the generated vkQueuePresentKHR outside of the dumped frames
+    std::future<int> presents = std::async(std::launch::async, []() {
+        for (int i = 0; i < 2; ++i) {
+            EXPECT_FALSE(ApiDumpInstance::current().shouldDumpOutput());
+            EXPECT_EQ(VK_SUCCESS, dump_skipped_present(ApiDumpInstance::current(), CountPresent, VK_NULL_HANDLE, nullptr));
+        }
+        return g_present_count;
+    });
+    EXPECT_EQ(std::future_status::ready, presents.wait_for(std::chrono::seconds(5)));
+    unlock.set_value();
+    writer.join();
+    EXPECT_EQ(2, presents.get());
+    EXPECT_FALSE(ApiDumpInstance::current().shouldDumpOutput());
+
+    ApiDumpInstance::current().nextFrame();
+    EXPECT_TRUE(ApiDumpInstance::current().shouldDumpOutput());
+    DumpCall("vkQueuePresentKHR", "", "", {{"VkQueue", 0x40}});
+    ApiDumpInstance::current().nextFrame();
+    ApiDumpInstance::current().nextFrame();
+    ApiDumpInstance::current().removeInstance();
+
+    // The frames skipped before the range are in the first file, which is rotated at the end of the range
+    const std::vector<std::string>& index = ReadLines("api_dump_range.index.txt");
+    ASSERT_EQ(1, index.size());
+    EXPECT_STREQ("0-3 api_dump_range.0001.txt", index[0].c_str());
+}
+
+TEST(test_api_dump_output, handle_index) {
+    VkBool32 use_file = VK_TRUE;
+    VkBool32 handle_index = VK_TRUE;
+    const char* filename_string = "api_dump_index.txt";
+    const char* output_format = "text";
+
+    InitLayer({{kLayerName, "file", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &use_file},
+               {kLayerName, "log_filename", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &filename_string},
+               {kLayerName, "output_format", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &output_format},
+               {kLayerName, "handle_index", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &handle_index}});
+
+    DumpCall("vkCreateBuffer", "VkBuffer", "", {{"VkDevice", 0x20}, {"VkBuffer", 0xb0}});
+    DumpCall("vkQueueWaitIdle", "", "", {});
+    DumpCall("vkDestroyBuffer", "", "VkBuffer", {{"VkDevice", 0x20}, {"VkBuffer", 0xb0}});
+    DumpCall("vkCreateBuffer", "VkBuffer", "", {{"VkDevice", 0x20}, {"VkBuffer", 0xb0}});
+
+    // The index of the calls dumped so far is written when the last instance is destroyed
+    ApiDumpInstance::current().removeInstance();
+
+    const std::vector<std::string>& index = ReadLines("api_dump_index.txt.handles");
+    ASSERT_EQ(7, index.size());
+    EXPECT_STREQ("dump api_dump_index.txt", index[0].c_str());
+
+    // The call without handles isn't indexed
+    unsigned long long sequence = 0, offset = 0, size = 0;
+    ASSERT_EQ(3, sscanf(index[1].c_str(), "call %llu %llu %llu", &sequence, &offset, &size));
+    EXPECT_EQ(0, sequence);
+    ASSERT_EQ(3, sscanf(index[2].c_str(), "call %llu %llu %llu", &sequence, &offset, &size));
+    EXPECT_EQ(2, sequence);
+    ASSERT_EQ(3, sscanf(index[3].c_str(), "call %llu %llu %llu", &sequence, &offset, &size));
+    EXPECT_EQ(3, sequence);
+
+    // The offsets locate the calls in the dump
+    std::ifstream dump("api_dump_index.txt", std::ios::binary);
+    std::string call(static_cast<std::size_t>(size), '\0');
+    dump.seekg(static_cast<std::streamoff>(offset));
+    dump.read(&call[0], static_cast<std::streamsize>(size));
+    EXPECT_EQ(0, call.find("vkCreateBuffer:\n"));
+
+    // The handle value reused after it was destroyed is indexed as a new lifetime
+    const std::vector<std::string> handles(index.begin() + 4, index.end());
+    EXPECT_EQ(1, std::count(handles.begin(), handles.end(), "handle VkBuffer 0xb0 0 2 0 2"));
+    EXPECT_EQ(1, std::count(handles.begin(), handles.end(), "handle VkDevice 0x20 - - 0 2 3"));
+    EXPECT_EQ(1, std::count(handles.begin(), handles.end(), "handle VkBuffer 0xb0 3 - 3"));
+}
+
+TEST(test_api_dump_output, handle_index_types) {
+    VkBool32 use_file = VK_TRUE;
+    VkBool32 handle_index = VK_TRUE;
+    const char* filename_string = "api_dump_types.txt";
+    const char* output_format = "text";
+
+    InitLayer({{kLayerName, "file", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &use_file},
+               {kLayerName, "log_filename", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &filename_string},
+               {kLayerName, "output_format", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &output_format},
+               {kLayerName, "handle_index", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &handle_index}});
+
+    // Non-dispatchable handles of different types may have the same value
+    DumpCall("vkCreateBuffer", "VkBuffer", "", {{"VkBuffer", 0xb0}});
+    DumpCall("vkCreateImage", "VkImage", "", {{"VkImage", 0xb0}});
+    DumpCall("vkDestroyBuffer", "", "VkBuffer", {{"VkBuffer", 0xb0}});
+    DumpCall("vkBindImageMemory", "", "", {{"VkImage", 0xb0}});
+
+    ApiDumpInstance::current().removeInstance();
+
+    const std::vector<std::string>& index = ReadLines("api_dump_types.txt.handles");
+    ASSERT_EQ(7, index.size());
+
+    const std::vector<std::string> handles(index.begin() + 5, index.end());
+    EXPECT_EQ(1, std::count(handles.begin(), handles.end(), "handle VkBuffer 0xb0 0 2 0 2"));
+    EXPECT_EQ(1, std::count(handles.begin(), handles.end(), "handle VkImage 0xb0 1 - 1 3"));
+}
+
+TEST(test_api_dump_output, trace_event_without_index) {
+    VkBool32 use_file = VK_TRUE;
+    VkBool32 handle_index = VK_TRUE;
+    const char* filename_string = "api_dump_trace.json";
+    const char* output_format = "trace_event";
+
+    InitLayer({{kLayerName, "file", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &use_file},
+               {kLayerName, "log_filename", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &filename_string},
+               {kLayerName, "output_format", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &output_format},
+               {kLayerName, "handle_index", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &handle_index}});
+
+    // The trace events aren't the calls query_api_dump.py reads back
+    EXPECT_FALSE(ApiDumpInstance::current().settings().indexHandles());
+
+    ApiDumpInstance::current().removeInstance();
+
+    EXPECT_FALSE(FileExists("api_dump_trace.json.handles"));
+}
+
+// Write the label events of a debug utils label call the way the generated functions do once the call returned
+static void DumpLabel(char phase, const char* name, VkCommandBuffer commandBuffer) {
+    ApiDumpInstance& dump_inst = ApiDumpInstance::current();
+
+    VkDebugUtilsLabelEXT label_info = {};
+    label_info.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+    label_info.pLabelName = name;
+
+    dump_inst.beginCall();
+    dump_inst.endCall();
+    dump_trace_event_label(dump_inst, phase, name != nullptr ? &label_info : nullptr, commandBuffer);
+}
+
+TEST(test_api_dump_output, trace_event_labels) {
+    VkBool32 use_file = VK_TRUE;
+    const char* filename_string = "api_dump_labels.json";
+    const char* output_format = "trace_event";
+
+    InitLayer({{kLayerName, "file", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &use_file},
+               {kLayerName, "log_filename", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &filename_string},
+               {kLayerName, "output_format", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &output_format}});
+
+    // The labels of two command buffers interleave, each is closed on its own track
+    VkCommandBuffer first = reinterpret_cast<VkCommandBuffer>(0xc0);
+    VkCommandBuffer second = reinterpret_cast<VkCommandBuffer>(0xc1);
+    DumpLabel('b', "first", first);
+    DumpLabel('b', "second", second);
+    DumpLabel('e', nullptr, first);
+    DumpLabel('n', "insert", second);
+    DumpLabel('e', nullptr, second);
+    DumpLabel('B', "queue", VK_NULL_HANDLE);
+    DumpLabel('E', nullptr, VK_NULL_HANDLE);
+    ApiDumpInstance::current().removeInstance();
+
+    std::vector<std::string> events;
+    for (const std::string& line : ReadLines("api_dump_labels.json")) {
+        if (line.find("\"cat\":\"label\"") != std::string::npos) events.push_back(line);
+    }
+    ASSERT_EQ(7, events.size());
+
+    const auto has = [&events](std::size_t event, const char* member) {
+        return events[event].find(member) != std::string::npos;
+    };
+    EXPECT_TRUE(has(0, "\"name\":\"first\"") && has(0, "\"ph\":\"b\"") && has(0, "\"id\":\"0xc0\""));
+    EXPECT_TRUE(has(1, "\"name\":\"second\"") && has(1, "\"ph\":\"b\"") && has(1, "\"id\":\"0xc1\""));
+    EXPECT_TRUE(has(2, "\"ph\":\"e\"") && has(2, "\"id\":\"0xc0\""));
+    EXPECT_TRUE(has(3, "\"name\":\"insert\"") && has(3, "\"ph\":\"n\"") && has(3, "\"id\":\"0xc1\""));
+    EXPECT_TRUE(has(4, "\"ph\":\"e\"") && has(4, "\"id\":\"0xc1\""));
+
+    // The queue labels stay slices of the submitting thread
+    EXPECT_TRUE(has(5, "\"name\":\"queue\"") && has(5, "\"ph\":\"B\"") && !has(5, "\"id\""));
+    EXPECT_TRUE(has(6, "\"ph\":\"E\"") && !has(6, "\"id\""));
+}
+
+// Dump a call that lasts at least 2 ms the way the generated text and json functions do with the timestamp setting
+static void DumpTimedCall() {
+    ApiDumpInstance& dump_inst = ApiDumpInstance::current();
+    const ApiDumpSettings& settings = dump_inst.settings();
+
+    dump_inst.beginCall();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    dump_inst.endCall();
+
+    dump_function_head(dump_inst, "vkQueueWaitIdle", "queue", "VkResult");
+    if (settings.format() == ApiDumpFormat::Json) {
+        dump_json_call_duration(dump_inst, false);
+        settings.stream() << settings.indentation(2) << "}";
+    } else {
+        settings.stream() << " VK_SUCCESS";
+        dump_text_call_duration(dump_inst);
+        settings.stream() << "\n\n";
+    }
+}
+
+static unsigned long long ReadValue(const std::string& line, const char* format) {
+    unsigned long long value = 0;
+    EXPECT_EQ(1, sscanf(line.c_str(), format, &value)) << line;
+    return value;
+}
+
+TEST(test_api_dump_output, timestamp_text) {
+    VkBool32 use_file = VK_TRUE;
+    VkBool32 timestamp = VK_TRUE;
+    VkBool32 show_thread_and_frame = VK_FALSE;
+    const char* filename_string = "api_dump_timestamp.txt";
+    const char* output_format = "text";
+
+    InitLayer({{kLayerName, "file", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &use_file},
+               {kLayerName, "log_filename", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &filename_string},
+               {kLayerName, "output_format", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &output_format},
+               {kLayerName, "timestamp", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &timestamp},
+               {kLayerName, "show_thread_and_frame", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &show_thread_and_frame}});
+
+    DumpTimedCall();
+    ApiDumpInstance::current().removeInstance();
+
+    std::vector<std::string> lines;
+    for (const std::string& line : ReadLines("api_dump_timestamp.txt")) {
+        if (line.find("Clock: ") == 0 || line.find("Time ") == 0 || line.find("vkQueueWaitIdle") == 0) lines.push_back(line);
+    }
+    ASSERT_EQ(3, lines.size());
+    EXPECT_EQ(0, lines[0].find("Clock: steady, Start: "));
+    EXPECT_NE(std::string::npos, lines[0].find(" ns system clock"));
+
+    // The timestamps and the durations are in ns
+    const unsigned long long time = ReadValue(lines[1], "Time %llu ns:");
+    const unsigned long long duration = ReadValue(lines[2], "vkQueueWaitIdle(queue) returns VkResult VK_SUCCESS, Duration %llu ns");
+    EXPECT_GE(duration, 2000000);
+    EXPECT_LT(time, ApiDumpInstance::current().settings().timestamp());
+
+    // The head and the duration share the timestamp taken by beginCall()
+    EXPECT_EQ(ApiDumpInstance::current().callStart(), time);
+}
+
+TEST(test_api_dump_output, timestamp_json) {
+    VkBool32 use_file = VK_TRUE;
+    VkBool32 timestamp = VK_TRUE;
+    const char* filename_string = "api_dump_timestamp.json";
+    const char* output_format = "json";
+
+    InitLayer({{kLayerName, "file", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &use_file},
+               {kLayerName, "log_filename", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &filename_string},
+               {kLayerName, "output_format", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &output_format},
+               {kLayerName, "timestamp", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &timestamp}});
+
+    DumpTimedCall();
+    ApiDumpInstance::current().removeInstance();
+
+    std::vector<std::string> lines;
+    for (const std::string& line : ReadLines("api_dump_timestamp.json")) {
+        const std::size_t begin = line.find_first_not_of(' ');
+        if (begin != std::string::npos && line[begin] == '"') lines.push_back(line.substr(begin));
+    }
+
+    const auto field = [&lines](const char* name) {
+        const auto it = std::find_if(lines.begin(), lines.end(), [name](const std::string& line) { return line.find(name) == 0; });
+        return it != lines.end() ? *it : std::string();
+    };
+    EXPECT_EQ("\"source\" : \"steady\",", field("\"source\""));
+
+    const unsigned long long time = ReadValue(field("\"time\""), "\"time\" : \"%llu ns\",");
+    const unsigned long long duration = ReadValue(field("\"duration\""), "\"duration\" : \"%llu ns\"");
+    EXPECT_GE(duration, 2000000);
+    EXPECT_LT(time, ApiDumpInstance::current().settings().timestamp());
+}
+
+TEST(test_api_dump_output, timestamp_instances) {
+    VkBool32 use_file = VK_TRUE;
+    VkBool32 timestamp = VK_TRUE;
+    const char* filename_string = "api_dump_instances.txt";
+    const char* output_format = "text";
+    const char* timestamp_clock = "tsc";
+
+    const std::vector<VkLayerSettingEXT> settings = {
+        {kLayerName, "file", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &use_file},
+        {kLayerName, "log_filename", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &filename_string},
+        {kLayerName, "output_format", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &output_format},
+        {kLayerName, "timestamp", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &timestamp},
+        {kLayerName, "timestamp_clock", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &timestamp_clock}};
+
+    InitLayer(settings);
+    const ApiDumpSettings& dump_settings = ApiDumpInstance::current().settings();
+    const std::chrono::steady_clock::time_point clock_start = dump_settings.clockStart();
+    const uint64_t clock_start_tsc = dump_settings.clockStartTsc();
+    const double tsc_ns_per_tick = dump_settings.tscNsPerTick();
+    const uint64_t first = dump_settings.timestamp();
+
+    // The clock keeps its origin when another instance is created, the TSC isn't calibrated again
+    InitLayer(settings);
+
+    EXPECT_TRUE(clock_start == dump_settings.clockStart());
+    EXPECT_EQ(clock_start_tsc, dump_settings.clockStartTsc());
+    EXPECT_EQ(tsc_ns_per_tick, dump_settings.tscNsPerTick());
+    EXPECT_GE(dump_settings.timestamp(), first);
+
+    ApiDumpInstance::current().removeInstance();
+    ApiDumpInstance::current().removeInstance();
+}
+
+TEST(test_api_dump_output, trigger_capture) {
+    VkBool32 use_file = VK_TRUE;
+    VkBool32 trigger_capture = VK_TRUE;
+    const char* filename_string = "api_dump_capture.txt";
+    const char* output_format = "text";
+    const char* trigger_file = "api_dump_capture.trigger";
+    int32_t trigger_pre_frames = 2;
+    int32_t trigger_post_frames = 0;
+
+    InitLayer({{kLayerName, "file", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &use_file},
+               {kLayerName, "log_filename", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &filename_string},
+               {kLayerName, "output_format", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &output_format},
+               {kLayerName, "trigger_capture", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &trigger_capture},
+               {kLayerName, "trigger_pre_frames", VK_LAYER_SETTING_TYPE_INT32_EXT, 1, &trigger_pre_frames},
+               {kLayerName, "trigger_post_frames", VK_LAYER_SETTING_TYPE_INT32_EXT, 1, &trigger_post_frames},
+               {kLayerName, "trigger_file", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &trigger_file}});
+
+    // The calls are recorded until the trigger file is found at the end of the third frame
+    ApiDumpInstance& dump_inst = ApiDumpInstance::current();
+    const VkResult result = VK_SUCCESS;
+    dump_captured_call(dump_inst, "vkQueueSubmit", "queue, submitCount, pSubmits, fence", "VkResult", &result);
+    dump_inst.nextFrame();
+    dump_captured_call(dump_inst, "vkCmdDraw", "commandBuffer, vertexCount, instanceCount, firstVertex, firstInstance", "void");
+    dump_inst.nextFrame();
+    dump_captured_call(dump_inst, "vkQueuePresentKHR", "queue, pPresentInfo", "VkResult", &result);
+    std::ofstream(trigger_file).close();
+
+    // The trigger file is checked at most every 100 ms, the poll of this frame isn't delayed by the previous ones
+    dump_inst.resetTriggerFilePoll();
+    dump_inst.nextFrame();
+    EXPECT_FALSE(FileExists(trigger_file));
+
+    // Without frames after the trigger, the calls are recorded again
+    EXPECT_TRUE(dump_inst.settings().isRecordingCalls());
+    dump_captured_call(dump_inst, "vkQueueWaitIdle", "queue", "VkResult", &result);
+    dump_inst.removeInstance();
+
+    // Only the frames before the trigger are formatted, without the parameters
+    std::vector<std::string> lines;
+    for (const std::string& line : ReadLines("api_dump_capture.txt")) {
+        if (line.find("Thread ") == 0 || line.find("vk") == 0) lines.push_back(line);
+    }
+    ASSERT_EQ(4, lines.size());
+    EXPECT_STREQ("Thread 0, Frame 1:", lines[0].c_str());
+    EXPECT_STREQ("vkCmdDraw(commandBuffer, vertexCount, instanceCount, firstVertex, firstInstance) returns void:",
+                 lines[1].c_str());
+    EXPECT_STREQ("Thread 0, Frame 2:", lines[2].c_str());
+    EXPECT_STREQ("vkQueuePresentKHR(queue, pPresentInfo) returns VkResult VK_SUCCESS (0):", lines[3].c_str());
+}
+
+TEST(test_api_dump_output, trigger_capture_parameters) {
+    VkBool32 use_file = VK_TRUE;
+    VkBool32 trigger_capture = VK_TRUE;
+    const char* filename_string = "api_dump_capture_parameters.txt";
+    const char* output_format = "text";
+    const char* trigger_file = "api_dump_capture_parameters.trigger";
+    int32_t trigger_pre_frames = 1;
+    int32_t trigger_post_frames = 0;
+
+    InitLayer({{kLayerName, "file", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &use_file},
+               {kLayerName, "log_filename", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &filename_string},
+               {kLayerName, "output_format", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &output_format},
+               {kLayerName, "trigger_capture", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &trigger_capture},
+               {kLayerName, "trigger_pre_frames", VK_LAYER_SETTING_TYPE_INT32_EXT, 1, &trigger_pre_frames},
+               {kLayerName, "trigger_post_frames", VK_LAYER_SETTING_TYPE_INT32_EXT, 1, &trigger_post_frames},
+               {kLayerName, "trigger_file", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &trigger_file}});
+
+    // The recorded calls are formatted with their parameters, like the generated text functions do
+    ApiDumpInstance& dump_inst = ApiDumpInstance::current();
+    const VkResult result = VK_SUCCESS;
+    ASSERT_TRUE(begin_captured_call(dump_inst, "vkQueueWaitIdle", "queue", "VkResult"));
+    dump_inst.settings().stream() << " VK_SUCCESS (0):\n    queue: VkQueue = 0x1234\n\n";
+    end_captured_call(dump_inst, "vkQueueWaitIdle", "queue", "VkResult", &result);
+
+    // A call larger than its buffer is recorded without its parameters
+    ASSERT_TRUE(begin_captured_call(dump_inst, "vkCmdDraw", "commandBuffer, vertexCount", "void"));
+    dump_inst.settings().stream() << ":\n    vertexCount: uint32_t = " << std::string(kCapturedCallMaxSize, '3') << "\n\n";
+    end_captured_call(dump_inst, "vkCmdDraw", "commandBuffer, vertexCount", "void");
+
+    std::ofstream(trigger_file).close();
+    dump_inst.resetTriggerFilePoll();
+    dump_inst.nextFrame();
+    EXPECT_FALSE(FileExists(trigger_file));
+    dump_inst.removeInstance();
+
+    std::vector<std::string> lines;
+    for (const std::string& line : ReadLines(filename_string)) {
+        if (line.find("Thread ") == 0 || line.find("vk") == 0 || line.find("    ") == 0) lines.push_back(line);
+    }
+    ASSERT_EQ(5, lines.size());
+    EXPECT_STREQ("Thread 0, Frame 0:", lines[0].c_str());
+    EXPECT_STREQ("vkQueueWaitIdle(queue) returns VkResult VK_SUCCESS (0):", lines[1].c_str());
+    EXPECT_STREQ("    queue: VkQueue = 0x1234", lines[2].c_str());
+    EXPECT_STREQ("Thread 0, Frame 0:", lines[3].c_str());
+    EXPECT_STREQ("vkCmdDraw(commandBuffer, vertexCount) returns void:", lines[4].c_str());
+}
+
+TEST(test_api_dump_output, per_thread_lock) {
+    VkBool32 use_file = VK_TRUE;
+    VkBool32 per_thread = VK_TRUE;
+    VkBool32 show_thread_and_frame = VK_FALSE;
+    const char* filename_string = "api_dump_threads.txt";
+    const char* output_format = "text";
+
+    InitLayer({{kLayerName, "file", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &use_file},
+               {kLayerName, "log_filename", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &filename_string},
+               {kLayerName, "output_format", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &output_format},
+               {kLayerName, "show_thread_and_frame", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &show_thread_and_frame},
+               {kLayerName, "per_thread", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &per_thread}});
+
+    // The output mode is kept when another instance is created without the per_thread setting
+    InitLayer({{kLayerName, "file", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &use_file},
+               {kLayerName, "log_filename", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &filename_string},
+               {kLayerName, "output_format", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &output_format},
+               {kLayerName, "show_thread_and_frame", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &show_thread_and_frame}});
+    EXPECT_TRUE(ApiDumpInstance::current().settings().perThreadOutput());
+
+    // Each thread dumps its calls the way the generated entry points do, without taking the output mutex
+    const int kCallCount = 200;
+    auto dump_calls = []() {
+        ApiDumpInstance& dump_inst = ApiDumpInstance::current();
+        for (int i = 0; i < kCallCount; ++i) {
+            const bool output_locked = dump_inst.lockOutput();
+            EXPECT_FALSE(output_locked);
+            dump_function_head(dump_inst, "vkQueueWaitIdle", "queue", "VkResult");
+            dump_inst.settings().stream() << ":\n\n";
+            dump_inst.unlockOutput(output_locked);
+        }
+    };
+    std::thread first(dump_calls);
+    std::thread second(dump_calls);
+    first.join();
+    second.join();
+
+    ApiDumpInstance::current().removeInstance();
+    ApiDumpInstance::current().removeInstance();
+
+    // Every call is in the file of its thread, with its own sequence number
+    std::vector<unsigned long long> sequences;
+    for (const char* path : {"api_dump_threads.thread0.txt", "api_dump_threads.thread1.txt"}) {
+        int calls = 0;
+        for (const std::string& line : ReadLines(path)) {
+            unsigned long long sequence = 0, frame = 0, time = 0;
+            if (sscanf(line.c_str(), "@@apidump %llu %llu %llu", &sequence, &frame, &time) == 3) {
+                sequences.push_back(sequence);
+                ++calls;
+            }
+        }
+        EXPECT_EQ(kCallCount, calls);
+    }
+    std::sort(sequences.begin(), sequences.end());
+    ASSERT_EQ(2 * kCallCount, sequences.size());
+    EXPECT_EQ(0, sequences.front());
+    EXPECT_EQ(2 * kCallCount - 1, sequences.back());
+    EXPECT_TRUE(std::adjacent_find(sequences.begin(), sequences.end()) == sequences.end());
+}
+
+#if defined(API_DUMP_USE_ZLIB)
+TEST(test_api_dump_output, compress) {
+    VkBool32 use_file = VK_TRUE;
+    VkBool32 compress = VK_TRUE;
+    const char* filename_string = "api_dump_compress.txt";
+    const char* output_format = "text";
+    int32_t rotate_frames = 1;
+
+    InitLayer({{kLayerName, "file", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &use_file},
+               {kLayerName, "log_filename", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &filename_string},
+               {kLayerName, "output_format", VK_LAYER_SETTING_TYPE_STRING_EXT, 1, &output_format},
+               {kLayerName, "rotate_frames", VK_LAYER_SETTING_TYPE_INT32_EXT, 1, &rotate_frames},
+               {kLayerName, "compress", VK_LAYER_SETTING_TYPE_BOOL32_EXT, 1, &compress}});
+
+    DumpCall("vkCreateDevice", "VkDevice", "", {{"VkDevice", 0x20}});
+    ApiDumpInstance::current().nextFrame();
+    DumpCall("vkQueuePresentKHR", "", "", {{"VkQueue", 0x40}});
+
+    // The compression thread is joined once the closed files are compressed
+    ApiDumpInstance::current().removeInstance();
+
+    EXPECT_TRUE(FileExists("api_dump_compress.0001.txt.gz"));
+    EXPECT_FALSE(FileExists("api_dump_compress.0001.txt"));
+
+    const std::vector<std::string>& index = ReadLines("api_dump_compress.index.txt");
+    ASSERT_EQ(1, index.size());
+    EXPECT_STREQ("0-0 api_dump_compress.0001.txt.gz", index[0].c_str());
+}
+#endif
@@ -52,6 +52,14 @@ BLOCKING_API_CALLS = [
     'vkQueueWaitIdle', 'vkAcquireNextImageKHR', 'vkGetQueryPoolResults',
 ]
 
+# Calls that update the layer state or advance the frame counter, they don't take the generic fast path. vkQueuePresentKHR has its
+# own, which counts the frame without taking the output mutex.
+FAST_PATH_EXCLUDED_CALLS = [
+    'vkEnumeratePhysicalDevices', 'vkDestroyInstance', 'vkDestroyDevice', 'vkGetPhysicalDeviceToolPropertiesEXT',
+    'vkDebugMarkerSetObjectNameEXT', 'vkSetDebugUtilsObjectNameEXT', 'vkQueuePresentKHR',
+    'vkAllocateCommandBuffers', 'vkDestroyCommandPool', 'vkFreeCommandBuffers',
+]
+
 COMMON_CODEGEN = """
 /* Copyright (c) 2015-2016, 2021 Valve Corporation
  * Copyright (c) 2015-2016, 2021 LunarG, Inc.
@@ -98,6 +106,8 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCreateInfo* pCre
 {{
     ApiDumpInstance::current().outputMutex()->lock();
     ApiDumpInstance::current().initLayerSettings(pCreateInfo, pAllocator);
+    // The head is output with the timestamp of the call, the duration of the call includes writing the head
+    ApiDumpInstance::current().beginCall();
     dump_function_head(ApiDumpInstance::current(), "vkCreateInstance", "pCreateInfo, pAllocator, pInstance", "VkResult");
 
     // Get the function pointer
@@ -113,12 +123,17 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCreateInfo* pCre
     // Call the function and create the dispatch table
     chain_info->u.pLayerInfo = chain_info->u.pLayerInfo->pNext;
     VkResult result = fpCreateInstance(pCreateInfo, pAllocator, pInstance);
+    ApiDumpInstance::current().endCall();
     if(result == VK_SUCCESS) {{
         initInstanceTable(*pInstance, fpGetInstanceProcAddr);
+        ApiDumpInstance::current().addInstance();
     }}
 
     // Output the API dump
     if (ApiDumpInstance::current().shouldDumpOutput()) {{
+        // While recording a trigger capture, the call is formatted into the capture ring instead of the output
+        const bool captured = begin_captured_call(ApiDumpInstance::current(), "vkCreateInstance", "pCreateInfo, pAllocator, pInstance", "VkResult");
+        ApiDumpInstance::current().settings().indexLifetime("VkInstance", "");
         switch(ApiDumpInstance::current().settings().format())
         {{
             case ApiDumpFormat::Text:
@@ -130,6 +145,12 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCreateInfo* pCre
             case ApiDumpFormat::Json:
                 dump_json_vkCreateInstance(ApiDumpInstance::current(), result, pCreateInfo, pAllocator, pInstance);
                 break;
+            case ApiDumpFormat::TraceEvent:
+                dump_trace_event_call(ApiDumpInstance::current(), "vkCreateInstance", &result);
+                break;
+        }}
+        if (captured) {{
+            end_captured_call(ApiDumpInstance::current(), "vkCreateInstance", "pCreateInfo, pAllocator, pInstance", "VkResult", &result);
         }}
     }}
     ApiDumpInstance::current().outputMutex()->unlock();
@@ -138,7 +159,9 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCreateInfo* pCre
 
 VKAPI_ATTR VkResult VKAPI_CALL vkCreateDevice(VkPhysicalDevice physicalDevice, const VkDeviceCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDevice* pDevice)
 {{
-    ApiDumpInstance::current().outputMutex()->lock();
+    const bool output_locked = ApiDumpInstance::current().lockOutput();
+    // The head is output with the timestamp of the call, the duration of the call includes writing the head
+    ApiDumpInstance::current().beginCall();
     dump_function_head(ApiDumpInstance::current(), "vkCreateDevice", "physicalDevice, pCreateInfo, pAllocator, pDevice", "VkResult");
 
     // Get the function pointer
@@ -155,12 +178,16 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateDevice(VkPhysicalDevice physicalDevice, c
     // Call the function and create the dispatch table
     chain_info->u.pLayerInfo = chain_info->u.pLayerInfo->pNext;
     VkResult result = fpCreateDevice(physicalDevice, pCreateInfo, pAllocator, pDevice);
+    ApiDumpInstance::current().endCall();
     if(result == VK_SUCCESS) {{
         initDeviceTable(*pDevice, fpGetDeviceProcAddr);
     }}
 
     // Output the API dump
     if (ApiDumpInstance::current().shouldDumpOutput()) {{
+        // While recording a trigger capture, the call is formatted into the capture ring instead of the output
+        const bool captured = begin_captured_call(ApiDumpInstance::current(), "vkCreateDevice", "physicalDevice, pCreateInfo, pAllocator, pDevice", "VkResult");
+        ApiDumpInstance::current().settings().indexLifetime("VkDevice", "");
         switch(ApiDumpInstance::current().settings().format())
         {{
             case ApiDumpFormat::Text:
@@ -172,9 +199,15 @@ VKAPI_ATTR VkResult VKAPI_CALL vkCreateDevice(VkPhysicalDevice physicalDevice, c
             case ApiDumpFormat::Json:
                 dump_json_vkCreateDevice(ApiDumpInstance::current(), result, physicalDevice, pCreateInfo, pAllocator, pDevice);
                 break;
+            case ApiDumpFormat::TraceEvent:
+                dump_trace_event_call(ApiDumpInstance::current(), "vkCreateDevice", &result);
+                break;
+        }}
+        if (captured) {{
+            end_captured_call(ApiDumpInstance::current(), "vkCreateDevice", "physicalDevice, pCreateInfo, pAllocator, pDevice", "VkResult", &result);
         }}
     }}
-    ApiDumpInstance::current().outputMutex()->unlock();
+    ApiDumpInstance::current().unlockOutput(output_locked);
     return result;
 }}
 
@@ -216,8 +249,16 @@ EXPORT_FUNCTION VKAPI_ATTR VkResult VKAPI_CALL vkEnumerateDeviceLayerProperties(
 @foreach function where('{funcDispatchType}' == 'instance' and '{funcName}' not in ['vkCreateInstance', 'vkCreateDevice', 'vkGetInstanceProcAddr', 'vkEnumerateDeviceExtensionProperties', 'vkEnumerateDeviceLayerProperties'])
 VKAPI_ATTR {funcReturn} VKAPI_CALL {funcName}({funcTypedParams})
 {{
+    @if('{funcName}' not in FAST_PATH_EXCLUDED_CALLS)
+    // Outside of the dumped frames, the call goes straight to the next layer without taking the output mutex
+    if (!ApiDumpInstance::current().shouldDumpOutput()) {{
+        return instance_dispatch_table({funcDispatchParam})->{funcShortName}({funcNamedParams});
+    }}
+    @end if
     @if('{funcName}' not in BLOCKING_API_CALLS)
-    ApiDumpInstance::current().outputMutex()->lock();
+    const bool output_locked = ApiDumpInstance::current().lockOutput();
+    // The head is output with the timestamp of the call, the duration of the call includes writing the head
+    ApiDumpInstance::current().beginCall();
     dump_function_head(ApiDumpInstance::current(), "{funcName}", "{funcNamedParams}", "{funcReturn}");
     @end if
 
@@ -239,14 +280,18 @@ VKAPI_ATTR {funcReturn} VKAPI_CALL {funcName}({funcTypedParams})
     }}
     @end if
 
+    @if('{funcName}' in BLOCKING_API_CALLS)
+    ApiDumpInstance::current().beginCall();
+    @end if
     @if('{funcReturn}' != 'void')
     {funcReturn} result = instance_dispatch_table({funcDispatchParam})->{funcShortName}({funcNamedParams});
     @end if
     @if('{funcReturn}' == 'void')
     instance_dispatch_table({funcDispatchParam})->{funcShortName}({funcNamedParams});
     @end if
+    ApiDumpInstance::current().endCall();
     @if('{funcName}' in BLOCKING_API_CALLS)
-    ApiDumpInstance::current().outputMutex()->lock();
+    const bool output_locked = ApiDumpInstance::current().lockOutput();
     dump_function_head(ApiDumpInstance::current(), "{funcName}", "{funcNamedParams}", "{funcReturn}");
     @end if
     {funcStateTrackingCode}
@@ -270,6 +315,11 @@ VKAPI_ATTR {funcReturn} VKAPI_CALL {funcName}({funcTypedParams})
     @end if
 
     if (ApiDumpInstance::current().shouldDumpOutput()) {{
+        // While recording a trigger capture, the call is formatted into the capture ring instead of the output
+        const bool captured = begin_captured_call(ApiDumpInstance::current(), "{funcName}", "{funcNamedParams}", "{funcReturn}");
+        @if('{funcCreatedHandle}' != '' or '{funcDestroyedHandle}' != '')
+        ApiDumpInstance::current().settings().indexLifetime("{funcCreatedHandle}", "{funcDestroyedHandle}");
+        @end if
         switch(ApiDumpInstance::current().settings().format())
         {{
             @if('{funcReturn}' != 'void')
@@ -282,6 +332,14 @@ VKAPI_ATTR {funcReturn} VKAPI_CALL {funcName}({funcTypedParams})
             case ApiDumpFormat::Json:
                 dump_json_{funcName}(ApiDumpInstance::current(), result, {funcNamedParams});
                 break;
+            case ApiDumpFormat::TraceEvent:
+                @if('{funcReturn}' == 'VkResult')
+                dump_trace_event_call(ApiDumpInstance::current(), "{funcName}", &result);
+                @end if
+                @if('{funcReturn}' != 'VkResult')
+                dump_trace_event_call(ApiDumpInstance::current(), "{funcName}");
+                @end if
+                break;
             @end if
             @if('{funcReturn}' == 'void')
             case ApiDumpFormat::Text:
@@ -293,10 +351,24 @@ VKAPI_ATTR {funcReturn} VKAPI_CALL {funcName}({funcTypedParams})
             case ApiDumpFormat::Json:
                 dump_json_{funcName}(ApiDumpInstance::current(), {funcNamedParams});
                 break;
+            case ApiDumpFormat::TraceEvent:
+                dump_trace_event_call(ApiDumpInstance::current(), "{funcName}");
+                break;
+            @end if
+        }}
+        if (captured) {{
+            @if('{funcReturn}' == 'VkResult')
+            end_captured_call(ApiDumpInstance::current(), "{funcName}", "{funcNamedParams}", "{funcReturn}", &result);
+            @end if
+            @if('{funcReturn}' != 'VkResult')
+            end_captured_call(ApiDumpInstance::current(), "{funcName}", "{funcNamedParams}", "{funcReturn}");
             @end if
         }}
     }}
-    ApiDumpInstance::current().outputMutex()->unlock();
+    @if('{funcName}' == 'vkDestroyInstance')
+    ApiDumpInstance::current().removeInstance();
+    @end if
+    ApiDumpInstance::current().unlockOutput(output_locked);
     @if('{funcReturn}' != 'void')
     return result;
     @end if
@@ -308,22 +380,42 @@ VKAPI_ATTR {funcReturn} VKAPI_CALL {funcName}({funcTypedParams})
 @foreach function where('{funcDispatchType}' == 'device' and '{funcName}' not in ['vkGetDeviceProcAddr'])
 VKAPI_ATTR {funcReturn} VKAPI_CALL {funcName}({funcTypedParams})
 {{
+    @if('{funcName}' in ['vkCmdInsertDebugUtilsLabelEXT', 'vkQueueInsertDebugUtilsLabelEXT'])
+    ApiDumpInstance::current().checkCaptureLabel(pLabelInfo);
+    @end if
+    @if('{funcName}' not in FAST_PATH_EXCLUDED_CALLS)
+    // Outside of the dumped frames, the call goes straight to the next layer without taking the output mutex
+    if (!ApiDumpInstance::current().shouldDumpOutput()) {{
+        return device_dispatch_table({funcDispatchParam})->{funcShortName}({funcNamedParams});
+    }}
+    @end if
+    @if('{funcName}' == 'vkQueuePresentKHR')
+    if (!ApiDumpInstance::current().shouldDumpOutput()) {{
+        return dump_skipped_present(ApiDumpInstance::current(), device_dispatch_table(queue)->QueuePresentKHR, queue, pPresentInfo);
+    }}
+    @end if
     @if('{funcName}' not in BLOCKING_API_CALLS)
-    ApiDumpInstance::current().outputMutex()->lock();
+    const bool output_locked = ApiDumpInstance::current().lockOutput();
     @if('{funcName}' in ['vkDebugMarkerSetObjectNameEXT', 'vkSetDebugUtilsObjectNameEXT'])
     ApiDumpInstance::current().update_object_name_map(pNameInfo);
     @end if
+    // The head is output with the timestamp of the call, the duration of the call includes writing the head
+    ApiDumpInstance::current().beginCall();
     dump_function_head(ApiDumpInstance::current(), "{funcName}", "{funcNamedParams}", "{funcReturn}");
     @end if
 
+    @if('{funcName}' in BLOCKING_API_CALLS)
+    ApiDumpInstance::current().beginCall();
+    @end if
     @if('{funcReturn}' != 'void')
     {funcReturn} result = device_dispatch_table({funcDispatchParam})->{funcShortName}({funcNamedParams});
     @end if
     @if('{funcReturn}' == 'void')
     device_dispatch_table({funcDispatchParam})->{funcShortName}({funcNamedParams});
     @end if
+    ApiDumpInstance::current().endCall();
     @if('{funcName}' in BLOCKING_API_CALLS)
-    ApiDumpInstance::current().outputMutex()->lock();
+    const bool output_locked = ApiDumpInstance::current().lockOutput();
     dump_function_head(ApiDumpInstance::current(), "{funcName}", "{funcNamedParams}", "{funcReturn}");
     @end if
     {funcStateTrackingCode}
@@ -332,6 +424,11 @@ VKAPI_ATTR {funcReturn} VKAPI_CALL {funcName}({funcTypedParams})
     @end if
 
     if (ApiDumpInstance::current().shouldDumpOutput()) {{
+        // While recording a trigger capture, the call is formatted into the capture ring instead of the output
+        const bool captured = begin_captured_call(ApiDumpInstance::current(), "{funcName}", "{funcNamedParams}", "{funcReturn}");
+        @if('{funcCreatedHandle}' != '' or '{funcDestroyedHandle}' != '')
+        ApiDumpInstance::current().settings().indexLifetime("{funcCreatedHandle}", "{funcDestroyedHandle}");
+        @end if
         switch(ApiDumpInstance::current().settings().format())
         {{
             @if('{funcReturn}' != 'void')
@@ -344,6 +441,14 @@ VKAPI_ATTR {funcReturn} VKAPI_CALL {funcName}({funcTypedParams})
             case ApiDumpFormat::Json:
                 dump_json_{funcName}(ApiDumpInstance::current(), result, {funcNamedParams});
                 break;
+            case ApiDumpFormat::TraceEvent:
+                @if('{funcReturn}' == 'VkResult')
+                dump_trace_event_call(ApiDumpInstance::current(), "{funcName}", &result);
+                @end if
+                @if('{funcReturn}' != 'VkResult')
+                dump_trace_event_call(ApiDumpInstance::current(), "{funcName}");
+                @end if
+                break;
             @end if
             @if('{funcReturn}' == 'void')
             case ApiDumpFormat::Text:
@@ -355,10 +460,44 @@ VKAPI_ATTR {funcReturn} VKAPI_CALL {funcName}({funcTypedParams})
             case ApiDumpFormat::Json:
                 dump_json_{funcName}(ApiDumpInstance::current(), {funcNamedParams});
                 break;
+            case ApiDumpFormat::TraceEvent:
+                dump_trace_event_call(ApiDumpInstance::current(), "{funcName}");
+                break;
+            @end if
+        }}
+        if (captured) {{
+            @if('{funcReturn}' == 'VkResult')
+            end_captured_call(ApiDumpInstance::current(), "{funcName}", "{funcNamedParams}", "{funcReturn}", &result);
+            @end if
+            @if('{funcReturn}' != 'VkResult')
+            end_captured_call(ApiDumpInstance::current(), "{funcName}", "{funcNamedParams}", "{funcReturn}");
             @end if
         }}
     }}
-    ApiDumpInstance::current().outputMutex()->unlock();
+    @if('{funcName}' in ['vkCmdBeginDebugUtilsLabelEXT', 'vkQueueBeginDebugUtilsLabelEXT', 'vkCmdEndDebugUtilsLabelEXT', 'vkQueueEndDebugUtilsLabelEXT', 'vkCmdInsertDebugUtilsLabelEXT', 'vkQueueInsertDebugUtilsLabelEXT'])
+    // The labels follow the event of the call, they are written as they are even while the calls are recorded by trigger capture
+    if (ApiDumpInstance::current().shouldDumpOutput() && ApiDumpInstance::current().settings().format() == ApiDumpFormat::TraceEvent) {{
+        @if('{funcName}' == 'vkCmdBeginDebugUtilsLabelEXT')
+        dump_trace_event_label(ApiDumpInstance::current(), 'b', pLabelInfo, commandBuffer);
+        @end if
+        @if('{funcName}' == 'vkCmdEndDebugUtilsLabelEXT')
+        dump_trace_event_label(ApiDumpInstance::current(), 'e', nullptr, commandBuffer);
+        @end if
+        @if('{funcName}' == 'vkCmdInsertDebugUtilsLabelEXT')
+        dump_trace_event_label(ApiDumpInstance::current(), 'n', pLabelInfo, commandBuffer);
+        @end if
+        @if('{funcName}' == 'vkQueueBeginDebugUtilsLabelEXT')
+        dump_trace_event_label(ApiDumpInstance::current(), 'B', pLabelInfo);
+        @end if
+        @if('{funcName}' == 'vkQueueEndDebugUtilsLabelEXT')
+        dump_trace_event_label(ApiDumpInstance::current(), 'E', nullptr);
+        @end if
+        @if('{funcName}' == 'vkQueueInsertDebugUtilsLabelEXT')
+        dump_trace_event_label(ApiDumpInstance::current(), 'i', pLabelInfo);
+        @end if
+    }}
+    @end if
+    ApiDumpInstance::current().unlockOutput(output_locked);
     @if('{funcName}' == 'vkQueuePresentKHR')
     ApiDumpInstance::current().nextFrame();
     @end if
@@ -526,12 +665,13 @@ void dump_text_{sysName}(const {sysType} object, const ApiDumpSettings& settings
 @foreach handle
 void dump_text_{hdlName}(const {hdlName} object, const ApiDumpSettings& settings, int indents)
 {{
+    settings.indexHandle("{hdlName}", (uint64_t) object);
     if(settings.showAddress()) {{
         settings.stream() << object;
 
-        std::unordered_map<uint64_t, std::string>::const_iterator it = ApiDumpInstance::current().object_name_map.find((uint64_t) object);
-        if (it != ApiDumpInstance::current().object_name_map.end()) {{
-            settings.stream() << " [" << it->second << "]";
+        std::string object_name;
+        if (ApiDumpInstance::current().find_object_name((uint64_t) object, object_name)) {{
+            settings.stream() << " [" << object_name << "]";
         }}
     }} else {{
         settings.stream() << "address";
@@ -788,6 +928,7 @@ void dump_text_{funcName}(ApiDumpInstance& dump_inst, {funcTypedParams})
     settings.stream() << " ";
     dump_text_{funcReturn}(result, settings, 0);
     @end if
+    dump_text_call_duration(dump_inst);
     settings.stream() << ":\\n";
     if(settings.showParams())
     {{
@@ -922,6 +1063,7 @@ void dump_html_{sysName}(const {sysType} object, const ApiDumpSettings& settings
 @foreach handle
 void dump_html_{hdlName}(const {hdlName} object, const ApiDumpSettings& settings, int indents)
 {{
+    settings.indexHandle("{hdlName}", (uint64_t) object);
     settings.stream() << "<div class='val'>";
     if(settings.showAddress()) {{
         settings.stream() << object;
@@ -1159,6 +1301,7 @@ void dump_html_{funcName}(ApiDumpInstance& dump_inst, {funcTypedParams})
     @if('{funcReturn}' != 'void')
     dump_html_{funcReturn}(result, settings, 0);
     @end if
+    dump_html_call_duration(dump_inst);
     settings.stream() << "</summary>";
 
     if(settings.showParams())
@@ -1292,6 +1435,7 @@ void dump_json_{sysName}(const {sysType} object, const ApiDumpSettings& settings
 @foreach handle
 void dump_json_{hdlName}(const {hdlName} object, const ApiDumpSettings& settings, int indents)
 {{
+    settings.indexHandle("{hdlName}", (uint64_t) object);
     if(settings.showAddress()) {{
         settings.stream() << "\\"" << object << "\\"";
     }} else {{
@@ -1515,6 +1659,13 @@ void dump_json_{funcName}(ApiDumpInstance& dump_inst, {funcTypedParams})
 {{
     const ApiDumpSettings& settings(dump_inst.settings());
 
+    @if('{funcReturn}' != 'void')
+    dump_json_call_duration(dump_inst, true);
+    @end if
+    @if('{funcReturn}' == 'void')
+    dump_json_call_duration(dump_inst, settings.showParams());
+    @end if
+
     @if('{funcReturn}' != 'void')
     settings.stream() << settings.indentation(3) << "\\\"returnValue\\\" : ";
     dump_json_{funcReturn}(result, settings, 0);
@@ -1846,6 +1997,16 @@ class ApiDumpOutputGenerator(OutputGenerator):
                 if member.typeID in self.aliases:
                     member.typeID = self.aliases[member.typeID]
 
+        # A handle output by a function is created by the first dumped call that outputs it, the vkDestroy* and vkFree*
+        # functions destroy the last handle parameter
+        for function in self.functions.values():
+            handleParams = [param for param in function.parameters if param.typeID in self.handles]
+            lastParam = function.parameters[-1]
+            if lastParam.typeID in self.handles and lastParam.pointerLevels > 0 and not lastParam.type.startswith('const'):
+                function.createdHandle = lastParam.typeID
+            if (function.name.startswith('vkDestroy') or function.name.startswith('vkFree')) and len(handleParams) > 0:
+                function.destroyedHandle = handleParams[-1].typeID
+
 
         # Find every @foreach, @if, and @end
         forIter = re.finditer('(^\\s*\\@foreach\\s+[a-z]+(\\s+where\\(.*\\))?\\s*^)|(\\@foreach [a-z]+(\\s+where\\(.*\\))?\\b)', self.format, flags=re.MULTILINE)
@@ -2445,6 +2606,10 @@ class VulkanFunction:
         if self.name in TRACKED_STATE:
             self.stateTrackingCode = TRACKED_STATE[self.name]
 
+        # The handle types created and destroyed by the function, for the handle index
+        self.createdHandle = ''
+        self.destroyedHandle = ''
+
     def values(self):
         return {
             'funcName': self.name,
@@ -2456,6 +2621,8 @@ class VulkanFunction:
             'funcDispatchParam': self.parameters[0].name,
             'funcDispatchType' : self.dispatchType,
             'funcStateTrackingCode': self.stateTrackingCode,
+            'funcCreatedHandle': self.createdHandle,
+            'funcDestroyedHandle': self.destroyedHandle,
         }
 
 class VulkanFunctionPointer:
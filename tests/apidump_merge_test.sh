@@ -0,0 +1,135 @@
+#!/bin/bash
+
+# apidump_merge_test.sh
+# This script will write the files of two threads the way the api_dump layer does
+# with the per_thread setting and check the order of the calls merged by
+# merge_api_dump.py. The path to merge_api_dump.py can be defined using the
+# environment variable MERGE_API_DUMP or using the command-line argument -m or
+# --merge. The python interpreter can be defined using the environment variable
+# PYTHON or using the command-line argument -p or --python, python3 is used by
+# default.
+
+# Track unrecognized arguments.
+UNRECOGNIZED=()
+
+# Parse the command-line arguments.
+while [[ $# -gt 0 ]]
+do
+   KEY="$1"
+   case $KEY in
+      -m|--merge)
+      MERGE_API_DUMP="$2"
+      shift
+      shift
+      ;;
+      -p|--python)
+      PYTHON="$2"
+      shift
+      shift
+      ;;
+      *)
+      UNRECOGNIZED+=("$1")
+      shift
+      ;;
+   esac
+done
+
+# Reject unrecognized arguments.
+if [[ ${#UNRECOGNIZED[@]} -ne 0 ]]; then
+   echo "ERROR: $0:$LINENO"
+   echo "Unrecognized command-line arguments: ${UNRECOGNIZED[*]}"
+   exit 1
+fi
+
+if [ -z ${MERGE_API_DUMP+x} ]; then
+   echo "ERROR: $0:$LINENO"
+   echo "merge_api_dump.py is undefined."
+   echo "Please set MERGE_API_DUMP or use the -m|--merge <path> command line option."
+   exit 1
+fi
+
+if [ -z ${PYTHON+x} ]; then
+   PYTHON=python3
+fi
+
+if [ -t 1 ] ; then
+    RED='\033[0;31m'
+    GREEN='\033[0;32m'
+    NC='\033[0m' # No Color
+else
+    RED=''
+    GREEN=''
+    NC=''
+fi
+
+OUTPUT_DIR=$(mktemp -d)
+
+printf "$GREEN[ RUN      ]$NC $0\n"
+
+# The calls of the two threads interleave, the second frame starts with a call of the second thread
+cat > "$OUTPUT_DIR/vk_apidump.thread0.txt" << EOF_THREAD
+@@apidump 0 0 100
+vkCreateBuffer(device, pCreateInfo, pAllocator, pBuffer) returns VkResult VK_SUCCESS (0):
+
+@@apidump 3 0 400
+vkQueueSubmit(queue, submitCount, pSubmits, fence) returns VkResult VK_SUCCESS (0):
+
+@@apidump 5 1 600
+vkQueuePresentKHR(queue, pPresentInfo) returns VkResult VK_SUCCESS (0):
+
+EOF_THREAD
+cat > "$OUTPUT_DIR/vk_apidump.thread1.txt" << EOF_THREAD
+@@apidump 1 0 200
+vkCreateImage(device, pCreateInfo, pAllocator, pImage) returns VkResult VK_SUCCESS (0):
+
+@@apidump 2 0 300
+vkBindImageMemory(device, image, memory, memoryOffset) returns VkResult VK_SUCCESS (0):
+
+@@apidump 4 1 500
+vkCmdDraw(commandBuffer, vertexCount, instanceCount, firstVertex, firstInstance) returns void:
+
+EOF_THREAD
+
+RESULT=0
+
+"$PYTHON" "$MERGE_API_DUMP" -o "$OUTPUT_DIR/merged.txt" "$OUTPUT_DIR/vk_apidump.thread1.txt" "$OUTPUT_DIR/vk_apidump.thread0.txt" \
+    > "$OUTPUT_DIR/merge.log" 2>&1
+if [ $? -ne 0 ]; then
+    echo "merge_api_dump.py failed: $(cat "$OUTPUT_DIR/merge.log")"
+    RESULT=1
+elif [ "$(grep -o "^vk[A-Za-z]*" "$OUTPUT_DIR/merged.txt" | tr '\n' ' ')" != \
+       "vkCreateBuffer vkCreateImage vkBindImageMemory vkQueueSubmit vkCmdDraw vkQueuePresentKHR " ]; then
+    echo "The merged calls aren't in sequence order: $(grep -o "^vk[A-Za-z]*" "$OUTPUT_DIR/merged.txt" | tr '\n' ' ')"
+    RESULT=1
+elif grep -q "^@@apidump" "$OUTPUT_DIR/merged.txt"; then
+    echo "The record headings are left in the merged calls"
+    RESULT=1
+fi
+
+# The JSON calls are grouped in their frames
+if [ $RESULT -eq 0 ]; then
+    printf '@@apidump 0 0 100\n        {\n            "name" : "vkQueueSubmit"\n        }' > "$OUTPUT_DIR/vk_apidump.thread0.json"
+    printf '\n@@apidump 2 1 300\n        {\n            "name" : "vkQueuePresentKHR"\n        }' >> "$OUTPUT_DIR/vk_apidump.thread0.json"
+    printf '@@apidump 1 0 200\n        {\n            "name" : "vkCmdDraw"\n        }' > "$OUTPUT_DIR/vk_apidump.thread1.json"
+
+    "$PYTHON" "$MERGE_API_DUMP" -o "$OUTPUT_DIR/merged.json" "$OUTPUT_DIR/vk_apidump.thread0.json" "$OUTPUT_DIR/vk_apidump.thread1.json" \
+        > "$OUTPUT_DIR/merge.log" 2>&1
+    FRAMES=$("$PYTHON" -c "import json, sys
+frames = json.load(open(sys.argv[1]))
+print(' '.join('%s:%s' % (frame['frameNumber'], ','.join(call['name'] for call in frame['apiCalls'])) for frame in frames))" \
+        "$OUTPUT_DIR/merged.json" 2>&1)
+    if [ "$FRAMES" != "0:vkQueueSubmit,vkCmdDraw 1:vkQueuePresentKHR" ]; then
+        echo "The merged JSON frames are wrong: $FRAMES"
+        RESULT=1
+    fi
+fi
+
+rm -rf "$OUTPUT_DIR"
+
+if [ $RESULT -eq 0 ]; then
+    printf "$GREEN[  PASSED  ]$NC $0\n"
+else
+    printf "$RED[  FAILED  ]$NC $0\n"
+fi
+
+exit $RESULT
@@ -0,0 +1,134 @@
+#!/bin/bash
+
+# apidump_query_test.sh
+# This script will write a dump and its handle index the way the api_dump layer does
+# with the handle_index setting and check the calls printed by query_api_dump.py. The
+# path to query_api_dump.py can be defined using the environment variable QUERY_API_DUMP
+# or using the command-line argument -q or --query. The python interpreter can be
+# defined using the environment variable PYTHON or using the command-line argument
+# -p or --python, python3 is used by default.
+
+# Track unrecognized arguments.
+UNRECOGNIZED=()
+
+# Parse the command-line arguments.
+while [[ $# -gt 0 ]]
+do
+   KEY="$1"
+   case $KEY in
+      -q|--query)
+      QUERY_API_DUMP="$2"
+      shift
+      shift
+      ;;
+      -p|--python)
+      PYTHON="$2"
+      shift
+      shift
+      ;;
+      *)
+      UNRECOGNIZED+=("$1")
+      shift
+      ;;
+   esac
+done
+
+# Reject unrecognized arguments.
+if [[ ${#UNRECOGNIZED[@]} -ne 0 ]]; then
+   echo "ERROR: $0:$LINENO"
+   echo "Unrecognized command-line arguments: ${UNRECOGNIZED[*]}"
+   exit 1
+fi
+
+if [ -z ${QUERY_API_DUMP+x} ]; then
+   echo "ERROR: $0:$LINENO"
+   echo "query_api_dump.py is undefined."
+   echo "Please set QUERY_API_DUMP or use the -q|--query <path> command line option."
+   exit 1
+fi
+
+if [ -z ${PYTHON+x} ]; then
+   PYTHON=python3
+fi
+
+if [ -t 1 ] ; then
+    RED='\033[0;31m'
+    GREEN='\033[0;32m'
+    NC='\033[0m' # No Color
+else
+    RED=''
+    GREEN=''
+    NC=''
+fi
+
+OUTPUT_DIR=$(mktemp -d)
+DUMP="$OUTPUT_DIR/vk_apidump.txt"
+
+printf "$GREEN[ RUN      ]$NC $0\n"
+
+# A buffer destroyed and created again with the same value, and an image sharing the value of the buffer
+CALLS=("vkCreateBuffer:\n    buffer: VkBuffer = 0xb0\n\n"
+       "vkCreateImage:\n    image: VkImage = 0xb0\n\n"
+       "vkDestroyBuffer:\n    buffer: VkBuffer = 0xb0\n\n"
+       "vkCreateBuffer:\n    buffer: VkBuffer = 0xb0\n\n")
+
+printf "# api_dump handle index\ndump vk_apidump.txt\n" > "$DUMP.handles"
+: > "$DUMP"
+for SEQUENCE in "${!CALLS[@]}"; do
+    OFFSET=$(wc -c < "$DUMP")
+    printf "${CALLS[$SEQUENCE]}" >> "$DUMP"
+    SIZE=$(( $(wc -c < "$DUMP") - OFFSET ))
+    echo "call $SEQUENCE $OFFSET $SIZE" >> "$DUMP.handles"
+done
+cat >> "$DUMP.handles" << EOF_INDEX
+handle VkBuffer 0xb0 0 2 0 2
+handle VkImage 0xb0 1 - 1
+handle VkBuffer 0xb0 3 - 3
+EOF_INDEX
+
+RESULT=0
+
+# Each lifetime of each type is listed, with every call referencing the value
+"$PYTHON" "$QUERY_API_DUMP" 0xb0 "$DUMP" > "$OUTPUT_DIR/all.txt" 2>&1
+if [ $? -ne 0 ]; then
+    echo "query_api_dump.py failed: $(cat "$OUTPUT_DIR/all.txt")"
+    RESULT=1
+elif [ "$(grep -c "^# call " "$OUTPUT_DIR/all.txt")" -ne 4 ]; then
+    echo "The calls referencing 0xb0 are missing"
+    RESULT=1
+elif ! grep -q "^# VkBuffer 0xb0: created by call 0, destroyed by call 2, referenced by 2 calls" "$OUTPUT_DIR/all.txt" ||
+     ! grep -q "^# VkBuffer 0xb0: created by call 3, not destroyed in the dump, referenced by 1 calls" "$OUTPUT_DIR/all.txt" ||
+     ! grep -q "^# VkImage 0xb0: created by call 1, not destroyed in the dump, referenced by 1 calls" "$OUTPUT_DIR/all.txt"; then
+    echo "The lifetimes of 0xb0 are wrong"
+    RESULT=1
+fi
+
+# The calls are read at their offsets in the dump
+if [ $RESULT -eq 0 ]; then
+    "$PYTHON" "$QUERY_API_DUMP" --type VkImage 0xb0 "$DUMP" > "$OUTPUT_DIR/image.txt" 2>&1
+    if [ "$(grep -c "^# call " "$OUTPUT_DIR/image.txt")" -ne 1 ] || ! grep -q "^# call 1$" "$OUTPUT_DIR/image.txt"; then
+        echo "The image sharing the value of the buffer isn't queried apart"
+        RESULT=1
+    elif ! grep -A1 "^# call 1$" "$OUTPUT_DIR/image.txt" | grep -q "^vkCreateImage:$"; then
+        echo "The call isn't read at its offset"
+        RESULT=1
+    fi
+fi
+
+if [ $RESULT -eq 0 ]; then
+    "$PYTHON" "$QUERY_API_DUMP" --summary 0xc0 "$DUMP" > "$OUTPUT_DIR/missing.txt" 2>&1
+    if ! grep -q "^# 0xc0 is not referenced by the dumped calls$" "$OUTPUT_DIR/missing.txt"; then
+        echo "The missing handle isn't reported"
+        RESULT=1
+    fi
+fi
+
+rm -rf "$OUTPUT_DIR"
+
+if [ $RESULT -eq 0 ]; then
+    printf "$GREEN[  PASSED  ]$NC $0\n"
+else
+    printf "$RED[  FAILED  ]$NC $0\n"
+fi
+
+exit $RESULT
@@ -0,0 +1,110 @@
+#!/bin/bash
+
+# via_driver_load_test.sh
+# This script will run vkvia with a driver whose library crashes when it's loaded and
+# check that vkvia reports the crash of the child process loading the library and
+# skips the Vulkan API calls instead of loading the driver itself. The path to the
+# vkvia executable can be defined using the environment variable VKVIA or using the
+# command-line argument -v or --via. The path to the crashing library can be defined
+# using the environment variable CRASH_DRIVER or using the command-line argument
+# -d or --driver.
+
+# Track unrecognized arguments.
+UNRECOGNIZED=()
+
+# Parse the command-line arguments.
+while [[ $# -gt 0 ]]
+do
+   KEY="$1"
+   case $KEY in
+      -v|--via)
+      VKVIA="$2"
+      shift
+      shift
+      ;;
+      -d|--driver)
+      CRASH_DRIVER="$2"
+      shift
+      shift
+      ;;
+      *)
+      UNRECOGNIZED+=("$1")
+      shift
+      ;;
+   esac
+done
+
+# Reject unrecognized arguments.
+if [[ ${#UNRECOGNIZED[@]} -ne 0 ]]; then
+   echo "ERROR: $0:$LINENO"
+   echo "Unrecognized command-line arguments: ${UNRECOGNIZED[*]}"
+   exit 1
+fi
+
+if [ -z ${VKVIA+x} ]; then
+   echo "ERROR: $0:$LINENO"
+   echo "vkvia executable is undefined."
+   echo "Please set VKVIA or use the -v|--via <path> command line option."
+   exit 1
+fi
+
+if [ -z ${CRASH_DRIVER+x} ]; then
+   echo "ERROR: $0:$LINENO"
+   echo "Crashing driver library is undefined."
+   echo "Please set CRASH_DRIVER or use the -d|--driver <path> command line option."
+   exit 1
+fi
+
+if [ -t 1 ] ; then
+    RED='\033[0;31m'
+    GREEN='\033[0;32m'
+    NC='\033[0m' # No Color
+else
+    RED=''
+    GREEN=''
+    NC=''
+fi
+
+OUTPUT_DIR=$(mktemp -d)
+
+printf "$GREEN[ RUN      ]$NC $0\n"
+
+cat > "$OUTPUT_DIR/crash_driver.json" << EOF_MANIFEST
+{
+    "file_format_version": "1.0.0",
+    "ICD": {
+        "library_path": "$CRASH_DRIVER",
+        "api_version": "1.3.0"
+    }
+}
+EOF_MANIFEST
+
+# Only the crashing driver is listed, vkvia fails to find a driver but it must not crash
+VK_DRIVER_FILES="$OUTPUT_DIR/crash_driver.json" "$VKVIA" --disable_cube_tests --disable_headless_tests \
+    --output_path "$OUTPUT_DIR" > "$OUTPUT_DIR/via_output.tmp" 2>&1
+STATUS=$?
+
+RESULT=0
+if [ $STATUS -gt 128 ]; then
+    echo "vkvia crashed with status $STATUS"
+    RESULT=1
+elif [ ! -f "$OUTPUT_DIR/vkvia.html" ]; then
+    echo "vkvia.html was not generated"
+    RESULT=1
+elif ! grep -q "Crashed with signal" "$OUTPUT_DIR/vkvia.html"; then
+    echo "The crash of the driver library is missing from vkvia.html"
+    RESULT=1
+elif ! grep -q "Driver failed to load in a separate process" "$OUTPUT_DIR/vkvia.html"; then
+    echo "The Vulkan API calls were not skipped"
+    RESULT=1
+fi
+
+rm -rf "$OUTPUT_DIR"
+
+if [ $RESULT -eq 0 ]; then
+    printf "$GREEN[  PASSED  ]$NC $0\n"
+else
+    printf "$RED[  FAILED  ]$NC $0\n"
+fi
+
+exit $RESULT
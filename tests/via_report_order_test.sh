@@ -0,0 +1,90 @@
+#!/bin/bash
+
+# via_report_order_test.sh
+# This script will run vkvia several times and check the sections and the tables of
+# the report are in the same order in each run. The parts of the report are collected
+# concurrently, the report must not depend on the scheduling of the threads. The path
+# to the vkvia executable can be defined using the environment variable VKVIA or using
+# the command-line argument -v or --via.
+
+# Track unrecognized arguments.
+UNRECOGNIZED=()
+
+# Parse the command-line arguments.
+while [[ $# -gt 0 ]]
+do
+   KEY="$1"
+   case $KEY in
+      -v|--via)
+      VKVIA="$2"
+      shift
+      shift
+      ;;
+      *)
+      UNRECOGNIZED+=("$1")
+      shift
+      ;;
+   esac
+done
+
+# Reject unrecognized arguments.
+if [[ ${#UNRECOGNIZED[@]} -ne 0 ]]; then
+   echo "ERROR: $0:$LINENO"
+   echo "Unrecognized command-line arguments: ${UNRECOGNIZED[*]}"
+   exit 1
+fi
+
+if [ -z ${VKVIA+x} ]; then
+   echo "ERROR: $0:$LINENO"
+   echo "vkvia executable is undefined."
+   echo "Please set VKVIA or use the -v|--via <path> command line option."
+   exit 1
+fi
+
+if [ -t 1 ] ; then
+    RED='\033[0;31m'
+    GREEN='\033[0;32m'
+    NC='\033[0m' # No Color
+else
+    RED=''
+    GREEN=''
+    NC=''
+fi
+
+OUTPUT_DIR=$(mktemp -d)
+
+printf "$GREEN[ RUN      ]$NC $0\n"
+
+# The result of vkvia depends on the Vulkan drivers of the machine, only the order of the section and table names is
+# compared, the tables of the test applications are disabled.
+RESULT=0
+for RUN in 1 2 3 4 5; do
+    mkdir "$OUTPUT_DIR/$RUN"
+    "$VKVIA" --disable_cube_tests --disable_headless_tests --output_path "$OUTPUT_DIR/$RUN" > "$OUTPUT_DIR/$RUN/via_output.tmp" 2>&1
+    if [ ! -f "$OUTPUT_DIR/$RUN/vkvia.html" ]; then
+        echo "vkvia.html was not generated by run $RUN"
+        RESULT=1
+        break
+    fi
+    grep -o 'class="section"><center>[^<]*\|class="header">[^<]*' "$OUTPUT_DIR/$RUN/vkvia.html" > "$OUTPUT_DIR/$RUN/order.txt"
+    if [ ! -s "$OUTPUT_DIR/$RUN/order.txt" ]; then
+        echo "No section found in vkvia.html of run $RUN"
+        RESULT=1
+        break
+    fi
+    if [ $RUN -gt 1 ] && ! diff "$OUTPUT_DIR/1/order.txt" "$OUTPUT_DIR/$RUN/order.txt"; then
+        echo "The sections of run $RUN are not in the order of run 1"
+        RESULT=1
+        break
+    fi
+done
+
+rm -rf "$OUTPUT_DIR"
+
+if [ $RESULT -eq 0 ]; then
+    printf "$GREEN[  PASSED  ]$NC $0\n"
+else
+    printf "$RED[  FAILED  ]$NC $0\n"
+fi
+
+exit $RESULT
@@ -0,0 +1,84 @@
+#!/bin/bash
+
+# via_test.sh
+# This script will run vkvia with an empty PATH and check the system information
+# sections are still generated. vkvia must only query the system with native calls
+# and must not depend on shell tools being reachable through PATH. The path to the
+# vkvia executable can be defined using the environment variable VKVIA or using
+# the command-line argument -v or --via.
+
+# Track unrecognized arguments.
+UNRECOGNIZED=()
+
+# Parse the command-line arguments.
+while [[ $# -gt 0 ]]
+do
+   KEY="$1"
+   case $KEY in
+      -v|--via)
+      VKVIA="$2"
+      shift
+      shift
+      ;;
+      *)
+      UNRECOGNIZED+=("$1")
+      shift
+      ;;
+   esac
+done
+
+# Reject unrecognized arguments.
+if [[ ${#UNRECOGNIZED[@]} -ne 0 ]]; then
+   echo "ERROR: $0:$LINENO"
+   echo "Unrecognized command-line arguments: ${UNRECOGNIZED[*]}"
+   exit 1
+fi
+
+if [ -z ${VKVIA+x} ]; then
+   echo "ERROR: $0:$LINENO"
+   echo "vkvia executable is undefined."
+   echo "Please set VKVIA or use the -v|--via <path> command line option."
+   exit 1
+fi
+
+if [ -t 1 ] ; then
+    RED='\033[0;31m'
+    GREEN='\033[0;32m'
+    NC='\033[0m' # No Color
+else
+    RED=''
+    GREEN=''
+    NC=''
+fi
+
+OUTPUT_DIR=$(mktemp -d)
+
+printf "$GREEN[ RUN      ]$NC $0\n"
+
+# The result of vkvia depends on the Vulkan drivers of the machine, only the generated sections are checked.
+PATH= "$VKVIA" --disable_cube_tests --output_path "$OUTPUT_DIR" > "$OUTPUT_DIR/via_output.tmp" 2>&1
+
+RESULT=0
+if [ ! -f "$OUTPUT_DIR/vkvia.html" ]; then
+    echo "vkvia.html was not generated"
+    RESULT=1
+elif grep -q "sh: .*not found\|Failure occurred during system call" "$OUTPUT_DIR/via_output.tmp"; then
+    cat "$OUTPUT_DIR/via_output.tmp"
+    RESULT=1
+elif [ -f /etc/os-release ] && ! grep -q "Distro" "$OUTPUT_DIR/vkvia.html"; then
+    echo "Distro is missing from vkvia.html"
+    RESULT=1
+elif ! grep -q "Current Dir Disk Space" "$OUTPUT_DIR/vkvia.html"; then
+    echo "Current Dir Disk Space is missing from vkvia.html"
+    RESULT=1
+fi
+
+rm -rf "$OUTPUT_DIR"
+
+if [ $RESULT -eq 0 ]; then
+    printf "$GREEN[  PASSED  ]$NC $0\n"
+else
+    printf "$RED[  FAILED  ]$NC $0\n"
+fi
+
+exit $RESULT
@@ -31,6 +31,10 @@
 
 int main(int argc, char** argv) {
     int success = 0;
+    if (ViaSystem::RunDriverLoadProcess(argc, argv, success)) {
+        return success;
+    }
+
 #ifdef VIA_WINDOWS_TARGET
     ViaSystem* via_system = reinterpret_cast<ViaSystem*>(new ViaSystemWindows());
 #elif VIA_LINUX_TARGET
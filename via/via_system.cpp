@@ -21,16 +21,42 @@
 #include <sstream>
 #include <cstring>
 #include <map>
+#include <future>
+#include <algorithm>
+#include <iterator>
+#include <cctype>
 
 #include <time.h>
+#include <sys/stat.h>
 #include <vulkan/vulkan.h>
 
 #include "via_system.hpp"
 
 #ifdef VIA_WINDOWS_TARGET
 #include <windows.h>
+#else
+#include <stdlib.h>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <dlfcn.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
 #endif
 
+// Identification of the JSON reports generated with --json_output, the version is incremented when the schema changes
+static const char JSON_REPORT_SCHEMA[] = "via_report";
+static const char JSON_REPORT_DIFF_SCHEMA[] = "via_report_diff";
+static const int JSON_REPORT_SCHEMA_VERSION = 1;
+
+// Argument used by VIA to run itself to load a driver library, see ViaSystem::RunDriverLoadProcess
+static const char DRIVER_LOAD_PROCESS_ARG[] = "--driver_load_process";
+static const uint32_t DEFAULT_DRIVER_LOAD_TIMEOUT = 10;
+
+thread_local ViaSystem::ViaReport* ViaSystem::_current_report = nullptr;
+
 ViaSystem::ViaSystem() {
     _generate_unique_file = false;
     _out_file = "";
@@ -43,6 +69,9 @@ bool ViaSystem::Init(int argc, char** argv) {
     char* output_path = nullptr;
     // Check and handle command-line arguments
     _run_cube_tests = true;
+    _run_headless_tests = true;
+    _profile = false;
+    _driver_load_timeout = DEFAULT_DRIVER_LOAD_TIMEOUT;
     _out_file_format = VIA_HTML_FORMAT;
     if (argc > 1) {
         for (int iii = 1; iii < argc; iii++) {
@@ -53,14 +82,32 @@ bool ViaSystem::Init(int argc, char** argv) {
                 ++iii;
             } else if (0 == strcmp("--disable_cube_tests", argv[iii])) {
                 _run_cube_tests = false;
+            } else if (0 == strcmp("--disable_headless_tests", argv[iii])) {
+                _run_headless_tests = false;
             } else if (0 == strcmp("--vkconfig_output", argv[iii])) {
                 _out_file_format = VIA_VKCONFIG_FORMAT;
+            } else if (0 == strcmp("--driver_timeout", argv[iii]) && argc > (iii + 1) && atoi(argv[iii + 1]) > 0) {
+                _driver_load_timeout = static_cast<uint32_t>(atoi(argv[iii + 1]));
+                ++iii;
+            } else if (0 == strcmp("--profile", argv[iii])) {
+                _profile = true;
+            } else if (0 == strcmp("--json_output", argv[iii])) {
+                _out_file_format = VIA_JSON_FORMAT;
+            } else if (0 == strcmp("--diff", argv[iii]) && argc > (iii + 1)) {
+                _out_file_format = VIA_JSON_FORMAT;
+                _diff_file = argv[iii + 1];
+                ++iii;
             } else {
                 std::cout << "Usage of " << argv[0] << ":" << std::endl
                           << "    " << argv[0]
                           << " [--unique_output] "
                              "[--output_path <path>]"
                              " [--disable_cube_tests]"
+                             " [--disable_headless_tests]"
+                             " [--driver_timeout <seconds>]"
+                             " [--profile]"
+                             " [--json_output]"
+                             " [--diff <old.json>]"
                           << std::endl
                           << "          [--unique_output] Optional "
                              "parameter to generate a unique html"
@@ -77,6 +124,22 @@ bool ViaSystem::Init(int argc, char** argv) {
                           << std::endl
                           << "          [--disable_cube_tests] Optional parameter to disable running cube to test the Vulkan SDK "
                              "installation."
+                          << std::endl
+                          << "          [--disable_headless_tests] Optional parameter to disable running the headless test on each"
+                          << std::endl
+                          << "                                     physical device"
+                          << std::endl
+                          << "          [--driver_timeout <seconds>] Optional parameter to set the time allowed to load each"
+                          << std::endl
+                          << "                                       driver library, 10 seconds by default"
+                          << std::endl
+                          << "          [--profile] Optional parameter to add the time spent in each step to the output"
+                          << std::endl
+                          << "          [--json_output] Optional parameter to generate a JSON report instead of the html output"
+                          << std::endl
+                          << "          [--diff <old.json>] Optional parameter to generate only the changes between the JSON"
+                          << std::endl
+                          << "                              report <old.json> and the current system"
                           << std::endl;
                 return false;
             }
@@ -117,7 +180,8 @@ bool ViaSystem::Init(int argc, char** argv) {
         time(&time_raw_format);
         tm* ptr_time = localtime(&time_raw_format);
         char time_date_filename[512];
-        if (strftime(time_date_filename, 511, "_%Y_%m_%d_%H_%M.html", ptr_time) == 0) {
+        const char* time_date_format = _out_file_format == VIA_HTML_FORMAT ? "_%Y_%m_%d_%H_%M.html" : "_%Y_%m_%d_%H_%M.json";
+        if (strftime(time_date_filename, 511, time_date_format, ptr_time) == 0) {
             LogError("Couldn't generate unique HTML file name for output");
             return false;
         }
@@ -125,11 +189,31 @@ bool ViaSystem::Init(int argc, char** argv) {
     } else {
         if (_out_file_format == VIA_HTML_FORMAT) {
             _out_file += ".html";
-        } else if (_out_file_format == VIA_VKCONFIG_FORMAT) {
+        } else if (_out_file_format == VIA_VKCONFIG_FORMAT || _out_file_format == VIA_JSON_FORMAT) {
             _out_file += ".json";
         }
     }
 
+    // The previous report is loaded before the output file is created, so that the output file can replace it.
+    if (!_diff_file.empty()) {
+        std::ifstream diff_stream(_diff_file);
+        Json::CharReaderBuilder builder;
+        builder["collectComments"] = false;
+        std::string errors;
+        if (diff_stream.fail() || !Json::parseFromStream(builder, diff_stream, &_diff_report, &errors)) {
+            LogError("Failed to read the JSON report " + _diff_file + " " + errors);
+            return false;
+        }
+        if (!_diff_report.isObject() || _diff_report["schema"] != Json::Value(JSON_REPORT_SCHEMA)) {
+            LogError(_diff_file + " is not a VIA JSON report");
+            return false;
+        }
+        if (_diff_report["schema_version"] != Json::Value(JSON_REPORT_SCHEMA_VERSION)) {
+            LogError(_diff_file + " was generated with another version of the VIA JSON report schema");
+            return false;
+        }
+    }
+
     // Write the output file to the current executing directory, or, if
     // that fails, write it out to the user's home folder.
 
@@ -145,6 +229,7 @@ bool ViaSystem::Init(int argc, char** argv) {
     }
 
     // Initialize various variables
+    _report_result = VIA_SUCCESSFUL;
     _found_sdk = false;
     _ran_tests = false;
     _is_system_installed_sdk = false;
@@ -159,17 +244,72 @@ bool ViaSystem::Init(int argc, char** argv) {
     return true;
 }
 
+// CPU time spent by all the threads of the process, user and kernel time
+static double GetProcessCpuTimeMs() {
+#ifdef VIA_WINDOWS_TARGET
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time)) {
+        return 0.0;
+    }
+    // FILETIME values are in 100 nanoseconds units
+    const uint64_t kernel = (static_cast<uint64_t>(kernel_time.dwHighDateTime) << 32) | kernel_time.dwLowDateTime;
+    const uint64_t user = (static_cast<uint64_t>(user_time.dwHighDateTime) << 32) | user_time.dwLowDateTime;
+    return static_cast<double>(kernel + user) / 10000.0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0.0;
+    }
+    const double user_ms = static_cast<double>(usage.ru_utime.tv_sec) * 1000.0 + usage.ru_utime.tv_usec / 1000.0;
+    const double system_ms = static_cast<double>(usage.ru_stime.tv_sec) * 1000.0 + usage.ru_stime.tv_usec / 1000.0;
+    return user_ms + system_ms;
+#endif
+}
+
 bool ViaSystem::GenerateInfo() {
+    const std::chrono::steady_clock::time_point wall_start = std::chrono::steady_clock::now();
+    const double cpu_start_ms = GetProcessCpuTimeMs();
+
     StartOutput("LunarG VIA");
-    ViaResults results = GenerateSystemInfo();
+
+    // The Vulkan API calls don't depend on the system info, probe Vulkan while the system info is collected. The probe
+    // only starts once the driver libraries were loaded in child processes, see GenerateVulkanInfo. As before the
+    // concurrent collection, the Vulkan API calls are only reported when the system info succeeded: the probe is
+    // cancelled when a part of the system info failed before it starts, its part is dropped otherwise.
+    _system_info_failed = false;
+    std::promise<void> driver_checks_promise;
+    const std::shared_future<void> driver_checks_done = driver_checks_promise.get_future().share();
+    ViaReport vulkan_part;
+    std::future<ViaResults> vulkan_task = std::async(std::launch::async, [this, &vulkan_part, driver_checks_done]() {
+        driver_checks_done.wait();
+        if (_system_info_failed) {
+            return VIA_SUCCESSFUL;
+        }
+        return GenerateReportPart(vulkan_part, &ViaSystem::GenerateVulkanInfo, "Vulkan API Calls");
+    });
+
+    ViaResults results = VIA_SUCCESSFUL;
+    {
+        // Destroyed before vulkan_task, whose destructor waits for the Vulkan API calls when the system info throws
+        DriverChecksGuard driver_checks(driver_checks_promise, _system_info_failed);
+        results = GenerateSystemInfo(driver_checks);
+    }
+    ViaResults vulkan_results = vulkan_task.get();
+    ViaResults headless_results = VIA_SUCCESSFUL;
     if (results != VIA_SUCCESSFUL) {
         goto print_results;
     }
-    results = GenerateVulkanInfo();
+    AppendReportPart(vulkan_part);
+    results = vulkan_results;
     if (results != VIA_SUCCESSFUL) {
         goto print_results;
     }
 
+    // A failed headless test doesn't prevent the Vulkan Cube tests from running, it's reported after them
+    if (_run_headless_tests) {
+        headless_results = GenerateHeadlessTestInfo();
+    }
+
     if (_run_cube_tests) {
         results = GenerateTestInfo();
         if (results != VIA_SUCCESSFUL) {
@@ -177,7 +317,18 @@ bool ViaSystem::GenerateInfo() {
         }
     }
 
+    results = headless_results;
+
 print_results:
+    if (_profile) {
+        // The CPU time of the whole process, including all the threads but not the child processes
+        AddProfileEntry("Total", "vkvia",
+                        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wall_start).count(),
+                        GetProcessCpuTimeMs() - cpu_start_ms);
+        PrintProfileInfo();
+    }
+
+    _report_result = results;
     EndOutput();
 
     // Print out a useful message for any common errors.
@@ -275,11 +426,20 @@ ViaSystem::~ViaSystem() {
 #endif
 }
 
-void ViaSystem::LogError(const std::string& error) { std::cerr << "VIA_ERROR:   " << error << std::endl; }
+void ViaSystem::LogError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(_log_mutex);
+    std::cerr << "VIA_ERROR:   " << error << std::endl;
+}
 
-void ViaSystem::LogWarning(const std::string& warning) { std::cerr << "VIA_WARNING: " << warning << std::endl; }
+void ViaSystem::LogWarning(const std::string& warning) {
+    std::lock_guard<std::mutex> lock(_log_mutex);
+    std::cerr << "VIA_WARNING: " << warning << std::endl;
+}
 
-void ViaSystem::LogInfo(const std::string& info) { std::cerr << "VIA_INFO:    " << info << std::endl; }
+void ViaSystem::LogInfo(const std::string& info) {
+    std::lock_guard<std::mutex> lock(_log_mutex);
+    std::cerr << "VIA_INFO:    " << info << std::endl;
+}
 
 bool ViaSystem::IsAbsolutePath(const std::string& path) {
     if (path[0] == _directory_symbol) {
@@ -330,46 +490,69 @@ bool ViaSystem::DetermineJsonLibraryPath(const std::string& json_location, const
     return success;
 }
 
-ViaSystem::ViaResults ViaSystem::GenerateSystemInfo() {
-    ViaResults overall_result = VIA_SUCCESSFUL;
-
-    BeginSection("System Info");
+ViaSystem::DriverChecksGuard::DriverChecksGuard(std::promise<void>& done, std::atomic<bool>& system_info_failed)
+    : _done(&done), _system_info_failed(system_info_failed) {}
 
-    ViaResults result = PrintSystemEnvironmentInfo();
-    if (VIA_SUCCESSFUL != result) {
-        overall_result = result;
-    }
-    result = PrintSystemHardwareInfo();
-    if (VIA_SUCCESSFUL != result) {
-        overall_result = result;
-    }
-    result = PrintSystemExecutableInfo();
-    if (VIA_SUCCESSFUL != result) {
-        overall_result = result;
-    }
-    result = PrintSystemDriverInfo();
-    if (VIA_SUCCESSFUL != result) {
-        overall_result = result;
-    }
-    result = PrintSystemLoaderInfo();
-    if (VIA_SUCCESSFUL != result) {
-        overall_result = result;
+ViaSystem::DriverChecksGuard::~DriverChecksGuard() {
+    if (_done != nullptr) {
+        _system_info_failed = true;
+        _done->set_value();
     }
-    result = PrintSystemSdkInfo();
-    if (VIA_SUCCESSFUL != result) {
-        overall_result = result;
-    }
-    result = PrintSystemImplicitLayerInfo();
-    if (VIA_SUCCESSFUL != result) {
-        overall_result = result;
+}
+
+void ViaSystem::DriverChecksGuard::Done() {
+    _done->set_value();
+    _done = nullptr;
+}
+
+ViaSystem::ViaResults ViaSystem::GenerateSystemInfo(DriverChecksGuard& driver_checks) {
+    ViaResults overall_result = VIA_SUCCESSFUL;
+
+    // Each table is collected in its own part, listed in the canonical order
+    typedef ViaResults (ViaSystem::*PFN_GeneratePart)();
+    const PFN_GeneratePart generate_parts[] = {&ViaSystem::PrintSystemEnvironmentInfo,   &ViaSystem::PrintSystemHardwareInfo,
+                                               &ViaSystem::PrintSystemExecutableInfo,    &ViaSystem::PrintSystemDriverInfo,
+                                               &ViaSystem::PrintSystemLoaderInfo,        &ViaSystem::PrintSystemSdkInfo,
+                                               &ViaSystem::PrintSystemImplicitLayerInfo, &ViaSystem::PrintSystemExplicitLayerInfo,
+                                               &ViaSystem::PrintSystemSettingsFileInfo};
+    const char* part_names[] = {"Environment",     "Hardware",        "Executable",     "Drivers",       "Loader",
+                                "SDK",             "Implicit Layers", "Explicit Layers", "Settings Files"};
+    const size_t part_count = sizeof(generate_parts) / sizeof(generate_parts[0]);
+
+    // Independent parts are generated concurrently. The parts of a chain are generated in sequence: the SDK info
+    // may use the OS name found with the environment info and the explicit layers info uses the override paths
+    // found with the implicit layers info.
+    const std::vector<std::vector<size_t>> chains = {{0, 1, 2, 5}, {3}, {4}, {6, 7}, {8}};
+
+    std::vector<ViaReport> parts(part_count);
+    std::vector<ViaResults> results(part_count, VIA_SUCCESSFUL);
+    std::vector<std::future<void>> tasks;
+    for (size_t i = 0; i < chains.size(); i++) {
+        const std::vector<size_t>& chain = chains[i];
+        tasks.push_back(std::async(std::launch::async, [this, &chain, &generate_parts, &part_names, &parts, &results,
+                                                         &driver_checks]() {
+            for (size_t j = 0; j < chain.size(); j++) {
+                results[chain[j]] = GenerateReportPart(parts[chain[j]], generate_parts[chain[j]], part_names[chain[j]]);
+                if (results[chain[j]] != VIA_SUCCESSFUL) {
+                    _system_info_failed = true;
+                }
+                if (generate_parts[chain[j]] == &ViaSystem::PrintSystemDriverInfo) {
+                    driver_checks.Done();
+                }
+            }
+        }));
     }
-    result = PrintSystemExplicitLayerInfo();
-    if (VIA_SUCCESSFUL != result) {
-        overall_result = result;
+    for (size_t i = 0; i < tasks.size(); i++) {
+        tasks[i].get();
     }
-    result = PrintSystemSettingsFileInfo();
-    if (VIA_SUCCESSFUL != result) {
-        overall_result = result;
+
+    BeginSection("System Info");
+
+    for (size_t i = 0; i < part_count; i++) {
+        AppendReportPart(parts[i]);
+        if (VIA_SUCCESSFUL != results[i]) {
+            overall_result = results[i];
+        }
     }
 
     EndSection();
@@ -379,6 +562,8 @@ ViaSystem::ViaResults ViaSystem::GenerateSystemInfo() {
 // Perform Vulkan commands to find out what extensions are available
 // to a Vulkan Instance, and attempt to create one.
 ViaSystem::ViaResults ViaSystem::GenerateInstanceInfo(void) {
+    ScopedTimer timer(this, "Vulkan", "Instance");
+
     ViaResults res = VIA_SUCCESSFUL;
     VkApplicationInfo app_info{};
     VkInstanceCreateInfo inst_info{};
@@ -455,6 +640,7 @@ ViaSystem::ViaResults ViaSystem::GenerateInstanceInfo(void) {
                 snprintf(generic_string, 1023, "Spec Vers %d", ext_props[iii].specVersion);
                 PrintTableElement(generic_string);
                 PrintEndTableRow();
+                PrintTableRowExtension();
             }
         }
     }
@@ -546,6 +732,8 @@ ViaSystem::ViaResults ViaSystem::GenerateInstanceInfo(void) {
 // the Vulkan commands.  There should be one for each Vulkan capable device
 // on the system.
 ViaSystem::ViaResults ViaSystem::GeneratePhysDevInfo(void) {
+    ScopedTimer timer(this, "Vulkan", "Physical Devices");
+
     ViaResults res = VIA_SUCCESSFUL;
     VkPhysicalDeviceProperties props;
     std::vector<VkPhysicalDevice> min_phys_devices;
@@ -962,6 +1150,7 @@ ViaSystem::ViaResults ViaSystem::GeneratePhysDevInfo(void) {
                         snprintf(generic_string, 1023, "Spec Vers %d", ext_props[jjj].specVersion);
                         PrintTableElement(generic_string);
                         PrintEndTableRow();
+                        PrintTableRowExtension();
                     }
                 }
             }
@@ -1057,6 +1246,8 @@ out:
 // Using the previously determine information, attempt to create a logical
 // device for each physical device we found.
 ViaSystem::ViaResults ViaSystem::GenerateLogicalDeviceInfo() {
+    ScopedTimer timer(this, "Vulkan", "Logical Devices");
+
     ViaResults res = VIA_SUCCESSFUL;
     VkDeviceCreateInfo device_create_info{};
     VkDeviceQueueCreateInfo queue_create_info{};
@@ -1185,6 +1376,8 @@ ViaSystem::ViaResults ViaSystem::GenerateLogicalDeviceInfo() {
 // Clean up all the Vulkan items we previously created and print
 // out if there are any problems.
 void ViaSystem::GenerateCleanupInfo(void) {
+    ScopedTimer timer(this, "Vulkan", "Cleanup");
+
     char generic_string[1024];
     uint32_t dev_count = static_cast<uint32_t>(_vulkan_1_0_info.vk_physical_devices.size());
 
@@ -1256,6 +1449,22 @@ ViaSystem::ViaResults ViaSystem::GenerateVulkanInfo(void) {
 
     BeginSection("Vulkan API Calls");
 
+    // The loader loads all the drivers when the instance is created, a driver can't be excluded without modifying the
+    // environment of VIA while the other threads read it. The Vulkan API calls are skipped instead.
+    if (!_failed_driver_libraries.empty()) {
+        PrintBeginTable("Instance", 3);
+        for (size_t i = 0; i < _failed_driver_libraries.size(); i++) {
+            PrintBeginTableRow();
+            PrintTableElement("vkCreateInstance");
+            PrintTableElement("SKIPPED");
+            PrintTableElement("Driver failed to load in a separate process: " + _failed_driver_libraries[i]);
+            PrintEndTableRow();
+        }
+        PrintEndTable();
+        res = VIA_VULKAN_CANT_FIND_DRIVER;
+        goto out;
+    }
+
     res = GenerateInstanceInfo();
     if (res != VIA_SUCCESSFUL) {
         goto out;
@@ -1281,208 +1490,1166 @@ out:
     return res;
 }
 
-// Print methods
+// Compute shader writing the index of each invocation in a storage buffer:
+//     layout(local_size_x = 64) in;
+//     layout(set = 0, binding = 0) buffer Data { uint values[]; };
+//     void main() { values[gl_GlobalInvocationID.x] = gl_GlobalInvocationID.x; }
+static const uint32_t HEADLESS_TEST_SHADER[] = {
+    0x07230203, 0x00010000, 0x00000000, 0x00000015, 0x00000000, 0x00020011, 0x00000001, 0x0003000e, 0x00000000, 0x00000001,
+    0x0006000f, 0x00000005, 0x00000010, 0x6e69616d, 0x00000000, 0x00000006, 0x00060010, 0x00000010, 0x00000011, 0x00000040,
+    0x00000001, 0x00000001, 0x00040047, 0x00000006, 0x0000000b, 0x0000001c, 0x00040047, 0x00000009, 0x00000006, 0x00000004,
+    0x00050048, 0x0000000a, 0x00000000, 0x00000023, 0x00000000, 0x00030047, 0x0000000a, 0x00000003, 0x00040047, 0x0000000c,
+    0x00000022, 0x00000000, 0x00040047, 0x0000000c, 0x00000021, 0x00000000, 0x00020013, 0x00000001, 0x00030021, 0x00000002,
+    0x00000001, 0x00040015, 0x00000003, 0x00000020, 0x00000000, 0x00040017, 0x00000004, 0x00000003, 0x00000003, 0x00040020,
+    0x00000005, 0x00000001, 0x00000004, 0x0004003b, 0x00000005, 0x00000006, 0x00000001, 0x00040020, 0x00000007, 0x00000001,
+    0x00000003, 0x0004002b, 0x00000003, 0x00000008, 0x00000000, 0x0003001d, 0x00000009, 0x00000003, 0x0003001e, 0x0000000a,
+    0x00000009, 0x00040020, 0x0000000b, 0x00000002, 0x0000000a, 0x0004003b, 0x0000000b, 0x0000000c, 0x00000002, 0x00040015,
+    0x0000000d, 0x00000020, 0x00000001, 0x0004002b, 0x0000000d, 0x0000000e, 0x00000000, 0x00040020, 0x0000000f, 0x00000002,
+    0x00000003, 0x00050036, 0x00000001, 0x00000010, 0x00000000, 0x00000002, 0x000200f8, 0x00000011, 0x00050041, 0x00000007,
+    0x00000012, 0x00000006, 0x00000008, 0x0004003d, 0x00000003, 0x00000013, 0x00000012, 0x00060041, 0x0000000f, 0x00000014,
+    0x0000000c, 0x0000000e, 0x00000013, 0x0003003e, 0x00000014, 0x00000013, 0x000100fd, 0x00010038};
+
+// The shader writes the first half of the buffer which is then copied to the second half
+static const uint32_t HEADLESS_TEST_ELEMENT_COUNT = 256;
+static const uint32_t HEADLESS_TEST_WORKGROUP_SIZE = 64;
+static const uint32_t HEADLESS_TEST_EMPTY_SUBMIT_COUNT = 10;
+static const uint64_t HEADLESS_TEST_FENCE_TIMEOUT = 10000000000ull;  // 10 seconds
+
+struct HeadlessTestResult {
+    bool skipped;
+    bool timed_out;
+    bool dispatch_valid;
+    bool transfer_valid;
+    double submit_ms;
+    double round_trip_ms;
+    double empty_round_trip_ms;
+    std::string error;
+};
+
+static double GetElapsedMs(const std::chrono::steady_clock::time_point& start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
 
-void ViaSystem::StartOutput(const std::string& title) {
-    if (_out_file_format == VIA_HTML_FORMAT) {
-        StartOutputHTML(title);
-    } else if (_out_file_format == VIA_VKCONFIG_FORMAT) {
-        StartOutputVkConfig(title);
+static bool CheckHeadlessTestCall(VkResult status, const char* call, std::string& error) {
+    if (VK_SUCCESS != status) {
+        char generic_string[1024];
+        snprintf(generic_string, 1023, "%s failed - %d", call, status);
+        error = generic_string;
+        return false;
     }
+    return true;
 }
 
-// Close out writing to the file.
-void ViaSystem::EndOutput() {
-    if (_out_file_format == VIA_HTML_FORMAT) {
-        EndOutputHTML();
-    } else if (_out_file_format == VIA_VKCONFIG_FORMAT) {
-        EndOutputVkConfig();
+// Create a device on the physical device, record a compute dispatch followed by a copy of its output, submit it and read back
+// the result. The submission is only performed with the Vulkan API so that it runs without a display.
+static bool RunHeadlessTest(VkPhysicalDevice physical_device, HeadlessTestResult& result) {
+    VkDevice device = VK_NULL_HANDLE;
+    VkQueue queue = VK_NULL_HANDLE;
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkShaderModule shader_module = VK_NULL_HANDLE;
+    VkDescriptorSetLayout set_layout = VK_NULL_HANDLE;
+    VkPipelineLayout pipeline_layout = VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkDescriptorPool descriptor_pool = VK_NULL_HANDLE;
+    VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+    VkCommandPool command_pool = VK_NULL_HANDLE;
+    VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE;
+    void* mapped = NULL;
+    const uint32_t* values = NULL;
+    uint32_t queue_family = UINT32_MAX;
+    uint32_t memory_type = UINT32_MAX;
+    uint32_t count = 0;
+    const float queue_priority = 1.0f;
+    const VkDeviceSize half_size = HEADLESS_TEST_ELEMENT_COUNT * sizeof(uint32_t);
+    std::vector<VkQueueFamilyProperties> queue_families;
+    VkPhysicalDeviceMemoryProperties memory_props{};
+    VkMemoryRequirements memory_reqs{};
+    VkDeviceQueueCreateInfo queue_info{};
+    VkDeviceCreateInfo device_info{};
+    VkBufferCreateInfo buffer_info{};
+    VkMemoryAllocateInfo alloc_info{};
+    VkShaderModuleCreateInfo shader_info{};
+    VkDescriptorSetLayoutBinding binding{};
+    VkDescriptorSetLayoutCreateInfo set_layout_info{};
+    VkPipelineLayoutCreateInfo pipeline_layout_info{};
+    VkComputePipelineCreateInfo pipeline_info{};
+    VkDescriptorPoolSize pool_size{};
+    VkDescriptorPoolCreateInfo pool_info{};
+    VkDescriptorSetAllocateInfo set_alloc_info{};
+    VkDescriptorBufferInfo descriptor_buffer_info{};
+    VkWriteDescriptorSet write{};
+    VkCommandPoolCreateInfo command_pool_info{};
+    VkCommandBufferAllocateInfo command_buffer_info{};
+    VkCommandBufferBeginInfo begin_info{};
+    VkBufferMemoryBarrier barrier{};
+    VkBufferCopy region{};
+    VkFenceCreateInfo fence_info{};
+    VkSubmitInfo submit_info{};
+    std::chrono::steady_clock::time_point start;
+    VkResult wait_status = VK_SUCCESS;
+    bool success = false;
+
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &count, NULL);
+    queue_families.resize(count);
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &count, queue_families.data());
+    for (uint32_t i = 0; i < count; i++) {
+        // Queues supporting compute operations implicitly support transfer operations
+        if (0 != (queue_families[i].queueFlags & VK_QUEUE_COMPUTE_BIT)) {
+            queue_family = i;
+            break;
+        }
+    }
+    if (UINT32_MAX == queue_family) {
+        result.skipped = true;
+        result.error = "No queue supporting compute operations";
+        goto out;
     }
-}
 
-void ViaSystem::BeginSection(const std::string& section_str) {
-    if (_out_file_format == VIA_HTML_FORMAT) {
-        BeginSectionHTML(section_str);
-    } else if (_out_file_format == VIA_VKCONFIG_FORMAT) {
-        BeginSectionVkConfig(section_str);
+    queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    queue_info.queueFamilyIndex = queue_family;
+    queue_info.queueCount = 1;
+    queue_info.pQueuePriorities = &queue_priority;
+    device_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    device_info.queueCreateInfoCount = 1;
+    device_info.pQueueCreateInfos = &queue_info;
+    if (!CheckHeadlessTestCall(vkCreateDevice(physical_device, &device_info, NULL, &device), "vkCreateDevice", result.error)) {
+        goto out;
     }
-}
+    vkGetDeviceQueue(device, queue_family, 0, &queue);
 
-void ViaSystem::EndSection() {
-    if (_out_file_format == VIA_HTML_FORMAT) {
-        EndSectionHTML();
-    } else if (_out_file_format == VIA_VKCONFIG_FORMAT) {
-        EndSectionVkConfig();
+    buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_info.size = 2 * half_size;
+    buffer_info.usage =
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (!CheckHeadlessTestCall(vkCreateBuffer(device, &buffer_info, NULL, &buffer), "vkCreateBuffer", result.error)) {
+        goto out;
     }
-}
 
-void ViaSystem::PrintStandardText(const std::string& text_str) {
-    if (_out_file_format == VIA_HTML_FORMAT) {
-        PrintStandardTextHTML(text_str);
-    } else if (_out_file_format == VIA_VKCONFIG_FORMAT) {
-        PrintStandardTextVkConfig(text_str);
+    vkGetBufferMemoryRequirements(device, buffer, &memory_reqs);
+    vkGetPhysicalDeviceMemoryProperties(physical_device, &memory_props);
+    for (uint32_t i = 0; i < memory_props.memoryTypeCount; i++) {
+        const VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        if (0 != (memory_reqs.memoryTypeBits & (1u << i)) && flags == (memory_props.memoryTypes[i].propertyFlags & flags)) {
+            memory_type = i;
+            break;
+        }
+    }
+    if (UINT32_MAX == memory_type) {
+        result.error = "No host visible and coherent memory type";
+        goto out;
     }
-}
 
-void ViaSystem::PrintBeginTable(const std::string& table_name, uint32_t num_cols) {
-    if (_out_file_format == VIA_HTML_FORMAT) {
-        PrintBeginTableHTML(table_name, num_cols);
-    } else if (_out_file_format == VIA_VKCONFIG_FORMAT) {
-        PrintBeginTableVkConfig(table_name);
+    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    alloc_info.allocationSize = memory_reqs.size;
+    alloc_info.memoryTypeIndex = memory_type;
+    if (!CheckHeadlessTestCall(vkAllocateMemory(device, &alloc_info, NULL, &memory), "vkAllocateMemory", result.error) ||
+        !CheckHeadlessTestCall(vkBindBufferMemory(device, buffer, memory, 0), "vkBindBufferMemory", result.error) ||
+        !CheckHeadlessTestCall(vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &mapped), "vkMapMemory", result.error)) {
+        goto out;
+    }
+    memset(mapped, 0xFF, static_cast<size_t>(2 * half_size));
+
+    shader_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    shader_info.codeSize = sizeof(HEADLESS_TEST_SHADER);
+    shader_info.pCode = HEADLESS_TEST_SHADER;
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    set_layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    set_layout_info.bindingCount = 1;
+    set_layout_info.pBindings = &binding;
+    if (!CheckHeadlessTestCall(vkCreateShaderModule(device, &shader_info, NULL, &shader_module), "vkCreateShaderModule",
+                               result.error) ||
+        !CheckHeadlessTestCall(vkCreateDescriptorSetLayout(device, &set_layout_info, NULL, &set_layout),
+                               "vkCreateDescriptorSetLayout", result.error)) {
+        goto out;
     }
-}
 
-void ViaSystem::PrintBeginTableRow() {
-    if (_out_file_format == VIA_HTML_FORMAT) {
-        PrintBeginTableRowHTML();
-    } else if (_out_file_format == VIA_VKCONFIG_FORMAT) {
-        PrintBeginTableRowVkConfig();
+    pipeline_layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipeline_layout_info.setLayoutCount = 1;
+    pipeline_layout_info.pSetLayouts = &set_layout;
+    if (!CheckHeadlessTestCall(vkCreatePipelineLayout(device, &pipeline_layout_info, NULL, &pipeline_layout),
+                               "vkCreatePipelineLayout", result.error)) {
+        goto out;
     }
-}
 
-void ViaSystem::PrintTableElement(const std::string& element, ViaElementAlign align) {
-    if (_out_file_format == VIA_HTML_FORMAT) {
-        PrintTableElementHTML(element, align);
-    } else if (_out_file_format == VIA_VKCONFIG_FORMAT) {
-        PrintTableElementVkConfig(element);
+    pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipeline_info.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipeline_info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipeline_info.stage.module = shader_module;
+    pipeline_info.stage.pName = "main";
+    pipeline_info.layout = pipeline_layout;
+    if (!CheckHeadlessTestCall(vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipeline_info, NULL, &pipeline),
+                               "vkCreateComputePipelines", result.error)) {
+        goto out;
     }
-}
 
-void ViaSystem::PrintEndTableRow() {
-    if (_out_file_format == VIA_HTML_FORMAT) {
-        PrintEndTableRowHTML();
-    } else if (_out_file_format == VIA_VKCONFIG_FORMAT) {
-        PrintEndTableRowVkConfig();
+    pool_size.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    pool_size.descriptorCount = 1;
+    pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_info.maxSets = 1;
+    pool_info.poolSizeCount = 1;
+    pool_info.pPoolSizes = &pool_size;
+    if (!CheckHeadlessTestCall(vkCreateDescriptorPool(device, &pool_info, NULL, &descriptor_pool), "vkCreateDescriptorPool",
+                               result.error)) {
+        goto out;
     }
-}
 
-void ViaSystem::PrintEndTable() {
-    if (_out_file_format == VIA_HTML_FORMAT) {
-        PrintEndTableHTML();
-    } else if (_out_file_format == VIA_VKCONFIG_FORMAT) {
-        PrintEndTableVkConfig();
+    set_alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    set_alloc_info.descriptorPool = descriptor_pool;
+    set_alloc_info.descriptorSetCount = 1;
+    set_alloc_info.pSetLayouts = &set_layout;
+    if (!CheckHeadlessTestCall(vkAllocateDescriptorSets(device, &set_alloc_info, &descriptor_set), "vkAllocateDescriptorSets",
+                               result.error)) {
+        goto out;
     }
-}
 
-// HTML methods
+    descriptor_buffer_info.buffer = buffer;
+    descriptor_buffer_info.offset = 0;
+    descriptor_buffer_info.range = half_size;
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = descriptor_set;
+    write.dstBinding = 0;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.pBufferInfo = &descriptor_buffer_info;
+    vkUpdateDescriptorSets(device, 1, &write, 0, NULL);
+
+    command_pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    command_pool_info.queueFamilyIndex = queue_family;
+    command_buffer_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    command_buffer_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    command_buffer_info.commandBufferCount = 1;
+    fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    if (!CheckHeadlessTestCall(vkCreateCommandPool(device, &command_pool_info, NULL, &command_pool), "vkCreateCommandPool",
+                               result.error) ||
+        !CheckHeadlessTestCall(vkCreateFence(device, &fence_info, NULL, &fence), "vkCreateFence", result.error)) {
+        goto out;
+    }
+    command_buffer_info.commandPool = command_pool;
+    if (!CheckHeadlessTestCall(vkAllocateCommandBuffers(device, &command_buffer_info, &command_buffer),
+                               "vkAllocateCommandBuffers", result.error)) {
+        goto out;
+    }
 
-// Start writing to the HTML file by creating the appropriate
-// header information including the appropriate CSS and JavaScript
-// items.
-void ViaSystem::StartOutputHTML(const std::string& title) {
-    _out_ofstream << "<!DOCTYPE html>" << std::endl;
-    _out_ofstream << "<HTML lang=\"en\" xml:lang=\"en\" "
-                     "xmlns=\"http://www.w3.org/1999/xhtml\">"
-                  << std::endl;
-    _out_ofstream << std::endl << "<HEAD>" << std::endl << "    <TITLE>" << title << "</TITLE>" << std::endl;
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (!CheckHeadlessTestCall(vkBeginCommandBuffer(command_buffer, &begin_info), "vkBeginCommandBuffer", result.error)) {
+        goto out;
+    }
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_layout, 0, 1, &descriptor_set, 0, NULL);
+    vkCmdDispatch(command_buffer, HEADLESS_TEST_ELEMENT_COUNT / HEADLESS_TEST_WORKGROUP_SIZE, 1, 1);
+
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = buffer;
+    barrier.offset = 0;
+    barrier.size = half_size;
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 1,
+                         &barrier, 0, NULL);
+
+    region.srcOffset = 0;
+    region.dstOffset = half_size;
+    region.size = half_size;
+    vkCmdCopyBuffer(command_buffer, buffer, buffer, 1, &region);
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    barrier.offset = half_size;
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, NULL, 1, &barrier, 0,
+                         NULL);
+    if (!CheckHeadlessTestCall(vkEndCommandBuffer(command_buffer), "vkEndCommandBuffer", result.error)) {
+        goto out;
+    }
 
-    _out_ofstream << "    <META charset=\"UTF-8\">" << std::endl
-                  << "    <style media=\"screen\" type=\"text/css\">" << std::endl
-                  << "        html {"
-                  << std::endl
-                  // By defining the color first, this won't override the background image
-                  // (unless the images aren't there).
-                  << "            background-color: #0b1e48;"
-                  << std::endl
-                  // The following changes try to load the text image twice (locally, then
-                  // off the web) followed by the background image twice (locally, then
-                  // off the web).  The background color will only show if both background
-                  // image loads fail.  In this way, a user will see their local copy on
-                  // their machine, while a person they share it with will see the web
-                  // images (or the background color).
-                  << "            background-image: url(\"https://vulkan.lunarg.com/img/VIATitle.png\"), "
-                  << "url(\"https://vulkan.lunarg.com/img/VIABackground.jpg\");" << std::endl
-                  << "            background-position: center top, center;" << std::endl
-                  << "            -webkit-background-size: auto, cover;" << std::endl
-                  << "            -moz-background-size: auto, cover;" << std::endl
-                  << "            -o-background-size: auto, cover;" << std::endl
-                  << "            background-size: auto, cover;" << std::endl
-                  << "            background-attachment: scroll, fixed;" << std::endl
-                  << "            background-repeat: no-repeat, no-repeat;" << std::endl
-                  << "        }"
-                  << std::endl
-                  // h1.section is used for section headers, and h1.version is used to
-                  // print out the application version text (which shows up just under
-                  // the title).
-                  << "        h1.section {" << std::endl
-                  << "            font-family: sans-serif;" << std::endl
-                  << "            font-size: 35px;" << std::endl
-                  << "            color: #FFFFFF;" << std::endl
-                  << "        }" << std::endl
-                  << "        h1.version {" << std::endl
-                  << "            font-family: sans-serif;" << std::endl
-                  << "            font-size: 25px;" << std::endl
-                  << "            color: #FFFFFF;" << std::endl
-                  << "        }" << std::endl
-                  << "        h2.note {" << std::endl
-                  << "            font-family: sans-serif;" << std::endl
-                  << "            font-size: 12px;" << std::endl
-                  << "            color: #FFFFFF;" << std::endl
-                  << "        }" << std::endl
-                  << "        table {" << std::endl
-                  << "            min-width: 600px;" << std::endl
-                  << "            width: 70%;" << std::endl
-                  << "            border-collapse: collapse;" << std::endl
-                  << "            border-color: grey;" << std::endl
-                  << "            font-family: sans-serif;" << std::endl
-                  << "        }" << std::endl
-                  << "        td.header {" << std::endl
-                  << "            padding: 18px;" << std::endl
-                  << "            border: 1px solid #ccc;" << std::endl
-                  << "            font-size: 18px;" << std::endl
-                  << "            color: #fff;" << std::endl
-                  << "        }" << std::endl
-                  << "        td.odd {" << std::endl
-                  << "            padding: 10px;" << std::endl
-                  << "            border: 1px solid #ccc;" << std::endl
-                  << "            font-size: 16px;" << std::endl
-                  << "            color: rgb(255, 255, 255);" << std::endl
-                  << "        }" << std::endl
-                  << "        td.even {" << std::endl
-                  << "            padding: 10px;" << std::endl
-                  << "            border: 1px solid #ccc;" << std::endl
-                  << "            font-size: 16px;" << std::endl
-                  << "            color: rgb(220, 220, 220);" << std::endl
-                  << "        }" << std::endl
-                  << "        tr.header {" << std::endl
-                  << "            background-color: rgba(64,64,64,0.75);" << std::endl
-                  << "        }" << std::endl
-                  << "        tr.odd {" << std::endl
-                  << "            background-color: rgba(0,0,0,0.6);" << std::endl
-                  << "        }" << std::endl
-                  << "        tr.even {" << std::endl
-                  << "            background-color: rgba(0,0,0,0.7);" << std::endl
-                  << "        }" << std::endl
-                  << "    </style>" << std::endl
-                  << "    <script src=\"https://ajax.googleapis.com/ajax/libs/jquery/"
-                  << "2.2.4/jquery.min.js\"></script>" << std::endl
-                  << "    <script type=\"text/javascript\">" << std::endl
-                  << "        $( document ).ready(function() {" << std::endl
-                  << "            $('table tr:not(.header)').hide();" << std::endl
-                  << "            $('.header').click(function() {" << std::endl
-                  << "                "
-                     "$(this).nextUntil('tr.header').slideToggle(300);"
-                  << std::endl
-                  << "            });" << std::endl
-                  << "        });" << std::endl
-                  << "    </script>" << std::endl
-                  << "</HEAD>" << std::endl
-                  << std::endl
-                  << "<BODY>" << std::endl
-                  << std::endl;
-    // We need space from the top for the VIA texture
-    for (uint32_t space = 0; space < 15; space++) {
-        _out_ofstream << "    <BR />" << std::endl;
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &command_buffer;
+    start = std::chrono::steady_clock::now();
+    if (!CheckHeadlessTestCall(vkQueueSubmit(queue, 1, &submit_info, fence), "vkQueueSubmit", result.error)) {
+        goto out;
+    }
+    result.submit_ms = GetElapsedMs(start);
+    wait_status = vkWaitForFences(device, 1, &fence, VK_TRUE, HEADLESS_TEST_FENCE_TIMEOUT);
+    if (!CheckHeadlessTestCall(wait_status, "vkWaitForFences", result.error)) {
+        goto out;
     }
+    result.round_trip_ms = GetElapsedMs(start);
 
-    _out_ofstream << "<center><h2 class=\"note\">< NOTE: Click on section name to expand "
-                     "table ></h2></center>"
-                  << std::endl
-                  << "    <BR />" << std::endl;
-}
+    values = static_cast<const uint32_t*>(mapped);
+    result.dispatch_valid = true;
+    result.transfer_valid = true;
+    for (uint32_t i = 0; i < HEADLESS_TEST_ELEMENT_COUNT; i++) {
+        result.dispatch_valid &= values[i] == i;
+        result.transfer_valid &= values[HEADLESS_TEST_ELEMENT_COUNT + i] == i;
+    }
 
-// Close out writing to the HTML file.
-void ViaSystem::EndOutputHTML() { _out_ofstream << "</BODY>" << std::endl << std::endl << "</HTML>" << std::endl; }
+    // Submissions without any work measure the overhead of the driver and the queue
+    for (uint32_t i = 0; i < HEADLESS_TEST_EMPTY_SUBMIT_COUNT; i++) {
+        if (!CheckHeadlessTestCall(vkResetFences(device, 1, &fence), "vkResetFences", result.error)) {
+            goto out;
+        }
+        start = std::chrono::steady_clock::now();
+        if (!CheckHeadlessTestCall(vkQueueSubmit(queue, 0, NULL, fence), "vkQueueSubmit", result.error)) {
+            goto out;
+        }
+        wait_status = vkWaitForFences(device, 1, &fence, VK_TRUE, HEADLESS_TEST_FENCE_TIMEOUT);
+        if (!CheckHeadlessTestCall(wait_status, "vkWaitForFences", result.error)) {
+            goto out;
+        }
+        result.empty_round_trip_ms += GetElapsedMs(start) / HEADLESS_TEST_EMPTY_SUBMIT_COUNT;
+    }
+
+    // The results are only informational: drivers that don't execute the work, like the mock ICD, still pass the test
+    success = true;
+
+out:
+    // The work still pending after a timeout may never complete, waiting for the device could block VIA. The objects can't be
+    // destroyed while in use, they are leaked.
+    if (VK_TIMEOUT == wait_status) {
+        result.timed_out = true;
+        return false;
+    }
+
+    if (VK_NULL_HANDLE != device) {
+        vkDeviceWaitIdle(device);
+        if (VK_NULL_HANDLE != fence) {
+            vkDestroyFence(device, fence, NULL);
+        }
+        if (VK_NULL_HANDLE != command_pool) {
+            vkDestroyCommandPool(device, command_pool, NULL);
+        }
+        if (VK_NULL_HANDLE != descriptor_pool) {
+            vkDestroyDescriptorPool(device, descriptor_pool, NULL);
+        }
+        if (VK_NULL_HANDLE != pipeline) {
+            vkDestroyPipeline(device, pipeline, NULL);
+        }
+        if (VK_NULL_HANDLE != pipeline_layout) {
+            vkDestroyPipelineLayout(device, pipeline_layout, NULL);
+        }
+        if (VK_NULL_HANDLE != set_layout) {
+            vkDestroyDescriptorSetLayout(device, set_layout, NULL);
+        }
+        if (VK_NULL_HANDLE != shader_module) {
+            vkDestroyShaderModule(device, shader_module, NULL);
+        }
+        if (VK_NULL_HANDLE != buffer) {
+            vkDestroyBuffer(device, buffer, NULL);
+        }
+        if (VK_NULL_HANDLE != memory) {
+            vkFreeMemory(device, memory, NULL);
+        }
+        vkDestroyDevice(device, NULL);
+    }
+    return success;
+}
+
+// Run the headless test on each physical device, the test doesn't need a display nor the SDK
+ViaSystem::ViaResults ViaSystem::GenerateHeadlessTestInfo(void) {
+    ScopedTimer timer(this, "Test", "Headless");
+
+    ViaResults res = VIA_SUCCESSFUL;
+    VkApplicationInfo app_info{};
+    VkInstanceCreateInfo inst_info{};
+    VkInstance instance = VK_NULL_HANDLE;
+    std::vector<VkPhysicalDevice> physical_devices;
+    uint32_t gpu_count = 0;
+    VkResult status = VK_SUCCESS;
+    bool timed_out = false;
+    char generic_string[1024];
+
+    app_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+    app_info.pApplicationName = "via";
+    app_info.applicationVersion = 1;
+    app_info.pEngineName = "via";
+    app_info.engineVersion = 1;
+    app_info.apiVersion = VK_API_VERSION_1_0;
+
+    inst_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+    inst_info.pApplicationInfo = &app_info;
+
+    BeginSection("Headless Tests");
+    PrintBeginTable("Headless Test", 3);
+
+    status = vkCreateInstance(&inst_info, NULL, &instance);
+    if (VK_SUCCESS == status) {
+        status = vkEnumeratePhysicalDevices(instance, &gpu_count, NULL);
+    }
+    if (VK_SUCCESS == status) {
+        physical_devices.resize(gpu_count);
+        status = vkEnumeratePhysicalDevices(instance, &gpu_count, physical_devices.data());
+    }
+    if (VK_SUCCESS != status) {
+        PrintBeginTableRow();
+        PrintTableElement("vkCreateInstance [1.0]");
+        snprintf(generic_string, 1023, "ERROR: Failed to create - %d", status);
+        PrintTableElement(generic_string);
+        PrintTableElement("");
+        PrintEndTableRow();
+        res = VIA_TEST_FAILED;
+    }
+
+    for (uint32_t gpu = 0; VK_SUCCESS == status && gpu < gpu_count; gpu++) {
+        VkPhysicalDeviceProperties props{};
+        vkGetPhysicalDeviceProperties(physical_devices[gpu], &props);
+
+        PrintBeginTableRow();
+        snprintf(generic_string, 1023, "[%d]", gpu);
+        PrintTableElement(generic_string);
+        PrintTableElement(props.deviceName);
+        PrintTableElement("");
+        PrintEndTableRow();
+
+        HeadlessTestResult result{};
+        const bool success = RunHeadlessTest(physical_devices[gpu], result);
+        if (result.timed_out) {
+            timed_out = true;
+        }
+
+        if (result.skipped) {
+            PrintBeginTableRow();
+            PrintTableElement("");
+            PrintTableElement("Skipped");
+            PrintTableElement(result.error);
+            PrintEndTableRow();
+            continue;
+        }
+
+        if (!result.error.empty()) {
+            PrintBeginTableRow();
+            PrintTableElement("");
+            PrintTableElement("FAILED!");
+            PrintTableElement(result.error);
+            PrintEndTableRow();
+        }
+        if (result.round_trip_ms > 0.0) {
+            PrintBeginTableRow();
+            PrintTableElement("");
+            PrintTableElement("Compute Dispatch Results");
+            PrintTableElement(result.dispatch_valid ? "Valid" : "Not Valid (informational)");
+            PrintEndTableRow();
+
+            PrintBeginTableRow();
+            PrintTableElement("");
+            PrintTableElement("Transfer Results");
+            PrintTableElement(result.transfer_valid ? "Valid" : "Not Valid (informational)");
+            PrintEndTableRow();
+
+            PrintBeginTableRow();
+            PrintTableElement("");
+            PrintTableElement("Submit Time");
+            snprintf(generic_string, 1023, "%.3f ms", result.submit_ms);
+            PrintTableElement(generic_string);
+            PrintEndTableRow();
+
+            PrintBeginTableRow();
+            PrintTableElement("");
+            PrintTableElement("Round Trip Time");
+            snprintf(generic_string, 1023, "%.3f ms", result.round_trip_ms);
+            PrintTableElement(generic_string);
+            PrintEndTableRow();
+        }
+        if (result.empty_round_trip_ms > 0.0) {
+            PrintBeginTableRow();
+            PrintTableElement("");
+            PrintTableElement("Empty Submit Round Trip Time");
+            snprintf(generic_string, 1023, "%.3f ms", result.empty_round_trip_ms);
+            PrintTableElement(generic_string);
+            PrintEndTableRow();
+        }
+
+        if (!success) {
+            res = VIA_TEST_FAILED;
+        }
+    }
+
+    PrintEndTable();
+    EndSection();
+
+    // The devices that timed out are leaked, the instance can't be destroyed before them
+    if (VK_NULL_HANDLE != instance && !timed_out) {
+        vkDestroyInstance(instance, NULL);
+    }
+
+    return res;
+}
+
+// Report methods
+
+ViaSystem::ViaResults ViaSystem::GenerateReportPart(ViaReport& part, ViaResults (ViaSystem::*generate)(), const std::string& name) {
+    ScopedTimer timer(this, "Section", name);
+
+    ViaReport* previous_report = _current_report;
+    _current_report = &part;
+    ViaResults result = (this->*generate)();
+    _current_report = previous_report;
+    return result;
+}
+
+// Append a part of the report to the current report, the blocks printed outside of a section
+// continue the current section.
+void ViaSystem::AppendReportPart(const ViaReport& part) {
+    for (size_t i = 0; i < part.size(); i++) {
+        const ViaReportSection& section = part[i];
+        if (section.name.empty() && !_current_report->empty() && !_current_report->back().ended) {
+            ViaReportSection& current_section = _current_report->back();
+            current_section.blocks.insert(current_section.blocks.end(), section.blocks.begin(), section.blocks.end());
+            current_section.ended = section.ended;
+        } else {
+            _current_report->push_back(section);
+        }
+    }
+}
+
+// Profiling methods
+
+// CPU time spent by the calling thread, the sections are generated on several threads
+static double GetThreadCpuTimeMs() {
+#ifdef VIA_WINDOWS_TARGET
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+    if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time)) {
+        return 0.0;
+    }
+    // FILETIME values are in 100 nanoseconds units
+    const uint64_t kernel = (static_cast<uint64_t>(kernel_time.dwHighDateTime) << 32) | kernel_time.dwLowDateTime;
+    const uint64_t user = (static_cast<uint64_t>(user_time.dwHighDateTime) << 32) | user_time.dwLowDateTime;
+    return static_cast<double>(kernel + user) / 10000.0;
+#else
+    struct timespec cpu_time;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_time) != 0) {
+        return 0.0;
+    }
+    return static_cast<double>(cpu_time.tv_sec) * 1000.0 + static_cast<double>(cpu_time.tv_nsec) / 1000000.0;
+#endif
+}
+
+ViaSystem::ScopedTimer::ScopedTimer(ViaSystem* via_system, const std::string& category, const std::string& name)
+    : _via_system(via_system->_profile ? via_system : nullptr), _cpu_start_ms(0.0) {
+    if (_via_system == nullptr) {
+        return;
+    }
+    _category = category;
+    _name = name;
+    _wall_start = std::chrono::steady_clock::now();
+    _cpu_start_ms = GetThreadCpuTimeMs();
+}
+
+ViaSystem::ScopedTimer::~ScopedTimer() {
+    if (_via_system == nullptr) {
+        return;
+    }
+    const double wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _wall_start).count();
+    _via_system->AddProfileEntry(_category, _name, wall_ms, GetThreadCpuTimeMs() - _cpu_start_ms);
+}
+
+void ViaSystem::AddProfileEntry(const std::string& category, const std::string& name, double wall_ms, double cpu_ms) {
+    std::lock_guard<std::mutex> lock(_profile_mutex);
+    _profile_entries.push_back(ProfileEntry{category, name, wall_ms, cpu_ms});
+}
+
+void ViaSystem::PrintProfileInfo() {
+    // The entries are recorded in completion order by several threads, group them by category in a fixed order
+    static const char* category_order[] = {"Total", "Section", "Vulkan", "Driver", "Layer manifest", "Settings file", "Test"};
+    const size_t category_count = sizeof(category_order) / sizeof(category_order[0]);
+
+    std::vector<ProfileEntry> entries;
+    {
+        std::lock_guard<std::mutex> lock(_profile_mutex);
+        entries = _profile_entries;
+    }
+    std::stable_sort(entries.begin(), entries.end(), [&](const ProfileEntry& a, const ProfileEntry& b) {
+        size_t a_rank = std::find(category_order, category_order + category_count, a.category) - category_order;
+        size_t b_rank = std::find(category_order, category_order + category_count, b.category) - category_order;
+        return a_rank < b_rank;
+    });
+
+    char generic_string[64];
+
+    BeginSection("Profile");
+    PrintBeginTable("Profile", 4);
+
+    PrintBeginTableRow();
+    PrintTableElement("Step");
+    PrintTableElement("Name");
+    PrintTableElement("Wall (ms)");
+    PrintTableElement("CPU (ms)");
+    PrintEndTableRow();
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (i == 0 || entries[i].category != entries[i - 1].category) {
+            PrintBeginTableRow();
+            PrintTableElement(entries[i].category);
+            PrintTableElement("");
+            PrintTableElement("");
+            PrintTableElement("");
+            PrintEndTableRow();
+        }
+
+        PrintBeginTableRow();
+        PrintTableElement("");
+        PrintTableElement(entries[i].name);
+        snprintf(generic_string, sizeof(generic_string), "%.3f", entries[i].wall_ms);
+        PrintTableElement(generic_string, VIA_ALIGN_RIGHT);
+        snprintf(generic_string, sizeof(generic_string), "%.3f", entries[i].cpu_ms);
+        PrintTableElement(generic_string, VIA_ALIGN_RIGHT);
+        PrintEndTableRow();
+    }
+
+    PrintEndTable();
+    EndSection();
+}
+
+// Manifest methods
+
+// Canonical path and identity of a file, the identity changes when the file is modified or replaced
+static bool GetFileIdentity(const std::string& path, std::string& canonical_path, uint64_t& device, uint64_t& inode,
+                            int64_t& modified_time, int64_t& size) {
+#ifdef VIA_WINDOWS_TARGET
+    char full_path[MAX_PATH];
+    if (NULL == _fullpath(full_path, path.c_str(), MAX_PATH)) {
+        return false;
+    }
+    struct _stat64 file_stat;
+    if (0 != _stat64(full_path, &file_stat)) {
+        return false;
+    }
+    canonical_path = full_path;
+#else
+    char* resolved_path = realpath(path.c_str(), NULL);
+    if (NULL == resolved_path) {
+        return false;
+    }
+    canonical_path = resolved_path;
+    free(resolved_path);
+    struct stat file_stat;
+    if (0 != stat(canonical_path.c_str(), &file_stat)) {
+        return false;
+    }
+#endif
+    device = static_cast<uint64_t>(file_stat.st_dev);
+    inode = static_cast<uint64_t>(file_stat.st_ino);  // Always 0 on Windows, the path and the time identify the file
+    modified_time = static_cast<int64_t>(file_stat.st_mtime);
+    size = static_cast<int64_t>(file_stat.st_size);
+    return true;
+}
+
+// Read a whole file into a buffer with a single read
+static bool ReadWholeFile(const std::string& path, int64_t size, std::string& contents) {
+    std::ifstream stream(path, std::ifstream::in | std::ifstream::binary);
+    if (stream.fail()) {
+        return false;
+    }
+    contents.resize(static_cast<size_t>(size));
+    const std::streamsize read_size = stream.rdbuf()->sgetn(&contents[0], static_cast<std::streamsize>(size));
+    contents.resize(static_cast<size_t>(read_size));
+    return true;
+}
+
+// Json::CharReader isn't thread safe, each thread generating a part of the report reuses its own reader
+static Json::CharReader* GetManifestReader() {
+    static thread_local std::unique_ptr<Json::CharReader> reader;
+    if (!reader) {
+        Json::CharReaderBuilder builder;
+        builder["collectComments"] = false;
+        reader.reset(builder.newCharReader());
+    }
+    return reader.get();
+}
+
+std::shared_ptr<const ViaSystem::ViaManifest> ViaSystem::LoadManifest(const std::string& path) {
+    std::string canonical_path;
+    uint64_t device = 0;
+    uint64_t inode = 0;
+    int64_t modified_time = 0;
+    int64_t size = 0;
+    if (!GetFileIdentity(path, canonical_path, device, inode, modified_time, size)) {
+        std::shared_ptr<ViaManifest> missing_manifest = std::make_shared<ViaManifest>();
+        missing_manifest->read = false;
+        return missing_manifest;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_manifest_mutex);
+        std::map<std::string, ViaManifestCacheEntry>::const_iterator it = _manifest_cache.find(canonical_path);
+        if (it != _manifest_cache.end() && it->second.device == device && it->second.inode == inode &&
+            it->second.modified_time == modified_time && it->second.size == size) {
+            return it->second.manifest;
+        }
+    }
+
+    // The file is parsed without holding the lock so that the report parts don't wait for each other
+    std::shared_ptr<ViaManifest> manifest = std::make_shared<ViaManifest>();
+    std::string contents;
+    manifest->read = ReadWholeFile(canonical_path, size, contents);
+    if (!manifest->read) {
+        return manifest;
+    }
+
+    const char* begin = contents.data();
+    if (!GetManifestReader()->parse(begin, begin + contents.size(), &manifest->root, &manifest->errors)) {
+        manifest->root = Json::nullValue;
+    }
+
+    std::lock_guard<std::mutex> lock(_manifest_mutex);
+    _manifest_cache[canonical_path] = ViaManifestCacheEntry{device, inode, modified_time, size, manifest};
+    return manifest;
+}
+
+// Driver load verification methods
+
+bool ViaSystem::RunDriverLoadProcess(int argc, char** argv, int& exit_code) {
+    if (argc != 3 || 0 != strcmp(DRIVER_LOAD_PROCESS_ARG, argv[1])) {
+        return false;
+    }
+
+#ifdef VIA_WINDOWS_TARGET
+    exit_code = -1;
+#else
+    // The load time is written on the first line of the output, followed by the error if the library couldn't be loaded
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    void* handle = dlopen(argv[2], RTLD_NOW | RTLD_LOCAL);
+    const double load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%.3f\n", load_ms);
+    if (NULL == handle) {
+        const char* error = dlerror();
+        printf("%s\n", error != NULL ? error : "Unknown error");
+        exit_code = 1;
+    } else {
+        dlclose(handle);
+        exit_code = 0;
+    }
+    fflush(stdout);
+#endif
+    return true;
+}
+
+#ifndef VIA_WINDOWS_TARGET
+void ViaSystem::StartDriverLoadVerification(const std::string& library_path) {
+    PrintBeginTableRow();
+    PrintTableElement("");
+    PrintTableElement("Library Load");
+    PrintTableElement("");
+    PrintEndTableRow();
+
+    PendingDriverLoad pending;
+    pending.library_path = library_path;
+    pending.row = GetCurrentReportTable().rows.size() - 1;
+    pending.pid = -1;
+    pending.fd = -1;
+
+    // The arguments are prepared before fork, the other threads of VIA may hold locks that the child can't use before exec
+    const char* args[] = {_exe_file.c_str(), DRIVER_LOAD_PROCESS_ARG, library_path.c_str(), NULL};
+
+    int fds[2];
+#if defined(VIA_LINUX_TARGET) || defined(VIA_BSD_TARGET)
+    // The pipe is close-on-exec from its creation, the processes started concurrently by the other threads don't inherit it
+    const bool piped = !_exe_file.empty() && 0 == pipe2(fds, O_CLOEXEC);
+#else
+    std::unique_lock<std::mutex> lock(_process_mutex);
+    const bool piped = !_exe_file.empty() && 0 == pipe(fds);
+    if (piped) {
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    }
+#endif
+    if (piped) {
+        pid_t pid = fork();
+        if (0 == pid) {
+            dup2(fds[1], STDOUT_FILENO);
+            execv(args[0], const_cast<char* const*>(args));
+            _exit(127);
+        }
+
+        close(fds[1]);
+        if (pid > 0) {
+            pending.pid = pid;
+            pending.fd = fds[0];
+        } else {
+            close(fds[0]);
+        }
+    }
+
+    _pending_driver_loads.push_back(pending);
+}
+
+void ViaSystem::FinishDriverLoadVerifications() {
+    // Collect the output of all the child processes until they exit or the timeout expires
+    const std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(_driver_load_timeout);
+    for (;;) {
+        std::vector<struct pollfd> poll_fds;
+        std::vector<size_t> poll_indices;
+        for (size_t i = 0; i < _pending_driver_loads.size(); i++) {
+            if (_pending_driver_loads[i].fd >= 0) {
+                struct pollfd poll_fd = {_pending_driver_loads[i].fd, POLLIN, 0};
+                poll_fds.push_back(poll_fd);
+                poll_indices.push_back(i);
+            }
+        }
+        if (poll_fds.empty()) {
+            break;
+        }
+
+        const int64_t remaining_ms =
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (remaining_ms <= 0) {
+            break;
+        }
+
+        const int ready = poll(&poll_fds[0], static_cast<nfds_t>(poll_fds.size()), static_cast<int>(remaining_ms));
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+
+        for (size_t i = 0; ready > 0 && i < poll_fds.size(); i++) {
+            if (0 == poll_fds[i].revents) {
+                continue;
+            }
+            PendingDriverLoad& pending = _pending_driver_loads[poll_indices[i]];
+            char buffer[256];
+            const ssize_t read_size = read(pending.fd, buffer, sizeof(buffer));
+            if (read_size > 0) {
+                pending.output.append(buffer, static_cast<size_t>(read_size));
+            } else if (read_size == 0 || errno != EINTR) {
+                close(pending.fd);
+                pending.fd = -1;
+            }
+        }
+    }
+
+    ViaReportBlock& table = GetCurrentReportTable();
+    char generic_string[1024];
+
+    for (size_t i = 0; i < _pending_driver_loads.size(); i++) {
+        PendingDriverLoad& pending = _pending_driver_loads[i];
+        std::string status = "FAILED TO LOAD!";
+        std::string result;
+
+        if (pending.pid < 0) {
+            result = "Failed to start the process loading " + pending.library_path;
+        } else {
+            const bool timed_out = pending.fd >= 0;
+            if (timed_out) {
+                kill(pending.pid, SIGKILL);
+                close(pending.fd);
+                pending.fd = -1;
+            }
+
+            int process_status = 0;
+            while (waitpid(pending.pid, &process_status, 0) < 0 && errno == EINTR) {
+            }
+
+            const size_t end_of_time = pending.output.find('\n');
+            const std::string load_time = pending.output.substr(0, end_of_time);
+            if (timed_out) {
+                snprintf(generic_string, 1023, "Timed out after %u seconds", _driver_load_timeout);
+                result = generic_string;
+                _failed_driver_libraries.push_back(pending.library_path);
+            } else if (WIFEXITED(process_status) && 0 == WEXITSTATUS(process_status) && !load_time.empty()) {
+                status = "Library Load";
+                result = "Loaded in " + load_time + " ms";
+            } else if (WIFEXITED(process_status) && 1 == WEXITSTATUS(process_status) && end_of_time != std::string::npos) {
+                result = TrimWhitespace(pending.output.substr(end_of_time + 1));
+            } else if (WIFSIGNALED(process_status)) {
+                snprintf(generic_string, 1023, "Crashed with signal %d", WTERMSIG(process_status));
+                result = generic_string;
+                _failed_driver_libraries.push_back(pending.library_path);
+            } else {
+                result = "Failed to start the process loading " + pending.library_path;
+            }
+        }
+
+        table.rows[pending.row][1].text = status;
+        table.rows[pending.row][2].text = result;
+    }
+
+    _pending_driver_loads.clear();
+}
+#endif
+
+ViaSystem::ViaReportSection& ViaSystem::GetCurrentReportSection() {
+    if (_current_report->empty() || _current_report->back().ended) {
+        _current_report->push_back(ViaReportSection{"", false, {}});
+    }
+    return _current_report->back();
+}
+
+ViaSystem::ViaReportBlock& ViaSystem::GetCurrentReportTable() {
+    ViaReportSection& section = GetCurrentReportSection();
+    if (section.blocks.empty() || !section.blocks.back().is_table) {
+        section.blocks.push_back(ViaReportBlock{true, "", 0, {}});
+    }
+    return section.blocks.back();
+}
+
+// Print methods
+
+void ViaSystem::StartOutput(const std::string& title) {
+    _report_title = title;
+    _report.clear();
+    _current_report = &_report;
+}
+
+// Write the collected report to the file.
+void ViaSystem::EndOutput() {
+    if (_out_file_format == VIA_JSON_FORMAT) {
+        if (_diff_file.empty()) {
+            WriteReportJson(_out_ofstream);
+        } else {
+            // The diff is computed from the same JSON as the one written with --json_output
+            std::stringstream report_stream;
+            WriteReportJson(report_stream);
+            Json::Value report;
+            Json::CharReaderBuilder builder;
+            builder["collectComments"] = false;
+            std::string errors;
+            Json::parseFromStream(builder, report_stream, &report, &errors);
+            WriteReportJsonDiff(_out_ofstream, _diff_report, report);
+        }
+        return;
+    }
+
+    const bool html = _out_file_format == VIA_HTML_FORMAT;
+
+    if (html) {
+        StartOutputHTML(_report_title);
+    } else {
+        StartOutputVkConfig(_report_title);
+    }
+
+    for (size_t i = 0; i < _report.size(); i++) {
+        const ViaReportSection& section = _report[i];
+        if (!section.name.empty()) {
+            if (html) {
+                BeginSectionHTML(section.name);
+            } else {
+                BeginSectionVkConfig(section.name);
+            }
+        }
+
+        for (size_t j = 0; j < section.blocks.size(); j++) {
+            const ViaReportBlock& block = section.blocks[j];
+            if (!block.is_table) {
+                if (html) {
+                    PrintStandardTextHTML(block.name);
+                } else {
+                    PrintStandardTextVkConfig(block.name);
+                }
+                continue;
+            }
+
+            if (html) {
+                PrintBeginTableHTML(block.name, block.num_cols);
+            } else {
+                PrintBeginTableVkConfig(block.name);
+            }
+            for (size_t k = 0; k < block.rows.size(); k++) {
+                const std::vector<ViaReportElement>& row = block.rows[k];
+                if (html) {
+                    PrintBeginTableRowHTML();
+                } else {
+                    PrintBeginTableRowVkConfig();
+                }
+                for (size_t l = 0; l < row.size(); l++) {
+                    if (html) {
+                        PrintTableElementHTML(row[l].text, row[l].align);
+                    } else {
+                        PrintTableElementVkConfig(row[l].text);
+                    }
+                }
+                if (html) {
+                    PrintEndTableRowHTML();
+                } else {
+                    PrintEndTableRowVkConfig();
+                }
+            }
+            if (html) {
+                PrintEndTableHTML();
+            } else {
+                PrintEndTableVkConfig();
+            }
+        }
+
+        if (section.ended) {
+            if (html) {
+                EndSectionHTML();
+            } else {
+                EndSectionVkConfig();
+            }
+        }
+    }
+
+    if (html) {
+        EndOutputHTML();
+    } else {
+        EndOutputVkConfig();
+    }
+}
+
+void ViaSystem::BeginSection(const std::string& section_str) {
+    _current_report->push_back(ViaReportSection{section_str, false, {}});
+}
+
+void ViaSystem::EndSection() { GetCurrentReportSection().ended = true; }
+
+void ViaSystem::PrintStandardText(const std::string& text_str) {
+    GetCurrentReportSection().blocks.push_back(ViaReportBlock{false, text_str, 0, {}});
+}
+
+void ViaSystem::PrintBeginTable(const std::string& table_name, uint32_t num_cols) {
+    GetCurrentReportSection().blocks.push_back(ViaReportBlock{true, table_name, num_cols, {}});
+}
+
+void ViaSystem::PrintBeginTableRow() { GetCurrentReportTable().rows.push_back(std::vector<ViaReportElement>()); }
+
+void ViaSystem::PrintTableElement(const std::string& element, ViaElementAlign align) {
+    ViaReportBlock& table = GetCurrentReportTable();
+    if (table.rows.empty()) {
+        table.rows.push_back(std::vector<ViaReportElement>());
+    }
+    table.rows.back().push_back(ViaReportElement{element, align});
+}
+
+void ViaSystem::PrintEndTableRow() {}
+
+void ViaSystem::PrintTableRowExtension() {
+    ViaReportBlock& table = GetCurrentReportTable();
+    if (!table.rows.empty()) {
+        table.extension_rows.push_back(table.rows.size() - 1);
+    }
+}
+
+void ViaSystem::PrintEndTable() {}
+
+// HTML methods
+
+// Start writing to the HTML file by creating the appropriate
+// header information including the appropriate CSS and JavaScript
+// items.
+void ViaSystem::StartOutputHTML(const std::string& title) {
+    _out_ofstream << "<!DOCTYPE html>" << std::endl;
+    _out_ofstream << "<HTML lang=\"en\" xml:lang=\"en\" "
+                     "xmlns=\"http://www.w3.org/1999/xhtml\">"
+                  << std::endl;
+    _out_ofstream << std::endl << "<HEAD>" << std::endl << "    <TITLE>" << title << "</TITLE>" << std::endl;
+
+    _out_ofstream << "    <META charset=\"UTF-8\">" << std::endl
+                  << "    <style media=\"screen\" type=\"text/css\">" << std::endl
+                  << "        html {"
+                  << std::endl
+                  // By defining the color first, this won't override the background image
+                  // (unless the images aren't there).
+                  << "            background-color: #0b1e48;"
+                  << std::endl
+                  // The following changes try to load the text image twice (locally, then
+                  // off the web) followed by the background image twice (locally, then
+                  // off the web).  The background color will only show if both background
+                  // image loads fail.  In this way, a user will see their local copy on
+                  // their machine, while a person they share it with will see the web
+                  // images (or the background color).
+                  << "            background-image: url(\"https://vulkan.lunarg.com/img/VIATitle.png\"), "
+                  << "url(\"https://vulkan.lunarg.com/img/VIABackground.jpg\");" << std::endl
+                  << "            background-position: center top, center;" << std::endl
+                  << "            -webkit-background-size: auto, cover;" << std::endl
+                  << "            -moz-background-size: auto, cover;" << std::endl
+                  << "            -o-background-size: auto, cover;" << std::endl
+                  << "            background-size: auto, cover;" << std::endl
+                  << "            background-attachment: scroll, fixed;" << std::endl
+                  << "            background-repeat: no-repeat, no-repeat;" << std::endl
+                  << "        }"
+                  << std::endl
+                  // h1.section is used for section headers, and h1.version is used to
+                  // print out the application version text (which shows up just under
+                  // the title).
+                  << "        h1.section {" << std::endl
+                  << "            font-family: sans-serif;" << std::endl
+                  << "            font-size: 35px;" << std::endl
+                  << "            color: #FFFFFF;" << std::endl
+                  << "        }" << std::endl
+                  << "        h1.version {" << std::endl
+                  << "            font-family: sans-serif;" << std::endl
+                  << "            font-size: 25px;" << std::endl
+                  << "            color: #FFFFFF;" << std::endl
+                  << "        }" << std::endl
+                  << "        h2.note {" << std::endl
+                  << "            font-family: sans-serif;" << std::endl
+                  << "            font-size: 12px;" << std::endl
+                  << "            color: #FFFFFF;" << std::endl
+                  << "        }" << std::endl
+                  << "        table {" << std::endl
+                  << "            min-width: 600px;" << std::endl
+                  << "            width: 70%;" << std::endl
+                  << "            border-collapse: collapse;" << std::endl
+                  << "            border-color: grey;" << std::endl
+                  << "            font-family: sans-serif;" << std::endl
+                  << "        }" << std::endl
+                  << "        td.header {" << std::endl
+                  << "            padding: 18px;" << std::endl
+                  << "            border: 1px solid #ccc;" << std::endl
+                  << "            font-size: 18px;" << std::endl
+                  << "            color: #fff;" << std::endl
+                  << "        }" << std::endl
+                  << "        td.odd {" << std::endl
+                  << "            padding: 10px;" << std::endl
+                  << "            border: 1px solid #ccc;" << std::endl
+                  << "            font-size: 16px;" << std::endl
+                  << "            color: rgb(255, 255, 255);" << std::endl
+                  << "        }" << std::endl
+                  << "        td.even {" << std::endl
+                  << "            padding: 10px;" << std::endl
+                  << "            border: 1px solid #ccc;" << std::endl
+                  << "            font-size: 16px;" << std::endl
+                  << "            color: rgb(220, 220, 220);" << std::endl
+                  << "        }" << std::endl
+                  << "        tr.header {" << std::endl
+                  << "            background-color: rgba(64,64,64,0.75);" << std::endl
+                  << "        }" << std::endl
+                  << "        tr.odd {" << std::endl
+                  << "            background-color: rgba(0,0,0,0.6);" << std::endl
+                  << "        }" << std::endl
+                  << "        tr.even {" << std::endl
+                  << "            background-color: rgba(0,0,0,0.7);" << std::endl
+                  << "        }" << std::endl
+                  << "    </style>" << std::endl
+                  << "    <script src=\"https://ajax.googleapis.com/ajax/libs/jquery/"
+                  << "2.2.4/jquery.min.js\"></script>" << std::endl
+                  << "    <script type=\"text/javascript\">" << std::endl
+                  << "        $( document ).ready(function() {" << std::endl
+                  << "            $('table tr:not(.header)').hide();" << std::endl
+                  << "            $('.header').click(function() {" << std::endl
+                  << "                "
+                     "$(this).nextUntil('tr.header').slideToggle(300);"
+                  << std::endl
+                  << "            });" << std::endl
+                  << "        });" << std::endl
+                  << "    </script>" << std::endl
+                  << "</HEAD>" << std::endl
+                  << std::endl
+                  << "<BODY>" << std::endl
+                  << std::endl;
+    // We need space from the top for the VIA texture
+    for (uint32_t space = 0; space < 15; space++) {
+        _out_ofstream << "    <BR />" << std::endl;
+    }
+
+    _out_ofstream << "<center><h2 class=\"note\">< NOTE: Click on section name to expand "
+                     "table ></h2></center>"
+                  << std::endl
+                  << "    <BR />" << std::endl;
+}
+
+// Close out writing to the HTML file.
+void ViaSystem::EndOutputHTML() { _out_ofstream << "</BODY>" << std::endl << std::endl << "</HTML>" << std::endl; }
 
 void ViaSystem::BeginSectionHTML(const std::string& section_str) {
     _out_ofstream << "    <H1 class=\"section\"><center>" << section_str << "</center></h1>" << std::endl;
@@ -1588,6 +2755,458 @@ void ViaSystem::PrintEndTableRowVkConfig() { _out_ofstream << "\n\t\t}"; }
 
 void ViaSystem::PrintEndTableVkConfig() { _out_ofstream << "\n\t}"; }
 
+// JSON report methods
+
+// Location of each table in the JSON report. Every category and table is always written, even when empty, so that
+// reports collected on different machines or at different times have the same layout. Tables missing from this list are
+// written in the "other" category. The rows of a volatile table change from one run to the next on the same system.
+struct ViaJsonTableLocation {
+    const char* table_name;
+    const char* category;
+    const char* key;
+    bool is_volatile;
+};
+
+static const ViaJsonTableLocation JSON_REPORT_TABLES[] = {
+    {"Environment", "system", "environment", false},
+    {"Hardware", "system", "hardware", false},
+    {"Executable Info", "system", "executable", false},
+    {"Vulkan Driver Info", "drivers", "manifests", false},
+    {"Vulkan Runtimes", "loader", "runtimes", false},
+    {"Vulkan SDKs", "loader", "sdks", false},
+    {"Vulkan Implicit Layers", "layers", "implicit", false},
+    {"Vulkan Explicit Layers", "layers", "explicit", false},
+    {"Vulkan Layer Settings File", "layers", "settings_files", false},
+    {"Instance", "devices", "instance", false},
+    {"Physical Devices", "devices", "physical", false},
+    {"Logical Devices", "devices", "logical", false},
+    {"Cleanup", "devices", "cleanup", false},
+    {"Headless Test", "tests", "headless", false},
+    {"Cube", "tests", "cube", false},
+    {"Profile", "profile", "timings", true},
+};
+
+// The rows listing an extension, see PrintTableRowExtension, are moved from these tables to the "extensions" category
+static const ViaJsonTableLocation JSON_REPORT_EXTENSION_TABLES[] = {
+    {"Instance", "extensions", "instance", false},
+    {"Physical Devices", "extensions", "device", false},
+};
+
+// Rows of the other tables that change from one run to the next on the same system, identified by one of their elements:
+// the free disk space and the load time of the driver libraries.
+static const char* JSON_REPORT_VOLATILE_ROWS[] = {"System Disk Space", "Current Dir Disk Space", "Disk Space", "Library Load"};
+
+// Compact JSON writer, the values are written to the stream as they are visited without building a document first.
+class ViaJsonWriter {
+   public:
+    ViaJsonWriter(std::ostream& stream) : _stream(stream), _need_comma(false) {}
+
+    void BeginObject() {
+        Separate();
+        _stream << '{';
+        _need_comma = false;
+    }
+
+    void EndObject() {
+        _stream << '}';
+        _need_comma = true;
+    }
+
+    void BeginArray() {
+        Separate();
+        _stream << '[';
+        _need_comma = false;
+    }
+
+    void EndArray() {
+        _stream << ']';
+        _need_comma = true;
+    }
+
+    void Key(const std::string& key) {
+        Separate();
+        WriteString(key);
+        _stream << ':';
+        _need_comma = false;
+    }
+
+    void String(const std::string& value) {
+        Separate();
+        WriteString(value);
+        _need_comma = true;
+    }
+
+    void Int(int value) {
+        Separate();
+        _stream << value;
+        _need_comma = true;
+    }
+
+    void Bool(bool value) {
+        Separate();
+        _stream << (value ? "true" : "false");
+        _need_comma = true;
+    }
+
+    void Value(const Json::Value& value) {
+        if (value.isObject()) {
+            BeginObject();
+            const std::vector<std::string> names = value.getMemberNames();
+            for (size_t i = 0; i < names.size(); i++) {
+                Key(names[i]);
+                Value(value[names[i]]);
+            }
+            EndObject();
+        } else if (value.isArray()) {
+            BeginArray();
+            for (Json::ArrayIndex i = 0; i < value.size(); i++) {
+                Value(value[i]);
+            }
+            EndArray();
+        } else if (value.isInt()) {
+            Int(value.asInt());
+        } else if (value.isBool()) {
+            Bool(value.asBool());
+        } else if (value.isNull()) {
+            Separate();
+            _stream << "null";
+            _need_comma = true;
+        } else {
+            String(value.asString());
+        }
+    }
+
+   private:
+    void Separate() {
+        if (_need_comma) {
+            _stream << ',';
+        }
+    }
+
+    void WriteString(const std::string& value) {
+        _stream << '\"';
+        for (size_t i = 0; i < value.size(); i++) {
+            const unsigned char c = static_cast<unsigned char>(value[i]);
+            if (c == '\"' || c == '\\') {
+                _stream << '\\' << value[i];
+            } else if (c == '\n') {
+                _stream << "\\n";
+            } else if (c == '\r') {
+                _stream << "\\r";
+            } else if (c == '\t') {
+                _stream << "\\t";
+            } else if (c < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                _stream << escaped;
+            } else {
+                _stream << value[i];
+            }
+        }
+        _stream << '\"';
+    }
+
+    std::ostream& _stream;
+    bool _need_comma;
+};
+
+// The machine key of a row label: lower case alphanumeric words separated by underscores
+static std::string GetJsonRowLabelKey(const std::string& label) {
+    std::string key;
+    for (size_t i = 0; i < label.size(); i++) {
+        const unsigned char c = static_cast<unsigned char>(label[i]);
+        if (isalnum(c)) {
+            key += static_cast<char>(tolower(c));
+        } else if (!key.empty() && key.back() != '_') {
+            key += '_';
+        }
+    }
+    while (!key.empty() && key.back() == '_') {
+        key.pop_back();
+    }
+    return key;
+}
+
+// The rows of a table form a hierarchy: a row with more leading empty elements than the previous ones describes the last
+// of them. The key of a row is the key of the row it describes followed by its label, its first non-empty element. The
+// index of a list item, "[2]" for example, is replaced by the name of the item that follows it, so that the key doesn't
+// change when an item is added before it. An address changes from one run to the next, the index is kept instead. A key
+// used by several rows of a table is suffixed by "#" and its occurrence.
+static std::vector<std::string> GetJsonRowKeys(const std::vector<std::vector<ViaReportElement>>& rows) {
+    std::vector<std::string> keys;
+    std::vector<std::pair<size_t, std::string>> parents;  // Depth and key of the rows described by the current one
+    std::map<std::string, int> occurrences;
+
+    for (size_t i = 0; i < rows.size(); i++) {
+        const std::vector<ViaReportElement>& row = rows[i];
+
+        size_t depth = 0;
+        while (depth < row.size() && row[depth].text.empty()) {
+            depth++;
+        }
+        while (!parents.empty() && parents.back().first >= depth) {
+            parents.pop_back();
+        }
+
+        std::string label = depth < row.size() ? row[depth].text : std::string();
+        const bool is_index = label.size() > 2 && label.front() == '[' && label.back() == ']';
+        if (is_index && depth + 1 < row.size() && !row[depth + 1].text.empty() && row[depth + 1].text.compare(0, 2, "0x") != 0) {
+            label = row[depth + 1].text;
+        }
+
+        std::string key = parents.empty() ? std::string() : parents.back().second + ".";
+        key += GetJsonRowLabelKey(label);
+        const int occurrence = ++occurrences[key];
+        if (occurrence > 1) {
+            key += "#" + std::to_string(occurrence);
+        }
+        parents.push_back(std::make_pair(depth, key));
+        keys.push_back(key);
+    }
+
+    return keys;
+}
+
+void ViaSystem::WriteReportJson(std::ostream& stream) {
+    const size_t table_count = sizeof(JSON_REPORT_TABLES) / sizeof(JSON_REPORT_TABLES[0]);
+    const size_t extension_table_count = sizeof(JSON_REPORT_EXTENSION_TABLES) / sizeof(JSON_REPORT_EXTENSION_TABLES[0]);
+
+    // Gather the tables by location first, the tables of a category are not next to each other in the report
+    std::vector<std::vector<const ViaReportBlock*>> tables(table_count);
+    std::vector<std::vector<const ViaReportBlock*>> extension_tables(extension_table_count);
+    std::map<std::string, std::vector<const ViaReportBlock*>> other_tables;
+    std::vector<std::string> messages;
+    for (size_t i = 0; i < _report.size(); i++) {
+        for (size_t j = 0; j < _report[i].blocks.size(); j++) {
+            const ViaReportBlock& block = _report[i].blocks[j];
+            if (!block.is_table) {
+                messages.push_back(block.name);
+                continue;
+            }
+
+            size_t location = 0;
+            while (location < table_count && block.name != JSON_REPORT_TABLES[location].table_name) {
+                location++;
+            }
+            if (location < table_count) {
+                tables[location].push_back(&block);
+            } else {
+                other_tables[block.name].push_back(&block);
+            }
+
+            for (size_t k = 0; k < extension_table_count; k++) {
+                if (block.name == JSON_REPORT_EXTENSION_TABLES[k].table_name) {
+                    extension_tables[k].push_back(&block);
+                }
+            }
+        }
+    }
+
+    ViaJsonWriter writer(stream);
+
+    // Each row is an object with its machine key and the array of its elements, the trailing empty elements are only used
+    // for the HTML layout. The rows listing an extension are only written in the "extensions" category.
+    auto write_rows = [&writer](const std::vector<const ViaReportBlock*>& blocks, bool is_volatile, bool extensions) {
+        writer.BeginArray();
+        for (size_t i = 0; i < blocks.size(); i++) {
+            const std::vector<std::string> keys = GetJsonRowKeys(blocks[i]->rows);
+            for (size_t j = 0; j < blocks[i]->rows.size(); j++) {
+                const std::vector<size_t>& extension_rows = blocks[i]->extension_rows;
+                if (extensions != (std::find(extension_rows.begin(), extension_rows.end(), j) != extension_rows.end())) {
+                    continue;
+                }
+
+                const std::vector<ViaReportElement>& row = blocks[i]->rows[j];
+                size_t element_count = row.size();
+                while (element_count > 0 && row[element_count - 1].text.empty()) {
+                    element_count--;
+                }
+
+                bool is_volatile_row = is_volatile;
+                for (size_t k = 0; k < element_count && !is_volatile_row; k++) {
+                    for (size_t l = 0; l < sizeof(JSON_REPORT_VOLATILE_ROWS) / sizeof(JSON_REPORT_VOLATILE_ROWS[0]); l++) {
+                        is_volatile_row |= row[k].text == JSON_REPORT_VOLATILE_ROWS[l];
+                    }
+                }
+
+                writer.BeginObject();
+                writer.Key("key");
+                writer.String(keys[j]);
+                writer.Key("values");
+                writer.BeginArray();
+                for (size_t k = 0; k < element_count; k++) {
+                    writer.String(row[k].text);
+                }
+                writer.EndArray();
+                if (is_volatile_row) {
+                    writer.Key("volatile");
+                    writer.Bool(true);
+                }
+                writer.EndObject();
+            }
+        }
+        writer.EndArray();
+    };
+
+    writer.BeginObject();
+    writer.Key("schema");
+    writer.String(JSON_REPORT_SCHEMA);
+    writer.Key("schema_version");
+    writer.Int(JSON_REPORT_SCHEMA_VERSION);
+    writer.Key("title");
+    writer.String(_report_title);
+    writer.Key("via_version");
+    writer.String(_app_version);
+    writer.Key("result");
+    writer.Int(_report_result);
+
+    for (size_t i = 0; i < table_count; i++) {
+        if (i == 0 || strcmp(JSON_REPORT_TABLES[i].category, JSON_REPORT_TABLES[i - 1].category) != 0) {
+            if (i > 0) {
+                writer.EndObject();
+            }
+            writer.Key(JSON_REPORT_TABLES[i].category);
+            writer.BeginObject();
+        }
+        writer.Key(JSON_REPORT_TABLES[i].key);
+        write_rows(tables[i], JSON_REPORT_TABLES[i].is_volatile, false);
+    }
+    writer.EndObject();
+
+    writer.Key("extensions");
+    writer.BeginObject();
+    for (size_t i = 0; i < extension_table_count; i++) {
+        writer.Key(JSON_REPORT_EXTENSION_TABLES[i].key);
+        write_rows(extension_tables[i], false, true);
+    }
+    writer.EndObject();
+
+    writer.Key("other");
+    writer.BeginObject();
+    for (auto it = other_tables.begin(); it != other_tables.end(); ++it) {
+        writer.Key(it->first);
+        write_rows(it->second, false, false);
+    }
+    writer.EndObject();
+
+    writer.Key("messages");
+    writer.BeginArray();
+    for (size_t i = 0; i < messages.size(); i++) {
+        writer.String(messages[i]);
+    }
+    writer.EndArray();
+
+    writer.EndObject();
+    stream << std::endl;
+}
+
+// The rows of a table indexed by their key. The messages are strings, they are their own key.
+static std::map<std::string, Json::Value> GetJsonRowsByKey(const Json::Value& rows) {
+    std::map<std::string, Json::Value> rows_by_key;
+    for (Json::ArrayIndex i = 0; rows.isArray() && i < rows.size(); i++) {
+        const Json::Value& row = rows[i];
+        if (row.isObject()) {
+            rows_by_key[row["key"].asString()] = row;
+        } else if (row.isString()) {
+            rows_by_key[row.asString()] = row;
+        }
+    }
+    return rows_by_key;
+}
+
+// Return the rows added, removed and changed between two versions of a table, or a null value when the table didn't
+// change. The volatile rows are ignored.
+static Json::Value DiffJsonRows(const Json::Value& old_rows, const Json::Value& new_rows) {
+    const std::map<std::string, Json::Value> old_rows_by_key = GetJsonRowsByKey(old_rows);
+    const std::map<std::string, Json::Value> new_rows_by_key = GetJsonRowsByKey(new_rows);
+
+    auto is_volatile = [](const Json::Value& row) { return row.isObject() && row["volatile"].asBool(); };
+
+    Json::Value added(Json::arrayValue);
+    Json::Value removed(Json::arrayValue);
+    Json::Value changed(Json::arrayValue);
+    for (auto it = new_rows_by_key.begin(); it != new_rows_by_key.end(); ++it) {
+        const auto old_it = old_rows_by_key.find(it->first);
+        if (is_volatile(it->second) || (old_it != old_rows_by_key.end() && is_volatile(old_it->second))) {
+            continue;
+        }
+        if (old_it == old_rows_by_key.end()) {
+            added.append(it->second);
+        } else if (old_it->second != it->second) {
+            Json::Value change(Json::objectValue);
+            change["key"] = it->first;
+            change["old"] = old_it->second["values"];
+            change["new"] = it->second["values"];
+            changed.append(change);
+        }
+    }
+    for (auto it = old_rows_by_key.begin(); it != old_rows_by_key.end(); ++it) {
+        if (!is_volatile(it->second) && new_rows_by_key.find(it->first) == new_rows_by_key.end()) {
+            removed.append(it->second);
+        }
+    }
+    if (added.empty() && removed.empty() && changed.empty()) {
+        return Json::nullValue;
+    }
+
+    Json::Value changes(Json::objectValue);
+    changes["added"] = added;
+    changes["removed"] = removed;
+    changes["changed"] = changed;
+    return changes;
+}
+
+static Json::Value DiffJsonValues(const Json::Value& old_value, const Json::Value& new_value) {
+    if (old_value.isObject() || new_value.isObject()) {
+        std::vector<std::string> names = old_value.isObject() ? old_value.getMemberNames() : std::vector<std::string>();
+        if (new_value.isObject()) {
+            const std::vector<std::string> new_names = new_value.getMemberNames();
+            names.insert(names.end(), new_names.begin(), new_names.end());
+        }
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+
+        Json::Value changes(Json::objectValue);
+        for (size_t i = 0; i < names.size(); i++) {
+            const Json::Value& old_member = old_value.isObject() ? old_value[names[i]] : Json::Value::nullSingleton();
+            const Json::Value& new_member = new_value.isObject() ? new_value[names[i]] : Json::Value::nullSingleton();
+            const Json::Value member_changes = DiffJsonValues(old_member, new_member);
+            if (!member_changes.isNull()) {
+                changes[names[i]] = member_changes;
+            }
+        }
+        return changes.empty() ? Json::Value(Json::nullValue) : changes;
+    } else if (old_value.isArray() || new_value.isArray()) {
+        return DiffJsonRows(old_value, new_value);
+    } else if (old_value != new_value) {
+        Json::Value changes(Json::objectValue);
+        changes["old"] = old_value;
+        changes["new"] = new_value;
+        return changes;
+    }
+    return Json::nullValue;
+}
+
+void ViaSystem::WriteReportJsonDiff(std::ostream& stream, const Json::Value& old_report, const Json::Value& new_report) {
+    Json::Value changes = DiffJsonValues(old_report, new_report);
+    if (changes.isNull()) {
+        changes = Json::objectValue;
+    }
+
+    ViaJsonWriter writer(stream);
+    writer.BeginObject();
+    writer.Key("schema");
+    writer.String(JSON_REPORT_DIFF_SCHEMA);
+    writer.Key("schema_version");
+    writer.Int(JSON_REPORT_SCHEMA_VERSION);
+    writer.Key("old_report");
+    writer.String(_diff_file);
+    writer.Key("changes");
+    writer.Value(changes);
+    writer.EndObject();
+    stream << std::endl;
+}
+
 // Trim any whitespace preceeding or following the actual
 // content inside of a string.  The actual items labeled
 // as whitespace are passed in as the second set of
@@ -1636,6 +3255,8 @@ static void ReplaceAllBackslashes(std::string& str) {
 }
 
 void ViaSystem::GenerateSettingsFileJsonInfo(const std::string& settings_file) {
+    ScopedTimer timer(this, "Settings file", settings_file);
+
     std::map<std::string, std::vector<VulkanSettingPair>> settings;
 
     // Load the file from the appropriate location
@@ -1737,7 +3358,7 @@ void ViaSystem::GenerateSettingsFileJsonInfo(const std::string& settings_file) {
 }
 
 // Print out the information stored in an explicit layer's JSON file.
-void ViaSystem::GenerateExplicitLayerJsonInfo(const char* layer_json_filename, Json::Value root) {
+void ViaSystem::GenerateExplicitLayerJsonInfo(const char* layer_json_filename, const Json::Value& root) {
     char generic_string[1024];
     uint32_t ext;
     if (!root["layer"].isNull()) {
@@ -1908,7 +3529,7 @@ void ViaSystem::GenerateExplicitLayerJsonInfo(const char* layer_json_filename, J
 // to disable the layer by default.  Additionally, some implicit
 // layers have an ENABLE environment variable so that they are
 // disabled by default, but can be enabled.
-void ViaSystem::GenerateImplicitLayerJsonInfo(const char* layer_json_filename, Json::Value root,
+void ViaSystem::GenerateImplicitLayerJsonInfo(const char* layer_json_filename, const Json::Value& root,
                                               std::vector<std::string>& override_paths) {
     bool enabled = true;
     bool expired = false;
@@ -2122,7 +3743,11 @@ ViaSystem::ViaResults ViaSystem::GenerateTestInfo(void) {
 
             full_cmd = cube_exe;
             full_cmd += " --c 100 --suppress_popups";
-            int test_result = RunTestInDirectory(path, cube_exe, full_cmd);
+            int test_result;
+            {
+                ScopedTimer timer(this, "Test", full_cmd);
+                test_result = RunTestInDirectory(path, cube_exe, full_cmd);
+            }
 
             PrintBeginTable("Cube", 2);
 
@@ -2143,7 +3768,10 @@ ViaSystem::ViaResults ViaSystem::GenerateTestInfo(void) {
 
             PrintBeginTableRow();
             PrintTableElement(full_cmd);
-            test_result = RunTestInDirectory(path, cube_exe, full_cmd);
+            {
+                ScopedTimer timer(this, "Test", full_cmd);
+                test_result = RunTestInDirectory(path, cube_exe, full_cmd);
+            }
             if (test_result == 0) {
                 PrintTableElement("VIA_SUCCESSFUL");
                 _ran_tests = true;
@@ -22,6 +22,12 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <mutex>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <future>
+#include <atomic>
 
 #include <json/json.h>
 #include <vulkan/vulkan.h>
@@ -36,6 +42,9 @@ class ViaSystem {
     ViaSystem();
     virtual ~ViaSystem();
 
+    // VIA runs itself to load each driver library in an isolated process, returns false when argv isn't such a process
+    static bool RunDriverLoadProcess(int argc, char** argv, int& exit_code);
+
     bool Init(int argc, char** argv);
     bool GenerateInfo();
 
@@ -72,6 +81,105 @@ class ViaSystem {
 
     enum ViaElementAlign { VIA_ALIGN_LEFT = 0, VIA_ALIGN_CENTER, VIA_ALIGN_RIGHT };
 
+    // Report model. The print methods collect the report in memory so that independent parts of the report can be
+    // generated concurrently, the report is only written to the output file in the canonical order by EndOutput.
+    struct ViaReportElement {
+        std::string text;
+        ViaElementAlign align;
+    };
+
+    struct ViaReportBlock {
+        bool is_table;     // Otherwise, the block is a standard text
+        std::string name;  // Table name or standard text
+        uint32_t num_cols;
+        std::vector<std::vector<ViaReportElement>> rows;
+        std::vector<size_t> extension_rows;  // Rows listing an extension, see PrintTableRowExtension
+    };
+
+    struct ViaReportSection {
+        std::string name;  // Empty for blocks printed outside of BeginSection/EndSection
+        bool ended;
+        std::vector<ViaReportBlock> blocks;
+    };
+
+    typedef std::vector<ViaReportSection> ViaReport;
+
+    // The report is collected concurrently by GenerateInfo:
+    // - the Vulkan API calls are probed on their own thread, once the Drivers part is generated;
+    // - each chain of system info parts runs on its own thread, see GenerateSystemInfo;
+    // - the headless and Vulkan Cube tests run on the main thread once all the parts are appended.
+    // Each thread prints to its own part through the thread_local _current_report. The parts are appended to _report
+    // in the canonical order once every thread finished, so the report is the same whatever the scheduling. The state
+    // shared by the threads is guarded: _log_mutex for the log, _profile_mutex for the profile entries, _manifest_mutex
+    // for the manifest cache and _process_mutex for the creation of child processes. Any other member written by a part
+    // is only read by a later part of the same chain, or once the threads are joined.
+
+    // Generate a part of the report on the calling thread, the print methods called by 'generate' are collected in 'part'
+    ViaResults GenerateReportPart(ViaReport& part, ViaResults (ViaSystem::*generate)(), const std::string& name);
+    void AppendReportPart(const ViaReport& part);
+    ViaReportSection& GetCurrentReportSection();
+    ViaReportBlock& GetCurrentReportTable();
+
+    // Measure the wall and CPU time spent in a scope, only when profiling is enabled with --profile
+    class ScopedTimer {
+       public:
+        ScopedTimer(ViaSystem* via_system, const std::string& category, const std::string& name);
+        ~ScopedTimer();
+
+       private:
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        ViaSystem* _via_system;
+        std::string _category;
+        std::string _name;
+        std::chrono::steady_clock::time_point _wall_start;
+        double _cpu_start_ms;
+    };
+
+    // Unblocks the Vulkan API calls waiting for the driver checks on every exit path of the system info: when the Drivers part
+    // ended, or when the system info ends without it because of an early failure or an exception, which cancels the calls.
+    class DriverChecksGuard {
+       public:
+        DriverChecksGuard(std::promise<void>& done, std::atomic<bool>& system_info_failed);
+        ~DriverChecksGuard();
+
+        void Done();  // Called once by the Drivers part
+
+       private:
+        DriverChecksGuard(const DriverChecksGuard&) = delete;
+        DriverChecksGuard& operator=(const DriverChecksGuard&) = delete;
+
+        std::promise<void>* _done;  // nullptr once the value is set
+        std::atomic<bool>& _system_info_failed;
+    };
+
+    struct ProfileEntry {
+        std::string category;
+        std::string name;
+        double wall_ms;
+        double cpu_ms;
+    };
+
+    void AddProfileEntry(const std::string& category, const std::string& name, double wall_ms, double cpu_ms);
+    void PrintProfileInfo();
+
+    // JSON manifest shared by all the scans finding the same file: drivers, implicit and explicit layers and SDK layers
+    struct ViaManifest {
+        bool read;           // The file could be read
+        Json::Value root;    // Json::nullValue when the file couldn't be parsed
+        std::string errors;  // Parsing errors
+    };
+
+    // Read and parse a manifest, the file is only parsed again when it's modified
+    std::shared_ptr<const ViaManifest> LoadManifest(const std::string& path);
+
+    // Driver libraries are loaded in child processes running in parallel so that a driver crashing or hanging while it's loaded
+    // doesn't stop VIA. A row of the current table is reserved for each library and filled once all the drivers are verified.
+    // The Vulkan API calls wait for the verification so that VIA doesn't load in-process a driver that crashed or hung.
+    void StartDriverLoadVerification(const std::string& library_path);
+    void FinishDriverLoadVerifications();
+
     // Print methods
     void StartOutput(const std::string& title);
     void EndOutput();
@@ -82,6 +190,8 @@ class ViaSystem {
     void PrintBeginTableRow();
     void PrintTableElement(const std::string& element, ViaElementAlign align = VIA_ALIGN_LEFT);
     void PrintEndTableRow();
+    // The current row lists an extension, it's written in the "extensions" category of the JSON report
+    void PrintTableRowExtension();
     void PrintEndTable();
 
     // HTML methods
@@ -108,6 +218,10 @@ class ViaSystem {
     void PrintEndTableRowVkConfig();
     void PrintEndTableVkConfig();
 
+    // JSON report methods
+    void WriteReportJson(std::ostream& stream);
+    void WriteReportJsonDiff(std::ostream& stream, const Json::Value& old_report, const Json::Value& new_report);
+
     // Logging methods
     void LogError(const std::string& error);
     void LogWarning(const std::string& warning);
@@ -139,12 +253,14 @@ class ViaSystem {
     virtual bool CheckExpiration(OverrideExpiration expiration) = 0;
 
     // Non-overrideable capture functions
-    ViaResults GenerateSystemInfo();
+    ViaResults GenerateSystemInfo(DriverChecksGuard& driver_checks);
     ViaResults GenerateVulkanInfo();
     ViaResults GenerateTestInfo();
+    ViaResults GenerateHeadlessTestInfo();
     void GenerateSettingsFileJsonInfo(const std::string& settings_file);
-    void GenerateExplicitLayerJsonInfo(const char* layer_json_filename, Json::Value root);
-    void GenerateImplicitLayerJsonInfo(const char* layer_json_filename, Json::Value root, std::vector<std::string>& override_paths);
+    void GenerateExplicitLayerJsonInfo(const char* layer_json_filename, const Json::Value& root);
+    void GenerateImplicitLayerJsonInfo(const char* layer_json_filename, const Json::Value& root,
+                                       std::vector<std::string>& override_paths);
     ViaResults GenerateInstanceInfo(void);
     ViaResults GeneratePhysDevInfo(void);
     ViaResults GenerateLogicalDeviceInfo();
@@ -182,16 +298,57 @@ class ViaSystem {
     std::string _home_path;
     std::string _app_version;
     std::string _exe_path;
+    std::string _exe_file;
     std::string _cur_path;
     std::string _out_file;
     std::string _full_out_file;
     std::ofstream _out_ofstream;
+    std::string _report_title;
+    ViaReport _report;
+    ViaResults _report_result;
+    static thread_local ViaReport* _current_report;
+    std::mutex _log_mutex;
+    std::vector<ProfileEntry> _profile_entries;
+    std::mutex _profile_mutex;
+
+    // Manifests indexed by canonical path, the identity of the file is used to detect modifications
+    struct ViaManifestCacheEntry {
+        uint64_t device;
+        uint64_t inode;
+        int64_t modified_time;
+        int64_t size;
+        std::shared_ptr<const ViaManifest> manifest;
+    };
+    std::map<std::string, ViaManifestCacheEntry> _manifest_cache;
+    std::mutex _manifest_mutex;
+
+    struct PendingDriverLoad {
+        std::string library_path;
+        size_t row;  // Row of the current table where the result is printed
+        int pid;
+        int fd;  // Standard output of the child process, -1 once it was closed
+        std::string output;
+    };
+    std::vector<PendingDriverLoad> _pending_driver_loads;
+
+    // Can be read once the driver checks of GenerateInfo are done, see DriverChecksGuard
+    std::vector<std::string> _failed_driver_libraries;  // Crashed or timed out while loading in a child process
+    std::atomic<bool> _system_info_failed;  // Set by the first system info part that fails, cancels the Vulkan API calls
+
+    // Serializes the creation of child processes on the platforms without pipe2, so that a child process doesn't
+    // inherit the pipe of another one before it's marked close-on-exec
+    std::mutex _process_mutex;
 
     // Command Line Argument items
     bool _run_cube_tests;
+    bool _run_headless_tests;
+    bool _profile;
+    uint32_t _driver_load_timeout;  // In seconds
 
-    enum ViaFileFormat { VIA_HTML_FORMAT = 0, VIA_VKCONFIG_FORMAT };
+    enum ViaFileFormat { VIA_HTML_FORMAT = 0, VIA_VKCONFIG_FORMAT, VIA_JSON_FORMAT };
     ViaFileFormat _out_file_format;
+    std::string _diff_file;
+    Json::Value _diff_report;
 
     // SDK items
     bool _found_sdk;
@@ -41,6 +41,7 @@ ViaSystemBSD::ViaSystemBSD() : ViaSystem() {
     int ret = sysctl(tmp_mib, sizeof(tmp_mib) / sizeof(tmp_mib[0]), temp_c_string, &len, NULL, 0);
     if (ret == 0) {
         std::string exe_location = temp_c_string;
+        _exe_file = exe_location;
         _exe_path = exe_location.substr(0, exe_location.rfind("/"));
     } else {
         _exe_path = "";
@@ -365,7 +366,10 @@ static bool FindBSDSystemObject(ViaSystemBSD *via_sys_bsd, std::string object_na
     // LD_LIBRARY_PATH may have multiple folders listed in it (colon
     // ':' delimited)
     if (env_value != NULL) {
-        char *tok = strtok(env_value, ":");
+        // Tokenize a copy, the environment is also read by the report parts generated concurrently
+        std::string tok_buffer = env_value;
+        char *tok_context = NULL;
+        char *tok = strtok_r(&tok_buffer[0], ":", &tok_context);
         while (tok != NULL) {
             if (strlen(tok) > 0) {
                 path_to_check = tok;
@@ -376,7 +380,7 @@ static bool FindBSDSystemObject(ViaSystemBSD *via_sys_bsd, std::string object_na
                     found_one = true;
                 }
             }
-            tok = strtok(NULL, ":");
+            tok = strtok_r(NULL, ":", &tok_context);
         }
     }
 
@@ -384,31 +388,19 @@ out:
     return found_one;
 }
 
-static bool VerifyOpen(std::string library_file, std::string &error) {
-    bool success = false;
-    void *handle = dlopen(library_file.c_str(), RTLD_NOW | RTLD_LOCAL);
-    if (NULL == handle) {
-        error = dlerror();
-    } else {
-        dlclose(handle);
-        success = true;
-    }
-    return success;
-}
-
 bool ViaSystemBSD::ReadDriverJson(std::string cur_driver_json, bool &found_lib) {
+    ScopedTimer timer(this, "Driver", cur_driver_json);
+
     bool found_json = false;
-    std::ifstream *stream = NULL;
-    Json::Value root = Json::nullValue;
+    std::shared_ptr<const ViaManifest> manifest = LoadManifest(cur_driver_json);
+    const Json::Value &root = manifest->root;
     Json::Value inst_exts = Json::nullValue;
     Json::Value dev_exts = Json::nullValue;
-    Json::Reader reader;
     std::string full_driver_path;
     char generic_string[2048];
     uint32_t j = 0;
 
-    stream = new std::ifstream(cur_driver_json.c_str(), std::ifstream::in);
-    if (nullptr == stream || stream->fail()) {
+    if (!manifest->read) {
         PrintBeginTableRow();
         PrintTableElement("");
         PrintTableElement("Error reading JSON file");
@@ -417,11 +409,11 @@ bool ViaSystemBSD::ReadDriverJson(std::string cur_driver_json, bool &found_lib)
         goto out;
     }
 
-    if (!reader.parse(*stream, root, false) || root.isNull()) {
+    if (root.isNull()) {
         PrintBeginTableRow();
         PrintTableElement("");
         PrintTableElement("Error reading JSON file");
-        PrintTableElement(reader.getFormattedErrorMessages());
+        PrintTableElement(manifest->errors);
         PrintEndTableRow();
         goto out;
     }
@@ -463,8 +455,7 @@ bool ViaSystemBSD::ReadDriverJson(std::string cur_driver_json, bool &found_lib)
     if (!root["ICD"]["library_path"].isNull()) {
         std::string driver_name = root["ICD"]["library_path"].asString();
         std::string location;
-        bool could_load = true;
-        std::string load_error;
+        std::string load_path;
         PrintTableElement(driver_name);
         PrintEndTableRow();
 
@@ -472,11 +463,11 @@ bool ViaSystemBSD::ReadDriverJson(std::string cur_driver_json, bool &found_lib)
             // First try the generated path.
             if (access(full_driver_path.c_str(), R_OK) != -1) {
                 found_lib = true;
-                could_load = VerifyOpen(full_driver_path, load_error);
+                load_path = full_driver_path;
             } else if (driver_name.find("/") == std::string::npos) {
                 if (FindBSDSystemObject(this, driver_name, location, CheckDriver, true)) {
                     found_lib = true;
-                    could_load = VerifyOpen(location, load_error);
+                    load_path = location;
                 }
             }
         }
@@ -490,12 +481,9 @@ bool ViaSystemBSD::ReadDriverJson(std::string cur_driver_json, bool &found_lib)
             PrintTableElement("");
             PrintTableElement(generic_string);
             PrintEndTableRow();
-        } else if (!could_load) {
-            PrintBeginTableRow();
-            PrintTableElement("");
-            PrintTableElement("FAILED TO LOAD!");
-            PrintTableElement(load_error);
-            PrintEndTableRow();
+        }
+        if (!load_path.empty()) {
+            StartDriverLoadVerification(load_path);
         }
     } else {
         PrintTableElement("MISSING!");
@@ -557,12 +545,6 @@ bool ViaSystemBSD::ReadDriverJson(std::string cur_driver_json, bool &found_lib)
 
 out:
 
-    if (nullptr != stream) {
-        stream->close();
-        delete stream;
-        stream = NULL;
-    }
-
     return found_json;
 }
 
@@ -578,7 +560,9 @@ void ViaSystemBSD::PrintDriverEnvVarInfo(const char* var, bool& found_json, bool
 
         // These variables may have multiple folders listed in it (colon
         // ':' delimited)
-        char *tok = strtok(env_var_value, ":");
+        std::string tok_buffer = env_var_value;
+        char *tok_context = NULL;
+        char *tok = strtok_r(&tok_buffer[0], ":", &tok_context);
         if (tok != NULL) {
             while (tok != NULL) {
                 if (access(tok, R_OK) != -1) {
@@ -598,7 +582,7 @@ void ViaSystemBSD::PrintDriverEnvVarInfo(const char* var, bool& found_json, bool
                     PrintTableElement("");
                     PrintEndTableRow();
                 }
-                tok = strtok(NULL, ":");
+                tok = strtok_r(NULL, ":", &tok_context);
             }
         } else {
             if (access(env_var_value, R_OK) != -1) {
@@ -704,6 +688,7 @@ ViaSystem::ViaResults ViaSystemBSD::PrintSystemDriverInfo() {
     PrintDriverEnvVarInfo("VK_ICD_FILENAMES", found_json, found_lib);
     PrintDriverEnvVarInfo("VK_ADD_DRIVER_FILES", found_json, found_lib);
 
+    FinishDriverLoadVerifications();
     PrintEndTable();
 
     if (!found_json) {
@@ -937,43 +922,36 @@ ViaSystem::ViaResults ViaSystemBSD::PrintExplicitLayersInFolder(const std::strin
                 cur_layer += "/";
                 cur_layer += cur_ent->d_name;
 
+                ScopedTimer timer(this, "Layer manifest", cur_layer);
+
                 // Parse the JSON file
-                std::ifstream *stream = NULL;
-                stream = new std::ifstream(cur_layer, std::ifstream::in);
-                if (nullptr == stream || stream->fail()) {
+                std::shared_ptr<const ViaManifest> manifest = LoadManifest(cur_layer);
+                if (!manifest->read) {
                     PrintBeginTableRow();
                     PrintTableElement("");
                     PrintTableElement(generic_string, VIA_ALIGN_RIGHT);
                     PrintTableElement(cur_ent->d_name);
                     PrintTableElement("ERROR reading JSON file!");
                     PrintEndTableRow();
+                } else if (manifest->root.isNull()) {
+                    // Report to the user the failure and their
+                    // locations in the document.
+                    PrintBeginTableRow();
+                    PrintTableElement("");
+                    PrintTableElement(generic_string, VIA_ALIGN_RIGHT);
+                    PrintTableElement(cur_ent->d_name);
+                    PrintTableElement(manifest->errors);
+                    PrintEndTableRow();
                 } else {
-                    Json::Value root = Json::nullValue;
-                    Json::Reader reader;
-                    if (!reader.parse(*stream, root, false) || root.isNull()) {
-                        // Report to the user the failure and their
-                        // locations in the document.
-                        PrintBeginTableRow();
-                        PrintTableElement("");
-                        PrintTableElement(generic_string, VIA_ALIGN_RIGHT);
-                        PrintTableElement(cur_ent->d_name);
-                        PrintTableElement(reader.getFormattedErrorMessages());
-                        PrintEndTableRow();
-                    } else {
-                        PrintBeginTableRow();
-                        PrintTableElement("");
-                        PrintTableElement(generic_string, VIA_ALIGN_RIGHT);
-                        PrintTableElement(cur_ent->d_name);
-                        PrintTableElement("");
-                        PrintEndTableRow();
-
-                        // Dump out the standard explicit layer information.
-                        GenerateExplicitLayerJsonInfo(cur_layer.c_str(), root);
-                    }
+                    PrintBeginTableRow();
+                    PrintTableElement("");
+                    PrintTableElement(generic_string, VIA_ALIGN_RIGHT);
+                    PrintTableElement(cur_ent->d_name);
+                    PrintTableElement("");
+                    PrintEndTableRow();
 
-                    stream->close();
-                    delete stream;
-                    stream = NULL;
+                    // Dump out the standard explicit layer information.
+                    GenerateExplicitLayerJsonInfo(cur_layer.c_str(), manifest->root);
                 }
             }
         }
@@ -1166,34 +1144,26 @@ ViaSystem::ViaResults ViaSystemBSD::PrintSystemImplicitLayerInfo() {
                     PrintTableElement("");
                     PrintEndTableRow();
 
-                    std::ifstream *stream = NULL;
-                    stream = new std::ifstream(cur_vulkan_layer_json, std::ifstream::in);
-                    if (nullptr == stream || stream->fail()) {
+                    ScopedTimer timer(this, "Layer manifest", cur_vulkan_layer_json);
+                    std::shared_ptr<const ViaManifest> manifest = LoadManifest(cur_vulkan_layer_json);
+                    if (!manifest->read) {
                         PrintBeginTableRow();
                         PrintTableElement("");
                         PrintTableElement("ERROR reading JSON file!");
                         PrintTableElement("");
                         PrintTableElement("");
                         PrintEndTableRow();
+                    } else if (manifest->root.isNull()) {
+                        // Report to the user the failure and their
+                        // locations in the document.
+                        PrintBeginTableRow();
+                        PrintTableElement("");
+                        PrintTableElement("ERROR parsing JSON file!");
+                        PrintTableElement(manifest->errors);
+                        PrintTableElement("");
+                        PrintEndTableRow();
                     } else {
-                        Json::Value root = Json::nullValue;
-                        Json::Reader reader;
-                        if (!reader.parse(*stream, root, false) || root.isNull()) {
-                            // Report to the user the failure and their
-                            // locations in the document.
-                            PrintBeginTableRow();
-                            PrintTableElement("");
-                            PrintTableElement("ERROR parsing JSON file!");
-                            PrintTableElement(reader.getFormattedErrorMessages());
-                            PrintTableElement("");
-                            PrintEndTableRow();
-                        } else {
-                            GenerateImplicitLayerJsonInfo(cur_vulkan_layer_json, root, _layer_override_search_path);
-                        }
-
-                        stream->close();
-                        delete stream;
-                        stream = NULL;
+                        GenerateImplicitLayerJsonInfo(cur_vulkan_layer_json, manifest->root, _layer_override_search_path);
                     }
                 }
             }
@@ -1219,7 +1189,9 @@ ViaSystem::ViaResults ViaSystemBSD::PrintLayerEnvVar(const char* var) {
     char *env_value = getenv(var);
     std::string cur_json;
     if (NULL != env_value) {
-        char *tok = strtok(env_value, ":");
+        std::string tok_buffer = env_value;
+        char *tok_context = NULL;
+        char *tok = strtok_r(&tok_buffer[0], ":", &tok_context);
         std::string explicit_layer_id = var;
 
         PrintBeginTableRow();
@@ -1238,7 +1210,7 @@ ViaSystem::ViaResults ViaSystemBSD::PrintLayerEnvVar(const char* var) {
                 cur_name << "Path " << offset++;
                 explicit_layer_id = cur_name.str();
                 result = PrintExplicitLayersInFolder(explicit_layer_id, cur_json);
-                tok = strtok(NULL, ":");
+                tok = strtok_r(NULL, ":", &tok_context);
             }
         } else {
             cur_json = env_value;
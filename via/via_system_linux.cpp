@@ -19,25 +19,467 @@
 
 #ifdef VIA_LINUX_TARGET
 
+#include <cerrno>
 #include <cstring>
 #include <sstream>
+#include <iterator>
 #include <algorithm>
 
 #include <stdlib.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <sys/statvfs.h>
 #include <sys/utsname.h>
+#include <sys/wait.h>
 #include <dirent.h>
 #include <unistd.h>
 #include <dlfcn.h>
+#include <elf.h>
+#include <link.h>
 
 #include "via_system_linux.hpp"
 
+// VIA only queries the system with native calls and file parsing so that it doesn't depend on
+// shell tools being installed or reachable through PATH.
+
+// Split a colon ':' delimited list of folders, skipping the empty entries.
+static std::vector<std::string> SplitPathList(const char *path_list) {
+    std::vector<std::string> folders;
+    if (path_list != NULL) {
+        std::stringstream stream(path_list);
+        std::string folder;
+        while (std::getline(stream, folder, ':')) {
+            if (!folder.empty()) {
+                folders.push_back(folder);
+            }
+        }
+    }
+    return folders;
+}
+
+// Search the folders listed in PATH for an executable, similar to 'which'.
+static bool FindExecutableInPath(const std::string &executable, std::string &location) {
+    if (executable.find('/') != std::string::npos) {
+        location = executable;
+        return access(executable.c_str(), X_OK) != -1;
+    }
+
+    const std::vector<std::string> folders = SplitPathList(getenv("PATH"));
+    for (size_t i = 0; i < folders.size(); i++) {
+        const std::string candidate = folders[i] + "/" + executable;
+        struct stat file_stats;
+        if (stat(candidate.c_str(), &file_stats) == 0 && S_ISREG(file_stats.st_mode) && access(candidate.c_str(), X_OK) != -1) {
+            location = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Run an executable with the whitespace separated arguments of the command-line, without going through a shell.
+// Returns 0 when the process exited successfully, -1 otherwise.
+static int RunProcess(const std::string &executable, const std::string &cmd_line) {
+    std::vector<std::string> arguments;
+    std::stringstream stream(cmd_line);
+    std::string argument;
+    while (stream >> argument) {
+        arguments.push_back(argument);
+    }
+    if (arguments.empty()) {
+        arguments.push_back(executable);
+    }
+
+    std::vector<char *> argv;
+    for (size_t i = 0; i < arguments.size(); i++) {
+        argv.push_back(const_cast<char *>(arguments[i].c_str()));
+    }
+    argv.push_back(NULL);
+
+    fflush(stdout);
+    fflush(stderr);
+
+    pid_t pid = fork();
+    if (pid == -1) {
+        return -1;
+    } else if (pid == 0) {
+        execv(executable.c_str(), argv.data());
+        _exit(127);
+    }
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) == -1) {
+        if (errno != EINTR) {
+            return -1;
+        }
+    }
+    return (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : -1;
+}
+
+// Read the value of a key from the os-release file, see os-release(5).
+static bool ReadOsReleaseValue(const std::string &key, std::string &value) {
+    const char *os_release_files[] = {"/etc/os-release", "/usr/lib/os-release"};
+    for (size_t i = 0; i < sizeof(os_release_files) / sizeof(os_release_files[0]); i++) {
+        std::ifstream stream(os_release_files[i]);
+        if (stream.fail()) {
+            continue;
+        }
+
+        std::string line;
+        while (std::getline(stream, line)) {
+            if (line.compare(0, key.size() + 1, key + "=") != 0) {
+                continue;
+            }
+
+            value = line.substr(key.size() + 1);
+            while (!value.empty() && (value.back() == ' ' || value.back() == '\t' || value.back() == '\r')) {
+                value.pop_back();
+            }
+            if (value.size() >= 2 && (value.front() == '\"' || value.front() == '\'') && value.back() == value.front()) {
+                value = value.substr(1, value.size() - 2);
+            }
+            return true;
+        }
+        return false;
+    }
+    return false;
+}
+
+// Read a null terminated string stored in a file buffer, without reading past the end of the buffer.
+static std::string ReadCString(const std::vector<char> &buffer, size_t offset) {
+    if (offset >= buffer.size()) {
+        return "";
+    }
+    return std::string(&buffer[offset], strnlen(&buffer[offset], buffer.size() - offset));
+}
+
+// Format a size in bytes with the largest unit that keeps a non-zero value.
+static std::string FormatByteSize(uint64_t bytes) {
+    char size_string[64];
+    if ((bytes >> 40) > 0x0ULL) {
+        snprintf(size_string, sizeof(size_string), "%u TB", static_cast<uint32_t>(bytes >> 40));
+    } else if ((bytes >> 30) > 0x0ULL) {
+        snprintf(size_string, sizeof(size_string), "%u GB", static_cast<uint32_t>(bytes >> 30));
+    } else if ((bytes >> 20) > 0x0ULL) {
+        snprintf(size_string, sizeof(size_string), "%u MB", static_cast<uint32_t>(bytes >> 20));
+    } else if ((bytes >> 10) > 0x0ULL) {
+        snprintf(size_string, sizeof(size_string), "%u KB", static_cast<uint32_t>(bytes >> 10));
+    } else {
+        snprintf(size_string, sizeof(size_string), "%u bytes", static_cast<uint32_t>(bytes));
+    }
+    return size_string;
+}
+
+// Read the identification, the type and the machine of an ELF header, which are laid out the same way for all classes.
+static bool ReadElfHeader(const std::string &path, ElfW(Ehdr) &header) {
+    std::ifstream stream(path, std::ifstream::in | std::ifstream::binary);
+    if (stream.fail() || !stream.read(reinterpret_cast<char *>(&header), EI_NIDENT + 2 * sizeof(uint16_t))) {
+        return false;
+    }
+    return memcmp(header.e_ident, ELFMAG, SELFMAG) == 0;
+}
+
+// Check the ELF header of a shared object matches the class and the machine of via itself, so that
+// a 32-bit library is never reported for a 64-bit via, or the reverse.
+static bool IsCompatibleElf(const std::string &path) {
+    ElfW(Ehdr) header;
+    if (!ReadElfHeader(path, header)) {
+        return false;
+    }
+
+    // The header of via is only read once, the initialization of local statics is thread-safe
+    static ElfW(Ehdr) self_header;
+    static const bool self_header_read = ReadElfHeader("/proc/self/exe", self_header);
+    if (!self_header_read) {
+        return true;
+    }
+
+    return header.e_ident[EI_CLASS] == self_header.e_ident[EI_CLASS] && header.e_machine == self_header.e_machine;
+}
+
+// Look up a library in the dynamic linker cache written by ldconfig, in both the old "ld.so-1.7.0" and the new
+// "glibc-ld.so.cache1.1" formats. This is the equivalent of 'ldconfig -p'.
+static bool FindInLdSoCache(const std::string &library_name, std::string &location) {
+    static const char old_magic[] = "ld.so-1.7.0";
+    static const char new_magic[] = "glibc-ld.so.cache1.1";
+
+    struct OldHeader {
+        char magic[sizeof(old_magic) - 1];
+        uint32_t nlibs;
+    };
+    struct OldEntry {
+        int32_t flags;
+        uint32_t key;
+        uint32_t value;
+    };
+    struct NewHeader {
+        char magic[sizeof(new_magic) - 1];
+        uint32_t nlibs;
+        uint32_t len_strings;
+        uint8_t flags;
+        uint8_t padding[3];
+        uint32_t extension_offset;
+        uint32_t unused[3];
+    };
+    struct NewEntry {
+        int32_t flags;
+        uint32_t key;
+        uint32_t value;
+        uint32_t osversion;
+        uint64_t hwcap;
+    };
+
+    std::ifstream stream("/etc/ld.so.cache", std::ifstream::in | std::ifstream::binary);
+    if (stream.fail()) {
+        return false;
+    }
+    const std::vector<char> cache((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    const size_t size = cache.size();
+
+    // Collect the candidate paths, the string offsets are relative to 'string_base'
+    std::vector<uint32_t> candidates;
+    size_t string_base = 0;
+
+    size_t new_offset = 0;
+    if (size >= sizeof(OldHeader) && memcmp(cache.data(), old_magic, sizeof(old_magic) - 1) == 0) {
+        OldHeader old_header;
+        memcpy(&old_header, cache.data(), sizeof(old_header));
+        const size_t old_end = sizeof(OldHeader) + static_cast<size_t>(old_header.nlibs) * sizeof(OldEntry);
+        if (old_end > size) {
+            return false;
+        }
+
+        // A new format cache may follow the old one, aligned on its entries
+        new_offset = (old_end + alignof(NewEntry) - 1) & ~(alignof(NewEntry) - 1);
+        if (new_offset + sizeof(NewHeader) > size || memcmp(&cache[new_offset], new_magic, sizeof(new_magic) - 1) != 0) {
+            string_base = old_end;
+            for (uint32_t i = 0; i < old_header.nlibs; i++) {
+                OldEntry entry;
+                memcpy(&entry, &cache[sizeof(OldHeader) + i * sizeof(OldEntry)], sizeof(entry));
+                if (ReadCString(cache, string_base + entry.key) == library_name) {
+                    candidates.push_back(entry.value);
+                }
+            }
+            new_offset = size;
+        }
+    }
+
+    if (new_offset + sizeof(NewHeader) <= size && memcmp(&cache[new_offset], new_magic, sizeof(new_magic) - 1) == 0) {
+        NewHeader new_header;
+        memcpy(&new_header, &cache[new_offset], sizeof(new_header));
+        const size_t entries_offset = new_offset + sizeof(NewHeader);
+        if (entries_offset + static_cast<size_t>(new_header.nlibs) * sizeof(NewEntry) > size) {
+            return false;
+        }
+
+        string_base = new_offset;
+        for (uint32_t i = 0; i < new_header.nlibs; i++) {
+            NewEntry entry;
+            memcpy(&entry, &cache[entries_offset + i * sizeof(NewEntry)], sizeof(entry));
+            if (ReadCString(cache, string_base + entry.key) == library_name) {
+                candidates.push_back(entry.value);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < candidates.size(); i++) {
+        const std::string path = ReadCString(cache, string_base + candidates[i]);
+        if (!path.empty() && IsCompatibleElf(path)) {
+            location = path;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Read the DT_NEEDED, DT_RPATH and DT_RUNPATH entries of the dynamic section of an ELF file of the same class as via.
+static bool ReadElfDynamicEntries(const std::string &path, std::vector<std::string> &needed, std::vector<std::string> &rpaths) {
+    std::ifstream stream(path, std::ifstream::in | std::ifstream::binary);
+    if (stream.fail()) {
+        return false;
+    }
+    const std::vector<char> file((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    ElfW(Ehdr) header;
+    if (file.size() < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.e_ident, ELFMAG, SELFMAG) != 0 || header.e_phentsize != sizeof(ElfW(Phdr)) ||
+        header.e_phoff + static_cast<size_t>(header.e_phnum) * sizeof(ElfW(Phdr)) > file.size()) {
+        return false;
+    }
+
+    std::vector<ElfW(Phdr)> program_headers(header.e_phnum);
+    memcpy(program_headers.data(), &file[header.e_phoff], header.e_phnum * sizeof(ElfW(Phdr)));
+
+    // The dynamic section references its string table by virtual address, find it in the loadable segments
+    const ElfW(Phdr) *dynamic_header = NULL;
+    for (size_t i = 0; i < program_headers.size(); i++) {
+        if (program_headers[i].p_type == PT_DYNAMIC) {
+            dynamic_header = &program_headers[i];
+        }
+    }
+    if (dynamic_header == NULL || dynamic_header->p_offset + dynamic_header->p_filesz > file.size()) {
+        return false;
+    }
+
+    std::vector<ElfW(Dyn)> dynamic_entries(dynamic_header->p_filesz / sizeof(ElfW(Dyn)));
+    memcpy(dynamic_entries.data(), &file[dynamic_header->p_offset], dynamic_entries.size() * sizeof(ElfW(Dyn)));
+
+    ElfW(Addr) string_table_address = 0;
+    for (size_t i = 0; i < dynamic_entries.size() && dynamic_entries[i].d_tag != DT_NULL; i++) {
+        if (dynamic_entries[i].d_tag == DT_STRTAB) {
+            string_table_address = dynamic_entries[i].d_un.d_ptr;
+        }
+    }
+
+    size_t string_table_offset = 0;
+    bool string_table_found = false;
+    for (size_t i = 0; i < program_headers.size(); i++) {
+        const ElfW(Phdr) &segment = program_headers[i];
+        if (segment.p_type == PT_LOAD && string_table_address >= segment.p_vaddr &&
+            string_table_address < segment.p_vaddr + segment.p_filesz) {
+            string_table_offset = segment.p_offset + (string_table_address - segment.p_vaddr);
+            string_table_found = true;
+            break;
+        }
+    }
+    if (!string_table_found) {
+        return false;
+    }
+
+    for (size_t i = 0; i < dynamic_entries.size() && dynamic_entries[i].d_tag != DT_NULL; i++) {
+        const ElfW(Dyn) &entry = dynamic_entries[i];
+        if (entry.d_tag != DT_NEEDED && entry.d_tag != DT_RPATH && entry.d_tag != DT_RUNPATH) {
+            continue;
+        }
+        const std::string value = ReadCString(file, string_table_offset + entry.d_un.d_val);
+        if (value.empty()) {
+            continue;
+        } else if (entry.d_tag == DT_NEEDED) {
+            needed.push_back(value);
+        } else {
+            std::vector<std::string> folders = SplitPathList(value.c_str());
+            rpaths.insert(rpaths.end(), folders.begin(), folders.end());
+        }
+    }
+
+    return true;
+}
+
+static int FindLoadedObjectCallback(struct dl_phdr_info *info, size_t size, void *data) {
+    (void)size;
+    std::pair<std::string, std::string> *search = reinterpret_cast<std::pair<std::string, std::string> *>(data);
+    if (info->dlpi_name != NULL && strstr(info->dlpi_name, search->first.c_str()) != NULL) {
+        search->second = info->dlpi_name;
+        return 1;
+    }
+    return 0;
+}
+
+// Find the path of the shared object, with a name starting by 'prefix', that via was linked against. This is the
+// equivalent of 'ldd': the object is searched in the objects loaded by the process first, and otherwise
+// resolved from the DT_NEEDED entries of the via executable the same way the dynamic linker does.
+static bool FindNeededLibrary(const std::string &prefix, std::string &location) {
+    std::pair<std::string, std::string> search(prefix, "");
+    if (dl_iterate_phdr(FindLoadedObjectCallback, &search) != 0 && search.second.find('/') != std::string::npos) {
+        location = search.second;
+        return true;
+    }
+
+    char exe_path[1024];
+    ssize_t len = ::readlink("/proc/self/exe", exe_path, sizeof(exe_path) - 1);
+    if (len == -1) {
+        return false;
+    }
+    exe_path[len] = '\0';
+    const std::string exe_string = exe_path;
+    const std::string origin = exe_string.substr(0, exe_string.rfind('/'));
+
+    std::vector<std::string> needed;
+    std::vector<std::string> rpaths;
+    if (!ReadElfDynamicEntries(exe_string, needed, rpaths)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < needed.size(); i++) {
+        if (needed[i].compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+
+        // Search order of the dynamic linker, see ld.so(8)
+        std::vector<std::string> folders = SplitPathList(getenv("LD_LIBRARY_PATH"));
+        for (size_t j = 0; j < rpaths.size(); j++) {
+            std::string folder = rpaths[j];
+            const size_t origin_pos = folder.find("$ORIGIN");
+            if (origin_pos != std::string::npos) {
+                folder.replace(origin_pos, strlen("$ORIGIN"), origin);
+            }
+            folders.push_back(folder);
+        }
+        for (size_t j = 0; j < folders.size(); j++) {
+            const std::string candidate = folders[j] + "/" + needed[i];
+            if (access(candidate.c_str(), R_OK) != -1 && IsCompatibleElf(candidate)) {
+                location = candidate;
+                return true;
+            }
+        }
+        if (FindInLdSoCache(needed[i], location)) {
+            return true;
+        }
+        const char *default_folders[] = {"/lib", "/usr/lib", "/lib64", "/usr/lib64"};
+        for (size_t j = 0; j < sizeof(default_folders) / sizeof(default_folders[0]); j++) {
+            const std::string candidate = std::string(default_folders[j]) + "/" + needed[i];
+            if (access(candidate.c_str(), R_OK) != -1 && IsCompatibleElf(candidate)) {
+                location = candidate;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Read the version of an installed package from the dpkg database, the equivalent of 'dpkg-query --show'.
+static bool FindDpkgPackage(const std::string &package, std::string &version) {
+    std::ifstream stream("/var/lib/dpkg/status");
+    if (stream.fail()) {
+        return false;
+    }
+
+    // The database is a list of stanzas separated by empty lines
+    bool package_matches = false;
+    bool installed = false;
+    std::string package_version;
+    std::string line;
+    bool more = true;
+    while (more) {
+        more = static_cast<bool>(std::getline(stream, line));
+        if (!more || line.empty()) {
+            if (package_matches && installed && !package_version.empty()) {
+                version = package_version;
+                return true;
+            }
+            package_matches = false;
+            installed = false;
+            package_version.clear();
+        } else if (line.compare(0, 9, "Package: ") == 0) {
+            package_matches = line.substr(9) == package;
+        } else if (line.compare(0, 8, "Status: ") == 0) {
+            installed = line.size() >= 10 && line.compare(line.size() - 10, 10, " installed") == 0;
+        } else if (line.compare(0, 9, "Version: ") == 0) {
+            package_version = line.substr(9);
+        }
+    }
+    return false;
+}
+
 ViaSystemLinux::ViaSystemLinux() : ViaSystem() {
     char temp_c_string[1024];
     ssize_t len = ::readlink("/proc/self/exe", temp_c_string, 1023);
     if (0 < len) {
+        temp_c_string[len] = '\0';
         std::string exe_location = temp_c_string;
+        _exe_file = exe_location;
         _exe_path = exe_location.substr(0, exe_location.rfind("/"));
     } else {
         _exe_path = "";
@@ -63,19 +505,18 @@ int ViaSystemLinux::RunTestInDirectory(std::string path, std::string test, std::
     if (NULL != getcwd(orig_dir, 1023)) {
         if (path.empty()) {
             // If the path is empty, check system paths.
-            auto const which_query = "which " + test;
-            err_code = system(which_query.c_str());
-            if (err_code != 0) {
+            std::string executable;
+            if (!FindExecutableInPath(test, executable)) {
                 err_code = 1;
                 LogWarning(test + " not found.  Skipping.");
             } else {
-                err_code = system(cmd_line.c_str());
+                err_code = RunProcess(executable, cmd_line);
             }
         } else {
             int err = chdir(path.c_str());
             if (-1 != err) {
                 if (-1 != access(test.c_str(), X_OK)) {
-                    err_code = system(cmd_line.c_str());
+                    err_code = RunProcess(test, cmd_line);
                 } else {
                     // Can't run because it's either not there or an actual
                     // exe.  So, just return a separate error code.
@@ -98,50 +539,29 @@ int ViaSystemLinux::RunTestInDirectory(std::string path, std::string test, std::
 
 ViaSystem::ViaResults ViaSystemLinux::PrintSystemEnvironmentInfo() {
     ViaResults result = VIA_SUCCESSFUL;
-    char path[1035];
     char *env_value;
     utsname uts_buffer;
 
     PrintBeginTable("Environment", 3);
 
-    FILE *fp = popen("cat /etc/os-release", "r");
-    if (fp == NULL) {
+    if (!ReadOsReleaseValue("PRETTY_NAME", _os_name)) {
         PrintBeginTableRow();
         PrintTableElement("ERROR");
-        PrintTableElement("Failed to cat /etc/os-release");
+        PrintTableElement("Failed to read /etc/os-release");
         PrintTableElement("");
         PrintEndTableRow();
         result = VIA_SYSTEM_CALL_FAILURE;
     } else {
-        // Read the output a line at a time - output it.
-        while (fgets(path, sizeof(path) - 1, fp) != NULL) {
-            if (NULL != strstr(path, "PRETTY_NAME")) {
-                uint32_t index;
-                index = strlen(path) - 1;
-                while (path[index] == ' ' || path[index] == '\t' || path[index] == '\r' || path[index] == '\n' ||
-                       path[index] == '\"') {
-                    path[index] = '\0';
-                    index = strlen(path) - 1;
-                }
-                index = 13;
-                while (path[index] == ' ' || path[index] == '\t' || path[index] == '\"') {
-                    index++;
-                }
-                _os_name = &path[index];
-                PrintBeginTableRow();
-                PrintTableElement("Linux");
-                PrintTableElement("");
-                PrintTableElement("");
-                PrintEndTableRow();
-                PrintBeginTableRow();
-                PrintTableElement("");
-                PrintTableElement("Distro");
-                PrintTableElement(_os_name);
-                PrintEndTableRow();
-                break;
-            }
-        }
-        pclose(fp);
+        PrintBeginTableRow();
+        PrintTableElement("Linux");
+        PrintTableElement("");
+        PrintTableElement("");
+        PrintEndTableRow();
+        PrintBeginTableRow();
+        PrintTableElement("");
+        PrintTableElement("Distro");
+        PrintTableElement(_os_name);
+        PrintEndTableRow();
     }
 
     errno = 0;
@@ -254,74 +674,24 @@ ViaSystem::ViaResults ViaSystemLinux::PrintSystemHardwareInfo() {
 
     // Print system disk space usage
     if (0 == statvfs("/etc/os-release", &fs_stats)) {
-        uint64_t bytes_total = (uint64_t)fs_stats.f_bsize * (uint64_t)fs_stats.f_bavail;
-        if ((bytes_total >> 40) > 0x0ULL) {
-            snprintf(generic_string, 1023, "%u TB", static_cast<uint32_t>(bytes_total >> 40));
-            PrintBeginTableRow();
-            PrintTableElement("System Disk Space");
-            PrintTableElement("Free");
-            PrintTableElement(generic_string);
-            PrintEndTableRow();
-        } else if ((bytes_total >> 30) > 0x0ULL) {
-            snprintf(generic_string, 1023, "%u GB", static_cast<uint32_t>(bytes_total >> 30));
-            PrintBeginTableRow();
-            PrintTableElement("System Disk Space");
-            PrintTableElement("Free");
-            PrintTableElement(generic_string);
-            PrintEndTableRow();
-        } else if ((bytes_total >> 20) > 0x0ULL) {
-            snprintf(generic_string, 1023, "%u MB", static_cast<uint32_t>(bytes_total >> 20));
-            PrintBeginTableRow();
-            PrintTableElement("System Disk Space");
-            PrintTableElement("Free");
-            PrintTableElement(generic_string);
-            PrintEndTableRow();
-        } else if ((bytes_total >> 10) > 0x0ULL) {
-            snprintf(generic_string, 1023, "%u KB", static_cast<uint32_t>(bytes_total >> 10));
-            PrintBeginTableRow();
-            PrintTableElement("System Disk Space");
-            PrintTableElement("Free");
-            PrintTableElement(generic_string);
-            PrintEndTableRow();
-        } else {
-            snprintf(generic_string, 1023, "%u bytes", static_cast<uint32_t>(bytes_total));
-            PrintBeginTableRow();
-            PrintTableElement("System Disk Space");
-            PrintTableElement("Free");
-            PrintTableElement(generic_string);
-            PrintEndTableRow();
-        }
+        PrintBeginTableRow();
+        PrintTableElement("System Disk Space");
+        PrintTableElement("Free");
+        PrintTableElement(FormatByteSize((uint64_t)fs_stats.f_bsize * (uint64_t)fs_stats.f_bavail));
+        PrintEndTableRow();
     }
 
     // Print current directory disk space info
-    sprintf(generic_string, "df -h \'%s\' | awk \'{ print $4 } \' | tail -n 1", _cur_path.c_str());
-    FILE *fp = popen(generic_string, "r");
-    if (fp == NULL) {
-        PrintBeginTableRow();
-        PrintTableElement("Current Dir Disk Space");
+    PrintBeginTableRow();
+    PrintTableElement("Current Dir Disk Space");
+    if (0 == statvfs(_cur_path.c_str(), &fs_stats)) {
+        PrintTableElement("Free");
+        PrintTableElement(FormatByteSize((uint64_t)fs_stats.f_bsize * (uint64_t)fs_stats.f_bavail));
+    } else {
         PrintTableElement("WARNING");
         PrintTableElement("Failed to determine current directory disk space");
-        PrintEndTableRow();
-    } else {
-        PrintBeginTableRow();
-        PrintTableElement("Current Dir Disk Space");
-        PrintTableElement("Free");
-        if (fgets(generic_string, 1023, fp) != NULL) {
-            uint32_t i = 0;
-            while (generic_string[i] != '\0') {
-                if (generic_string[i] == '\n') {
-                    generic_string[i] = '\0';
-                    break;
-                }
-                i++;
-            }
-            PrintTableElement(generic_string);
-        } else {
-            PrintTableElement("Failed to determine current directory disk space");
-        }
-        PrintEndTableRow();
-        pclose(fp);
     }
+    PrintEndTableRow();
 
     PrintEndTable();
     return result;
@@ -437,7 +807,10 @@ static bool FindLinuxSystemObject(ViaSystemLinux *via_sys_linux, std::string obj
     // LD_LIBRARY_PATH may have multiple folders listed in it (colon
     // ':' delimited)
     if (env_value != NULL) {
-        char *tok = strtok(env_value, ":");
+        // Tokenize a copy, the environment is also read by the report parts generated concurrently
+        std::string tok_buffer = env_value;
+        char *tok_context = NULL;
+        char *tok = strtok_r(&tok_buffer[0], ":", &tok_context);
         while (tok != NULL) {
             if (strlen(tok) > 0) {
                 path_to_check = tok;
@@ -448,7 +821,7 @@ static bool FindLinuxSystemObject(ViaSystemLinux *via_sys_linux, std::string obj
                     found_one = true;
                 }
             }
-            tok = strtok(NULL, ":");
+            tok = strtok_r(NULL, ":", &tok_context);
         }
     }
 
@@ -456,31 +829,19 @@ out:
     return found_one;
 }
 
-static bool VerifyOpen(std::string library_file, std::string &error) {
-    bool success = false;
-    void *handle = dlopen(library_file.c_str(), RTLD_NOW | RTLD_LOCAL);
-    if (NULL == handle) {
-        error = dlerror();
-    } else {
-        dlclose(handle);
-        success = true;
-    }
-    return success;
-}
-
 bool ViaSystemLinux::ReadDriverJson(std::string cur_driver_json, bool &found_lib) {
+    ScopedTimer timer(this, "Driver", cur_driver_json);
+
     bool found_json = false;
-    std::ifstream *stream = NULL;
-    Json::Value root = Json::nullValue;
+    std::shared_ptr<const ViaManifest> manifest = LoadManifest(cur_driver_json);
+    const Json::Value &root = manifest->root;
     Json::Value inst_exts = Json::nullValue;
     Json::Value dev_exts = Json::nullValue;
-    Json::Reader reader;
     std::string full_driver_path;
     char generic_string[2048];
     uint32_t j = 0;
 
-    stream = new std::ifstream(cur_driver_json.c_str(), std::ifstream::in);
-    if (nullptr == stream || stream->fail()) {
+    if (!manifest->read) {
         PrintBeginTableRow();
         PrintTableElement("");
         PrintTableElement("Error reading JSON file");
@@ -489,11 +850,11 @@ bool ViaSystemLinux::ReadDriverJson(std::string cur_driver_json, bool &found_lib
         goto out;
     }
 
-    if (!reader.parse(*stream, root, false) || root.isNull()) {
+    if (root.isNull()) {
         PrintBeginTableRow();
         PrintTableElement("");
         PrintTableElement("Error reading JSON file");
-        PrintTableElement(reader.getFormattedErrorMessages());
+        PrintTableElement(manifest->errors);
         PrintEndTableRow();
         goto out;
     }
@@ -535,8 +896,7 @@ bool ViaSystemLinux::ReadDriverJson(std::string cur_driver_json, bool &found_lib
     if (!root["ICD"]["library_path"].isNull()) {
         std::string driver_name = root["ICD"]["library_path"].asString();
         std::string location;
-        bool could_load = true;
-        std::string load_error;
+        std::string load_path;
         PrintTableElement(driver_name);
         PrintEndTableRow();
 
@@ -544,19 +904,16 @@ bool ViaSystemLinux::ReadDriverJson(std::string cur_driver_json, bool &found_lib
             // First try the generated path.
             if (access(full_driver_path.c_str(), R_OK) != -1) {
                 found_lib = true;
-                could_load = VerifyOpen(full_driver_path, load_error);
+                load_path = full_driver_path;
             } else if (driver_name.find("/") == std::string::npos) {
                 if (FindLinuxSystemObject(this, driver_name, location, CheckDriver, true)) {
                     found_lib = true;
-                    could_load = VerifyOpen(location, load_error);
+                    load_path = location;
                 }
             }
         }
         if (!found_lib) {
-            FILE *fp;
-            sprintf(generic_string, "/sbin/ldconfig -v -N -p | grep %s | awk \'{ print $4 }\'", driver_name.c_str());
-            fp = popen(generic_string, "r");
-            if (fp == NULL) {
+            if (!FindInLdSoCache(driver_name, location)) {
                 snprintf(generic_string, 1023,
                          "Failed to find driver %s "
                          "referenced by JSON %s",
@@ -567,27 +924,18 @@ bool ViaSystemLinux::ReadDriverJson(std::string cur_driver_json, bool &found_lib
                 PrintTableElement(generic_string);
                 PrintEndTableRow();
             } else {
-                char query_res[1024];
-
-                // Read the output a line at a time - output it.
-                if (fgets(query_res, sizeof(query_res) - 1, fp) != NULL) {
-                    snprintf(generic_string, 2047, "Found at %s", query_res);
-                    PrintBeginTableRow();
-                    PrintTableElement("");
-                    PrintTableElement("");
-                    PrintTableElement(generic_string);
-                    PrintEndTableRow();
-                    found_lib = true;
-                    could_load = VerifyOpen(query_res, load_error);
-                }
-                pclose(fp);
+                snprintf(generic_string, 2047, "Found at %s", location.c_str());
+                PrintBeginTableRow();
+                PrintTableElement("");
+                PrintTableElement("");
+                PrintTableElement(generic_string);
+                PrintEndTableRow();
+                found_lib = true;
+                load_path = location;
             }
-        } else if (!could_load) {
-            PrintBeginTableRow();
-            PrintTableElement("");
-            PrintTableElement("FAILED TO LOAD!");
-            PrintTableElement(load_error);
-            PrintEndTableRow();
+        }
+        if (!load_path.empty()) {
+            StartDriverLoadVerification(load_path);
         }
     } else {
         PrintTableElement("MISSING!");
@@ -649,12 +997,6 @@ bool ViaSystemLinux::ReadDriverJson(std::string cur_driver_json, bool &found_lib
 
 out:
 
-    if (nullptr != stream) {
-        stream->close();
-        delete stream;
-        stream = NULL;
-    }
-
     return found_json;
 }
 
@@ -670,7 +1012,9 @@ void ViaSystemLinux::PrintDriverEnvVarInfo(const char* var, bool& found_json, bo
 
         // These variables may have multiple folders listed in it (colon
         // ':' delimited)
-        char *tok = strtok(env_var_value, ":");
+        std::string tok_buffer = env_var_value;
+        char *tok_context = NULL;
+        char *tok = strtok_r(&tok_buffer[0], ":", &tok_context);
         if (tok != NULL) {
             while (tok != NULL) {
                 if (access(tok, R_OK) != -1) {
@@ -690,7 +1034,7 @@ void ViaSystemLinux::PrintDriverEnvVarInfo(const char* var, bool& found_json, bo
                     PrintTableElement("");
                     PrintEndTableRow();
                 }
-                tok = strtok(NULL, ":");
+                tok = strtok_r(NULL, ":", &tok_context);
             }
         } else {
             if (access(env_var_value, R_OK) != -1) {
@@ -798,6 +1142,7 @@ ViaSystem::ViaResults ViaSystemLinux::PrintSystemDriverInfo() {
     PrintDriverEnvVarInfo("VK_ICD_FILENAMES", found_json, found_lib);
     PrintDriverEnvVarInfo("VK_ADD_DRIVER_FILES", found_json, found_lib);
 
+    FinishDriverLoadVerifications();
     PrintEndTable();
 
     if (!found_json) {
@@ -818,12 +1163,11 @@ ViaSystem::ViaResults ViaSystemLinux::PrintRuntimesInFolder(std::string &folder_
     runtime_dir = opendir(folder_loc.c_str());
     if (NULL != runtime_dir) {
         bool file_found = false;
-        FILE *pfp;
         uint32_t i = 0;
         dirent *cur_ent;
-        std::string command_str;
+        std::string full_name;
         std::stringstream generic_str;
-        char path[1035];
+        char link_target[1035];
 
         if (print_header) {
             PrintBeginTableRow();
@@ -836,12 +1180,9 @@ ViaSystem::ViaResults ViaSystemLinux::PrintRuntimesInFolder(std::string &folder_
         while ((cur_ent = readdir(runtime_dir)) != NULL) {
             if (NULL != strstr(cur_ent->d_name, object_name.c_str()) && strlen(cur_ent->d_name) == 14) {
                 // Get the source of this symbolic link
-                command_str = "stat -c%N \'";
-                command_str += folder_loc;
-                command_str += "/";
-                command_str += cur_ent->d_name;
-                command_str += "\'";
-                pfp = popen(command_str.c_str(), "r");
+                full_name = folder_loc;
+                full_name += "/";
+                full_name += cur_ent->d_name;
 
                 generic_str << "[" << i++ << "]";
 
@@ -850,36 +1191,27 @@ ViaSystem::ViaResults ViaSystemLinux::PrintRuntimesInFolder(std::string &folder_
 
                 file_found = true;
 
-                if (pfp == NULL) {
+                struct stat link_stats;
+                if (0 != lstat(full_name.c_str(), &link_stats)) {
                     PrintTableElement(cur_ent->d_name);
                     PrintTableElement("Failed to retrieve symbolic link");
                     res = VIA_SYSTEM_CALL_FAILURE;
-                } else {
-                    if (NULL != fgets(path, sizeof(path) - 1, pfp)) {
-                        std::string cmd = path;
-                        size_t arrow_loc = cmd.find("->");
-                        if (arrow_loc == std::string::npos) {
-                            std::string trimmed_path = TrimWhitespace(path, " \t\n\r\'\"");
-
-                            PrintTableElement(trimmed_path);
-                            PrintTableElement("");
-                        } else {
-                            std::string before_arrow = cmd.substr(0, arrow_loc);
-                            std::string trim_before = TrimWhitespace(before_arrow, " \t\n\r\'\"");
-                            std::string after_arrow = cmd.substr(arrow_loc + 2, std::string::npos);
-                            std::string trim_after = TrimWhitespace(after_arrow, " \t\n\r\'\"");
-                            PrintTableElement(trim_before);
-                            PrintTableElement(trim_after);
-                        }
+                } else if (S_ISLNK(link_stats.st_mode)) {
+                    ssize_t len = ::readlink(full_name.c_str(), link_target, sizeof(link_target) - 1);
+                    if (len != -1) {
+                        link_target[len] = '\0';
+                        PrintTableElement(full_name);
+                        PrintTableElement(link_target);
                     } else {
                         PrintTableElement(cur_ent->d_name);
                         PrintTableElement("Failed to retrieve symbolic link");
                     }
-
-                    PrintEndTableRow();
-
-                    pclose(pfp);
+                } else {
+                    PrintTableElement(full_name);
+                    PrintTableElement("");
                 }
+
+                PrintEndTableRow();
             }
         }
         if (!file_found) {
@@ -909,12 +1241,7 @@ static bool CheckRuntime(ViaSystemLinux *via_sys_linux, std::string &folder_loc,
 ViaSystem::ViaResults ViaSystemLinux::PrintSystemLoaderInfo() {
     ViaResults result = VIA_SUCCESSFUL;
     const char vulkan_so_prefix[] = "libvulkan.so.";
-    char path[1035];
-    char generic_string[2048];
-    char buff[1024];
-    std::string runtime_dir_name;
     std::string location;
-    FILE *pfp;
 
     PrintBeginTable("Vulkan Runtimes", 3);
 
@@ -928,71 +1255,25 @@ ViaSystem::ViaResults ViaSystemLinux::PrintSystemLoaderInfo() {
         result = VIA_VULKAN_CANT_FIND_RUNTIME;
     }
 
-    ssize_t len = ::readlink("/proc/self/exe", buff, 1023);
-    if (len != -1) {
-        buff[len] = '\0';
-
-        std::string runtime_dir_id = "Runtime Folder Used By via";
-        snprintf(generic_string, 2047, "ldd \'%s\'", buff);
-        pfp = popen(generic_string, "r");
-        if (pfp == NULL) {
-            PrintBeginTableRow();
-            PrintTableElement(runtime_dir_id);
-            PrintTableElement("Failed to query via library info");
-            PrintTableElement("");
-            PrintEndTableRow();
-            result = VIA_SYSTEM_CALL_FAILURE;
-        } else {
-            bool found = false;
-            while (fgets(path, sizeof(path) - 1, pfp) != NULL) {
-                if (NULL != strstr(path, vulkan_so_prefix)) {
-                    std::string cmd = path;
-                    size_t arrow_loc = cmd.find("=>");
-                    if (arrow_loc == std::string::npos) {
-                        std::string trimmed_path = TrimWhitespace(path, " \t\n\r\'\"");
-                        PrintBeginTableRow();
-                        PrintTableElement(runtime_dir_id);
-                        PrintTableElement(trimmed_path);
-                        PrintTableElement("");
-                        PrintEndTableRow();
-                    } else {
-                        std::string after_arrow = cmd.substr(arrow_loc + 2);
-                        std::string before_slash = after_arrow.substr(0, after_arrow.rfind("/"));
-                        std::string trimmed = TrimWhitespace(before_slash, " \t\n\r\'\"");
+    std::string runtime_dir_id = "Runtime Folder Used By via";
+    std::string runtime_path;
+    if (FindNeededLibrary(vulkan_so_prefix, runtime_path)) {
+        std::string runtime_folder = runtime_path.substr(0, runtime_path.rfind("/"));
 
-                        PrintBeginTableRow();
-                        PrintTableElement(runtime_dir_id);
-                        PrintTableElement(trimmed);
-                        PrintTableElement("");
-                        PrintEndTableRow();
+        PrintBeginTableRow();
+        PrintTableElement(runtime_dir_id);
+        PrintTableElement(runtime_folder);
+        PrintTableElement("");
+        PrintEndTableRow();
 
-                        std::string find_so = vulkan_so_prefix;
-                        ViaResults temp_res = PrintRuntimesInFolder(trimmed, find_so, false);
-                        if (!found) {
-                            // If nothing's been found so far, save the current error message
-                            result = temp_res;
-                            // If the result was successful, then we did end up finding at least
-                            // one.
-                            if (result == VIA_SUCCESSFUL) {
-                                found = true;
-                            }
-                            // We found at least one runtime already, clear any failures
-                        } else if (found && result == VIA_VULKAN_CANT_FIND_RUNTIME) {
-                            result = VIA_SUCCESSFUL;
-                        }
-                    }
-                    break;
-                }
-            }
-            if (!found) {
-                PrintBeginTableRow();
-                PrintTableElement(runtime_dir_id);
-                PrintTableElement("Failed to find Vulkan SO used for via");
-                PrintTableElement("");
-                PrintEndTableRow();
-            }
-            pclose(pfp);
-        }
+        std::string find_so = vulkan_so_prefix;
+        result = PrintRuntimesInFolder(runtime_folder, find_so, false);
+    } else {
+        PrintBeginTableRow();
+        PrintTableElement(runtime_dir_id);
+        PrintTableElement("Failed to find Vulkan SO used for via");
+        PrintTableElement("");
+        PrintEndTableRow();
     }
 
     PrintEndTable();
@@ -1030,43 +1311,36 @@ ViaSystem::ViaResults ViaSystemLinux::PrintExplicitLayersInFolder(const std::str
                 cur_layer += "/";
                 cur_layer += cur_ent->d_name;
 
+                ScopedTimer timer(this, "Layer manifest", cur_layer);
+
                 // Parse the JSON file
-                std::ifstream *stream = NULL;
-                stream = new std::ifstream(cur_layer, std::ifstream::in);
-                if (nullptr == stream || stream->fail()) {
+                std::shared_ptr<const ViaManifest> manifest = LoadManifest(cur_layer);
+                if (!manifest->read) {
                     PrintBeginTableRow();
                     PrintTableElement("");
                     PrintTableElement(generic_string, VIA_ALIGN_RIGHT);
                     PrintTableElement(cur_ent->d_name);
                     PrintTableElement("ERROR reading JSON file!");
                     PrintEndTableRow();
+                } else if (manifest->root.isNull()) {
+                    // Report to the user the failure and their
+                    // locations in the document.
+                    PrintBeginTableRow();
+                    PrintTableElement("");
+                    PrintTableElement(generic_string, VIA_ALIGN_RIGHT);
+                    PrintTableElement(cur_ent->d_name);
+                    PrintTableElement(manifest->errors);
+                    PrintEndTableRow();
                 } else {
-                    Json::Value root = Json::nullValue;
-                    Json::Reader reader;
-                    if (!reader.parse(*stream, root, false) || root.isNull()) {
-                        // Report to the user the failure and their
-                        // locations in the document.
-                        PrintBeginTableRow();
-                        PrintTableElement("");
-                        PrintTableElement(generic_string, VIA_ALIGN_RIGHT);
-                        PrintTableElement(cur_ent->d_name);
-                        PrintTableElement(reader.getFormattedErrorMessages());
-                        PrintEndTableRow();
-                    } else {
-                        PrintBeginTableRow();
-                        PrintTableElement("");
-                        PrintTableElement(generic_string, VIA_ALIGN_RIGHT);
-                        PrintTableElement(cur_ent->d_name);
-                        PrintTableElement("");
-                        PrintEndTableRow();
-
-                        // Dump out the standard explicit layer information.
-                        GenerateExplicitLayerJsonInfo(cur_layer.c_str(), root);
-                    }
+                    PrintBeginTableRow();
+                    PrintTableElement("");
+                    PrintTableElement(generic_string, VIA_ALIGN_RIGHT);
+                    PrintTableElement(cur_ent->d_name);
+                    PrintTableElement("");
+                    PrintEndTableRow();
 
-                    stream->close();
-                    delete stream;
-                    stream = NULL;
+                    // Dump out the standard explicit layer information.
+                    GenerateExplicitLayerJsonInfo(cur_layer.c_str(), manifest->root);
                 }
             }
         }
@@ -1159,45 +1433,19 @@ ViaSystem::ViaResults ViaSystemLinux::PrintSystemSdkInfo() {
 
     // Next, try system install items
     if (!sdk_exists) {
-        FILE *dpkg_output = popen("dpkg-query --show --showformat='${Package} ${Version}' vulkan-sdk", "r");
-
-        if (dpkg_output != nullptr) {
-            char cur_line[1035];
-            std::string install_name;
-            std::string install_version;
-            std::string target("vulkan-sdk");
-            // Read the output a line at a time - output it.
-            while (fgets(cur_line, sizeof(cur_line) - 1, dpkg_output) != nullptr) {
-                if (!strncmp(cur_line, target.c_str(), target.size())) {
-                    uint32_t count = 0;
-                    // Found it
-                    char *p = strtok(cur_line, " ");
-                    while (p) {
-                        if (count == 0) {
-                            install_name = p;
-                        } else if (count == 1) {
-                            install_version = p;
-                            break;
-                        }
-                        count++;
-                        p = strtok(NULL, " ");
-                    }
-                    break;
-                }
-            }
-            pclose(dpkg_output);
-            if (install_name.size() > 0 && install_version.size() > 0) {
-                PrintBeginTableRow();
-                PrintTableElement("System Installed SDK");
-                PrintTableElement(install_name.c_str());
-                PrintTableElement(install_version.c_str());
-                PrintTableElement("");
-                PrintEndTableRow();
+        std::string install_name = "vulkan-sdk";
+        std::string install_version;
+        if (FindDpkgPackage(install_name, install_version)) {
+            PrintBeginTableRow();
+            PrintTableElement("System Installed SDK");
+            PrintTableElement(install_name.c_str());
+            PrintTableElement(install_version.c_str());
+            PrintTableElement("");
+            PrintEndTableRow();
 
-                _found_sdk = true;
-                _is_system_installed_sdk = true;
-                sdk_exists = true;
-            }
+            _found_sdk = true;
+            _is_system_installed_sdk = true;
+            sdk_exists = true;
         }
     }
 
@@ -1276,34 +1524,26 @@ ViaSystem::ViaResults ViaSystemLinux::PrintSystemImplicitLayerInfo() {
                     PrintTableElement("");
                     PrintEndTableRow();
 
-                    std::ifstream *stream = NULL;
-                    stream = new std::ifstream(cur_vulkan_layer_json, std::ifstream::in);
-                    if (nullptr == stream || stream->fail()) {
+                    ScopedTimer timer(this, "Layer manifest", cur_vulkan_layer_json);
+                    std::shared_ptr<const ViaManifest> manifest = LoadManifest(cur_vulkan_layer_json);
+                    if (!manifest->read) {
                         PrintBeginTableRow();
                         PrintTableElement("");
                         PrintTableElement("ERROR reading JSON file!");
                         PrintTableElement("");
                         PrintTableElement("");
                         PrintEndTableRow();
+                    } else if (manifest->root.isNull()) {
+                        // Report to the user the failure and their
+                        // locations in the document.
+                        PrintBeginTableRow();
+                        PrintTableElement("");
+                        PrintTableElement("ERROR parsing JSON file!");
+                        PrintTableElement(manifest->errors);
+                        PrintTableElement("");
+                        PrintEndTableRow();
                     } else {
-                        Json::Value root = Json::nullValue;
-                        Json::Reader reader;
-                        if (!reader.parse(*stream, root, false) || root.isNull()) {
-                            // Report to the user the failure and their
-                            // locations in the document.
-                            PrintBeginTableRow();
-                            PrintTableElement("");
-                            PrintTableElement("ERROR parsing JSON file!");
-                            PrintTableElement(reader.getFormattedErrorMessages());
-                            PrintTableElement("");
-                            PrintEndTableRow();
-                        } else {
-                            GenerateImplicitLayerJsonInfo(cur_vulkan_layer_json, root, _layer_override_search_path);
-                        }
-
-                        stream->close();
-                        delete stream;
-                        stream = NULL;
+                        GenerateImplicitLayerJsonInfo(cur_vulkan_layer_json, manifest->root, _layer_override_search_path);
                     }
                 }
             }
@@ -1329,7 +1569,9 @@ ViaSystem::ViaResults ViaSystemLinux::PrintLayerEnvVar(const char* var) {
     char *env_value = getenv(var);
     std::string cur_json;
     if (NULL != env_value) {
-        char *tok = strtok(env_value, ":");
+        std::string tok_buffer = env_value;
+        char *tok_context = NULL;
+        char *tok = strtok_r(&tok_buffer[0], ":", &tok_context);
         std::string explicit_layer_id = var;
 
         PrintBeginTableRow();
@@ -1348,7 +1590,7 @@ ViaSystem::ViaResults ViaSystemLinux::PrintLayerEnvVar(const char* var) {
                 cur_name << "Path " << offset++;
                 explicit_layer_id = cur_name.str();
                 result = PrintExplicitLayersInFolder(explicit_layer_id, cur_json);
-                tok = strtok(NULL, ":");
+                tok = strtok_r(NULL, ":", &tok_context);
             }
         } else {
             cur_json = env_value;
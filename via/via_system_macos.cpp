@@ -43,6 +43,7 @@ ViaSystemMacOS::ViaSystemMacOS() : ViaSystem() {
     _NSGetExecutablePath(temp_exe_path_c_str, &bufSize);
     if (bufSize > 0) {
         std::string exe_location = temp_exe_path_c_str;
+        _exe_file = exe_location;
         _exe_path = exe_location.substr(0, exe_location.rfind("/"));
     } else {
         _exe_path = "";
@@ -106,7 +107,11 @@ ViaSystem::ViaResults ViaSystemMacOS::PrintSystemEnvironmentInfo() {
 
     PrintBeginTable("Environment", 3);
 
-    FILE *fp = popen("sw_vers", "r");
+    FILE *fp = NULL;
+    {
+        std::lock_guard<std::mutex> lock(_process_mutex);
+        fp = popen("sw_vers", "r");
+    }
     if (fp == NULL) {
         PrintBeginTableRow();
         PrintTableElement("ERROR");
@@ -256,7 +261,11 @@ ViaSystem::ViaResults ViaSystemMacOS::PrintSystemHardwareInfo() {
 
     // Print current directory disk space info
     sprintf(generic_string, "df -h \'%s\' | awk \'{ print $4 } \' | tail -n 1", _cur_path.c_str());
-    FILE *fp = popen(generic_string, "r");
+    FILE *fp = NULL;
+    {
+        std::lock_guard<std::mutex> lock(_process_mutex);
+        fp = popen(generic_string, "r");
+    }
     if (fp == NULL) {
         PrintBeginTableRow();
         PrintTableElement("Current Dir Disk Space");
@@ -377,7 +386,10 @@ static bool FindMacOSSystemObject(ViaSystemMacOS *via_sys_macos, std::string obj
     // DYLD_LIBRARY_PATH may have multiple folders listed in it (colon
     // ':' delimited)
     if (env_value != NULL) {
-        char *tok = strtok(env_value, ":");
+        // Tokenize a copy, the environment is also read by the report parts generated concurrently
+        std::string tok_buffer = env_value;
+        char *tok_context = NULL;
+        char *tok = strtok_r(&tok_buffer[0], ":", &tok_context);
         while (tok != NULL) {
             if (strlen(tok) > 0) {
                 path_to_check = tok;
@@ -388,7 +400,7 @@ static bool FindMacOSSystemObject(ViaSystemMacOS *via_sys_macos, std::string obj
                     found_one = true;
                 }
             }
-            tok = strtok(NULL, ":");
+            tok = strtok_r(NULL, ":", &tok_context);
         }
     }
 
@@ -396,31 +408,19 @@ out:
     return found_one;
 }
 
-static bool VerifyOpen(std::string library_file, std::string &error) {
-    bool success = false;
-    void *handle = dlopen(library_file.c_str(), RTLD_NOW | RTLD_LOCAL);
-    if (NULL == handle) {
-        error = dlerror();
-    } else {
-        dlclose(handle);
-        success = true;
-    }
-    return success;
-}
-
 bool ViaSystemMacOS::ReadDriverJson(std::string cur_driver_json, bool &found_lib) {
+    ScopedTimer timer(this, "Driver", cur_driver_json);
+
     bool found_json = false;
-    std::ifstream *stream = NULL;
-    Json::Value root = Json::nullValue;
+    std::shared_ptr<const ViaManifest> manifest = LoadManifest(cur_driver_json);
+    const Json::Value &root = manifest->root;
     Json::Value inst_exts = Json::nullValue;
     Json::Value dev_exts = Json::nullValue;
-    Json::Reader reader;
     std::string full_driver_path;
     char generic_string[2048];
     uint32_t j = 0;
 
-    stream = new std::ifstream(cur_driver_json.c_str(), std::ifstream::in);
-    if (nullptr == stream || stream->fail()) {
+    if (!manifest->read) {
         PrintBeginTableRow();
         PrintTableElement("");
         PrintTableElement("Error reading JSON file");
@@ -429,11 +429,11 @@ bool ViaSystemMacOS::ReadDriverJson(std::string cur_driver_json, bool &found_lib
         goto out;
     }
 
-    if (!reader.parse(*stream, root, false) || root.isNull()) {
+    if (root.isNull()) {
         PrintBeginTableRow();
         PrintTableElement("");
         PrintTableElement("Error reading JSON file");
-        PrintTableElement(reader.getFormattedErrorMessages());
+        PrintTableElement(manifest->errors);
         PrintEndTableRow();
         goto out;
     }
@@ -475,8 +475,7 @@ bool ViaSystemMacOS::ReadDriverJson(std::string cur_driver_json, bool &found_lib
     if (!root["ICD"]["library_path"].isNull()) {
         std::string driver_name = root["ICD"]["library_path"].asString();
         std::string location;
-        bool could_load = true;
-        std::string load_error;
+        std::string load_path;
         PrintTableElement(driver_name);
         PrintEndTableRow();
 
@@ -484,11 +483,11 @@ bool ViaSystemMacOS::ReadDriverJson(std::string cur_driver_json, bool &found_lib
             // First try the generated path.
             if (access(full_driver_path.c_str(), R_OK) != -1) {
                 found_lib = true;
-                could_load = VerifyOpen(full_driver_path, load_error);
+                load_path = full_driver_path;
             } else if (driver_name.find("/") == std::string::npos) {
                 if (FindMacOSSystemObject(this, driver_name, location, CheckDriver, true)) {
                     found_lib = true;
-                    could_load = VerifyOpen(location, load_error);
+                    load_path = location;
                 }
             }
         }
@@ -507,7 +506,7 @@ bool ViaSystemMacOS::ReadDriverJson(std::string cur_driver_json, bool &found_lib
                     PrintTableElement(generic_string);
                     PrintEndTableRow();
                     found_lib = true;
-                    could_load = VerifyOpen(path.c_str(), load_error);
+                    load_path = path;
                     break;
                 }
             }
@@ -522,12 +521,9 @@ bool ViaSystemMacOS::ReadDriverJson(std::string cur_driver_json, bool &found_lib
                 PrintTableElement(generic_string);
                 PrintEndTableRow();
             }
-        } else if (!could_load) {
-            PrintBeginTableRow();
-            PrintTableElement("");
-            PrintTableElement("FAILED TO LOAD!");
-            PrintTableElement(load_error);
-            PrintEndTableRow();
+        }
+        if (!load_path.empty()) {
+            StartDriverLoadVerification(load_path);
         }
     } else {
         PrintTableElement("MISSING!");
@@ -589,12 +585,6 @@ bool ViaSystemMacOS::ReadDriverJson(std::string cur_driver_json, bool &found_lib
 
 out:
 
-    if (nullptr != stream) {
-        stream->close();
-        delete stream;
-        stream = NULL;
-    }
-
     return found_json;
 }
 
@@ -610,7 +600,9 @@ void ViaSystemMacOS::PrintDriverEnvVarInfo(const char *var, bool &found_json, bo
 
         // These variables may have multiple folders listed in it (colon
         // ':' delimited)
-        char *tok = strtok(env_var_value, ":");
+        std::string tok_buffer = env_var_value;
+        char *tok_context = NULL;
+        char *tok = strtok_r(&tok_buffer[0], ":", &tok_context);
         if (tok != NULL) {
             while (tok != NULL) {
                 if (access(tok, R_OK) != -1) {
@@ -630,7 +622,7 @@ void ViaSystemMacOS::PrintDriverEnvVarInfo(const char *var, bool &found_json, bo
                     PrintTableElement("");
                     PrintEndTableRow();
                 }
-                tok = strtok(NULL, ":");
+                tok = strtok_r(NULL, ":", &tok_context);
             }
         } else {
             if (access(env_var_value, R_OK) != -1) {
@@ -738,6 +730,7 @@ ViaSystem::ViaResults ViaSystemMacOS::PrintSystemDriverInfo() {
     PrintDriverEnvVarInfo("VK_ICD_FILENAMES", found_json, found_lib);
     PrintDriverEnvVarInfo("VK_ADD_DRIVER_FILES", found_json, found_lib);
 
+    FinishDriverLoadVerifications();
     PrintEndTable();
 
     if (!found_json) {
@@ -939,43 +932,36 @@ ViaSystem::ViaResults ViaSystemMacOS::PrintExplicitLayersInFolder(const std::str
                 cur_layer += "/";
                 cur_layer += cur_ent->d_name;
 
+                ScopedTimer timer(this, "Layer manifest", cur_layer);
+
                 // Parse the JSON file
-                std::ifstream *stream = NULL;
-                stream = new std::ifstream(cur_layer, std::ifstream::in);
-                if (nullptr == stream || stream->fail()) {
+                std::shared_ptr<const ViaManifest> manifest = LoadManifest(cur_layer);
+                if (!manifest->read) {
                     PrintBeginTableRow();
                     PrintTableElement("");
                     PrintTableElement(generic_string, VIA_ALIGN_RIGHT);
                     PrintTableElement(cur_ent->d_name);
                     PrintTableElement("ERROR reading JSON file!");
                     PrintEndTableRow();
+                } else if (manifest->root.isNull()) {
+                    // Report to the user the failure and their
+                    // locations in the document.
+                    PrintBeginTableRow();
+                    PrintTableElement("");
+                    PrintTableElement(generic_string, VIA_ALIGN_RIGHT);
+                    PrintTableElement(cur_ent->d_name);
+                    PrintTableElement(manifest->errors);
+                    PrintEndTableRow();
                 } else {
-                    Json::Value root = Json::nullValue;
-                    Json::Reader reader;
-                    if (!reader.parse(*stream, root, false) || root.isNull()) {
-                        // Report to the user the failure and their
-                        // locations in the document.
-                        PrintBeginTableRow();
-                        PrintTableElement("");
-                        PrintTableElement(generic_string, VIA_ALIGN_RIGHT);
-                        PrintTableElement(cur_ent->d_name);
-                        PrintTableElement(reader.getFormattedErrorMessages());
-                        PrintEndTableRow();
-                    } else {
-                        PrintBeginTableRow();
-                        PrintTableElement("");
-                        PrintTableElement(generic_string, VIA_ALIGN_RIGHT);
-                        PrintTableElement(cur_ent->d_name);
-                        PrintTableElement("");
-                        PrintEndTableRow();
-
-                        // Dump out the standard explicit layer information.
-                        GenerateExplicitLayerJsonInfo(cur_layer.c_str(), root);
-                    }
+                    PrintBeginTableRow();
+                    PrintTableElement("");
+                    PrintTableElement(generic_string, VIA_ALIGN_RIGHT);
+                    PrintTableElement(cur_ent->d_name);
+                    PrintTableElement("");
+                    PrintEndTableRow();
 
-                    stream->close();
-                    delete stream;
-                    stream = NULL;
+                    // Dump out the standard explicit layer information.
+                    GenerateExplicitLayerJsonInfo(cur_layer.c_str(), manifest->root);
                 }
             }
         }
@@ -1128,34 +1114,26 @@ ViaSystem::ViaResults ViaSystemMacOS::PrintSystemImplicitLayerInfo() {
                     PrintTableElement("");
                     PrintEndTableRow();
 
-                    std::ifstream *stream = NULL;
-                    stream = new std::ifstream(cur_vulkan_layer_json, std::ifstream::in);
-                    if (nullptr == stream || stream->fail()) {
+                    ScopedTimer timer(this, "Layer manifest", cur_vulkan_layer_json);
+                    std::shared_ptr<const ViaManifest> manifest = LoadManifest(cur_vulkan_layer_json);
+                    if (!manifest->read) {
                         PrintBeginTableRow();
                         PrintTableElement("");
                         PrintTableElement("ERROR reading JSON file!");
                         PrintTableElement("");
                         PrintTableElement("");
                         PrintEndTableRow();
+                    } else if (manifest->root.isNull()) {
+                        // Report to the user the failure and their
+                        // locations in the document.
+                        PrintBeginTableRow();
+                        PrintTableElement("");
+                        PrintTableElement("ERROR parsing JSON file!");
+                        PrintTableElement(manifest->errors);
+                        PrintTableElement("");
+                        PrintEndTableRow();
                     } else {
-                        Json::Value root = Json::nullValue;
-                        Json::Reader reader;
-                        if (!reader.parse(*stream, root, false) || root.isNull()) {
-                            // Report to the user the failure and their
-                            // locations in the document.
-                            PrintBeginTableRow();
-                            PrintTableElement("");
-                            PrintTableElement("ERROR parsing JSON file!");
-                            PrintTableElement(reader.getFormattedErrorMessages());
-                            PrintTableElement("");
-                            PrintEndTableRow();
-                        } else {
-                            GenerateImplicitLayerJsonInfo(cur_vulkan_layer_json, root, _layer_override_search_path);
-                        }
-
-                        stream->close();
-                        delete stream;
-                        stream = NULL;
+                        GenerateImplicitLayerJsonInfo(cur_vulkan_layer_json, manifest->root, _layer_override_search_path);
                     }
                 }
             }
@@ -1181,7 +1159,9 @@ ViaSystem::ViaResults ViaSystemMacOS::PrintLayerEnvVar(const char *var) {
     char *env_value = getenv(var);
     std::string cur_json;
     if (NULL != env_value) {
-        char *tok = strtok(env_value, ":");
+        std::string tok_buffer = env_value;
+        char *tok_context = NULL;
+        char *tok = strtok_r(&tok_buffer[0], ":", &tok_context);
         std::string explicit_layer_id = var;
 
         PrintBeginTableRow();
@@ -1200,7 +1180,7 @@ ViaSystem::ViaResults ViaSystemMacOS::PrintLayerEnvVar(const char *var) {
                 cur_name << "Path " << offset++;
                 explicit_layer_id = cur_name.str();
                 result = PrintExplicitLayersInFolder(explicit_layer_id, cur_json);
-                tok = strtok(NULL, ":");
+                tok = strtok_r(NULL, ":", &tok_context);
             }
         } else {
             cur_json = env_value;
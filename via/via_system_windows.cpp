@@ -924,11 +924,8 @@ ViaSystem::ViaResults ViaSystemWindows::PrintSystemExecutableInfo() {
 bool ViaSystemWindows::PrintDriverRegistryInfo(std::vector<std::tuple<std::string, bool, std::string>> &cur_driver_json,
                                                std::string system_path, bool &found_lib) {
     bool found_json = false;
-    std::ifstream *stream = NULL;
-    Json::Value root = Json::nullValue;
     Json::Value dev_exts = Json::nullValue;
     Json::Value inst_exts = Json::nullValue;
-    Json::Reader reader;
     std::string full_driver_path;
     char generic_string[1024];
     uint32_t j = 0;
@@ -965,8 +962,10 @@ bool ViaSystemWindows::PrintDriverRegistryInfo(std::vector<std::tuple<std::strin
         PrintEndTableRow();
         cur_reg_name = driver_json_name;
 
-        stream = new std::ifstream(driver_json_path.c_str(), std::ifstream::in);
-        if (nullptr == stream || stream->fail()) {
+        ScopedTimer timer(this, "Driver", driver_json_path);
+        std::shared_ptr<const ViaManifest> manifest = LoadManifest(driver_json_path);
+        const Json::Value &root = manifest->root;
+        if (!manifest->read) {
             PrintBeginTableRow();
             PrintTableElement("");
             PrintTableElement("");
@@ -976,16 +975,13 @@ bool ViaSystemWindows::PrintDriverRegistryInfo(std::vector<std::tuple<std::strin
             continue;
         }
 
-        if (!reader.parse(*stream, root, false) || root.isNull()) {
+        if (root.isNull()) {
             PrintBeginTableRow();
             PrintTableElement("");
             PrintTableElement("");
             PrintTableElement("Error reading JSON file");
-            PrintTableElement(reader.getFormattedErrorMessages());
+            PrintTableElement(manifest->errors);
             PrintEndTableRow();
-            stream->close();
-            delete stream;
-            stream = NULL;
             continue;
         }
 
@@ -1007,9 +1003,6 @@ bool ViaSystemWindows::PrintDriverRegistryInfo(std::vector<std::tuple<std::strin
             PrintTableElement("ICD Section");
             PrintTableElement("MISSING!");
             PrintEndTableRow();
-            stream->close();
-            delete stream;
-            stream = NULL;
             continue;
         }
 
@@ -1138,11 +1131,6 @@ bool ViaSystemWindows::PrintDriverRegistryInfo(std::vector<std::tuple<std::strin
                 }
             }
         }
-        if (nullptr != stream) {
-            stream->close();
-            delete stream;
-            stream = NULL;
-        }
     }
 
     return found_json;
@@ -1534,35 +1522,27 @@ bool ViaSystemWindows::PrintExplicitLayersRegInfo(std::vector<std::tuple<std::st
         PrintTableElement("");
         PrintEndTableRow();
 
-        std::ifstream *stream = NULL;
-        stream = new std::ifstream(cur_layer_json_path, std::ifstream::in);
-        if (nullptr == stream || stream->fail()) {
+        ScopedTimer timer(this, "Layer manifest", cur_layer_json_path);
+        std::shared_ptr<const ViaManifest> manifest = LoadManifest(cur_layer_json_path);
+        if (!manifest->read) {
             PrintBeginTableRow();
             PrintTableElement("");
             PrintTableElement("Error reading JSON file!");
             PrintTableElement("");
             PrintTableElement("");
             PrintEndTableRow();
+        } else if (manifest->root.isNull()) {
+            // Report to the user the failure and their locations in the
+            // document.
+            PrintBeginTableRow();
+            PrintTableElement("");
+            PrintTableElement("Error parsing JSON file!");
+            PrintTableElement(manifest->errors);
+            PrintTableElement("");
+            PrintEndTableRow();
         } else {
-            Json::Value root = Json::nullValue;
-            Json::Reader reader;
-            if (!reader.parse(*stream, root, false) || root.isNull()) {
-                // Report to the user the failure and their locations in the
-                // document.
-                PrintBeginTableRow();
-                PrintTableElement("");
-                PrintTableElement("Error parsing JSON file!");
-                PrintTableElement(reader.getFormattedErrorMessages());
-                PrintTableElement("");
-                PrintEndTableRow();
-            } else {
-                GenerateExplicitLayerJsonInfo(cur_layer_json_path.c_str(), root);
-                found = true;
-            }
-
-            stream->close();
-            delete stream;
-            stream = NULL;
+            GenerateExplicitLayerJsonInfo(cur_layer_json_path.c_str(), manifest->root);
+            found = true;
         }
     }
     return found;
@@ -1597,35 +1577,27 @@ bool ViaSystemWindows::PrintImplicitLayersRegInfo(std::vector<std::tuple<std::st
         PrintTableElement("");
         PrintEndTableRow();
 
-        std::ifstream *stream = NULL;
-        stream = new std::ifstream(cur_layer_json_path, std::ifstream::in);
-        if (nullptr == stream || stream->fail()) {
+        ScopedTimer timer(this, "Layer manifest", cur_layer_json_path);
+        std::shared_ptr<const ViaManifest> manifest = LoadManifest(cur_layer_json_path);
+        if (!manifest->read) {
             PrintBeginTableRow();
             PrintTableElement("");
             PrintTableElement("ERROR reading JSON file!");
             PrintTableElement("");
             PrintTableElement("");
             PrintEndTableRow();
+        } else if (manifest->root.isNull()) {
+            // Report to the user the failure and their locations in the
+            // document.
+            PrintBeginTableRow();
+            PrintTableElement("");
+            PrintTableElement("ERROR parsing JSON file!");
+            PrintTableElement(manifest->errors);
+            PrintTableElement("");
+            PrintEndTableRow();
         } else {
-            Json::Value root = Json::nullValue;
-            Json::Reader reader;
-            if (!reader.parse(*stream, root, false) || root.isNull()) {
-                // Report to the user the failure and their locations in the
-                // document.
-                PrintBeginTableRow();
-                PrintTableElement("");
-                PrintTableElement("ERROR parsing JSON file!");
-                PrintTableElement(reader.getFormattedErrorMessages());
-                PrintTableElement("");
-                PrintEndTableRow();
-            } else {
-                GenerateImplicitLayerJsonInfo(ConvertPathFormat(cur_layer_json_path).c_str(), root, override_paths);
-                found = true;
-            }
-
-            stream->close();
-            delete stream;
-            stream = NULL;
+            GenerateImplicitLayerJsonInfo(ConvertPathFormat(cur_layer_json_path).c_str(), manifest->root, override_paths);
+            found = true;
         }
     }
     return found;
@@ -1820,34 +1792,26 @@ ViaSystem::ViaResults ViaSystemWindows::FindAndPrintAllExplicitLayersInPath(cons
                 PrintTableElement("");
                 PrintEndTableRow();
 
-                std::ifstream *stream = NULL;
-                stream = new std::ifstream(cur_json_path, std::ifstream::in);
-                if (nullptr == stream || stream->fail()) {
+                ScopedTimer timer(this, "Layer manifest", cur_json_path);
+                std::shared_ptr<const ViaManifest> manifest = LoadManifest(cur_json_path);
+                if (!manifest->read) {
                     PrintBeginTableRow();
                     PrintTableElement("");
                     PrintTableElement("");
                     PrintTableElement("ERROR reading JSON file!");
                     PrintTableElement("");
                     PrintEndTableRow();
+                } else if (manifest->root.isNull()) {
+                    // Report to the user the failure and their
+                    // locations in the document.
+                    PrintBeginTableRow();
+                    PrintTableElement("");
+                    PrintTableElement("");
+                    PrintTableElement("ERROR parsing JSON file!");
+                    PrintTableElement(manifest->errors);
+                    PrintEndTableRow();
                 } else {
-                    Json::Value root = Json::nullValue;
-                    Json::Reader reader;
-                    if (!reader.parse(*stream, root, false) || root.isNull()) {
-                        // Report to the user the failure and their
-                        // locations in the document.
-                        PrintBeginTableRow();
-                        PrintTableElement("");
-                        PrintTableElement("");
-                        PrintTableElement("ERROR parsing JSON file!");
-                        PrintTableElement(reader.getFormattedErrorMessages());
-                        PrintEndTableRow();
-                    } else {
-                        GenerateExplicitLayerJsonInfo(cur_json_path.c_str(), root);
-                    }
-
-                    stream->close();
-                    delete stream;
-                    stream = NULL;
+                    GenerateExplicitLayerJsonInfo(cur_json_path.c_str(), manifest->root);
                 }
             }
         } while (FindNextFileA(hFind, &ffd) != 0);
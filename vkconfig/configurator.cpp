@@ -172,4 +172,42 @@ void Configurator::ResetToDefault(bool hard) {
     }
 }
 
+bool Configurator::UpdateLayerFiles(const std::vector<std::string> &manifest_paths) {
+    // The settings of the configurations are owned by the layers, the previous layers are kept until the settings are moved
+    const std::vector<Layer> previous_layers = this->layers.available_layers;
+
+    std::vector<std::string> updated_layers;
+    for (std::size_t i = 0, n = manifest_paths.size(); i < n; ++i) {
+        const std::vector<std::string> &keys = this->layers.UpdateLayerFromFile(manifest_paths[i]);
+        for (std::size_t j = 0, o = keys.size(); j < o; ++j) {
+            AppendString(updated_layers, keys[j]);
+        }
+    }
+
+    if (updated_layers.empty()) {
+        return false;
+    }
+
+    // The configurations are neither saved nor reloaded from their files, the values edited by the user are kept
+    this->configurations.UpdateLayerSettings(this->layers.available_layers, updated_layers);
+
+    this->configurations.Configure(this->layers.available_layers);
+    return true;
+}
+
+bool Configurator::UpdateConfigurationFiles(const std::vector<std::string> &configuration_paths) {
+    bool updated = false;
+    for (std::size_t i = 0, n = configuration_paths.size(); i < n; ++i) {
+        if (this->configurations.UpdateConfigurationFromFile(this->layers.available_layers, configuration_paths[i])) {
+            updated = true;
+        }
+    }
+
+    if (updated) {
+        this->configurations.Configure(this->layers.available_layers);
+    }
+
+    return updated;
+}
+
 std::vector<std::string> Configurator::GetDeviceNames() const { return device_names; }
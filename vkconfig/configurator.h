@@ -52,6 +52,11 @@ class Configurator {
 
     void ResetToDefault(bool hard);
 
+    // Apply the changes of layer manifests and configuration files made by other processes.
+    // Returns whether the layers or the configurations changed.
+    bool UpdateLayerFiles(const std::vector<std::string>& manifest_paths);
+    bool UpdateConfigurationFiles(const std::vector<std::string>& configuration_paths);
+
     std::string profile_file;
 
     std::vector<std::string> GetDeviceNames() const;
@@ -706,17 +706,17 @@ void LayersDialog::accept() {
         FindByKey(configurator.configurations.available_configurations, this->configuration.key.c_str());
     assert(saved_configuration != nullptr);
 
-    if (saved_configuration->key != ui->lineEditName->text().toStdString()) {
-        configurator.configurations.RemoveConfigurationFile(saved_configuration->key);
-    }
-
     const std::string active_configuration_name = ui->lineEditName->text().toStdString();
 
-    saved_configuration->key = active_configuration_name;
+    if (saved_configuration->key != active_configuration_name) {
+        saved_configuration = configurator.configurations.RenameConfiguration(this->configuration.key, active_configuration_name);
+    }
+
     saved_configuration->description = ui->lineEditDescription->text().toStdString();
     saved_configuration->parameters = this->configuration.parameters;
     saved_configuration->user_defined_paths = this->configuration.user_defined_paths;
     saved_configuration->setting_tree_state.clear();
+    saved_configuration->dirty = true;
     configurator.configurations.SaveAllConfigurations(configurator.layers.available_layers);
 
     QDialog::accept();
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2020-2024 Valve Corporation
+ * Copyright (c) 2020-2024 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ * - Christophe Riccio <christophe@lunarg.com>
+ */
+
+#include "file_watcher.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QFileInfoList>
+
+// Editors and installers often write a file in several steps, wait for the directories to be quiet before reloading
+static const int DEBOUNCE_DELAY_MS = 250;
+
+static QString GetAbsolutePath(const std::string &path) { return QDir(path.c_str()).absolutePath(); }
+
+FileWatcher::FileWatcher(QObject *parent) : QObject(parent) {
+    this->timer.setSingleShot(true);
+    this->timer.setInterval(DEBOUNCE_DELAY_MS);
+
+    connect(&this->watcher, SIGNAL(directoryChanged(const QString &)), this, SLOT(OnDirectoryChanged(const QString &)));
+    connect(&this->watcher, SIGNAL(fileChanged(const QString &)), this, SLOT(OnFileChanged(const QString &)));
+    connect(&this->timer, SIGNAL(timeout()), this, SLOT(OnTimeout()));
+}
+
+void FileWatcher::Watch(const std::vector<std::string> &layers_paths, const std::string &configurations_path) {
+    QStringList directories;
+    for (std::size_t i = 0, n = layers_paths.size(); i < n; ++i) {
+        const QString &directory = GetAbsolutePath(layers_paths[i]);
+        if (QFileInfo(directory).isDir() && !directories.contains(directory)) {
+            directories.append(directory);
+        }
+    }
+
+    this->layers_directories = directories;
+    this->configurations_directory = GetAbsolutePath(configurations_path);
+
+    if (QFileInfo(this->configurations_directory).isDir() && !directories.contains(this->configurations_directory)) {
+        directories.append(this->configurations_directory);
+    }
+
+    // Only the directories that are no longer or not yet watched are updated
+    std::vector<QString> unwatched_directories;
+    for (auto it = this->snapshots.begin(), end = this->snapshots.end(); it != end; ++it) {
+        if (!directories.contains(it->first)) {
+            unwatched_directories.push_back(it->first);
+        }
+    }
+
+    for (std::size_t i = 0, n = unwatched_directories.size(); i < n; ++i) {
+        this->UnwatchDirectory(unwatched_directories[i]);
+    }
+
+    for (int i = 0, n = directories.size(); i < n; ++i) {
+        if (this->snapshots.find(directories[i]) == this->snapshots.end()) {
+            this->WatchDirectory(directories[i]);
+        }
+    }
+}
+
+FileWatcher::DirectorySnapshot FileWatcher::TakeSnapshot(const QString &path) {
+    DirectorySnapshot snapshot;
+
+    const QFileInfoList &files = QDir(path).entryInfoList(QStringList() << "*.json", QDir::Files | QDir::NoDotAndDotDot);
+    for (int i = 0, n = files.size(); i < n; ++i) {
+        FileStamp stamp;
+        stamp.last_modified = files[i].lastModified();
+        stamp.size = files[i].size();
+        snapshot[files[i].absoluteFilePath()] = stamp;
+    }
+
+    return snapshot;
+}
+
+void FileWatcher::WatchDirectory(const QString &path) {
+    const DirectorySnapshot &snapshot = this->snapshots[path] = TakeSnapshot(path);
+
+    // Files are watched too because modifying a file in place doesn't notify its directory on all platforms
+    QStringList paths;
+    paths.append(path);
+    for (auto it = snapshot.begin(), end = snapshot.end(); it != end; ++it) {
+        paths.append(it->first);
+    }
+
+    this->watcher.addPaths(paths);
+}
+
+void FileWatcher::UnwatchDirectory(const QString &path) {
+    const DirectorySnapshot &snapshot = this->snapshots[path];
+
+    QStringList paths;
+    paths.append(path);
+    for (auto it = snapshot.begin(), end = snapshot.end(); it != end; ++it) {
+        paths.append(it->first);
+    }
+
+    this->watcher.removePaths(paths);
+    this->snapshots.erase(path);
+}
+
+QStringList FileWatcher::CollectChanges(const QString &path) {
+    QStringList changes;
+
+    auto found = this->snapshots.find(path);
+    if (found == this->snapshots.end()) {
+        return changes;
+    }
+
+    const DirectorySnapshot &previous = found->second;
+    const DirectorySnapshot &current = TakeSnapshot(path);
+
+    for (auto it = current.begin(), end = current.end(); it != end; ++it) {
+        auto previous_it = previous.find(it->first);
+        if (previous_it == previous.end()) {
+            changes.append(it->first);  // Added
+        } else if (previous_it->second.last_modified != it->second.last_modified || previous_it->second.size != it->second.size) {
+            changes.append(it->first);  // Modified
+        }
+    }
+
+    for (auto it = previous.begin(), end = previous.end(); it != end; ++it) {
+        if (current.find(it->first) == current.end()) {
+            changes.append(it->first);  // Removed
+        }
+    }
+
+    found->second = current;
+
+    // A file replaced by a rename or newly created is no longer or not yet watched
+    const QStringList &watched_files = this->watcher.files();
+    for (auto it = current.begin(), end = current.end(); it != end; ++it) {
+        if (!watched_files.contains(it->first)) {
+            this->watcher.addPath(it->first);
+        }
+    }
+
+    return changes;
+}
+
+void FileWatcher::OnDirectoryChanged(const QString &path) {
+    if (!this->pending_directories.contains(path)) {
+        this->pending_directories.append(path);
+    }
+
+    this->timer.start();
+}
+
+void FileWatcher::OnFileChanged(const QString &path) {
+    if (!this->pending_files.contains(path)) {
+        this->pending_files.append(path);
+    }
+
+    const QString &directory = QFileInfo(path).absolutePath();
+    if (!this->pending_directories.contains(directory)) {
+        this->pending_directories.append(directory);
+    }
+
+    this->timer.start();
+}
+
+void FileWatcher::OnTimeout() {
+    QStringList changes = this->pending_files;
+    for (int i = 0, n = this->pending_directories.size(); i < n; ++i) {
+        changes.append(this->CollectChanges(this->pending_directories[i]));
+    }
+    changes.removeDuplicates();
+
+    this->pending_files.clear();
+    this->pending_directories.clear();
+
+    QStringList layer_files;
+    QStringList configuration_files;
+
+    for (int i = 0, n = changes.size(); i < n; ++i) {
+        const QFileInfo info(changes[i]);
+        if (info.suffix() != "json") {
+            continue;
+        }
+
+        const QString &directory = info.absolutePath();
+        if (directory == this->configurations_directory) {
+            configuration_files.append(info.absoluteFilePath());
+        } else if (this->layers_directories.contains(directory)) {
+            layer_files.append(info.absoluteFilePath());
+        }
+    }
+
+    if (!layer_files.empty()) {
+        emit LayerFilesChanged(layer_files);
+    }
+
+    if (!configuration_files.empty()) {
+        emit ConfigurationFilesChanged(configuration_files);
+    }
+}
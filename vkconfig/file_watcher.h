@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2020-2024 Valve Corporation
+ * Copyright (c) 2020-2024 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ * - Christophe Riccio <christophe@lunarg.com>
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QDateTime>
+#include <QStringList>
+
+#include <string>
+#include <vector>
+#include <map>
+
+// Watch the layer manifests and the configuration files directories. Bursts of file system events are coalesced so that only
+// the files actually added, modified or removed are reported once the directories are quiet.
+class FileWatcher : public QObject {
+    Q_OBJECT
+   public:
+    FileWatcher(QObject *parent = nullptr);
+
+    // Set the directories to watch, directories that don't exist are ignored
+    void Watch(const std::vector<std::string> &layers_paths, const std::string &configurations_path);
+
+   Q_SIGNALS:
+    void LayerFilesChanged(const QStringList &files);
+    void ConfigurationFilesChanged(const QStringList &files);
+
+   private Q_SLOTS:
+    void OnDirectoryChanged(const QString &path);
+    void OnFileChanged(const QString &path);
+    void OnTimeout();
+
+   private:
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+
+    struct FileStamp {
+        QDateTime last_modified;
+        qint64 size;
+    };
+    typedef std::map<QString, FileStamp> DirectorySnapshot;
+
+    static DirectorySnapshot TakeSnapshot(const QString &path);
+    void WatchDirectory(const QString &path);
+    void UnwatchDirectory(const QString &path);
+    QStringList CollectChanges(const QString &path);
+
+    QFileSystemWatcher watcher;
+    QTimer timer;
+
+    std::map<QString, DirectorySnapshot> snapshots;  // Indexed by watched directory
+    QStringList layers_directories;
+    QString configurations_directory;
+
+    QStringList pending_directories;
+    QStringList pending_files;
+};
@@ -23,10 +23,12 @@
 #include "main_layers.h"
 #include "main_doc.h"
 #include "main_signal.h"
+#include "vulkan_util.h"
 
 #include "../vkconfig_core/path.h"
 
 #include <cassert>
+#include <cstring>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -36,6 +38,11 @@
 #include <QtCore>
 
 int main(int argc, char* argv[]) {
+    // Child process started by the GUI to report the Vulkan status without loading the drivers in the GUI process
+    if (argc == 2 && std::strcmp(argv[1], VULKAN_STATUS_PROBE_ARG) == 0) {
+        return RunVulkanStatusProbe();
+    }
+
 #ifdef _WIN32
     DWORD procId;
     DWORD count = GetConsoleProcessList(&procId, 1);
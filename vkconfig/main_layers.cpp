@@ -152,6 +152,11 @@ int run_layers(const CommandLine& command_line) {
         case COMMAND_LAYERS_VERBOSE: {
             return RunLayersVerbose(command_line);
         }
+        case COMMAND_LAYERS_BATCH:
+        case COMMAND_LAYERS_SERVER: {
+            printf("\nThe layers batch and server modes require vkconfig3...\n");
+            return -1;
+        }
         default: {
             assert(0);
             return -1;
@@ -37,6 +37,8 @@
 #include "../vkconfig_core/help.h"
 #include "../vkconfig_core/doc.h"
 #include "../vkconfig_core/date.h"
+#include "../vkconfig_core/override.h"
+#include "../vkconfig_core/path.h"
 
 #include <QProcess>
 #include <QMessageBox>
@@ -48,6 +50,9 @@
 #include <QSettings>
 #include <QDesktopServices>
 #include <QPropertyAnimation>
+#include <QApplication>
+#include <QDir>
+#include <QTimer>
 
 #if VKC_PLATFORM == VKC_PLATFORM_LINUX || VKC_PLATFORM == VKC_PLATFORM_MACOS
 #include <unistd.h>
@@ -63,6 +68,7 @@ static const int LAUNCH_ROW_HEIGHT = 26;
 #else
 static const int LAUNCH_ROW_HEIGHT = 28;
 #endif
+static const int FILE_CHANGES_POSTPONE_MS = 1000;  // Wait for the opened dialog to close
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent),
@@ -123,6 +129,13 @@ MainWindow::MainWindow(QWidget *parent)
 
     connect(ui->launcher_loader_debug, SIGNAL(currentIndexChanged(int)), this, SLOT(OnLauncherLoaderMessageChanged(int)));
 
+    _file_changes_timer.setSingleShot(true);
+    connect(&_file_changes_timer, SIGNAL(timeout()), this, SLOT(ApplyFileChanges()));
+    connect(&_file_watcher, SIGNAL(LayerFilesChanged(const QStringList &)), this, SLOT(OnLayerFilesChanged(const QStringList &)));
+    connect(&_file_watcher, SIGNAL(ConfigurationFilesChanged(const QStringList &)), this,
+            SLOT(OnConfigurationFilesChanged(const QStringList &)));
+    connect(&_vulkan_status_probe, SIGNAL(ResultReady()), this, SLOT(OnVulkanStatusReady()));
+
     Configurator &configurator = Configurator::Get();
     Environment &environment = configurator.environment;
 
@@ -148,6 +161,9 @@ MainWindow::MainWindow(QWidget *parent)
     this->InitTray();
     this->UpdateTray();
     this->UpdateUI();
+
+    // Probe early so that the status is usually ready when it's first displayed
+    _vulkan_status_probe.Request();
 }
 
 MainWindow::~MainWindow() { ResetLaunchApplication(); }
@@ -311,6 +327,36 @@ static std::string GetMainWindowTitle(bool active) {
     return title;
 }
 
+static QString GetVulkanStatusText(const VulkanStatusProbe &probe) {
+    return ("Vulkan Development Status:\n" + GenerateVulkanStatus(probe) + "\n").c_str();
+}
+
+// Compare the layers settings file read by the layers with the active configuration
+static QString GetAppliedSettingsText() {
+    Configurator &configurator = Configurator::Get();
+
+    if (!configurator.configurations.HasActiveConfiguration(configurator.layers.available_layers)) {
+        return QString();
+    }
+
+    const Configuration *configuration = configurator.configurations.FindActiveConfiguration();
+    assert(configuration != nullptr);
+
+    const std::vector<std::string> &differences = CompareSettingsOverride(
+        configurator.layers.available_layers, *configuration, GetPath(BUILTIN_PATH_OVERRIDE_SETTINGS));
+
+    std::string text = "Applied Layers Settings:\n";
+    if (differences.empty()) {
+        text += format("- The layers settings of '%s' are applied\n", configuration->key.c_str());
+    } else {
+        for (std::size_t i = 0, n = differences.size(); i < n; ++i) {
+            text += "- " + differences[i] + "\n";
+        }
+    }
+
+    return (text + "\n").c_str();
+}
+
 void MainWindow::UpdateUI() {
     static int check_recurse = 0;
     ++check_recurse;
@@ -450,6 +496,9 @@ void MainWindow::UpdateUI() {
     // Update title bar
     setWindowTitle(GetMainWindowTitle(has_active_configuration).c_str());
 
+    // The layers paths may have changed with the selected configuration
+    this->UpdateFileWatcher();
+
     ui->configuration_tree->blockSignals(false);
     this->blockSignals(false);
 
@@ -724,14 +773,12 @@ void MainWindow::OnConfigurationItemChanged(QTreeWidgetItem *item, int column) {
             Alert::ConfigurationRenamingFailed();
         }
 
-        // Find existing configuration using it's old name
         const std::string old_name = configuration_item->configuration_name;
-        Configuration *configuration = FindByKey(configurator.configurations.available_configurations, old_name.c_str());
 
         if (valid_new_name) {
             // Rename configuration ; Remove old configuration file ; change the name of the configuration
-            configurator.configurations.RemoveConfigurationFile(old_name);
-            configuration->key = configuration_item->configuration_name = new_name;
+            configurator.configurations.RenameConfiguration(old_name, new_name);
+            configuration_item->configuration_name = new_name;
             configurator.configurations.SaveAllConfigurations(configurator.layers.available_layers);
 
             configurator.ActivateConfiguration(new_name);
@@ -1449,12 +1496,60 @@ void MainWindow::on_push_button_clear_log_clicked() {
     ui->push_button_clear_log->setEnabled(false);
 }
 
+void MainWindow::OnVulkanStatusReady() {
+    ApplyVulkanStatus(_vulkan_status_probe);
+
+    if (_pending_vulkan_status.isEmpty()) {
+        return;
+    }
+
+    const QString &status = GetVulkanStatusText(_vulkan_status_probe);
+
+    // Replace the statuses displayed while probing, unless they were cleared from the log in the meantime
+    QString text = ui->log_browser->toPlainText();
+    for (int i = 0, n = _pending_vulkan_status.size(); i < n; ++i) {
+        const int index = text.indexOf(_pending_vulkan_status[i]);
+        if (index >= 0) {
+            text.replace(index, _pending_vulkan_status[i].size(), status);
+        }
+    }
+    ui->log_browser->setPlainText(text);
+
+    _pending_vulkan_status.clear();
+
+    // The log file is only appended, the status follows the output the application logged while it was probed
+    if (!_pending_vulkan_status_log_file.isEmpty()) {
+        const std::string &log = status.toStdString();
+        if (_log_file.isOpen() && _log_file.fileName() == _pending_vulkan_status_log_file) {
+            _log_file.write(log.c_str(), log.size());
+            _log_file.flush();
+        } else {
+            QFile log_file(_pending_vulkan_status_log_file);
+            if (log_file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Append)) {
+                log_file.write(log.c_str(), log.size());
+            }
+        }
+        _pending_vulkan_status_log_file.clear();
+    }
+}
+
 void MainWindow::on_push_button_status_clicked() { this->UpdateStatus(); }
 
 void MainWindow::UpdateStatus() {
+    // The status and the applied settings are read from the layers override files
+    _settings_tree_manager.FlushPendingChanges();
+
     ui->push_button_clear_log->setEnabled(true);
 
-    QString text = ("Vulkan Development Status:\n" + GenerateVulkanStatus() + "\n").c_str();
+    // The status button always reports a fresh probe, in case the drivers changed without the environment changing
+    _vulkan_status_probe.Request(false);
+
+    const QString &status = GetVulkanStatusText(_vulkan_status_probe);
+    if (_vulkan_status_probe.GetResult() == nullptr) {
+        _pending_vulkan_status.append(status);
+    }
+
+    QString text = status + GetAppliedSettingsText();
 
     if (!ui->check_box_clear_on_launch->isChecked()) {
         text += ui->log_browser->toPlainText();
@@ -1589,10 +1684,12 @@ bool MainWindow::eventFilter(QObject *target, QEvent *event) {
                         break;
                 }
                 configuration->setting_tree_state.clear();
+                configuration->dirty = true;
                 require_update_ui = true;
             } else if (action == show_advanced_setting_action) {
                 configuration->view_advanced_settings = action->isChecked();
                 configuration->setting_tree_state.clear();
+                configuration->dirty = true;
             } else if (action == export_html_action) {
                 const std::string path = format("%s/%s.html", GetPath(BUILTIN_PATH_APPDATA).c_str(), layer->key.c_str());
                 ExportHtmlDoc(*layer, path);
@@ -1728,10 +1825,19 @@ void MainWindow::on_push_button_launcher_clicked() {
         return;
     }
 
+    // The application reads the layers override files, the last edits must be written before it starts
+    _settings_tree_manager.FlushPendingChanges();
+
     std::string launch_log;
 
     // Update the Vulkan Developemnt status to record the system configuration
-    QString vulkan_status = ("Vulkan Development Status:\n" + GenerateVulkanStatus() + "\n").c_str();
+    _vulkan_status_probe.Request();
+
+    const QString &vulkan_status = GetVulkanStatusText(_vulkan_status_probe);
+    const bool probing = _vulkan_status_probe.GetResult() == nullptr;
+    if (probing) {
+        _pending_vulkan_status.append(vulkan_status);
+    }
     launch_log += vulkan_status.toStdString();
 
     // We are logging, let's add that we've launched a new application
@@ -1782,6 +1888,11 @@ void MainWindow::on_push_button_launcher_clicked() {
         }
     }
 
+    // The log file records the status while it's probed, the result is appended once it's ready
+    if (probing && _log_file.isOpen()) {
+        _pending_vulkan_status_log_file = _log_file.fileName();
+    }
+
     if (ui->check_box_clear_on_launch->isChecked()) {
         ui->log_browser->clear();
     }
@@ -1874,3 +1985,87 @@ void MainWindow::Log(const std::string &log) {
         _log_file.flush();
     }
 }
+
+void MainWindow::UpdateFileWatcher() {
+    const Configurator &configurator = Configurator::Get();
+
+    std::vector<std::string> layers_paths;
+
+    const std::vector<std::string> &search_paths = configurator.layers.BuildPathList();
+    for (std::size_t i = 0, n = search_paths.size(); i < n; ++i) {
+        const std::string &path = search_paths[i];
+
+        // Registry locations are not directories, the directories of the layers they list are watched below
+        if (path.empty() || QString(path.c_str()).startsWith("HKEY")) continue;
+
+        if (VKC_PLATFORM != VKC_PLATFORM_WINDOWS && path[0] == '.') {
+            layers_paths.push_back(QDir().homePath().toStdString() + "/" + path);
+        } else {
+            layers_paths.push_back(path);
+        }
+    }
+
+    for (std::size_t i = 0, n = configurator.layers.available_layers.size(); i < n; ++i) {
+        const std::string &manifest_path = configurator.layers.available_layers[i].manifest_path;
+        AppendString(layers_paths, QFileInfo(manifest_path.c_str()).absolutePath().toStdString());
+    }
+
+    _file_watcher.Watch(layers_paths, GetPath(BUILTIN_PATH_CONFIG_LAST));
+}
+
+void MainWindow::OnLayerFilesChanged(const QStringList &files) {
+    for (int i = 0, n = files.size(); i < n; ++i) {
+        if (!_pending_layer_files.contains(files[i])) _pending_layer_files.append(files[i]);
+    }
+
+    this->ApplyFileChanges();
+}
+
+void MainWindow::OnConfigurationFilesChanged(const QStringList &files) {
+    for (int i = 0, n = files.size(); i < n; ++i) {
+        if (!_pending_configuration_files.contains(files[i])) _pending_configuration_files.append(files[i]);
+    }
+
+    this->ApplyFileChanges();
+}
+
+/// Layers and configurations modified by another process, an installer or a text editor,
+/// are reloaded without restarting Vulkan Configurator. Only the changed files are reloaded.
+void MainWindow::ApplyFileChanges() {
+    // The file watcher already debounced the changes. Don't replace the layers and configurations used by an opened dialog,
+    // the changes are batched until it's closed.
+    if (QApplication::activeModalWidget() != nullptr) {
+        _file_changes_timer.start(FILE_CHANGES_POSTPONE_MS);
+        return;
+    }
+
+    Configurator &configurator = Configurator::Get();
+
+    // The configuration files saved by Vulkan Configurator itself are not reloaded
+    std::vector<std::string> configuration_files;
+    for (int i = 0, n = _pending_configuration_files.size(); i < n; ++i) {
+        const std::string path = _pending_configuration_files[i].toStdString();
+        if (configurator.configurations.HasConfigurationFileChanged(path)) configuration_files.push_back(path);
+    }
+    _pending_configuration_files.clear();
+
+    std::vector<std::string> layer_files;
+    for (int i = 0, n = _pending_layer_files.size(); i < n; ++i) {
+        layer_files.push_back(_pending_layer_files[i].toStdString());
+    }
+    _pending_layer_files.clear();
+
+    if (layer_files.empty() && configuration_files.empty()) return;
+
+    // The settings tree widgets reference the settings of the layers and configurations about to be reloaded
+    _settings_tree_manager.CleanupGUI();
+
+    const bool layers_updated = configurator.UpdateLayerFiles(layer_files);
+    const bool configurations_updated = configurator.UpdateConfigurationFiles(configuration_files);
+
+    if (layers_updated || configurations_updated) {
+        LoadConfigurationList();
+    }
+
+    this->UpdateUI();
+}
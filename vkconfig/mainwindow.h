@@ -23,6 +23,8 @@
 
 #include "configurator.h"
 #include "settings_tree.h"
+#include "vulkan_util.h"
+#include "file_watcher.h"
 
 #include "ui_mainwindow.h"
 
@@ -34,6 +36,7 @@
 #include <QShowEvent>
 #include <QResizeEvent>
 #include <QProcess>
+#include <QTimer>
 #include <QSystemTrayIcon>
 
 #include <memory>
@@ -67,6 +70,15 @@ class MainWindow : public QMainWindow {
    private:
     SettingsTreeManager _settings_tree_manager;
 
+    VulkanStatusProbe _vulkan_status_probe;
+    QStringList _pending_vulkan_status;  // Statuses displayed while the probe is running, replaced once the result is ready
+    QString _pending_vulkan_status_log_file;  // Log file of a launch that recorded the status while it was probed
+
+    FileWatcher _file_watcher;
+    QStringList _pending_layer_files;
+    QStringList _pending_configuration_files;
+    QTimer _file_changes_timer;  // Applies the changes batched while a modal dialog is open
+
     std::unique_ptr<QProcess> _launch_application;  // Keeps track of the monitored app
     QFile _log_file;                                // Log file for layer output
 
@@ -112,6 +124,7 @@ class MainWindow : public QMainWindow {
     void ReloadDefaultClicked(ConfigurationListItem *item);
 
    private slots:
+    void OnVulkanStatusReady();
     void trayActionRestore();
     void trayActionControlledByApplications();
     void trayActionControlledByConfigurator();
@@ -170,6 +183,10 @@ class MainWindow : public QMainWindow {
     void errorOutputAvailable();                                    // Layeroutput is available
     void processClosed(int exitCode, QProcess::ExitStatus status);  // app died
 
+    void OnLayerFilesChanged(const QStringList &files);
+    void OnConfigurationFilesChanged(const QStringList &files);
+    void ApplyFileChanges();
+
    private:
     MainWindow(const MainWindow &) = delete;
     MainWindow &operator=(const MainWindow &) = delete;
@@ -183,6 +200,7 @@ class MainWindow : public QMainWindow {
     void StartTool(Tool tool);
     QStringList BuildEnvVariables() const;
     void UpdateStatus();
+    void UpdateFileWatcher();
 
     void ClearLog();
 
@@ -50,7 +50,15 @@
 static const char *TOOLTIP_ORDER =
     "Layers are executed between the Vulkan application and driver in the specific order represented here";
 
-SettingsTreeManager::SettingsTreeManager() : launched_application(false), tree(nullptr) {}
+// Bursts of edits, such as typing in a text field, are applied to the layers override files once
+static const int CONFIGURE_DELAY_MS = 100;
+
+SettingsTreeManager::SettingsTreeManager() : launched_application(false), tree(nullptr) {
+    this->configure_timer.setSingleShot(true);
+    this->configure_timer.setInterval(CONFIGURE_DELAY_MS);
+
+    this->connect(&this->configure_timer, SIGNAL(timeout()), this, SLOT(OnConfigureTimeout()));
+}
 
 void SettingsTreeManager::CreateGUI(QTreeWidget *build_tree) {
     assert(build_tree);
@@ -196,13 +204,18 @@ void SettingsTreeManager::CreateGUI(QTreeWidget *build_tree) {
 
     this->connect(this->tree, SIGNAL(expanded(const QModelIndex)), this, SLOT(OnExpandedChanged(const QModelIndex)));
     this->connect(this->tree, SIGNAL(collapsed(const QModelIndex)), this, SLOT(OnCollapsedChanged(const QModelIndex)));
-
-    this->tree->resizeColumnToContents(0);
+    this->connect(this->tree, SIGNAL(itemExpanded(QTreeWidgetItem *)), this, SLOT(OnItemExpanded(QTreeWidgetItem *)),
+                  Qt::UniqueConnection);
 
     if (!configuration->setting_tree_state.isEmpty()) {
         this->SetTreeState(configuration->setting_tree_state, 0, this->tree->invisibleRootItem());
     }
 
+    // Widgets are only built for the visible items, the others are built when their parent item is first expanded
+    this->BuildVisibleWidgets(this->tree->invisibleRootItem());
+
+    this->tree->resizeColumnToContents(0);
+
     this->tree->blockSignals(false);
 }
 
@@ -210,12 +223,19 @@ void SettingsTreeManager::CleanupGUI() {
     if (this->tree == nullptr)  // Was not initialized
         return;
 
+    this->FlushPendingChanges();
+
+    this->widget_keys.clear();
+    this->dependent_items.clear();
+    this->pending_widgets.clear();
+
     Configurator &configurator = Configurator::Get();
 
     Configuration *configuration = configurator.configurations.FindActiveConfiguration();
     if (configuration != nullptr) {
         configuration->setting_tree_state.clear();
         GetTreeState(configuration->setting_tree_state, this->tree->invisibleRootItem());
+        configuration->dirty = true;
     }
 
     this->validation.reset();
@@ -235,6 +255,7 @@ void SettingsTreeManager::OnExpandedChanged(const QModelIndex &index) {
     Configuration *configuration = configurator.configurations.FindActiveConfiguration();
     configuration->setting_tree_state.clear();
     GetTreeState(configuration->setting_tree_state, this->tree->invisibleRootItem());
+    configuration->dirty = true;
 
     return;
 }
@@ -250,6 +271,7 @@ void SettingsTreeManager::OnCollapsedChanged(const QModelIndex &index) {
     Configuration *configuration = configurator.configurations.FindActiveConfiguration();
     configuration->setting_tree_state.clear();
     GetTreeState(configuration->setting_tree_state, this->tree->invisibleRootItem());
+    configuration->dirty = true;
 
     return;
 }
@@ -267,6 +289,8 @@ void SettingsTreeManager::BuildValidationTree(QTreeWidgetItem *parent, Parameter
     this->validation.reset(
         new WidgetSettingValidation(this->tree, validation_areas_item, validation_layer->settings, parameter.settings));
     this->connect(this->validation.get(), SIGNAL(itemChanged()), this, SLOT(OnSettingChanged()));
+    this->widget_keys[this->validation.get()].push_back("enables");
+    this->widget_keys[this->validation.get()].push_back("disables");
 
     SettingMetaSet &settings = validation_layer->settings;
     for (std::size_t i = 0, n = settings.size(); i < n; ++i) {
@@ -315,49 +339,23 @@ void SettingsTreeManager::BuildTreeItem(QTreeWidgetItem *parent, Parameter &para
             item->setExpanded(meta_object.expanded);
         } break;
         case SETTING_BOOL:
-        case SETTING_BOOL_NUMERIC_DEPRECATED: {
-            const SettingMetaBool &meta = static_cast<const SettingMetaBool &>(meta_object);
-
-            WidgetSettingBool *widget = new WidgetSettingBool(tree, item, meta, parameter.settings);
-            this->connect(widget, SIGNAL(itemChanged()), this, SLOT(OnSettingChanged()));
-        } break;
-
-        case SETTING_INT: {
-            const SettingMetaInt &meta = static_cast<const SettingMetaInt &>(meta_object);
-
-            WidgetSettingInt *widget = new WidgetSettingInt(tree, item, meta, parameter.settings);
-            this->connect(widget, SIGNAL(itemChanged()), this, SLOT(OnSettingChanged()));
-        } break;
-
-        case SETTING_FLOAT: {
-            const SettingMetaFloat &meta = static_cast<const SettingMetaFloat &>(meta_object);
-
-            WidgetSettingFloat *widget = new WidgetSettingFloat(tree, item, meta, parameter.settings);
-            this->connect(widget, SIGNAL(itemChanged()), this, SLOT(OnSettingChanged()));
-        } break;
-
-        case SETTING_FRAMES: {
-            const SettingMetaFrames &meta = static_cast<const SettingMetaFrames &>(meta_object);
-
-            WidgetSettingFrames *widget = new WidgetSettingFrames(tree, item, meta, parameter.settings);
-            this->connect(widget, SIGNAL(itemChanged()), this, SLOT(OnSettingChanged()));
-        } break;
-
+        case SETTING_BOOL_NUMERIC_DEPRECATED:
+        case SETTING_INT:
+        case SETTING_FLOAT:
+        case SETTING_FRAMES:
         case SETTING_SAVE_FILE:
         case SETTING_LOAD_FILE:
         case SETTING_SAVE_FOLDER:
-        case SETTING_LOAD_FOLDER: {
-            const SettingMetaFilesystem &meta = static_cast<const SettingMetaFilesystem &>(meta_object);
-
-            WidgetSettingFilesystem *widget = new WidgetSettingFilesystem(tree, item, meta, parameter.settings);
-            this->connect(widget, SIGNAL(itemChanged()), this, SLOT(OnSettingChanged()));
+        case SETTING_LOAD_FOLDER:
+        case SETTING_STRING:
+        case SETTING_LIST: {
+            this->AddPendingWidget(item, parameter, meta_object, "", meta_object.expanded);
         } break;
 
         case SETTING_ENUM: {
             const SettingMetaEnum &meta = static_cast<const SettingMetaEnum &>(meta_object);
 
-            WidgetSettingEnum *enum_widget = new WidgetSettingEnum(tree, item, meta, parameter.settings);
-            this->connect(enum_widget, SIGNAL(itemChanged()), this, SLOT(OnSettingChanged()));
+            this->AddPendingWidget(item, parameter, meta_object, "", meta_object.expanded);
 
             for (std::size_t i = 0, n = meta.enum_values.size(); i < n; ++i) {
                 const SettingEnumValue &value = meta.enum_values[i];
@@ -387,8 +385,7 @@ void SettingsTreeManager::BuildTreeItem(QTreeWidgetItem *parent, Parameter &para
                 QTreeWidgetItem *child = new QTreeWidgetItem();
                 item->addChild(child);
 
-                WidgetSettingFlag *widget = new WidgetSettingFlag(tree, child, meta, parameter.settings, value.key.c_str());
-                this->connect(widget, SIGNAL(itemChanged()), this, SLOT(OnSettingChanged()));
+                this->AddPendingWidget(child, parameter, meta_object, value.key, value.expanded);
 
                 for (std::size_t j = 0, o = value.settings.size(); j < o; ++j) {
                     this->BuildTreeItem(child, parameter, *value.settings[j]);
@@ -396,28 +393,121 @@ void SettingsTreeManager::BuildTreeItem(QTreeWidgetItem *parent, Parameter &para
             }
         } break;
 
-        case SETTING_STRING: {
-            const SettingMetaString &meta = static_cast<const SettingMetaString &>(meta_object);
-
-            WidgetSettingString *widget = new WidgetSettingString(tree, item, meta, parameter.settings);
-            this->connect(widget, SIGNAL(itemChanged()), this, SLOT(OnSettingChanged()));
+        default: {
+            item->setText(0, "Unknown setting");
+            assert(0);  // Unknown setting
         } break;
+    }
 
-        case SETTING_LIST: {
-            const SettingMetaList &meta = static_cast<const SettingMetaList &>(meta_object);
+    for (std::size_t i = 0, n = meta_object.children.size(); i < n; ++i) {
+        this->BuildTreeItem(item, parameter, *meta_object.children[i]);
+    }
+}
 
-            WidgetSettingList *widget = new WidgetSettingList(tree, item, meta, parameter.settings);
-            this->connect(widget, SIGNAL(itemChanged()), this, SLOT(OnSettingChanged()));
-        } break;
+void SettingsTreeManager::AddPendingWidget(QTreeWidgetItem *item, Parameter &parameter, const SettingMeta &meta,
+                                           const std::string &flag, bool expanded) {
+    PendingWidget pending_widget;
+    pending_widget.parameter = &parameter;
+    pending_widget.meta = &meta;
+    pending_widget.flag = flag;
+    this->pending_widgets[item] = pending_widget;
 
+    // Set by the widget when built but required beforehand to know whether the children items are visible
+    item->setExpanded(expanded);
+}
+
+void SettingsTreeManager::BuildWidget(QTreeWidgetItem *item) {
+    auto found = this->pending_widgets.find(item);
+    if (found == this->pending_widgets.end()) {
+        return;
+    }
+
+    const PendingWidget pending_widget = found->second;
+    this->pending_widgets.erase(found);
+
+    SettingDataSet &data_set = pending_widget.parameter->settings;
+    const SettingMeta &meta = *pending_widget.meta;
+
+    // Widgets reset the item expanded state from the layer manifest, keep the state restored from the configuration
+    const bool expanded = item->isExpanded();
+    const bool blocked = this->tree->blockSignals(true);
+
+    WidgetSettingBase *widget = nullptr;
+    switch (meta.type) {
+        case SETTING_BOOL:
+        case SETTING_BOOL_NUMERIC_DEPRECATED: {
+            widget = new WidgetSettingBool(tree, item, static_cast<const SettingMetaBool &>(meta), data_set);
+        } break;
+        case SETTING_INT: {
+            widget = new WidgetSettingInt(tree, item, static_cast<const SettingMetaInt &>(meta), data_set);
+        } break;
+        case SETTING_FLOAT: {
+            widget = new WidgetSettingFloat(tree, item, static_cast<const SettingMetaFloat &>(meta), data_set);
+        } break;
+        case SETTING_FRAMES: {
+            widget = new WidgetSettingFrames(tree, item, static_cast<const SettingMetaFrames &>(meta), data_set);
+        } break;
+        case SETTING_SAVE_FILE:
+        case SETTING_LOAD_FILE:
+        case SETTING_SAVE_FOLDER:
+        case SETTING_LOAD_FOLDER: {
+            widget = new WidgetSettingFilesystem(tree, item, static_cast<const SettingMetaFilesystem &>(meta), data_set);
+        } break;
+        case SETTING_ENUM: {
+            widget = new WidgetSettingEnum(tree, item, static_cast<const SettingMetaEnum &>(meta), data_set);
+        } break;
+        case SETTING_FLAGS: {
+            widget = new WidgetSettingFlag(tree, item, static_cast<const SettingMetaFlags &>(meta), data_set,
+                                           pending_widget.flag.c_str());
+        } break;
+        case SETTING_STRING: {
+            widget = new WidgetSettingString(tree, item, static_cast<const SettingMetaString &>(meta), data_set);
+        } break;
+        case SETTING_LIST: {
+            widget = new WidgetSettingList(tree, item, static_cast<const SettingMetaList &>(meta), data_set);
+        } break;
         default: {
-            item->setText(0, "Unknown setting");
             assert(0);  // Unknown setting
         } break;
     }
 
-    for (std::size_t i = 0, n = meta_object.children.size(); i < n; ++i) {
-        this->BuildTreeItem(item, parameter, *meta_object.children[i]);
+    item->setExpanded(expanded);
+    this->tree->blockSignals(blocked);
+
+    if (widget == nullptr) {
+        return;
+    }
+
+    this->connect(widget, SIGNAL(itemChanged()), this, SLOT(OnSettingChanged()));
+    this->AddWidget(widget, item, meta);
+}
+
+void SettingsTreeManager::BuildVisibleWidgets(QTreeWidgetItem *parent) {
+    for (int i = 0, n = parent->childCount(); i < n; ++i) {
+        QTreeWidgetItem *child = parent->child(i);
+
+        this->BuildWidget(child);
+
+        if (child->isExpanded()) {
+            this->BuildVisibleWidgets(child);
+        }
+    }
+}
+
+void SettingsTreeManager::OnItemExpanded(QTreeWidgetItem *item) {
+    if (this->pending_widgets.empty()) {
+        return;
+    }
+
+    this->BuildVisibleWidgets(item);
+    this->tree->resizeColumnToContents(0);
+}
+
+void SettingsTreeManager::AddWidget(QObject *widget, QTreeWidgetItem *item, const SettingMeta &meta) {
+    this->widget_keys[widget].push_back(meta.key);
+
+    for (std::size_t i = 0, n = meta.dependence.size(); i < n; ++i) {
+        this->dependent_items[meta.dependence[i]->key].push_back(item);
     }
 }
 
@@ -458,7 +548,29 @@ int SettingsTreeManager::SetTreeState(QByteArray &byte_array, int index, QTreeWi
 
 void SettingsTreeManager::OnPresetChanged() { this->Refresh(REFRESH_ENABLE_AND_STATE); }
 
-void SettingsTreeManager::OnSettingChanged() { this->Refresh(REFRESH_ENABLE_ONLY); }
+void SettingsTreeManager::OnSettingChanged() {
+    auto found = this->widget_keys.find(this->sender());
+    if (found == this->widget_keys.end()) {
+        this->Refresh(REFRESH_ENABLE_ONLY);
+        return;
+    }
+
+    // Only the settings depending on the edited settings may be enabled, disabled or hidden by the edit
+    this->tree->blockSignals(true);
+
+    for (std::size_t i = 0, n = found->second.size(); i < n; ++i) {
+        auto dependents = this->dependent_items.find(found->second[i]);
+        if (dependents == this->dependent_items.end()) continue;
+
+        for (std::size_t j = 0, o = dependents->second.size(); j < o; ++j) {
+            this->RefreshItem(REFRESH_ENABLE_ONLY, dependents->second[j]);
+        }
+    }
+
+    this->tree->blockSignals(false);
+
+    this->ApplyChanges();
+}
 
 void SettingsTreeManager::Refresh(RefreshAreas refresh_areas) {
     this->tree->blockSignals(true);
@@ -470,6 +582,10 @@ void SettingsTreeManager::Refresh(RefreshAreas refresh_areas) {
 
     this->tree->blockSignals(false);
 
+    this->ApplyChanges();
+}
+
+void SettingsTreeManager::ApplyChanges() {
     if (this->launched_application) {
         QSettings settings;
         if (!settings.value("vkconfig_restart", false).toBool()) {
@@ -480,6 +596,20 @@ void SettingsTreeManager::Refresh(RefreshAreas refresh_areas) {
     }
 
     // Refresh layer configuration
+    Configurator &configurator = Configurator::Get();
+    configurator.configurations.SetDirty(configurator.environment.GetSelectedConfiguration());
+
+    this->configure_timer.start();
+}
+
+void SettingsTreeManager::FlushPendingChanges() {
+    if (this->configure_timer.isActive()) {
+        this->configure_timer.stop();
+        this->OnConfigureTimeout();
+    }
+}
+
+void SettingsTreeManager::OnConfigureTimeout() {
     Configurator &configurator = Configurator::Get();
     configurator.configurations.Configure(configurator.layers.available_layers);
 }
@@ -46,6 +46,7 @@ SOURCES += \
     ../vkconfig_core/json_validator.cpp \
     ../vkconfig_core/layer.cpp \
     ../vkconfig_core/layer_manager.cpp \
+    ../vkconfig_core/layer_settings_file.cpp \
     ../vkconfig_core/layer_preset.cpp \
     ../vkconfig_core/layer_state.cpp \
     ../vkconfig_core/layer_type.cpp \
@@ -65,8 +66,10 @@ SOURCES += \
     ../vkconfig_core/setting_int.cpp \
     ../vkconfig_core/setting_list.cpp \
     ../vkconfig_core/setting_string.cpp \
+    ../vkconfig_core/string_pool.cpp \
     ../vkconfig_core/util.cpp \
     ../vkconfig_core/version.cpp \
+    ../vkconfig_core/vulkan_status_probe.cpp \
     vulkan_util.cpp \
     widget_preset.cpp \
     widget_setting.cpp \
@@ -95,6 +98,7 @@ SOURCES += \
     mainwindow.cpp \
     settings_tree.cpp \
     settings_validation_areas.cpp \
+    file_watcher.cpp \
     configurator.cpp
 
 HEADERS += \
@@ -113,6 +117,7 @@ HEADERS += \
     ../vkconfig_core/json_validator.h \
     ../vkconfig_core/layer.h \
     ../vkconfig_core/layer_manager.h \
+    ../vkconfig_core/layer_settings_file.h \
     ../vkconfig_core/layer_preset.h \
     ../vkconfig_core/layer_state.h \
     ../vkconfig_core/layer_type.h \
@@ -132,8 +137,10 @@ HEADERS += \
     ../vkconfig_core/setting_int.h \
     ../vkconfig_core/setting_list.h \
     ../vkconfig_core/setting_string.h \
+    ../vkconfig_core/string_pool.h \
     ../vkconfig_core/util.h \
     ../vkconfig_core/version.h \
+    ../vkconfig_core/vulkan_status_probe.h \
     vulkan_util.h \
     widget_preset.h \
     widget_setting.h \
@@ -161,6 +168,7 @@ HEADERS += \
     mainwindow.h \
     settings_validation_areas.h \
     settings_tree.h \
+    file_watcher.h \
     configurator.h
 
 FORMS += \
@@ -181,6 +189,10 @@ win32: {
   RC_ICONS = resourcefiles/vulkan.ico
 }
 
+unix: {
+  LIBS += $$QMAKE_LIBS_DYNLOAD
+}
+
 macx: {
 #CONFIG += file_copies
 #COPIES += shellScript
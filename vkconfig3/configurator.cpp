@@ -91,7 +91,7 @@ void Configurator::ActivateConfiguration(const std::string &configuration_name)
 
     if (this->environment.Get(ACTIVE_CONFIGURATION) == name) return;
 
-    Configuration *configuration = FindByKey(this->configurations.available_configurations, name.c_str());
+    Configuration *configuration = this->configurations.FindConfiguration(name);
     if (configuration == nullptr) return;
 
     this->environment.Set(ACTIVE_CONFIGURATION, configuration->key.c_str());
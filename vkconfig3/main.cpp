@@ -23,10 +23,12 @@
 #include "main_layers.h"
 #include "main_doc.h"
 #include "main_signal.h"
+#include "vulkan_util.h"
 
 #include "../vkconfig_core/path.h"
 
 #include <cassert>
+#include <cstring>
 
 #ifdef COMMAND_PROMPT_OUTPUT
 #ifdef _WIN32
@@ -35,6 +37,11 @@
 #endif  // COMMAND_PROMPT_OUTPUT
 
 int main(int argc, char* argv[]) {
+    // Child process started by the GUI to report the Vulkan status without loading the drivers in the GUI process
+    if (argc == 2 && std::strcmp(argv[1], VULKAN_STATUS_PROBE_ARG) == 0) {
+        return RunVulkanStatusProbe();
+    }
+
     ::vkconfig_version = "vkconfig3";
 
     InitSignals();
@@ -68,7 +75,7 @@ int main(int argc, char* argv[]) {
             return 0;
         }
         case COMMAND_LAYERS: {
-            return run_layers(command_line);
+            return run_layers(argc, argv, command_line);
         }
         case COMMAND_RESET: {
             return run_reset(argc, argv, command_line);
@@ -39,7 +39,11 @@ int run_doc_html(const CommandLine& command_line) {
         const Layer& layer = layers.available_layers[i];
         if (layer.key == command_line.doc_layer_name) {
             const std::string path = format("%s/%s.html", command_line.doc_out_dir.c_str(), layer.key.c_str());
-            ExportHtmlDoc(layer, path);
+            if (!ExportHtmlDoc(layer, path)) {
+                printf("vkconfig: could not write %s\n", path.c_str());
+                return -1;
+            }
+            printf("vkconfig: html file written to %s\n", path.c_str());
             return 0;
         }
     }
@@ -60,7 +64,11 @@ int run_doc_markdown(const CommandLine& command_line) {
         const Layer& layer = layers.available_layers[i];
         if (layer.key == command_line.doc_layer_name) {
             const std::string path = format("%s/%s.md", command_line.doc_out_dir.c_str(), layer.key.c_str());
-            ExportMarkdownDoc(layer, path);
+            if (!ExportMarkdownDoc(layer, path)) {
+                printf("vkconfig: could not write %s\n", path.c_str());
+                return -1;
+            }
+            printf("vkconfig: markdown file written to %s\n", path.c_str());
             return 0;
         }
     }
@@ -80,7 +88,7 @@ int run_doc_settings(const CommandLine& command_line) {
     Layer* layer;
 
     layers.LoadLayer(command_line.doc_layer_name);
-    layer = FindByKey(layers.available_layers, command_line.doc_layer_name.c_str());
+    layer = layers.FindLayer(command_line.doc_layer_name);
     if (!layer) {
         fprintf(stderr, "vkconfig: Could not load layer %s\n", command_line.doc_layer_name.c_str());
         fprintf(stderr, "Run \"vkconfig layers --list\" to get list of available layers\n");
@@ -89,11 +97,41 @@ int run_doc_settings(const CommandLine& command_line) {
     config = configuration_manager.CreateConfiguration(layers.available_layers, "Config");
     config.parameters = GatherParameters(config.parameters, layers.available_layers);
     config.parameters[0].state = LAYER_STATE_OVERRIDDEN;
-    ExportSettingsDoc(layers.available_layers, config, command_line.doc_out_dir + "/vk_layer_settings.txt");
+    const std::string path = command_line.doc_out_dir + "/vk_layer_settings.txt";
+    if (ExportSettingsDoc(layers.available_layers, config, path)) {
+        printf("vkconfig: settings written to %s\n", path.c_str());
+    } else {
+        printf("vkconfig: could not write %s\n", path.c_str());
+        rval = -1;
+    }
 
     return rval;
 }
 
+int run_doc_all(const CommandLine& command_line) {
+    PathManager paths(command_line.command_vulkan_sdk, SUPPORTED_CONFIG_FILES);
+    Environment environment(paths);
+    environment.Reset(Environment::DEFAULT);
+
+    LayerManager layers(environment);
+    layers.LoadAllInstalledLayers();
+
+    if (layers.available_layers.empty()) {
+        fprintf(stderr, "vkconfig: No Vulkan layer found\n");
+        return -1;
+    }
+
+    const std::vector<std::string>& failed_files = ExportAllDoc(layers.available_layers, command_line.doc_out_dir);
+    for (std::size_t i = 0, n = failed_files.size(); i < n; ++i) {
+        printf("vkconfig: could not write %s\n", failed_files[i].c_str());
+    }
+
+    printf("vkconfig: documentation of %d layers written to %s\n", static_cast<int>(layers.available_layers.size()),
+           command_line.doc_out_dir.c_str());
+
+    return failed_files.empty() ? 0 : -1;
+}
+
 int run_doc(const CommandLine& command_line) {
     assert(command_line.command == COMMAND_DOC);
     assert(command_line.error == ERROR_NONE);
@@ -108,6 +146,9 @@ int run_doc(const CommandLine& command_line) {
         case COMMAND_DOC_SETTINGS: {
             return run_doc_settings(command_line);
         }
+        case COMMAND_DOC_ALL: {
+            return run_doc_all(command_line);
+        }
         default: {
             assert(0);
             return -1;
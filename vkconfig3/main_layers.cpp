@@ -25,6 +25,11 @@
 #include "../vkconfig_core/override.h"
 #include "../vkconfig_core/layer_manager.h"
 
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <iostream>
 #include <cassert>
 
 static int RunLayersOverride(const CommandLine& command_line) {
@@ -135,7 +140,112 @@ static int RunLayersVerbose(const CommandLine& command_line) {
     return 0;
 }
 
-int run_layers(const CommandLine& command_line) {
+static QByteArray SerializeReply(const QJsonObject& reply) {
+    return QJsonDocument(reply).toJson(QJsonDocument::Compact) + "\n";
+}
+
+static bool IsReplySuccess(const QJsonObject& reply) { return reply.value("result").toString() == "success"; }
+
+static int RunLayersBatch(const CommandLine& command_line) {
+    LayersSession session(command_line.command_vulkan_sdk, SUPPORTED_CONFIG_FILES);
+
+    // The commands following a failed command are executed, the exit status reports the failure
+    bool failed = false;
+
+    bool quit = false;
+    std::string command_text;
+    while (!quit && std::getline(std::cin, command_text)) {
+        const QJsonObject& reply = session.Execute(command_text, quit);
+        if (!IsReplySuccess(reply)) {
+            failed = true;
+        }
+
+        const QByteArray& text = SerializeReply(reply);
+        fwrite(text.constData(), 1, text.size(), stdout);
+        fflush(stdout);
+    }
+
+    return failed ? -1 : 0;
+}
+
+LayersServer::LayersServer(QLocalServer& server, LayersSession& session) : server(server), session(session) {
+    this->connect(&this->server, SIGNAL(newConnection()), this, SLOT(OnNewConnection()));
+}
+
+void LayersServer::OnNewConnection() {
+    while (this->server.hasPendingConnections()) {
+        QLocalSocket* socket = this->server.nextPendingConnection();
+
+        this->connect(socket, SIGNAL(readyRead()), this, SLOT(OnReadyRead()));
+        this->connect(socket, SIGNAL(disconnected()), this, SLOT(OnDisconnected()));
+
+        // Commands may have been received before the signals were connected
+        this->ExecuteCommands(socket);
+    }
+}
+
+void LayersServer::OnReadyRead() {
+    QLocalSocket* socket = qobject_cast<QLocalSocket*>(this->sender());
+    if (socket != nullptr) {
+        this->ExecuteCommands(socket);
+    }
+}
+
+void LayersServer::ExecuteCommands(QLocalSocket* socket) {
+    bool quit = false;
+    while (!quit && socket->canReadLine()) {
+        const QByteArray& command_text = socket->readLine();
+        socket->write(SerializeReply(this->session.Execute(command_text.toStdString(), quit)));
+    }
+
+    if (quit) {
+        // The reply is written before the event loop stops, a client that doesn't read it doesn't block the server
+        socket->waitForBytesWritten(1000);
+        this->server.close();
+        QCoreApplication::quit();
+    }
+}
+
+void LayersServer::OnDisconnected() {
+    QLocalSocket* socket = qobject_cast<QLocalSocket*>(this->sender());
+    if (socket != nullptr) {
+        socket->deleteLater();
+    }
+}
+
+static int RunLayersServer(int argc, char* argv[], const CommandLine& command_line) {
+    QCoreApplication app(argc, argv);
+
+    // A server left behind by a crashed process refuses the connections, only its socket is removed. The socket of a running
+    // server is kept.
+    QLocalSocket probe;
+    probe.connectToServer(command_line.layers_server_name.c_str());
+    if (probe.waitForConnected(1000)) {
+        printf("\nA layers server is already listening to '%s'\n", command_line.layers_server_name.c_str());
+        return -1;
+    } else if (probe.error() == QLocalSocket::ConnectionRefusedError) {
+        QLocalServer::removeServer(command_line.layers_server_name.c_str());
+    }
+
+    // The commands rewrite the Vulkan layers configuration of the user, no other user may connect
+    QLocalServer server;
+    server.setSocketOptions(QLocalServer::UserAccessOption);
+    if (!server.listen(command_line.layers_server_name.c_str())) {
+        printf("\nFailed to listen to '%s': %s\n", command_line.layers_server_name.c_str(),
+               server.errorString().toStdString().c_str());
+        return -1;
+    }
+
+    LayersSession session(command_line.command_vulkan_sdk, SUPPORTED_CONFIG_FILES);
+    LayersServer layers_server(server, session);
+
+    printf("Listening to '%s'...\n", server.fullServerName().toStdString().c_str());
+    fflush(stdout);
+
+    return app.exec();
+}
+
+int run_layers(int argc, char* argv[], const CommandLine& command_line) {
     assert(command_line.command == COMMAND_LAYERS);
     assert(command_line.error == ERROR_NONE);
 
@@ -152,6 +262,12 @@ int run_layers(const CommandLine& command_line) {
         case COMMAND_LAYERS_VERBOSE: {
             return RunLayersVerbose(command_line);
         }
+        case COMMAND_LAYERS_BATCH: {
+            return RunLayersBatch(command_line);
+        }
+        case COMMAND_LAYERS_SERVER: {
+            return RunLayersServer(argc, argv, command_line);
+        }
         default: {
             assert(0);
             return -1;
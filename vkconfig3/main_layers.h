@@ -21,5 +21,32 @@
 #pragma once
 
 #include "../vkconfig_core/command_line.h"
+#include "../vkconfig_core/layers_session.h"
 
-int run_layers(const CommandLine& command_line);
+#include <QObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+// Serve the commands of the clients of a local server, each line received is a command. The clients are served concurrently by
+// the event loop, the commands of a client are executed in order.
+class LayersServer : public QObject {
+    Q_OBJECT
+   public:
+    LayersServer(QLocalServer& server, LayersSession& session);
+
+   private Q_SLOTS:
+    void OnNewConnection();
+    void OnReadyRead();
+    void OnDisconnected();
+
+   private:
+    LayersServer(const LayersServer&) = delete;
+    LayersServer& operator=(const LayersServer&) = delete;
+
+    void ExecuteCommands(QLocalSocket* socket);
+
+    QLocalServer& server;
+    LayersSession& session;
+};
+
+int run_layers(int argc, char* argv[], const CommandLine& command_line);
@@ -178,6 +178,8 @@ MainWindow::MainWindow(QWidget *parent)
 
     connect(ui->launcher_loader_debug, SIGNAL(currentIndexChanged(int)), this, SLOT(OnLauncherLoaderMessageChanged(int)));
 
+    connect(&_vulkan_status_probe, SIGNAL(ResultReady()), this, SLOT(OnVulkanStatusReady()));
+
     Configurator &configurator = Configurator::Get();
     Environment &environment = configurator.environment;
 
@@ -292,6 +294,10 @@ static std::string GetMainWindowTitle(bool active) {
     return title;
 }
 
+static QString GetVulkanStatusText(const VulkanStatusProbe &probe) {
+    return ("Vulkan Development Status:\n" + GenerateVulkanStatus(probe)).c_str();
+}
+
 void MainWindow::InitUI() {
     Configurator &configurator = Configurator::Get();
     const Environment &environment = configurator.environment;
@@ -444,8 +450,7 @@ void MainWindow::UpdateUI() {
             assert(item);
             assert(!item->configuration_name.empty());
 
-            Configuration *configuration =
-                FindByKey(configurator.configurations.available_configurations, item->configuration_name.c_str());
+            Configuration *configuration = configurator.configurations.FindConfiguration(item->configuration_name);
             if (configuration == nullptr) continue;
 
             item->setText(1, item->configuration_name.c_str());
@@ -478,8 +483,7 @@ void MainWindow::UpdateUI() {
     ui->tree_layers_list->setEnabled(enable_layer_ui);
     ui->tree_layers_list->clear();
 
-    Configuration *configuration =
-        FindByKey(configurator.configurations.available_configurations, active_contiguration_name.c_str());
+    Configuration *configuration = configurator.configurations.FindConfiguration(active_contiguration_name);
     if (configuration != nullptr) {
         std::vector<Parameter> parameters = GatherParameters(configuration->parameters, configurator.layers.available_layers);
 
@@ -603,7 +607,15 @@ void MainWindow::UpdateUI() {
     if (configurator.request_vulkan_status) {
         ui->log_browser->clear();
 
-        ui->log_browser->setPlainText(("Vulkan Development Status:\n" + GenerateVulkanStatus()).c_str());
+        // The status depends on the layers override files
+        _settings_tree_manager.FlushPendingChanges();
+        _vulkan_status_probe.Request();
+
+        const QString &status = GetVulkanStatusText(_vulkan_status_probe);
+        if (_vulkan_status_probe.GetResult() == nullptr) {
+            _pending_vulkan_status.append(status);
+        }
+        ui->log_browser->setPlainText(status);
         ui->push_button_clear_log->setEnabled(true);
         configurator.request_vulkan_status = false;
 
@@ -813,16 +825,13 @@ void MainWindow::OnConfigurationItemChanged(QTreeWidgetItem *item, int column) {
         }
 
         const bool failed = new_name.empty() || !IsPortableFilename(new_name);
-        Configuration *duplicate_configuration =
-            failed ? nullptr : FindByKey(configurator.configurations.available_configurations, new_name.c_str());
+        Configuration *duplicate_configuration = failed ? nullptr : configurator.configurations.FindConfiguration(new_name);
 
         if (duplicate_configuration != nullptr) {
             Alert::ConfigurationRenamingFailed();
         }
 
-        // Find existing configuration using it's old name
         const std::string old_name = configuration_item->configuration_name;
-        Configuration *configuration = FindByKey(configurator.configurations.available_configurations, old_name.c_str());
 
         if (failed || duplicate_configuration != nullptr) {
             // If the configurate name is empty or the configuration name is taken, keep old configuration name
@@ -834,8 +843,8 @@ void MainWindow::OnConfigurationItemChanged(QTreeWidgetItem *item, int column) {
             configurator.ActivateConfiguration(old_name);
         } else {
             // Rename configuration ; Remove old configuration file ; change the name of the configuration
-            configurator.configurations.RemoveConfigurationFile(old_name);
-            configuration->key = configuration_item->configuration_name = new_name;
+            configurator.configurations.RenameConfiguration(old_name, new_name);
+            configuration_item->configuration_name = new_name;
             configurator.configurations.SaveAllConfigurations(configurator.layers.available_layers);
             configurator.configurations.LoadAllConfigurations(configurator.layers.available_layers);
 
@@ -1075,8 +1084,7 @@ void MainWindow::EditClicked(ConfigurationListItem *item) {
     assert(!item->configuration_name.empty());
 
     Configurator &configurator = Configurator::Get();
-    Configuration *configuration =
-        FindByKey(configurator.configurations.available_configurations, item->configuration_name.c_str());
+    Configuration *configuration = configurator.configurations.FindConfiguration(item->configuration_name);
     assert(configuration != nullptr);
     /*
     LayersDialog dlg(this, *configuration);
@@ -1141,8 +1149,7 @@ void MainWindow::ResetClicked(ConfigurationListItem *item) {
     assert(!item->configuration_name.empty());
 
     Configurator &configurator = Configurator::Get();
-    Configuration *configuration =
-        FindByKey(configurator.configurations.available_configurations, item->configuration_name.c_str());
+    Configuration *configuration = configurator.configurations.FindConfiguration(item->configuration_name);
     assert(configuration != nullptr);
 
     QMessageBox alert;
@@ -1502,6 +1509,28 @@ void MainWindow::on_push_button_clear_log_clicked() {
     ui->push_button_clear_log->setEnabled(false);
 }
 
+void MainWindow::OnVulkanStatusReady() {
+    ApplyVulkanStatus(_vulkan_status_probe);
+
+    if (_pending_vulkan_status.isEmpty()) {
+        return;
+    }
+
+    const QString &status = GetVulkanStatusText(_vulkan_status_probe);
+
+    // Replace the statuses displayed while probing, unless they were cleared from the log in the meantime
+    QString text = ui->log_browser->toPlainText();
+    for (int i = 0, n = _pending_vulkan_status.size(); i < n; ++i) {
+        const int index = text.indexOf(_pending_vulkan_status[i]);
+        if (index >= 0) {
+            text.replace(index, _pending_vulkan_status[i].size(), status);
+        }
+    }
+    ui->log_browser->setPlainText(text);
+
+    _pending_vulkan_status.clear();
+}
+
 const Layer *GetLayer(QTreeWidget *tree, QTreeWidgetItem *item) {
     if (item == tree->invisibleRootItem()) return nullptr;
     if (item == nullptr) return nullptr;
@@ -1613,10 +1642,12 @@ bool MainWindow::eventFilter(QObject *target, QEvent *event) {
                         break;
                 }
                 configuration->setting_tree_state.clear();
+                configuration->dirty = true;
                 _settings_tree_manager.CreateGUI(ui->settings_tree);
             } else if (action == show_advanced_setting_action) {
                 configuration->view_advanced_settings = action->isChecked();
                 configuration->setting_tree_state.clear();
+                configuration->dirty = true;
                 _settings_tree_manager.CreateGUI(ui->settings_tree);
             } else if (action == export_html_action) {
                 const std::string path = format("%s/%s.html", GetPath(BUILTIN_PATH_APPDATA).c_str(), layer->key.c_str());
@@ -1773,6 +1804,9 @@ void MainWindow::on_push_button_launcher_clicked() {
         return;
     }
 
+    // The application reads the layers override files, the last edits must be written before it starts
+    _settings_tree_manager.FlushPendingChanges();
+
     // We are logging, let's add that we've launched a new application
     std::string launch_log = "Launching Vulkan Application:\n";
 
@@ -23,6 +23,7 @@
 
 #include "configurator.h"
 #include "settings_tree.h"
+#include "vulkan_util.h"
 
 #include "ui_mainwindow.h"
 
@@ -181,6 +182,9 @@ class MainWindow : public QMainWindow {
    private:
     SettingsTreeManager _settings_tree_manager;
 
+    VulkanStatusProbe _vulkan_status_probe;
+    QStringList _pending_vulkan_status;  // Statuses displayed while the probe is running, replaced once the result is ready
+
     std::unique_ptr<QProcess> _launch_application;  // Keeps track of the monitored app
     QFile _log_file;                                // Log file for layer output
 
@@ -227,6 +231,7 @@ class MainWindow : public QMainWindow {
     void AddLayerItem(const Parameter &parameter);
 
    private slots:
+    void OnVulkanStatusReady();
     void iconActivated(QSystemTrayIcon::ActivationReason reason);
 
    public Q_SLOTS:
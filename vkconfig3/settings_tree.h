@@ -30,9 +30,12 @@
 
 #include <QObject>
 #include <QTreeWidget>
+#include <QTimer>
 
 #include <vector>
 #include <memory>
+#include <map>
+#include <string>
 
 class SettingsTreeManager : QObject {
     Q_OBJECT
@@ -42,6 +45,9 @@ class SettingsTreeManager : QObject {
     void CreateGUI(QTreeWidget *build_tree);
     void CleanupGUI();
 
+    // Write the layers override files now if an edit is waiting for the configure delay
+    void FlushPendingChanges();
+
     void GetTreeState(QByteArray &byte_array, QTreeWidgetItem *top_item);
     int SetTreeState(QByteArray &byte_array, int index, QTreeWidgetItem *top_item);
 
@@ -53,6 +59,10 @@ class SettingsTreeManager : QObject {
     void OnExpandedChanged(const QModelIndex &index);
     void OnCollapsedChanged(const QModelIndex &index);
 
+   private Q_SLOTS:
+    void OnConfigureTimeout();
+    void OnItemExpanded(QTreeWidgetItem *item);
+
    private:
     SettingsTreeManager(const SettingsTreeManager &) = delete;
     SettingsTreeManager &operator=(const SettingsTreeManager &) = delete;
@@ -62,7 +72,27 @@ class SettingsTreeManager : QObject {
     void BuildTreeItem(QTreeWidgetItem *parent, Parameter &parameter, const SettingMeta &meta);
 
     void RefreshItem(RefreshAreas refresh_areas, QTreeWidgetItem *parent);
+    void ApplyChanges();
+
+    void AddPendingWidget(QTreeWidgetItem *item, Parameter &parameter, const SettingMeta &meta, const std::string &flag,
+                          bool expanded);
+    void BuildWidget(QTreeWidgetItem *item);
+    void BuildVisibleWidgets(QTreeWidgetItem *parent);
+
+    // Record the settings edited by a widget and the settings the widget depends on
+    void AddWidget(QObject *widget, QTreeWidgetItem *item, const SettingMeta &meta);
 
     QTreeWidget *tree;
     std::unique_ptr<WidgetSettingValidation> validation;
+
+    std::map<const QObject *, std::vector<std::string>> widget_keys;        // Settings edited, indexed by widget
+    std::map<std::string, std::vector<QTreeWidgetItem *>> dependent_items;  // Reverse dependence graph, indexed by setting key
+    QTimer configure_timer;
+
+    struct PendingWidget {
+        Parameter *parameter;
+        const SettingMeta *meta;
+        std::string flag;  // Only for SETTING_FLAGS
+    };
+    std::map<const QTreeWidgetItem *, PendingWidget> pending_widgets;  // Widgets not built yet, indexed by tree item
 };
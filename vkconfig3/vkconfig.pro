@@ -42,9 +42,11 @@ SOURCES += \
     ../vkconfig_core/json_validator.cpp \
     ../vkconfig_core/layer.cpp \
     ../vkconfig_core/layer_manager.cpp \
+    ../vkconfig_core/layer_settings_file.cpp \
     ../vkconfig_core/layer_preset.cpp \
     ../vkconfig_core/layer_state.cpp \
     ../vkconfig_core/layer_type.cpp \
+    ../vkconfig_core/layers_session.cpp \
     ../vkconfig_core/override.cpp \
     ../vkconfig_core/parameter.cpp \
     ../vkconfig_core/path.cpp \
@@ -61,8 +63,10 @@ SOURCES += \
     ../vkconfig_core/setting_int.cpp \
     ../vkconfig_core/setting_list.cpp \
     ../vkconfig_core/setting_string.cpp \
+    ../vkconfig_core/string_pool.cpp \
     ../vkconfig_core/util.cpp \
     ../vkconfig_core/version.cpp \
+    ../vkconfig_core/vulkan_status_probe.cpp \
     vulkan_util.cpp \
     widget_preset.cpp \
     widget_setting.cpp \
@@ -108,9 +112,11 @@ HEADERS += \
     ../vkconfig_core/json_validator.h \
     ../vkconfig_core/layer.h \
     ../vkconfig_core/layer_manager.h \
+    ../vkconfig_core/layer_settings_file.h \
     ../vkconfig_core/layer_preset.h \
     ../vkconfig_core/layer_state.h \
     ../vkconfig_core/layer_type.h \
+    ../vkconfig_core/layers_session.h \
     ../vkconfig_core/override.h \
     ../vkconfig_core/parameter.h \
     ../vkconfig_core/path.h \
@@ -127,8 +133,10 @@ HEADERS += \
     ../vkconfig_core/setting_int.h \
     ../vkconfig_core/setting_list.h \
     ../vkconfig_core/setting_string.h \
+    ../vkconfig_core/string_pool.h \
     ../vkconfig_core/util.h \
     ../vkconfig_core/version.h \
+    ../vkconfig_core/vulkan_status_probe.h \
     vulkan_util.h \
     widget_preset.h \
     widget_setting.h \
@@ -174,6 +182,10 @@ win32: {
   RC_ICONS = resourcefiles/vulkan.ico
 }
 
+unix: {
+  LIBS += $$QMAKE_LIBS_DYNLOAD
+}
+
 macx: {
 #CONFIG += file_copies
 #COPIES += shellScript
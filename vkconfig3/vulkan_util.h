@@ -20,9 +20,11 @@
 
 #pragma once
 
-#include "../vkconfig_core/version.h"
+#include "../vkconfig_core/vulkan_status_probe.h"
 
 #include <string>
 
-Version GetVulkanLoaderVersion();
-std::string GenerateVulkanStatus();
+// Alert about the failures found by the probe and update the names of the physical devices
+void ApplyVulkanStatus(const VulkanStatusProbe &probe);
+
+std::string GenerateVulkanStatus(const VulkanStatusProbe &probe);
@@ -127,6 +127,9 @@ static const CommandLayersDesc command_layers_desc[] = {
     {COMMAND_LAYERS_OVERRIDE, "-o", 3},
     {COMMAND_LAYERS_SURRENDER, "--surrender", 2},
     {COMMAND_LAYERS_SURRENDER, "-s", 2},
+    {COMMAND_LAYERS_BATCH, "--batch", 2},
+    {COMMAND_LAYERS_BATCH, "-b", 2},
+    {COMMAND_LAYERS_SERVER, "--server", 3},
 };
 
 struct CommandDocDesc {
@@ -139,6 +142,7 @@ static const CommandDocDesc command_doc_desc[] = {
     {COMMAND_DOC_HTML, "--html", 3},
     {COMMAND_DOC_MARKDOWN, "--markdown", 3},
     {COMMAND_DOC_SETTINGS, "--settings", 3},
+    {COMMAND_DOC_ALL, "--all", 2},
 };
 
 static CommandLayersArg GetCommandLayersId(const char* token) {
@@ -177,6 +181,7 @@ CommandLine::CommandLine(int argc, char* argv[])
       command_reset_arg(_command_reset_arg),
       command_layers_arg(_command_layers_arg),
       layers_configuration_path(_layers_configuration_path),
+      layers_server_name(_layers_server_name),
       command_doc_arg(_command_doc_arg),
       command_vulkan_sdk(_command_vulkan_sdk),
       doc_layer_name(_doc_layer_name),
@@ -234,20 +239,19 @@ CommandLine::CommandLine(int argc, char* argv[])
                 }
                 break;
             }
+
+            if (_command_layers_arg == COMMAND_LAYERS_SERVER) {
+                _layers_server_name = argv[arg_offset + 2];
+                break;
+            }
         } break;
         case COMMAND_DOC: {
-            if (argc <= arg_offset + 2) {
+            if (argc <= arg_offset + 1) {
                 _error = ERROR_MISSING_COMMAND_ARGUMENT;
                 _error_args.push_back(argv[arg_offset + 0]);
                 break;
             }
 
-            if (argc > 5) {
-                _error = ERROR_TOO_MANY_COMMAND_ARGUMENTS;
-                _error_args.push_back(argv[arg_offset + 0]);
-                break;
-            }
-
             _command_doc_arg = GetCommandDocId(argv[arg_offset + 1]);
             if (_command_doc_arg == COMMAND_DOC_NONE) {
                 _error = ERROR_INVALID_COMMAND_ARGUMENT;
@@ -255,6 +259,31 @@ CommandLine::CommandLine(int argc, char* argv[])
                 _error_args.push_back(argv[arg_offset + 1]);
                 break;
             }
+
+            // All the layers are documented, only the output dir may be specified
+            if (_command_doc_arg == COMMAND_DOC_ALL) {
+                if (argc > arg_offset + 3) {
+                    _error = ERROR_TOO_MANY_COMMAND_ARGUMENTS;
+                    _error_args.push_back(argv[arg_offset + 0]);
+                    break;
+                }
+
+                _doc_out_dir = argc == arg_offset + 3 ? argv[arg_offset + 2] : ".";
+                break;
+            }
+
+            if (argc <= arg_offset + 2) {
+                _error = ERROR_MISSING_COMMAND_ARGUMENT;
+                _error_args.push_back(argv[arg_offset + 0]);
+                break;
+            }
+
+            if (argc > 5) {
+                _error = ERROR_TOO_MANY_COMMAND_ARGUMENTS;
+                _error_args.push_back(argv[arg_offset + 0]);
+                break;
+            }
+
             _doc_layer_name = argv[arg_offset + 2];
             if (argc == 5) {
                 // Output dir arg was specified
@@ -398,6 +427,8 @@ void CommandLine::usage() const {
             printf("\tvkconfig layers (--surrender | -s)\n");
             printf("\tvkconfig layers (--list | -l)\n");
             printf("\tvkconfig layers (--list-verbose | -lv)\n");
+            printf("\tvkconfig layers (--batch | -b)\n");
+            printf("\tvkconfig layers --server <server_name>\n");
             printf("\n");
             printf("Description\n");
             printf("\tvkconfig layers (--override | -o) <layers_configuration_file>\n");
@@ -411,6 +442,21 @@ void CommandLine::usage() const {
             printf("\n");
             printf("\tvkconfig layers (--list-version | -lv)\n");
             printf("\t\tList the Vulkan layers found by %s on the system with locations and versions.\n", VKCONFIG_NAME);
+            printf("\n");
+            printf("\tvkconfig layers (--batch | -b)\n");
+            printf("\t\tRead 'layers' commands from the standard input, one per line, and reply to each with a JSON\n");
+            printf("\t\tobject on a single line. The Vulkan layers and layers configurations are loaded once and\n");
+            printf("\t\trefreshed when their files change. Commands:\n");
+            printf("\t\t  override <layers_configuration_file>\n");
+            printf("\t\t  surrender\n");
+            printf("\t\t  list\n");
+            printf("\t\t  verbose\n");
+            printf("\t\t  doc (html | markdown | settings) <layer_name> [<output_dir>]\n");
+            printf("\t\t  doc all [<output_dir>]\n");
+            printf("\t\t  quit\n");
+            printf("\n");
+            printf("\tvkconfig layers --server <server_name>\n");
+            printf("\t\tLike --batch but read the commands from the clients of the <server_name> local socket.\n");
             break;
         }
         case HELP_DOC: {
@@ -421,6 +467,7 @@ void CommandLine::usage() const {
             printf("\tvkconfig doc --html <layer_name> [<output_dir>]\n");
             printf("\tvkconfig doc --markdown <layer_name> [<output_dir>]\n");
             printf("\tvkconfig doc --settings <layer_name> [<output_dir>]\n");
+            printf("\tvkconfig doc --all [<output_dir>]\n");
             printf("\n");
             printf("Description\n");
             printf("\tvkconfig doc --html <layer_name> [<output_dir>]\n");
@@ -434,6 +481,11 @@ void CommandLine::usage() const {
             printf("\tvkconfig doc --settings <layer_name> [<output_dir>]\n");
             printf("\t\tCreate the vk_layers_settings.txt file for the given layer.\n");
             printf("\t\tThe file is written to <output_dir>, or current directory if not specified.\n");
+            printf("\n");
+            printf("\tvkconfig doc --all [<output_dir>]\n");
+            printf("\t\tCreate the html, markdown and vk_layers_settings.txt files for all the layers found on the system,\n");
+            printf("\t\tand the layers_settings.json file describing the settings of all these layers.\n");
+            printf("\t\tThe files are written to <output_dir>, or current directory if not specified.\n");
             break;
         }
         case HELP_RESET: {
@@ -40,10 +40,12 @@ enum CommandLayersArg {
     COMMAND_LAYERS_OVERRIDE,
     COMMAND_LAYERS_SURRENDER,
     COMMAND_LAYERS_LIST,
-    COMMAND_LAYERS_VERBOSE
+    COMMAND_LAYERS_VERBOSE,
+    COMMAND_LAYERS_BATCH,
+    COMMAND_LAYERS_SERVER
 };
 
-enum CommandDocArg { COMMAND_DOC_NONE = 0, COMMAND_DOC_HTML, COMMAND_DOC_MARKDOWN, COMMAND_DOC_SETTINGS };
+enum CommandDocArg { COMMAND_DOC_NONE = 0, COMMAND_DOC_HTML, COMMAND_DOC_MARKDOWN, COMMAND_DOC_SETTINGS, COMMAND_DOC_ALL };
 
 enum CommandResetArg { COMMAND_RESET_NONE = 0, COMMAND_RESET_SOFT, COMMAND_RESET_HARD };
 
@@ -70,6 +72,7 @@ class CommandLine {
     const CommandResetArg& command_reset_arg;
     const CommandLayersArg& command_layers_arg;
     const std::string& layers_configuration_path;
+    const std::string& layers_server_name;
     const CommandDocArg& command_doc_arg;
     const std::string& command_vulkan_sdk;
     const std::string& doc_layer_name;
@@ -86,6 +89,7 @@ class CommandLine {
     CommandResetArg _command_reset_arg;
     CommandLayersArg _command_layers_arg;
     std::string _layers_configuration_path;
+    std::string _layers_server_name;
     CommandDocArg _command_doc_arg;
     std::string _command_vulkan_sdk;
     std::string _doc_layer_name;
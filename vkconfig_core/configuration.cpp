@@ -27,6 +27,7 @@
 #include "version.h"
 
 #include <QFile>
+#include <QSaveFile>
 #include <QFileInfo>
 #include <QJsonDocument>
 #include <QJsonArray>
@@ -39,7 +40,8 @@
 #include <string>
 #include <algorithm>
 
-Configuration::Configuration() : key("New Configuration"), platform_flags(PLATFORM_DESKTOP_BIT), view_advanced_settings(false) {}
+Configuration::Configuration()
+    : key("New Configuration"), platform_flags(PLATFORM_DESKTOP_BIT), view_advanced_settings(false), dirty(true) {}
 
 bool Configuration::Load2_2(const std::vector<Layer>& available_layers, const QJsonObject& json_root_object) {
     const QJsonValue& json_configuration_value = json_root_object.value("configuration");
@@ -151,8 +153,10 @@ bool Configuration::Load(const std::vector<Layer>& available_layers, const std::
 }
 
 bool Configuration::Save(const std::vector<Layer>& available_layers, const std::string& full_path, bool exporter) const {
-    assert(!full_path.empty());
+    return this->Save(full_path, this->Serialize(available_layers, exporter));
+}
 
+QByteArray Configuration::Serialize(const std::vector<Layer>& available_layers, bool exporter) const {
     QJsonObject root;
     root.insert("file_format_version", Version::LAYER_CONFIG.str().c_str());
 
@@ -220,28 +224,39 @@ bool Configuration::Save(const std::vector<Layer>& available_layers, const std::
     root.insert("configuration", json_configuration);
 
     QJsonDocument doc(root);
+    return doc.toJson();
+}
+
+bool Configuration::Save(const std::string& full_path, const QByteArray& content) const {
+    assert(!full_path.empty());
 
-    QFile json_file(full_path.c_str());
-    const bool result = json_file.open(QIODevice::WriteOnly | QIODevice::Text);
+    // Write a temporary file renamed on commit so that an interrupted save never leaves a truncated configuration file.
+    // No text mode conversion, the file content is the serialized content that the configuration manager hashes.
+    QSaveFile json_file(full_path.c_str());
+    bool result = json_file.open(QIODevice::WriteOnly);
     assert(result);
 
+    if (result) {
+        json_file.write(content);
+        result = json_file.commit();
+    }
+
     if (!result) {
         QMessageBox alert;
         alert.setText("Could not save the configuration file!");
         alert.setWindowTitle(this->key.c_str());
         alert.setIcon(QMessageBox::Warning);
         alert.exec();
-        return false;
-    } else {
-        json_file.write(doc.toJson());
-        json_file.close();
-        return true;
     }
+
+    return result;
 }
 
 void Configuration::Reset(const std::vector<Layer>& available_layers, const PathManager& path_manager) {
     (void)path_manager;
 
+    this->dirty = true;
+
     // Case 1: reset using built-in configuration files
     const QFileInfoList& builtin_configuration_files = GetJSONFiles(":/configurations/");
     for (int i = 0, n = builtin_configuration_files.size(); i < n; ++i) {
@@ -35,6 +35,8 @@ class Configuration {
 
     bool Load(const std::vector<Layer>& available_layers, const std::string& full_path);
     bool Save(const std::vector<Layer>& available_layers, const std::string& full_path, bool exporter = false) const;
+    bool Save(const std::string& full_path, const QByteArray& content) const;
+    QByteArray Serialize(const std::vector<Layer>& available_layers, bool exporter = false) const;
     bool HasOverride() const;
 
     void Reset(const std::vector<Layer>& available_layers, const PathManager& path_manager);
@@ -50,6 +52,9 @@ class Configuration {
     std::vector<Parameter> parameters;
     std::vector<std::string> user_defined_paths;
 
+    // Set when the configuration may differ from its file, only dirty configurations are saved by the configuration manager
+    bool dirty;
+
     bool IsBuiltIn() const;
 
    private:
@@ -26,6 +26,18 @@
 
 #include <QMessageBox>
 #include <QFileInfoList>
+#include <QCryptographicHash>
+
+static QByteArray HashFile(const std::string &path) {
+    QFile file(path.c_str());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+
+    return QCryptographicHash::hash(file.readAll(), QCryptographicHash::Sha1);
+}
+
+static std::string GetAbsoluteFilePath(const std::string &path) { return QFileInfo(path.c_str()).absoluteFilePath().toStdString(); }
 
 ConfigurationManager::ConfigurationManager(Environment &environment) : environment(environment) {}
 
@@ -33,6 +45,7 @@ ConfigurationManager::~ConfigurationManager() {}
 
 void ConfigurationManager::LoadAllConfigurations(const std::vector<Layer> &available_layers) {
     this->available_configurations.clear();
+    this->configuration_index.Clear();
 
     // If this is the first time, we need to create the initial set of
     // configuration files.
@@ -67,9 +80,10 @@ void ConfigurationManager::LoadDefaultConfigurations(const std::vector<Layer> &a
 
         OrderParameter(configuration.parameters, available_layers);
 
-        Configuration *found_configuration = FindByKey(this->available_configurations, configuration.key.c_str());
+        Configuration *found_configuration = this->FindConfiguration(configuration.key);
         if (found_configuration == nullptr) {
             this->available_configurations.push_back(configuration);
+            this->configuration_index.Append(this->available_configurations);
         }
     }
 
@@ -85,6 +99,8 @@ void ConfigurationManager::SortConfigurations() {
     };
 
     std::sort(this->available_configurations.begin(), this->available_configurations.end(), Compare());
+
+    this->configuration_index.Rebuild(this->available_configurations);
 }
 
 void ConfigurationManager::LoadConfigurationsPath(const std::vector<Layer> &available_layers, const char *path) {
@@ -104,45 +120,184 @@ void ConfigurationManager::LoadConfigurationsPath(const std::vector<Layer> &avai
             continue;
         }
 
-        if (FindByKey(available_configurations, configuration.key.c_str()) != nullptr) {
+        if (this->FindConfiguration(configuration.key) != nullptr) {
             continue;
         }
 
+        this->RecordConfigurationFile(info.absoluteFilePath().toStdString());
+        configuration.dirty = false;
+
         std::string missing_layer;
         if (!HasMissingLayer(configuration.parameters, available_layers, missing_layer)) {
             OrderParameter(configuration.parameters, available_layers);
         }
 
         available_configurations.push_back(configuration);
+        this->configuration_index.Append(this->available_configurations);
     }
 }
 
 void ConfigurationManager::SaveAllConfigurations(const std::vector<Layer> &available_layers) {
     for (std::size_t i = 0, n = available_configurations.size(); i < n; ++i) {
-        const std::string path = GetPath(BUILTIN_PATH_CONFIG_LAST) + "/" + available_configurations[i].key + ".json";
-        available_configurations[i].Save(available_layers, path.c_str());
+        Configuration &configuration = available_configurations[i];
+
+        const std::string path = GetPath(BUILTIN_PATH_CONFIG_LAST) + "/" + configuration.key + ".json";
+        auto found = this->configuration_file_hashes.find(GetAbsoluteFilePath(path));
+
+        // Clean configurations are not even serialized when their file was last read or written by the configuration manager
+        if (!configuration.dirty && found != this->configuration_file_hashes.end()) {
+            continue;
+        }
+
+        // Edits may be reverted or not affect the file, in which case the file is not rewritten
+        const QByteArray &content = configuration.Serialize(available_layers);
+        const QByteArray &hash = QCryptographicHash::hash(content, QCryptographicHash::Sha1);
+        if (found != this->configuration_file_hashes.end() && found->second == hash) {
+            configuration.dirty = false;
+            continue;
+        }
+
+        if (configuration.Save(path, content)) {
+            this->configuration_file_hashes[GetAbsoluteFilePath(path)] = hash;
+            configuration.dirty = false;
+        }
+    }
+}
+
+void ConfigurationManager::SetDirty(const std::string &configuration_name) {
+    Configuration *configuration = this->FindConfiguration(configuration_name);
+    if (configuration != nullptr) {
+        configuration->dirty = true;
+    }
+}
+
+void ConfigurationManager::RecordConfigurationFile(const std::string &path) {
+    this->configuration_file_hashes[GetAbsoluteFilePath(path)] = HashFile(path);
+}
+
+bool ConfigurationManager::HasConfigurationFileChanged(const std::string &path) const {
+    const QFileInfo info(path.c_str());
+
+    // Configuration files are named after the configuration key
+    if (!info.exists()) {
+        return this->FindConfiguration(info.completeBaseName().toStdString()) != nullptr;
+    }
+
+    auto it = this->configuration_file_hashes.find(GetAbsoluteFilePath(path));
+    return it == this->configuration_file_hashes.end() || it->second != HashFile(path);
+}
+
+bool ConfigurationManager::UpdateConfigurationFromFile(const std::vector<Layer> &available_layers, const std::string &path) {
+    const QFileInfo info(path.c_str());
+    const std::string absolute_path = GetAbsoluteFilePath(path);
+
+    if (!info.exists()) {
+        this->configuration_file_hashes.erase(absolute_path);
+
+        // Configuration files are named after the configuration key
+        const std::string key = info.completeBaseName().toStdString();
+        if (this->FindConfiguration(key) == nullptr) {
+            return false;
+        }
+
+        std::vector<Configuration> updated_configurations;
+        for (std::size_t i = 0, n = this->available_configurations.size(); i < n; ++i) {
+            if (this->available_configurations[i].key == key) {
+                continue;
+            }
+            updated_configurations.push_back(this->available_configurations[i]);
+        }
+
+        std::swap(updated_configurations, this->available_configurations);
+        this->SortConfigurations();
+        return true;
+    }
+
+    // The file content is known, e.g. it was just saved by the configuration manager
+    if (!this->HasConfigurationFileChanged(path)) {
+        return false;
     }
+
+    const QByteArray hash = HashFile(path);
+
+    Configuration configuration;
+    if (!configuration.Load(available_layers, path)) {
+        return false;
+    }
+
+    this->configuration_file_hashes[absolute_path] = hash;
+    configuration.dirty = false;
+
+    std::string missing_layer;
+    if (!HasMissingLayer(configuration.parameters, available_layers, missing_layer)) {
+        OrderParameter(configuration.parameters, available_layers);
+    }
+
+    Configuration *found_configuration = this->FindConfiguration(configuration.key);
+    if (found_configuration != nullptr) {
+        *found_configuration = configuration;
+    } else {
+        this->available_configurations.push_back(configuration);
+        this->SortConfigurations();
+    }
+
+    return true;
+}
+
+bool ConfigurationManager::UpdateLayerSettings(const std::vector<Layer> &available_layers,
+                                               const std::vector<std::string> &layer_keys) {
+    bool updated = false;
+
+    for (std::size_t i = 0, n = this->available_configurations.size(); i < n; ++i) {
+        Configuration &configuration = this->available_configurations[i];
+
+        for (std::size_t j = 0, o = configuration.parameters.size(); j < o; ++j) {
+            Parameter &parameter = configuration.parameters[j];
+            if (!IsStringFound(layer_keys, parameter.key)) continue;
+
+            // A removed layer leaves the parameter without settings, like a configuration loaded with a missing layer
+            SettingDataSet settings;
+            const Layer *layer = FindByKey(available_layers, parameter.key.c_str());
+            if (layer != nullptr) {
+                CollectDefaultSettingData(layer->settings, settings);
+            }
+
+            for (std::size_t k = 0, p = settings.size(); k < p; ++k) {
+                const SettingData *previous = FindSetting(parameter.settings, settings[k]->key.c_str());
+                if (previous != nullptr) {
+                    settings[k]->Copy(previous);
+                }
+            }
+
+            std::swap(parameter.settings, settings);
+            updated = true;
+        }
+    }
+
+    return updated;
 }
 
 Configuration &ConfigurationManager::CreateConfiguration(const std::vector<Layer> &available_layers,
                                                          const std::string &configuration_name, bool duplicate) {
-    Configuration *duplicate_configuration = FindByKey(available_configurations, configuration_name.c_str());
+    Configuration *duplicate_configuration = this->FindConfiguration(configuration_name);
 
     Configuration new_configuration = duplicate_configuration != nullptr && duplicate ? *duplicate_configuration : Configuration();
     new_configuration.key = MakeConfigurationName(available_configurations, configuration_name);
 
     const std::string path = GetPath(BUILTIN_PATH_CONFIG_LAST) + "/" + new_configuration.key + ".json";
     new_configuration.Save(available_layers, path.c_str());
+    this->RecordConfigurationFile(path);
 
     // Reload from file to workaround the lack of SettingSet copy support
     Configuration configuration;
     const bool result = configuration.Load(available_layers, path.c_str());
     assert(result);
+    configuration.dirty = false;
 
     this->available_configurations.push_back(configuration);
     this->SortConfigurations();
 
-    return *FindByKey(this->available_configurations, configuration.key.c_str());
+    return *this->FindConfiguration(configuration.key);
 }
 
 bool ConfigurationManager::HasFile(const Configuration &configuration) const {
@@ -173,6 +328,7 @@ void ConfigurationManager::RemoveConfigurationFiles() {
         const QFileInfoList &configuration_files = GetJSONFiles(path.c_str());
         for (int i = 0, n = configuration_files.size(); i < n; ++i) {
             QFile::remove(configuration_files[i].filePath());
+            this->configuration_file_hashes.erase(configuration_files[i].absoluteFilePath().toStdString());
         }
     }
 }
@@ -190,6 +346,7 @@ void ConfigurationManager::RemoveConfigurationFile(const std::string &key) {
             const QString filename = configuration_files[j].fileName();
             if (filename.toStdString() == key + ".json") {
                 QFile::remove(configuration_files[j].filePath());
+                this->configuration_file_hashes.erase(configuration_files[j].absoluteFilePath().toStdString());
             }
         }
     }
@@ -222,6 +379,25 @@ void ConfigurationManager::RemoveConfiguration(const std::vector<Layer> &availab
     this->Configure(available_layers);
 }
 
+Configuration *ConfigurationManager::RenameConfiguration(const std::string &configuration_name,
+                                                         const std::string &new_configuration_name) {
+    assert(!configuration_name.empty());
+    assert(!new_configuration_name.empty());
+
+    Configuration *configuration = this->FindConfiguration(configuration_name);
+    if (configuration == nullptr) {
+        return nullptr;
+    }
+
+    this->RemoveConfigurationFile(configuration_name);
+
+    configuration->key = new_configuration_name;
+    configuration->dirty = true;
+    this->configuration_index.Rebuild(this->available_configurations);
+
+    return configuration;
+}
+
 void ConfigurationManager::Configure(const std::vector<Layer> &available_layers) {
     const std::string active_configuration_name = this->environment.GetSelectedConfiguration();
 
@@ -229,7 +405,7 @@ void ConfigurationManager::Configure(const std::vector<Layer> &available_layers)
         this->environment.SetSelectedConfiguration("");
         this->Configure(available_layers, "");
     } else {
-        Configuration *selected_configuration = FindByKey(this->available_configurations, active_configuration_name.c_str());
+        Configuration *selected_configuration = this->FindConfiguration(active_configuration_name);
         if (selected_configuration == nullptr) {
             environment.SetSelectedConfiguration("");
         }
@@ -247,7 +423,7 @@ void ConfigurationManager::Configure(const std::vector<Layer> &available_layers,
             if (configuration_name.empty()) {
                 ::SurrenderConfiguration(this->environment);
             } else {
-                Configuration *selected_configuration = FindByKey(this->available_configurations, configuration_name.c_str());
+                Configuration *selected_configuration = this->FindConfiguration(configuration_name);
                 std::string missing_layer;
                 if (::HasMissingLayer(selected_configuration->parameters, available_layers, missing_layer)) {
                     ::SurrenderConfiguration(this->environment);
@@ -270,12 +446,20 @@ void ConfigurationManager::Configure(const std::vector<Layer> &available_layers,
     }
 }
 
+Configuration *ConfigurationManager::FindConfiguration(const std::string &configuration_name) {
+    return this->configuration_index.Find(this->available_configurations, configuration_name.c_str());
+}
+
+const Configuration *ConfigurationManager::FindConfiguration(const std::string &configuration_name) const {
+    return this->configuration_index.Find(this->available_configurations, configuration_name.c_str());
+}
+
 Configuration *ConfigurationManager::FindActiveConfiguration() {
     if (this->environment.GetSelectedConfiguration().empty()) {
         return nullptr;
     }
 
-    return FindByKey(this->available_configurations, this->environment.GetSelectedConfiguration().c_str());
+    return this->FindConfiguration(this->environment.GetSelectedConfiguration());
 }
 
 bool ConfigurationManager::HasActiveConfiguration(const std::vector<Layer> &available_layers) const {
@@ -287,7 +471,7 @@ bool ConfigurationManager::HasActiveConfiguration(const std::vector<Layer> &avai
             if (configuration_name.empty()) {
                 return false;
             } else {
-                const Configuration *selected_configuration = FindByKey(this->available_configurations, configuration_name.c_str());
+                const Configuration *selected_configuration = this->FindConfiguration(configuration_name);
                 if (selected_configuration != nullptr) {
                     std::string missing_layer;
                     return !::HasMissingLayer(selected_configuration->parameters, available_layers, missing_layer);
@@ -319,6 +503,7 @@ std::string ConfigurationManager::ImportConfiguration(const std::vector<Layer> &
     }
 
     configuration.key = MakeConfigurationName(this->available_configurations, configuration.key + " (Imported)");
+    configuration.dirty = true;
     this->available_configurations.push_back(configuration);
     this->SortConfigurations();
 
@@ -330,7 +515,7 @@ void ConfigurationManager::ExportConfiguration(const std::vector<Layer> &availab
     assert(!configuration_name.empty());
     assert(!full_export_path.empty());
 
-    Configuration *configuration = FindByKey(available_configurations, configuration_name.c_str());
+    Configuration *configuration = this->FindConfiguration(configuration_name);
     assert(configuration);
 
     if (!configuration->Save(available_layers, full_export_path, true)) {
@@ -376,12 +561,13 @@ void ConfigurationManager::FirstDefaultsConfigurations(const std::vector<Layer>
             continue;
         }
 
-        if (FindByKey(available_configurations, configuration.key.c_str()) != nullptr) {
+        if (this->FindConfiguration(configuration.key) != nullptr) {
             continue;
         }
 
         OrderParameter(configuration.parameters, available_layers);
         available_configurations.push_back(configuration);
+        this->configuration_index.Append(this->available_configurations);
     }
 }
 
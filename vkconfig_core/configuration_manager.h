@@ -23,9 +23,13 @@
 #include "configuration.h"
 #include "environment.h"
 #include "path_manager.h"
+#include "util.h"
+
+#include <QByteArray>
 
 #include <string>
 #include <vector>
+#include <map>
 
 class ConfigurationManager {
    public:
@@ -34,18 +38,39 @@ class ConfigurationManager {
 
     void LoadAllConfigurations(const std::vector<Layer>& available_layers);
 
+    // Only the dirty configurations are saved, and only when their content differs from their file
     void SaveAllConfigurations(const std::vector<Layer>& available_layers);
 
+    // Mark a configuration modified so that it's saved by the next SaveAllConfigurations call
+    void SetDirty(const std::string& configuration_name);
+
+    // Reload a single configuration file that was added, modified or removed by another process.
+    // Returns whether the list of configurations changed, files last written or read by the configuration manager are skipped.
+    bool UpdateConfigurationFromFile(const std::vector<Layer>& available_layers, const std::string& path);
+
+    // Whether a configuration file was added, modified or removed since the configuration manager last read or wrote it
+    bool HasConfigurationFileChanged(const std::string& path) const;
+
+    // Move the settings of the parameters of the updated layers to the settings of the reloaded layers, keeping their values.
+    // The previous layers must still be alive. Returns whether a configuration uses one of the layers.
+    bool UpdateLayerSettings(const std::vector<Layer>& available_layers, const std::vector<std::string>& layer_keys);
+
     Configuration& CreateConfiguration(const std::vector<Layer>& available_layers, const std::string& configuration_name,
                                        bool duplicate = false);
 
     void RemoveConfiguration(const std::vector<Layer>& available_layers, const std::string& configuration_name);
 
+    // Remove the file of the configuration, it's saved with the new name by the next SaveAllConfigurations call
+    Configuration* RenameConfiguration(const std::string& configuration_name, const std::string& new_configuration_name);
+
     std::string ImportConfiguration(const std::vector<Layer>& available_layers, const std::string& full_import_path);
     void ExportConfiguration(const std::vector<Layer>& available_layers, const std::string& full_export_path,
                              const std::string& configuration_name);
     Configuration* FindActiveConfiguration();
 
+    Configuration* FindConfiguration(const std::string& configuration_name);
+    const Configuration* FindConfiguration(const std::string& configuration_name) const;
+
     bool HasActiveConfiguration(const std::vector<Layer>& available_layers) const;
 
     // The only function that actually configure the system, the Vulkan Loader, the Vulkan layer settings, creating and deleting
@@ -82,5 +107,12 @@ class ConfigurationManager {
     void LoadConfigurationsPath(const std::vector<Layer>& available_layers, const char* path);
     void LoadDefaultConfigurations(const std::vector<Layer>& available_layers);
 
+    // Remember the content of a configuration file read or written by the configuration manager
+    void RecordConfigurationFile(const std::string& path);
+
     Environment& environment;
+
+    std::map<std::string, QByteArray> configuration_file_hashes;  // Indexed by absolute file path
+
+    KeyIndex<Configuration> configuration_index;
 };
@@ -22,7 +22,52 @@
 #include "setting_flags.h"
 #include "override.h"
 
+#include <QFile>
 #include <QFileInfo>
+#include <QDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QThreadPool>
+#include <QRunnable>
+
+#include <cstring>
+
+// Write the documentation to the file while it's generated instead of building the whole document in memory
+class DocWriter {
+   public:
+    DocWriter(const std::string& path) : file(path.c_str()), failed(false) {
+        this->failed = !this->file.open(QIODevice::WriteOnly | QIODevice::Text);
+    }
+
+    bool IsOpen() const { return this->file.isOpen(); }
+
+    DocWriter& operator+=(const std::string& text) { return this->Write(text.data(), text.size()); }
+    DocWriter& operator+=(const char* text) { return this->Write(text, std::strlen(text)); }
+
+    // Returns whether the whole document was written
+    bool Close() {
+        if (this->file.isOpen()) {
+            this->failed = !this->file.flush() || this->failed;
+            this->file.close();
+        }
+        return !this->failed;
+    }
+
+   private:
+    DocWriter(const DocWriter&) = delete;
+    DocWriter& operator=(const DocWriter&) = delete;
+
+    DocWriter& Write(const char* data, std::size_t size) {
+        if (!this->failed && this->file.write(data, static_cast<qint64>(size)) != static_cast<qint64>(size)) {
+            this->failed = true;
+        }
+        return *this;
+    }
+
+    QFile file;
+    bool failed;
+};
 
 static std::string BuildPlatformsHtml(int platform_flags) {
     std::string text;
@@ -50,7 +95,7 @@ static std::string BuildPlatformsMarkdown(int platform_flags) {
     return text;
 }
 
-static void WriteSettingsOverviewHtml(std::string& text, const Layer& layer, const SettingMetaSet& settings) {
+static void WriteSettingsOverviewHtml(DocWriter& text, const Layer& layer, const SettingMetaSet& settings) {
     for (std::size_t i = 0, n = settings.size(); i < n; ++i) {
         const SettingMeta* setting = settings[i];
 
@@ -85,7 +130,7 @@ static void WriteSettingsOverviewHtml(std::string& text, const Layer& layer, con
     }
 }
 
-static void WriteSettingsOverviewMarkdown(std::string& text, const Layer& layer, const SettingMetaSet& settings) {
+static void WriteSettingsOverviewMarkdown(DocWriter& text, const Layer& layer, const SettingMetaSet& settings) {
     for (std::size_t i = 0, n = settings.size(); i < n; ++i) {
         const SettingMeta* setting = settings[i];
 
@@ -128,7 +173,7 @@ static const std::string GetLayerSettingsDocURL(const Layer& layer) {
     }
 }
 
-static void WriteSettingsDetailsHtml(std::string& text, const Layer& layer, const SettingMetaSet& settings) {
+static void WriteSettingsDetailsHtml(DocWriter& text, const Layer& layer, const SettingMetaSet& settings) {
     for (std::size_t i = 0, n = settings.size(); i < n; ++i) {
         const SettingMeta* setting = settings[i];
 
@@ -206,7 +251,7 @@ static void WriteSettingsDetailsHtml(std::string& text, const Layer& layer, cons
     }
 }
 
-static void WriteSettingsDetailsMarkdown(std::string& text, const Layer& layer, const SettingMetaSet& settings) {
+static void WriteSettingsDetailsMarkdown(DocWriter& text, const Layer& layer, const SettingMetaSet& settings) {
     for (std::size_t i = 0, n = settings.size(); i < n; ++i) {
         const SettingMeta* setting = settings[i];
 
@@ -281,8 +326,11 @@ size_t GetNumSettings(const Layer& layer) {
     return rval;
 }
 
-void ExportHtmlDoc(const Layer& layer, const std::string& path) {
-    std::string text;
+bool ExportHtmlDoc(const Layer& layer, const std::string& path) {
+    DocWriter text(path);
+    if (!text.IsOpen()) {
+        return false;
+    }
 
     text += "<!DOCTYPE html>\n";
     text += "<html>\n";
@@ -381,18 +429,14 @@ void ExportHtmlDoc(const Layer& layer, const std::string& path) {
     text += "</body>\n";
     text += "</html>\n";
 
-    QFile file(path.c_str());
-    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        file.write(text.c_str());
-        file.close();
-        printf("vkconfig: html file written to %s\n", path.c_str());
-    } else {
-        printf("vkconfig: could not write %s\n", path.c_str());
-    }
+    return text.Close();
 }
 
-void ExportMarkdownDoc(const Layer& layer, const std::string& path) {
-    std::string text;
+bool ExportMarkdownDoc(const Layer& layer, const std::string& path) {
+    DocWriter text(path);
+    if (!text.IsOpen()) {
+        return false;
+    }
 
     text += format("## %s\n", layer.key.c_str());
 
@@ -453,19 +497,200 @@ void ExportMarkdownDoc(const Layer& layer, const std::string& path) {
         }
     }
 
-    QFile file(path.c_str());
-    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        file.write(text.c_str());
-        file.close();
-        printf("vkconfig: markdown file written to %s\n", path.c_str());
-    } else {
-        printf("vkconfig: could not write %s\n", path.c_str());
+    return text.Close();
+}
+
+bool ExportSettingsDoc(const std::vector<Layer>& available_layers, const Configuration& configuration, const std::string& path) {
+    return WriteSettingsOverride(available_layers, configuration, path);
+}
+
+static QJsonArray BuildPlatformsJson(int platform_flags) {
+    QJsonArray json_platforms;
+
+    const std::vector<std::string>& platforms = GetPlatformTokens(platform_flags);
+    for (std::size_t i = 0, n = platforms.size(); i < n; ++i) {
+        json_platforms.append(platforms[i].c_str());
+    }
+
+    return json_platforms;
+}
+
+static void WriteHeaderJson(QJsonObject& json_object, const Header& header) {
+    json_object.insert("label", header.label.c_str());
+    if (!header.description.empty()) {
+        json_object.insert("description", header.description.c_str());
+    }
+    if (!header.url.empty()) {
+        json_object.insert("url", header.url.c_str());
+    }
+    json_object.insert("status", GetToken(header.status));
+    json_object.insert("view", GetToken(header.view));
+    json_object.insert("platforms", BuildPlatformsJson(header.platform_flags));
+}
+
+static QJsonArray BuildSettingsJson(const SettingMetaSet& settings) {
+    QJsonArray json_settings;
+
+    for (std::size_t i = 0, n = settings.size(); i < n; ++i) {
+        const SettingMeta* setting = settings[i];
+
+        QJsonObject json_setting;
+        json_setting.insert("key", setting->key.c_str());
+        json_setting.insert("type", GetToken(setting->type));
+        WriteHeaderJson(json_setting, *setting);
+        if (!setting->env.empty()) {
+            json_setting.insert("env", setting->env.c_str());
+        }
+
+        if (setting->type != SETTING_GROUP) {
+            json_setting.insert("default", setting->Export(EXPORT_MODE_DOC).c_str());
+        }
+
+        if (IsEnum(setting->type) || IsFlags(setting->type)) {
+            const SettingMetaEnumeration& setting_enum = static_cast<const SettingMetaEnumeration&>(*setting);
+
+            QJsonArray json_values;
+            for (std::size_t j = 0, o = setting_enum.enum_values.size(); j < o; ++j) {
+                const SettingEnumValue& value = setting_enum.enum_values[j];
+
+                QJsonObject json_value;
+                json_value.insert("key", value.key.c_str());
+                WriteHeaderJson(json_value, value);
+                if (!value.settings.empty()) {
+                    json_value.insert("settings", BuildSettingsJson(value.settings));
+                }
+                json_values.append(json_value);
+            }
+            json_setting.insert(IsEnum(setting->type) ? "enum" : "flags", json_values);
+        }
+
+        if (!setting->children.empty()) {
+            json_setting.insert("settings", BuildSettingsJson(setting->children));
+        }
+
+        json_settings.append(json_setting);
+    }
+
+    return json_settings;
+}
+
+static QJsonObject BuildLayerJson(const Layer& layer) {
+    QJsonObject json_layer;
+    json_layer.insert("key", layer.key.c_str());
+    json_layer.insert("description", layer.description.c_str());
+    if (!layer.url.empty()) {
+        json_layer.insert("url", layer.url.c_str());
     }
+    json_layer.insert("status", GetToken(layer.status));
+    json_layer.insert("api_version", layer.api_version.str().c_str());
+    json_layer.insert("implementation_version", layer.implementation_version.c_str());
+    json_layer.insert("manifest", QFileInfo(layer.manifest_path.c_str()).fileName());
+    json_layer.insert("platforms", BuildPlatformsJson(layer.platforms));
+    json_layer.insert("settings", BuildSettingsJson(layer.settings));
+
+    QJsonArray json_presets;
+    for (std::size_t i = 0, n = layer.presets.size(); i < n; ++i) {
+        const LayerPreset& preset = layer.presets[i];
+
+        QJsonArray json_preset_settings;
+        for (std::size_t j = 0, o = preset.settings.size(); j < o; ++j) {
+            const SettingData* data = preset.settings[j];
+
+            QJsonObject json_preset_setting;
+            json_preset_setting.insert("key", data->key.c_str());
+            json_preset_setting.insert("value", data->Export(EXPORT_MODE_DOC).c_str());
+            json_preset_settings.append(json_preset_setting);
+        }
+
+        QJsonObject json_preset;
+        WriteHeaderJson(json_preset, preset);
+        json_preset.insert("settings", json_preset_settings);
+        json_presets.append(json_preset);
+    }
+    json_layer.insert("presets", json_presets);
+
+    return json_layer;
 }
 
-void ExportSettingsDoc(const std::vector<Layer>& available_layers, const Configuration& configuration, const std::string& path) {
-    if (WriteSettingsOverride(available_layers, configuration, path))
-        printf("vkconfig: settings written to %s\n", path.c_str());
-    else
-        printf("vkconfig: could not write %s\n", path.c_str());
+struct LayerDocResult {
+    QByteArray settings_json;
+    std::vector<std::string> failed_files;
+};
+
+// Generate all the documentation files of a single layer, the layers are documented concurrently
+class LayerDocTask : public QRunnable {
+   public:
+    LayerDocTask(const Layer& layer, const std::string& output_dir, LayerDocResult& result)
+        : layer(layer), output_dir(output_dir), result(result) {}
+
+    void run() override {
+        const std::string html_path = format("%s/%s.html", this->output_dir.c_str(), this->layer.key.c_str());
+        if (!ExportHtmlDoc(this->layer, html_path)) {
+            this->result.failed_files.push_back(html_path);
+        }
+
+        const std::string markdown_path = format("%s/%s.md", this->output_dir.c_str(), this->layer.key.c_str());
+        if (!ExportMarkdownDoc(this->layer, markdown_path)) {
+            this->result.failed_files.push_back(markdown_path);
+        }
+
+        // The layer is copied to only document its own settings
+        const std::vector<Layer> doc_layers(1, this->layer);
+
+        Configuration configuration;
+        configuration.key = this->layer.key;
+        configuration.parameters = GatherParameters(configuration.parameters, doc_layers);
+        configuration.parameters[0].state = LAYER_STATE_OVERRIDDEN;
+
+        const std::string settings_path = format("%s/%s_vk_layer_settings.txt", this->output_dir.c_str(), this->layer.key.c_str());
+        if (!ExportSettingsDoc(doc_layers, configuration, settings_path)) {
+            this->result.failed_files.push_back(settings_path);
+        }
+
+        this->result.settings_json = QJsonDocument(BuildLayerJson(this->layer)).toJson(QJsonDocument::Compact);
+    }
+
+   private:
+    const Layer& layer;
+    const std::string output_dir;
+    LayerDocResult& result;
+};
+
+std::vector<std::string> ExportAllDoc(const std::vector<Layer>& available_layers, const std::string& output_dir) {
+    std::vector<std::string> failed_files;
+
+    if (!QDir().mkpath(output_dir.c_str())) {
+        failed_files.push_back(output_dir);
+        return failed_files;
+    }
+
+    std::vector<LayerDocResult> results(available_layers.size());
+
+    QThreadPool thread_pool;
+    for (std::size_t i = 0, n = available_layers.size(); i < n; ++i) {
+        thread_pool.start(new LayerDocTask(available_layers[i], output_dir, results[i]));
+    }
+    thread_pool.waitForDone();
+
+    // The settings of each layer are written on a single line, in the order of the layers
+    const std::string json_path = output_dir + "/layers_settings.json";
+    DocWriter json(json_path);
+    json += "{\n";
+    json += format("    \"vkconfig_version\": \"%s\",\n", Version::VKCONFIG.str().c_str());
+    json += "    \"layers\": [\n";
+    for (std::size_t i = 0, n = results.size(); i < n; ++i) {
+        json += "        ";
+        json += std::string(results[i].settings_json.constData(), results[i].settings_json.size());
+        json += i < n - 1 ? ",\n" : "\n";
+
+        failed_files.insert(failed_files.end(), results[i].failed_files.begin(), results[i].failed_files.end());
+    }
+    json += "    ]\n";
+    json += "}\n";
+
+    if (!json.Close()) {
+        failed_files.push_back(json_path);
+    }
+
+    return failed_files;
 }
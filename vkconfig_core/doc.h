@@ -23,9 +23,15 @@
 #include "environment.h"
 #include "configuration.h"
 
-void ExportHtmlDoc(const Layer& layer, const std::string& path);
+// Export functions return whether the file was written
 
-void ExportMarkdownDoc(const Layer& layer, const std::string& path);
+bool ExportHtmlDoc(const Layer& layer, const std::string& path);
 
-void ExportSettingsDoc(const std::vector<Layer>& available_layers,
+bool ExportMarkdownDoc(const Layer& layer, const std::string& path);
+
+bool ExportSettingsDoc(const std::vector<Layer>& available_layers,
                        const Configuration& configuration, const std::string& path);
+
+// Export the html, markdown and vk_layer_settings.txt files of each layer, and the settings of all the layers in
+// layers_settings.json. The layers are documented on a thread pool. Returns the files that couldn't be written.
+std::vector<std::string> ExportAllDoc(const std::vector<Layer>& available_layers, const std::string& output_dir);
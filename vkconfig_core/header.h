@@ -22,6 +22,7 @@
 
 #include "platform.h"
 #include "json.h"
+#include "string_pool.h"
 
 #include <string>
 
@@ -42,9 +43,9 @@ const char* GetToken(SettingView state);
 struct Header {
     Header() : status(STATUS_STABLE), view(SETTING_VIEW_STANDARD), platform_flags(PLATFORM_DESKTOP_BIT), expanded(true) {}
 
-    std::string label;
-    std::string description;
-    std::string url;
+    InternedString label;
+    InternedString description;
+    InternedString url;
     StatusType status;
     SettingView view;
     int platform_flags;
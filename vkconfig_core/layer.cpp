@@ -77,10 +77,18 @@ static std::string GetBuiltinFolder(const Version& version) {
 
 const char* Layer::NO_PRESET = "User-Defined Settings";
 
-Layer::Layer() : status(STATUS_STABLE), platforms(PLATFORM_DESKTOP_BIT), type(LAYER_TYPE_EXPLICIT) {}
+Layer::Layer()
+    : status(STATUS_STABLE),
+      platforms(PLATFORM_DESKTOP_BIT),
+      type(LAYER_TYPE_EXPLICIT),
+      arena(std::make_shared<SettingMetaArena>()) {}
 
 Layer::Layer(const std::string& key, const LayerType layer_type)
-    : key(key), status(STATUS_STABLE), platforms(PLATFORM_DESKTOP_BIT), type(layer_type) {}
+    : key(key),
+      status(STATUS_STABLE),
+      platforms(PLATFORM_DESKTOP_BIT),
+      type(layer_type),
+      arena(std::make_shared<SettingMetaArena>()) {}
 
 Layer::Layer(const std::string& key, const LayerType layer_type, const Version& file_format_version, const Version& api_version,
              const std::string& implementation_version, const std::string& library_path)
@@ -91,7 +99,8 @@ Layer::Layer(const std::string& key, const LayerType layer_type, const Version&
       implementation_version(implementation_version),
       status(STATUS_STABLE),
       platforms(PLATFORM_DESKTOP_BIT),
-      type(layer_type) {}
+      type(layer_type),
+      arena(std::make_shared<SettingMetaArena>()) {}
 
 // Todo: Load the layer with Vulkan API
 bool Layer::IsValid() const {
@@ -159,11 +168,26 @@ SettingMeta* Layer::Instantiate(SettingMetaSet& meta_set, const std::string& key
     }
 
     assert(setting_meta != nullptr);
-    this->memory.push_back(std::shared_ptr<SettingMeta>(setting_meta));
+    this->arena->settings.push_back(std::unique_ptr<SettingMeta>(setting_meta));
+    this->arena->index.insert(std::make_pair(key, setting_meta));  // Keep the first setting like FindSetting
     meta_set.push_back(setting_meta);
     return setting_meta;
 }
 
+SettingMeta* Layer::FindSetting(const char* key) {
+    assert(key != nullptr);
+
+    auto it = this->arena->index.find(key);
+    return it != this->arena->index.end() ? it->second : nullptr;
+}
+
+const SettingMeta* Layer::FindSetting(const char* key) const {
+    assert(key != nullptr);
+
+    auto it = this->arena->index.find(key);
+    return it != this->arena->index.end() ? it->second : nullptr;
+}
+
 /// Reports errors via a message box. This might be a bad idea?
 bool Layer::Load(const std::vector<Layer>& available_layers, const std::string& full_path_to_file, LayerType layer_type) {
     this->type = layer_type;  // Set layer type, no way to know this from the json file
@@ -327,7 +351,7 @@ bool Layer::Load(const std::vector<Layer>& available_layers, const std::string&
             this->status = default_layer.status;
             std::swap(this->settings, default_layer.settings);
             std::swap(this->presets, default_layer.presets);
-            this->memory = default_layer.memory;
+            this->arena = default_layer.arena;
         }
     }
 
@@ -417,7 +441,7 @@ void Layer::AddSettingData(SettingDataSet& settings_data, const QJsonValue& json
 
     const std::string& key = ReadStringValue(json_setting_object, "key");
 
-    SettingMeta* setting_meta = FindSetting(this->settings, key.c_str());
+    SettingMeta* setting_meta = this->FindSetting(key.c_str());
     assert(setting_meta);
 
     SettingData* setting_data = setting_meta->Instantiate();
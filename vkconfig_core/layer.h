@@ -32,6 +32,14 @@
 
 #include <vector>
 #include <string>
+#include <memory>
+#include <unordered_map>
+
+// The settings of a layer, shared by all the copies of the layer so that copying a layer doesn't copy its settings
+struct SettingMetaArena {
+    std::vector<std::unique_ptr<SettingMeta> > settings;   // Settings are never removed, their addresses are stable
+    std::unordered_map<std::string, SettingMeta*> index;  // All the settings of the layer, indexed by key
+};
 
 class Layer {
    public:
@@ -41,6 +49,8 @@ class Layer {
     Layer(const std::string& key, const LayerType layer_type);
     Layer(const std::string& key, const LayerType layer_type, const Version& file_format_version, const Version& api_version,
           const std::string& implementation_version, const std::string& library_path);
+    Layer(const Layer&) = default;
+    Layer(Layer&&) = default;
 
     bool IsValid() const;
 
@@ -48,6 +58,10 @@ class Layer {
 
     SettingMeta* Instantiate(SettingMetaSet& meta_set, const std::string& key, const SettingType type);
 
+    // Constant time alternative to FindSetting(layer.settings, key), including children and enum values settings
+    SettingMeta* FindSetting(const char* key);
+    const SettingMeta* FindSetting(const char* key) const;
+
     void AddSettingData(SettingDataSet& data_set, const QJsonValue& json_setting_value);
 
     void AddSettingsSet(SettingMetaSet& meta_set, const SettingMeta* parent, const QJsonValue& json_settings_value);
@@ -79,7 +93,7 @@ class Layer {
    private:
     Layer& operator=(const Layer&) = delete;
 
-    std::vector<std::shared_ptr<SettingMeta> > memory;  // Settings are deleted when all layers instances are deleted.
+    std::shared_ptr<SettingMetaArena> arena;  // Settings are deleted when all layers instances are deleted.
 };
 
 void CollectDefaultSettingData(const SettingMetaSet& meta_set, SettingDataSet& data_set);
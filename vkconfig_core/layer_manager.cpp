@@ -25,6 +25,7 @@
 
 #include <QSettings>
 #include <QDir>
+#include <QFileInfo>
 #include <QStringList>
 
 /// Going back and forth between the Windows registry and looking for files
@@ -82,12 +83,28 @@ static const char *SEARCH_PATHS[] = {"/usr/local/etc/vulkan/explicit_layer.d",
                                      ".local/share/vulkan/implicit_layer.d"};
 #endif
 
+static LayerType GetLayerType(const std::string &path) {
+    LayerType type = LAYER_TYPE_USER_DEFINED;
+    if (QString(path.c_str()).contains("explicit", Qt::CaseInsensitive)) type = LAYER_TYPE_EXPLICIT;
+    if (QString(path.c_str()).contains("implicit", Qt::CaseInsensitive)) type = LAYER_TYPE_IMPLICIT;
+    return type;
+}
+
 LayerManager::LayerManager(const Environment &environment) : environment(environment) { available_layers.reserve(10); }
 
-void LayerManager::Clear() { available_layers.clear(); }
+void LayerManager::Clear() {
+    available_layers.clear();
+    layer_index.Clear();
+}
 
 bool LayerManager::Empty() const { return available_layers.empty(); }
 
+Layer *LayerManager::FindLayer(const std::string &layer_name) { return layer_index.Find(available_layers, layer_name.c_str()); }
+
+const Layer *LayerManager::FindLayer(const std::string &layer_name) const {
+    return layer_index.Find(available_layers, layer_name.c_str());
+}
+
 std::vector<std::string> LayerManager::BuildPathList() const {
     std::vector<std::string> list;
 
@@ -133,6 +150,7 @@ std::vector<std::string> LayerManager::BuildPathList() const {
 // Find all installed layers on the system.
 void LayerManager::LoadAllInstalledLayers() {
     available_layers.clear();
+    layer_index.Clear();
 
     // FIRST: If VK_LAYER_PATH is set it has precedence over other layers.
     const std::vector<std::string> &env_user_defined_layers_paths_set =
@@ -169,6 +187,7 @@ void LayerManager::LoadAllInstalledLayers() {
 // Load a single layer
 void LayerManager::LoadLayer(const std::string &layer_name) {
     available_layers.clear();
+    layer_index.Clear();
 
     // FIRST: If VK_LAYER_PATH is set it has precedence over other layers.
     const std::vector<std::string> &env_user_defined_layers_paths_set =
@@ -209,9 +228,7 @@ void LayerManager::LoadLayer(const std::string &layer_name) {
 void LayerManager::LoadLayersFromPath(const std::string &path) {
     // On Windows custom files are in the file system. On non Windows all layers are
     // searched this way
-    LayerType type = LAYER_TYPE_USER_DEFINED;
-    if (QString(path.c_str()).contains("explicit", Qt::CaseInsensitive)) type = LAYER_TYPE_EXPLICIT;
-    if (QString(path.c_str()).contains("implicit", Qt::CaseInsensitive)) type = LAYER_TYPE_IMPLICIT;
+    const LayerType type = GetLayerType(path);
 
     PathFinder file_list;
 
@@ -240,19 +257,18 @@ void LayerManager::LoadLayersFromPath(const std::string &path) {
         Layer layer;
         if (layer.Load(available_layers, file_list.GetFileName(i).c_str(), type)) {
             // Make sure this layer name has not already been added
-            if (FindByKey(available_layers, layer.key.c_str()) != nullptr) continue;
+            if (FindLayer(layer.key) != nullptr) continue;
 
             // Good to go, add the layer
             available_layers.push_back(layer);
+            layer_index.Append(available_layers);
         }
     }
 }
 
 // Attempt to load the named layer from the given path
 bool LayerManager::LoadLayerFromPath(const std::string &layer_name, const std::string &path) {
-    LayerType type = LAYER_TYPE_USER_DEFINED;
-    if (QString(path.c_str()).contains("explicit", Qt::CaseInsensitive)) type = LAYER_TYPE_EXPLICIT;
-    if (QString(path.c_str()).contains("implicit", Qt::CaseInsensitive)) type = LAYER_TYPE_IMPLICIT;
+    const LayerType type = GetLayerType(path);
 
     PathFinder file_list;
 
@@ -273,9 +289,60 @@ bool LayerManager::LoadLayerFromPath(const std::string &layer_name, const std::s
             // Add this layer if the layer name matches, then return
             if (layer_name == layer.key) {
                 available_layers.push_back(layer);
+                layer_index.Append(available_layers);
                 return true;
             }
         }
     }
     return false;
 }
+
+/// Only the layer loaded from the manifest is updated, the precedence between the search paths is not reevaluated: a new layer
+/// manifest declaring a layer already loaded from another manifest is ignored, like with LoadLayersFromPath.
+std::vector<std::string> LayerManager::UpdateLayerFromFile(const std::string &manifest_path) {
+    std::vector<std::string> updated_layers;
+
+    const QFileInfo file_info(manifest_path.c_str());
+    const QString absolute_path = file_info.absoluteFilePath();
+
+    // Layer doesn't support assignment, the list of layers is rebuilt without the layer previously loaded from the manifest
+    std::vector<Layer> layers;
+    layers.reserve(available_layers.size() + 1);
+
+    std::size_t position = available_layers.size();
+    for (std::size_t i = 0, n = available_layers.size(); i < n; ++i) {
+        if (QFileInfo(available_layers[i].manifest_path.c_str()).absoluteFilePath() == absolute_path) {
+            position = i;
+            updated_layers.push_back(available_layers[i].key);
+            continue;
+        }
+        layers.push_back(available_layers[i]);
+    }
+
+    Layer layer;
+    const bool loaded = file_info.exists() && layer.Load(layers, manifest_path, GetLayerType(manifest_path)) &&
+                        FindByKey(layers, layer.key.c_str()) == nullptr;
+
+    if (!loaded && updated_layers.empty()) {
+        return updated_layers;  // Not a layer manifest, or a layer already loaded from another manifest
+    }
+
+    if (loaded) {
+        // Keep the position of the reloaded layer
+        std::vector<Layer> ordered_layers;
+        ordered_layers.reserve(layers.size() + 1);
+        for (std::size_t i = 0, n = layers.size(); i < n; ++i) {
+            if (i == position) ordered_layers.push_back(layer);
+            ordered_layers.push_back(layers[i]);
+        }
+        if (position >= layers.size()) ordered_layers.push_back(layer);
+
+        std::swap(layers, ordered_layers);
+        AppendString(updated_layers, layer.key);
+    }
+
+    std::swap(available_layers, layers);
+    layer_index.Rebuild(available_layers);
+
+    return updated_layers;
+}
@@ -22,6 +22,7 @@
 
 #include "layer.h"
 #include "environment.h"
+#include "util.h"
 
 #include <QStringList>
 
@@ -40,12 +41,21 @@ class LayerManager {
     void LoadLayer(const std::string& layer_name);
     void LoadLayersFromPath(const std::string& path);
 
+    // Reload a single layer manifest that was added, modified or removed.
+    // Returns the keys of the layers removed or loaded, empty when the list of layers didn't change.
+    std::vector<std::string> UpdateLayerFromFile(const std::string& manifest_path);
+
     std::vector<std::string> BuildPathList() const;
 
+    Layer* FindLayer(const std::string& layer_name);
+    const Layer* FindLayer(const std::string& layer_name) const;
+
     std::vector<Layer> available_layers;
 
     const Environment& environment;
 
    private:
     bool LoadLayerFromPath(const std::string& layer_name, const std::string& path);
+
+    KeyIndex<Layer> layer_index;
 };
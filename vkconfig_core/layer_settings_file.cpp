@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2020-2024 Valve Corporation
+ * Copyright (c) 2020-2024 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ * - Christophe Riccio <christophe@lunarg.com>
+ */
+
+#include "layer_settings_file.h"
+
+#include <QFile>
+#include <QByteArray>
+
+#include <cstring>
+
+static const char* SETTING_UNDERLINE = "# =====================";
+static const char* SETTING_IDENTIFIER = "# <LayerIdentifier>.";
+static const std::size_t DESCRIPTION_COLUMNS = 80;
+
+// A range of the parsed buffer, the characters are only copied when they are stored in a LayerSettingsFileSetting
+struct SettingsFileToken {
+    SettingsFileToken() : data(nullptr), size(0) {}
+    SettingsFileToken(const char* data, std::size_t size) : data(data), size(size) {}
+
+    bool empty() const { return this->size == 0; }
+
+    bool StartsWith(const char* prefix) const {
+        const std::size_t length = std::strlen(prefix);
+        return this->size >= length && std::memcmp(this->data, prefix, length) == 0;
+    }
+
+    bool Equals(const char* text) const { return this->size == std::strlen(text) && this->StartsWith(text); }
+
+    std::size_t Find(char c) const {
+        const void* found = std::memchr(this->data, c, this->size);
+        return found == nullptr ? this->size : static_cast<const char*>(found) - this->data;
+    }
+
+    std::size_t FindLast(char c) const {
+        for (std::size_t i = this->size; i > 0; --i) {
+            if (this->data[i - 1] == c) return i - 1;
+        }
+        return this->size;
+    }
+
+    SettingsFileToken Mid(std::size_t position, std::size_t length = static_cast<std::size_t>(-1)) const {
+        if (position > this->size) position = this->size;
+        if (length > this->size - position) length = this->size - position;
+        return SettingsFileToken(this->data + position, length);
+    }
+
+    SettingsFileToken Trimmed() const {
+        std::size_t begin = 0;
+        std::size_t end = this->size;
+        while (begin < end && (this->data[begin] == ' ' || this->data[begin] == '\t')) ++begin;
+        while (end > begin && (this->data[end - 1] == ' ' || this->data[end - 1] == '\t')) --end;
+        return this->Mid(begin, end - begin);
+    }
+
+    std::string str() const { return std::string(this->data, this->size); }
+
+    const char* data;
+    std::size_t size;
+};
+
+// Words are separated by single spaces and wrapped at 80 columns
+static void WriteDescription(std::string& content, const std::string& description) {
+    const std::size_t size = description.size();
+
+    bool has_words = false;
+    std::size_t columns = 2;
+    for (std::size_t begin = 0; begin <= size;) {
+        std::size_t end = description.find(' ', begin);
+        if (end == std::string::npos) {
+            end = size;
+            if (end == begin) break;  // No trailing empty word
+        }
+
+        const std::size_t length = end - begin;
+        if (!has_words) {
+            content += '#';
+            has_words = true;
+        }
+        if (length + columns > DESCRIPTION_COLUMNS) {
+            content += "\n#";
+            columns = 2;
+        }
+        content += ' ';
+        content.append(description, begin, length);
+        columns += length + 1;
+
+        begin = end + 1;
+    }
+
+    content += '\n';
+}
+
+std::string WriteLayerSettingsFile(const std::vector<LayerSettingsFileLayer>& layers) {
+    std::size_t capacity = 0;
+    for (std::size_t i = 0, n = layers.size(); i < n; ++i) {
+        const LayerSettingsFileLayer& layer = layers[i];
+        capacity += layer.key.size() + 8;
+
+        for (std::size_t j = 0, o = layer.settings.size(); j < o; ++j) {
+            const LayerSettingsFileSetting& setting = layer.settings[j];
+            capacity += setting.label.size() + setting.description.size() + layer.prefix.size() + setting.key.size() * 2 +
+                        setting.value.size() + 96;
+        }
+    }
+
+    std::string content;
+    content.reserve(capacity);
+
+    for (std::size_t i = 0, n = layers.size(); i < n; ++i) {
+        const LayerSettingsFileLayer& layer = layers[i];
+
+        if (!layer.key.empty()) {
+            content += "\n# ";
+            content += layer.key;
+            content += "\n\n";
+        }
+
+        for (std::size_t j = 0, o = layer.settings.size(); j < o; ++j) {
+            const LayerSettingsFileSetting& setting = layer.settings[j];
+
+            content += "# ";
+            content += setting.label;
+            content += '\n';
+            content += SETTING_UNDERLINE;
+            content += '\n';
+            content += SETTING_IDENTIFIER;
+            content += setting.key;
+            content += '\n';
+
+            WriteDescription(content, setting.description);
+
+            if (setting.commented) {
+                content += '#';
+            }
+            content += layer.prefix;
+            content += setting.key;
+            content += " = ";
+            content += setting.value;
+            content += "\n\n";
+        }
+    }
+
+    return content;
+}
+
+// "<prefix><key> = <value>", the prefix ends with the last '.' before the '='
+static bool IsSettingLine(const SettingsFileToken& line) {
+    const std::size_t equal = line.Find('=');
+    const SettingsFileToken name = line.Mid(0, equal).Trimmed();
+    return equal < line.size && name.FindLast('.') < name.size;
+}
+
+static void AddSetting(std::vector<LayerSettingsFileLayer>& layers, const SettingsFileToken& line, bool commented,
+                       std::string& label, std::string& description) {
+    const std::size_t equal = line.Find('=');
+    const SettingsFileToken name = line.Mid(0, equal).Trimmed();
+    const SettingsFileToken prefix = name.Mid(0, name.FindLast('.') + 1);
+
+    LayerSettingsFileLayer* layer = nullptr;
+    if (!layers.empty() && (layers.back().prefix.empty() || prefix.Equals(layers.back().prefix.c_str()))) {
+        layer = &layers.back();
+    } else {
+        for (std::size_t i = 0, n = layers.size(); i < n; ++i) {
+            if (prefix.Equals(layers[i].prefix.c_str())) {
+                layer = &layers[i];
+                break;
+            }
+        }
+    }
+    if (layer == nullptr) {
+        layers.push_back(LayerSettingsFileLayer());
+        layer = &layers.back();
+    }
+    if (layer->prefix.empty()) {
+        layer->prefix = prefix.str();
+    }
+
+    LayerSettingsFileSetting setting;
+    setting.key = name.Mid(prefix.size).str();
+    setting.value = line.Mid(equal + 1).Trimmed().str();
+    setting.commented = commented;
+    std::swap(setting.label, label);
+    if (!description.empty()) {
+        setting.description.assign(description, 1, std::string::npos);  // Each description line starts with a separator
+        description.clear();
+    }
+
+    layer->settings.push_back(setting);
+}
+
+std::vector<LayerSettingsFileLayer> ParseLayerSettingsFile(const char* data, std::size_t size) {
+    std::vector<SettingsFileToken> lines;
+    for (std::size_t begin = 0; begin < size;) {
+        const void* found = std::memchr(data + begin, '\n', size - begin);
+        const std::size_t end = found == nullptr ? size : static_cast<const char*>(found) - data;
+
+        std::size_t length = end - begin;
+        if (length > 0 && data[begin + length - 1] == '\r') --length;
+        lines.push_back(SettingsFileToken(data + begin, length));
+
+        begin = end + 1;
+    }
+
+    std::vector<LayerSettingsFileLayer> layers;
+
+    std::string label;
+    std::string description;
+    bool in_setting = false;  // Between a setting heading and the setting line
+
+    for (std::size_t i = 0, n = lines.size(); i < n; ++i) {
+        const SettingsFileToken& line = lines[i];
+        if (line.Trimmed().empty()) {
+            continue;
+        }
+
+        if (line.data[0] != '#') {
+            if (IsSettingLine(line)) {
+                AddSetting(layers, line, false, label, description);
+            }
+            in_setting = false;
+            continue;
+        }
+
+        const SettingsFileToken comment = line.Mid(1);
+
+        // "# <description>", the leading space is kept as the separator with the previous line
+        if (in_setting && comment.StartsWith(" ")) {
+            description.append(comment.data, comment.size);
+            continue;
+        }
+
+        // "#<prefix><key> = <value>", a setting commented out
+        if (!comment.StartsWith(" ") && IsSettingLine(comment)) {
+            AddSetting(layers, comment, true, label, description);
+            in_setting = false;
+            continue;
+        }
+
+        // "# <label>", "# =====================", "# <LayerIdentifier>.<key>"
+        if (i + 1 < n && lines[i + 1].Equals(SETTING_UNDERLINE)) {
+            label = comment.Mid(comment.StartsWith(" ") ? 1 : 0).str();
+            description.clear();
+            in_setting = true;
+
+            ++i;
+            if (i + 1 < n && lines[i + 1].StartsWith(SETTING_IDENTIFIER)) {
+                ++i;
+            }
+            continue;
+        }
+
+        // "# <layer key>" followed by an empty line, other comments are ignored
+        const SettingsFileToken heading = comment.Trimmed();
+        const bool followed_by_empty_line = i + 1 < n && lines[i + 1].Trimmed().empty();
+        if (!in_setting && followed_by_empty_line && !heading.empty() && heading.Find(' ') == heading.size) {
+            LayerSettingsFileLayer layer;
+            layer.key = heading.str();
+            layers.push_back(layer);
+        }
+    }
+
+    return layers;
+}
+
+bool LoadLayerSettingsFile(const std::string& path, std::vector<LayerSettingsFileLayer>& layers) {
+    QFile file(path.c_str());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 size = file.size();
+    if (size == 0) {
+        layers.clear();
+        return true;
+    }
+
+    uchar* data = file.map(0, size);
+    if (data != nullptr) {
+        layers = ParseLayerSettingsFile(reinterpret_cast<const char*>(data), static_cast<std::size_t>(size));
+        file.unmap(data);
+    } else {
+        const QByteArray& content = file.readAll();
+        layers = ParseLayerSettingsFile(content.constData(), static_cast<std::size_t>(content.size()));
+    }
+
+    return true;
+}
+
+const LayerSettingsFileSetting* FindLayerSetting(const std::vector<LayerSettingsFileLayer>& layers, const std::string& prefix,
+                                                 const std::string& key) {
+    for (std::size_t i = 0, n = layers.size(); i < n; ++i) {
+        if (layers[i].prefix != prefix) continue;
+
+        for (std::size_t j = 0, o = layers[i].settings.size(); j < o; ++j) {
+            if (layers[i].settings[j].key == key) {
+                return &layers[i].settings[j];
+            }
+        }
+    }
+
+    return nullptr;
+}
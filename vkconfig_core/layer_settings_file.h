@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2020-2024 Valve Corporation
+ * Copyright (c) 2020-2024 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ * - Christophe Riccio <christophe@lunarg.com>
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// A setting written in vk_layer_settings.txt, "<prefix><key> = <value>" preceded by its label and description comments
+struct LayerSettingsFileSetting {
+    LayerSettingsFileSetting() : commented(false) {}
+
+    std::string key;
+    std::string value;
+    std::string label;
+    std::string description;
+    bool commented;  // Written commented out because the setting dependences are not met, the layer ignores it
+};
+
+// The settings of a layer in vk_layer_settings.txt, preceded by a "# <key>" heading comment
+struct LayerSettingsFileLayer {
+    std::string key;     // Empty when the settings are not preceded by a layer heading
+    std::string prefix;  // "khronos_validation." for VK_LAYER_KHRONOS_validation
+    std::vector<LayerSettingsFileSetting> settings;
+};
+
+// Generate the content of a vk_layer_settings.txt file
+std::string WriteLayerSettingsFile(const std::vector<LayerSettingsFileLayer>& layers);
+
+// Parse the content of a vk_layer_settings.txt file. Settings lines are "<prefix><key> = <value>", comments that are neither a
+// layer heading, a setting label or description nor a commented out setting are ignored.
+std::vector<LayerSettingsFileLayer> ParseLayerSettingsFile(const char* data, std::size_t size);
+
+// Map and parse a vk_layer_settings.txt file, returns false when the file can't be read
+bool LoadLayerSettingsFile(const std::string& path, std::vector<LayerSettingsFileLayer>& layers);
+
+const LayerSettingsFileSetting* FindLayerSetting(const std::vector<LayerSettingsFileLayer>& layers, const std::string& prefix,
+                                                 const std::string& key);
@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2020-2024 Valve Corporation
+ * Copyright (c) 2020-2024 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ * - Christophe Riccio <christophe@lunarg.com>
+ */
+
+#include "layers_session.h"
+#include "override.h"
+#include "doc.h"
+#include "util.h"
+
+#include <QJsonArray>
+#include <QElapsedTimer>
+#include <QDir>
+
+std::vector<std::string> SplitCommand(const std::string& command_text) {
+    std::vector<std::string> args;
+
+    std::string arg;
+    bool quoted = false;
+    bool has_arg = false;
+    for (std::size_t i = 0, n = command_text.size(); i < n; ++i) {
+        const char c = command_text[i];
+        if (c == '"') {
+            quoted = !quoted;
+            has_arg = true;
+        } else if (!quoted && (c == ' ' || c == '\t' || c == '\r' || c == '\n')) {
+            if (has_arg) args.push_back(arg);
+            arg.clear();
+            has_arg = false;
+        } else {
+            arg += c;
+            has_arg = true;
+        }
+    }
+
+    if (has_arg) args.push_back(arg);
+
+    return args;
+}
+
+static QJsonObject BuildReply(const std::string& command, bool result, const std::string& message) {
+    QJsonObject reply;
+    reply.insert("command", command.c_str());
+    reply.insert("result", result ? "success" : "failure");
+    if (!message.empty()) {
+        reply.insert("message", message.c_str());
+    }
+    return reply;
+}
+
+LayersSession::LayersSession(const std::string& vulkan_sdk, const std::vector<std::string>& supported_config_files)
+    : paths(vulkan_sdk, supported_config_files), environment(paths), layers(environment) {
+    this->environment.Reset(Environment::DEFAULT);
+
+    this->layers.LoadAllInstalledLayers();
+    this->manifest_stamps = this->BuildManifestStamps();
+}
+
+LayersSession::~LayersSession() {
+    this->environment.Reset(Environment::SYSTEM);  // Don't change the system settings on exit
+}
+
+LayersSession::FileStamp LayersSession::GetFileStamp(const QFileInfo& info) {
+    FileStamp stamp;
+    stamp.last_modified = info.lastModified();
+    stamp.size = info.size();
+    return stamp;
+}
+
+std::map<std::string, LayersSession::FileStamp> LayersSession::BuildManifestStamps() const {
+    std::vector<std::string> directories;
+
+    const std::vector<std::string>& search_paths = this->layers.BuildPathList();
+    for (std::size_t i = 0, n = search_paths.size(); i < n; ++i) {
+        const std::string& path = search_paths[i];
+
+        // Registry locations are not directories, the directories of the layers they list are added below
+        if (path.empty() || QString(path.c_str()).startsWith("HKEY")) continue;
+
+        if (VKC_PLATFORM != VKC_PLATFORM_WINDOWS && path[0] == '.') {
+            AppendString(directories, QDir().homePath().toStdString() + "/" + path);
+        } else {
+            AppendString(directories, path);
+        }
+    }
+
+    for (std::size_t i = 0, n = this->layers.available_layers.size(); i < n; ++i) {
+        const std::string& manifest_path = this->layers.available_layers[i].manifest_path;
+        AppendString(directories, QFileInfo(manifest_path.c_str()).absolutePath().toStdString());
+    }
+
+    std::map<std::string, FileStamp> stamps;
+    for (std::size_t i = 0, n = directories.size(); i < n; ++i) {
+        const QFileInfoList& files = QDir(directories[i].c_str()).entryInfoList(QStringList() << "*.json", QDir::Files);
+        for (int j = 0, o = files.size(); j < o; ++j) {
+            stamps[files[j].absoluteFilePath().toStdString()] = GetFileStamp(files[j]);
+        }
+    }
+
+    return stamps;
+}
+
+void LayersSession::RefreshLayers() {
+    const std::map<std::string, FileStamp>& stamps = this->BuildManifestStamps();
+
+    std::vector<std::string> changed_manifests;
+    for (auto it = stamps.begin(), end = stamps.end(); it != end; ++it) {
+        auto previous = this->manifest_stamps.find(it->first);
+        if (previous == this->manifest_stamps.end() || previous->second != it->second) {
+            changed_manifests.push_back(it->first);
+        }
+    }
+
+    for (auto it = this->manifest_stamps.begin(), end = this->manifest_stamps.end(); it != end; ++it) {
+        if (stamps.find(it->first) == stamps.end()) {
+            changed_manifests.push_back(it->first);
+        }
+    }
+
+    this->manifest_stamps = stamps;
+
+    bool updated = false;
+    for (std::size_t i = 0, n = changed_manifests.size(); i < n; ++i) {
+        if (!this->layers.UpdateLayerFromFile(changed_manifests[i]).empty()) {
+            updated = true;
+        }
+    }
+
+    // The layers configuration settings data are owned by the layers
+    if (updated) {
+        this->configurations.clear();
+    }
+}
+
+const Configuration* LayersSession::LoadConfiguration(const std::string& path, std::string& error) {
+    const QFileInfo info(path.c_str());
+    if (!info.exists()) {
+        error = format("'%s' couldn't be found", path.c_str());
+        return nullptr;
+    }
+
+    const std::string absolute_path = info.absoluteFilePath().toStdString();
+    const FileStamp& stamp = GetFileStamp(info);
+
+    auto found = this->configurations.find(absolute_path);
+    if (found != this->configurations.end() && !(found->second.stamp != stamp)) {
+        return &found->second.configuration;
+    }
+
+    Configuration configuration;
+    if (!configuration.Load(this->layers.available_layers, absolute_path)) {
+        this->configurations.erase(absolute_path);
+        error = format("Failed to load the layers configuration file '%s'", path.c_str());
+        return nullptr;
+    }
+
+    CachedConfiguration& cached = this->configurations[absolute_path];
+    cached.stamp = stamp;
+    cached.configuration = configuration;
+    return &cached.configuration;
+}
+
+QJsonObject LayersSession::Override(const std::vector<std::string>& args) {
+    if (args.size() != 2) {
+        return BuildReply(args[0], false, "Usage: override <layers_configuration_file>");
+    }
+
+    std::string error;
+    const Configuration* configuration = this->LoadConfiguration(args[1], error);
+    if (configuration == nullptr) {
+        return BuildReply(args[0], false, error);
+    }
+
+    // With command line, don't store the application list, it's always global, save and restore the setting
+    const bool use_application_list = this->environment.GetUseApplicationList();
+    this->environment.SetUseApplicationList(false);
+
+    const bool override_result = OverrideConfiguration(this->environment, this->layers.available_layers, *configuration);
+
+    this->environment.SetUseApplicationList(use_application_list);
+
+    if (!override_result) {
+        return BuildReply(args[0], false, "Failed to override Vulkan applications layers");
+    }
+
+    QJsonArray json_layers;
+    for (std::size_t i = 0, n = configuration->parameters.size(); i < n; ++i) {
+        const Parameter& parameter = configuration->parameters[i];
+        if (parameter.state == LAYER_STATE_APPLICATION_CONTROLLED) continue;
+
+        QJsonObject json_layer;
+        json_layer.insert("key", parameter.key.c_str());
+        json_layer.insert("state", parameter.state == LAYER_STATE_OVERRIDDEN ? "Overridden" : "Excluded");
+        json_layers.append(json_layer);
+    }
+
+    QJsonObject reply = BuildReply(args[0], true, "");
+    reply.insert("configuration", configuration->key.c_str());
+    reply.insert("layers", json_layers);
+    return reply;
+}
+
+QJsonObject LayersSession::Surrender(const std::vector<std::string>& args) {
+    if (args.size() != 1) {
+        return BuildReply(args[0], false, "Usage: surrender");
+    }
+
+    const bool has_overridden_layers = HasOverride();
+    const bool surrender_result = SurrenderConfiguration(this->environment);
+
+    if (!surrender_result) {
+        return BuildReply(args[0], false, "Failed to surrender Vulkan applications layers");
+    }
+
+    QJsonObject reply = BuildReply(args[0], true, "");
+    reply.insert("overridden", has_overridden_layers);
+    return reply;
+}
+
+QJsonObject LayersSession::List(const std::vector<std::string>& args, bool verbose) {
+    if (args.size() != 1) {
+        return BuildReply(args[0], false, verbose ? "Usage: verbose" : "Usage: list");
+    }
+
+    QJsonArray json_layers;
+    for (std::size_t i = 0, n = this->layers.available_layers.size(); i < n; ++i) {
+        const Layer& layer = this->layers.available_layers[i];
+
+        if (verbose) {
+            QJsonObject json_layer;
+            json_layer.insert("key", layer.key.c_str());
+            json_layer.insert("type", GetLayerTypeLabel(layer.type));
+            json_layer.insert("api_version", layer.api_version.str().c_str());
+            json_layer.insert("implementation_version", layer.implementation_version.c_str());
+            json_layer.insert("description", layer.description.c_str());
+            json_layer.insert("manifest_path", layer.manifest_path.c_str());
+            json_layer.insert("binary_path", layer.binary_path.c_str());
+            json_layers.append(json_layer);
+        } else {
+            json_layers.append(layer.key.c_str());
+        }
+    }
+
+    QJsonObject reply = BuildReply(args[0], true, "");
+    reply.insert("layers", json_layers);
+    return reply;
+}
+
+QJsonObject LayersSession::Doc(const std::vector<std::string>& args) {
+    if (args.size() >= 2 && args.size() <= 3 && args[1] == "all") {
+        const std::string& out_dir = args.size() == 3 ? args[2] : std::string(".");
+
+        const std::vector<std::string>& failed_files = ExportAllDoc(this->layers.available_layers, out_dir);
+        if (!failed_files.empty()) {
+            return BuildReply(args[0], false, format("Could not write %s", failed_files[0].c_str()));
+        }
+
+        QJsonObject reply = BuildReply(args[0], true, "");
+        reply.insert("path", out_dir.c_str());
+        return reply;
+    }
+
+    if (args.size() < 3 || args.size() > 4) {
+        return BuildReply(args[0], false, "Usage: doc (html | markdown | settings | all) [<layer_name>] [<output_dir>]");
+    }
+
+    const std::string& doc_kind = args[1];
+    const std::string& layer_name = args[2];
+    const std::string& out_dir = args.size() == 4 ? args[3] : std::string(".");
+
+    const Layer* layer = this->layers.FindLayer(layer_name);
+    if (layer == nullptr) {
+        return BuildReply(args[0], false, format("Could not load layer %s", layer_name.c_str()));
+    }
+
+    std::string path;
+    bool result = false;
+    if (doc_kind == "html") {
+        path = format("%s/%s.html", out_dir.c_str(), layer->key.c_str());
+        result = ExportHtmlDoc(*layer, path);
+    } else if (doc_kind == "markdown") {
+        path = format("%s/%s.md", out_dir.c_str(), layer->key.c_str());
+        result = ExportMarkdownDoc(*layer, path);
+    } else if (doc_kind == "settings") {
+        const std::vector<Layer> doc_layers(1, *layer);
+
+        Configuration configuration;
+        configuration.key = "Config";
+        configuration.parameters = GatherParameters(configuration.parameters, doc_layers);
+        configuration.parameters[0].state = LAYER_STATE_OVERRIDDEN;
+
+        path = out_dir + "/vk_layer_settings.txt";
+        result = ExportSettingsDoc(doc_layers, configuration, path);
+    } else {
+        return BuildReply(args[0], false, format("Invalid doc argument: '%s'", doc_kind.c_str()));
+    }
+
+    if (!result) {
+        return BuildReply(args[0], false, format("Could not write %s", path.c_str()));
+    }
+
+    QJsonObject reply = BuildReply(args[0], true, "");
+    reply.insert("path", path.c_str());
+    return reply;
+}
+
+QJsonObject LayersSession::Execute(const std::string& command_text, bool& quit) {
+    QElapsedTimer timer;
+    timer.start();
+
+    const std::vector<std::string>& args = SplitCommand(command_text);
+    if (args.empty()) {
+        return BuildReply("", false, "Empty command");
+    }
+
+    this->RefreshLayers();
+
+    const std::string& command = args[0];
+
+    QJsonObject reply;
+    if (command == "override") {
+        reply = this->Override(args);
+    } else if (command == "surrender") {
+        reply = this->Surrender(args);
+    } else if (command == "list") {
+        reply = this->List(args, false);
+    } else if (command == "verbose") {
+        reply = this->List(args, true);
+    } else if (command == "doc") {
+        reply = this->Doc(args);
+    } else if (command == "quit" || command == "exit") {
+        quit = true;
+        reply = BuildReply(command, true, "");
+    } else {
+        reply = BuildReply(command, false, format("Unknown command: '%s'", command.c_str()));
+    }
+
+    reply.insert("elapsed_ms", static_cast<double>(timer.nsecsElapsed()) / 1000000.0);
+    return reply;
+}
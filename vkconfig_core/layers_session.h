@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2020-2024 Valve Corporation
+ * Copyright (c) 2020-2024 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ * - Christophe Riccio <christophe@lunarg.com>
+ */
+
+#pragma once
+
+#include "configuration.h"
+#include "environment.h"
+#include "layer_manager.h"
+#include "path_manager.h"
+
+#include <QJsonObject>
+#include <QDateTime>
+#include <QFileInfo>
+
+#include <map>
+#include <string>
+#include <vector>
+
+// Split a command line on spaces, double quotes group arguments with spaces like paths
+std::vector<std::string> SplitCommand(const std::string& command_text);
+
+// Layers and layers configurations kept loaded between the commands of a batch or server session. Before each command, only
+// the layer manifests and the layers configuration files that changed since the previous command are reloaded.
+class LayersSession {
+   public:
+    LayersSession(const std::string& vulkan_sdk, const std::vector<std::string>& supported_config_files);
+    ~LayersSession();
+
+    // Execute a single command and return the JSON reply
+    QJsonObject Execute(const std::string& command_text, bool& quit);
+
+   private:
+    LayersSession(const LayersSession&) = delete;
+    LayersSession& operator=(const LayersSession&) = delete;
+
+    struct FileStamp {
+        QDateTime last_modified;
+        qint64 size;
+
+        bool operator!=(const FileStamp& other) const { return last_modified != other.last_modified || size != other.size; }
+    };
+
+    struct CachedConfiguration {
+        FileStamp stamp;
+        Configuration configuration;
+    };
+
+    static FileStamp GetFileStamp(const QFileInfo& info);
+
+    std::map<std::string, FileStamp> BuildManifestStamps() const;
+    void RefreshLayers();
+    const Configuration* LoadConfiguration(const std::string& path, std::string& error);
+
+    QJsonObject Override(const std::vector<std::string>& args);
+    QJsonObject Surrender(const std::vector<std::string>& args);
+    QJsonObject List(const std::vector<std::string>& args, bool verbose);
+    QJsonObject Doc(const std::vector<std::string>& args);
+
+    PathManager paths;
+    Environment environment;
+    LayerManager layers;
+
+    std::map<std::string, FileStamp> manifest_stamps;           // Indexed by absolute manifest path
+    std::map<std::string, CachedConfiguration> configurations;  // Indexed by absolute configuration path
+};
@@ -28,12 +28,34 @@
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
-#include <QTextStream>
+#include <QSaveFile>
 
 #include <vulkan/vulkan.h>
 
 #include <cstdio>
 
+// Replace the file content only when it changed. The new content is written to a temporary file which is then renamed, so that
+// the Vulkan Loader of running applications never reads a partially written or a missing file.
+static bool WriteFileIfChanged(const std::string& path, const QByteArray& content) {
+    QFile current_file(path.c_str());
+    if (current_file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        const QByteArray current_content = current_file.readAll();
+        current_file.close();
+
+        if (current_content == content) {
+            return true;
+        }
+    }
+
+    QSaveFile file(path.c_str());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    file.write(content);
+    return file.commit();
+}
+
 // Create and write VkLayer_override.json file
 bool WriteLayersOverride(const Environment& environment, const std::vector<Layer>& available_layers,
                          const Configuration& configuration, const std::string& layers_path) {
@@ -46,6 +68,10 @@ bool WriteLayersOverride(const Environment& environment, const std::vector<Layer
 
     QStringList layer_system_paths;
 
+    // The layer of each overridden parameter is looked up once
+    KeyIndex<Layer> layer_index;
+    layer_index.Rebuild(available_layers);
+
     QStringList layer_override_paths;
     for (std::size_t i = 0, n = configuration.parameters.size(); i < n; ++i) {
         const Parameter& parameter = configuration.parameters[i];
@@ -55,7 +81,7 @@ bool WriteLayersOverride(const Environment& environment, const std::vector<Layer
 
         if (parameter.state != LAYER_STATE_OVERRIDDEN) continue;
 
-        const Layer* layer = FindByKey(available_layers, parameter.key.c_str());
+        const Layer* layer = layer_index.Find(available_layers, parameter.key.c_str());
         if (layer == nullptr) {
             continue;
         }
@@ -156,29 +182,15 @@ bool WriteLayersOverride(const Environment& environment, const std::vector<Layer
     root.insert("layer", layer);
     QJsonDocument doc(root);
 
-    QFile json_file(layers_path.c_str());
-    const bool result_layers_file = json_file.open(QIODevice::WriteOnly | QIODevice::Text);
+    const bool result_layers_file = WriteFileIfChanged(layers_path, doc.toJson());
     assert(result_layers_file);
-    json_file.write(doc.toJson());
-    json_file.close();
 
     return result_layers_file;
 }
 
-// Create and write vk_layer_settings.txt file
-bool WriteSettingsOverride(const std::vector<Layer>& available_layers, const Configuration& configuration,
-                           const std::string& settings_path) {
-    if (settings_path.empty() || !QFileInfo(settings_path.c_str()).absoluteDir().exists()) {
-        fprintf(stderr, "Cannot open file %s\n", settings_path.c_str());
-        exit(1);
-    };
-    QFile file(settings_path.c_str());
-    const bool result_settings_file = file.open(QIODevice::WriteOnly | QIODevice::Text);
-    if (!result_settings_file) {
-        fprintf(stderr, "Cannot open file %s\n", settings_path.c_str());
-        exit(1);
-    }
-    QTextStream stream(&file);
+bool GenerateSettingsOverride(const std::vector<Layer>& available_layers, const Configuration& configuration,
+                              std::vector<LayerSettingsFileLayer>& layers) {
+    layers.clear();
 
     bool has_missing_layers = false;
 
@@ -199,10 +211,11 @@ bool WriteSettingsOverride(const std::vector<Layer>& available_layers, const Con
 
         const bool use_builtin_validation = UseBuiltinValidationSettings(parameter);
 
-        stream << "\n";
-        stream << "# " << layer->key.c_str() << "\n\n";
-
-        std::string lc_layer_name = GetLayerSettingPrefix(layer->key);
+        layers.push_back(LayerSettingsFileLayer());
+        LayerSettingsFileLayer& file_layer = layers.back();
+        file_layer.key = layer->key;
+        file_layer.prefix = GetLayerSettingPrefix(layer->key);
+        file_layer.settings.reserve(parameter.settings.size());
 
         for (std::size_t i = 0, m = parameter.settings.size(); i < m; ++i) {
             const SettingData* setting_data = parameter.settings[i];
@@ -223,7 +236,7 @@ bool WriteSettingsOverride(const std::vector<Layer>& available_layers, const Con
             }
 
             // Skip missing settings
-            const SettingMeta* meta = FindSetting(layer->settings, setting_data->key.c_str());
+            const SettingMeta* meta = layer->FindSetting(setting_data->key.c_str());
             if (meta == nullptr) {
                 continue;
             }
@@ -233,47 +246,97 @@ bool WriteSettingsOverride(const std::vector<Layer>& available_layers, const Con
                 continue;
             }
 
-            stream << "# ";
-            stream << meta->label.c_str();
-            stream << "\n# =====================\n# <LayerIdentifier>.";
-            stream << meta->key.c_str() << "\n";
-
-            // Break up description into smaller words
-            std::string description = meta->description;
-            std::vector<std::string> words;
-            std::size_t pos;
-            while ((pos = description.find(" ")) != std::string::npos) {
-                words.push_back(description.substr(0, pos));
-                description.erase(0, pos + 1);
-            }
-            if (description.size() > 0) words.push_back(description);
-            if (words.size() > 0) {
-                stream << "#";
-                std::size_t nchars = 2;
-                for (auto word : words) {
-                    if (word.size() + nchars > 80) {
-                        stream << "\n#";
-                        nchars = 2;
-                    }
-                    stream << " " << word.c_str();
-                    nchars += (word.size() + 1);
-                }
-            }
-            stream << "\n";
+            LayerSettingsFileSetting file_setting;
+            file_setting.key = setting_data->key;
+            file_setting.value = setting_data->Export(EXPORT_MODE_OVERRIDE);
+            file_setting.label = meta->label;
+            file_setting.description = meta->description;
 
             // If feature has unmet dependency, output it but comment it out
-            if (::CheckDependence(*meta, parameter.settings) != SETTING_DEPENDENCE_ENABLE) {
-                stream << "#";
+            file_setting.commented = ::CheckDependence(*meta, parameter.settings) != SETTING_DEPENDENCE_ENABLE;
+
+            file_layer.settings.push_back(file_setting);
+        }
+    }
+
+    return !has_missing_layers;
+}
+
+// Create and write vk_layer_settings.txt file
+bool WriteSettingsOverride(const std::vector<Layer>& available_layers, const Configuration& configuration,
+                           const std::string& settings_path) {
+    if (settings_path.empty() || !QFileInfo(settings_path.c_str()).absoluteDir().exists()) {
+        fprintf(stderr, "Cannot open file %s\n", settings_path.c_str());
+        return false;
+    }
+
+    std::vector<LayerSettingsFileLayer> layers;
+    const bool has_all_layers = GenerateSettingsOverride(available_layers, configuration, layers);
+
+    // The file is generated in memory first, to be compared with the file on disk
+    const std::string& content = WriteLayerSettingsFile(layers);
+
+    const bool result_settings_file =
+        WriteFileIfChanged(settings_path, QByteArray::fromRawData(content.data(), static_cast<int>(content.size())));
+    if (!result_settings_file) {
+        fprintf(stderr, "Cannot open file %s\n", settings_path.c_str());
+        return false;
+    }
+
+    return result_settings_file && has_all_layers;
+}
+
+std::vector<std::string> CompareSettingsOverride(const std::vector<Layer>& available_layers, const Configuration& configuration,
+                                                 const std::string& settings_path) {
+    std::vector<std::string> differences;
+
+    std::vector<LayerSettingsFileLayer> applied_layers;
+    if (!LoadLayerSettingsFile(settings_path, applied_layers)) {
+        differences.push_back(format("The layers settings file is missing: %s", settings_path.c_str()));
+        return differences;
+    }
+
+    std::vector<LayerSettingsFileLayer> expected_layers;
+    GenerateSettingsOverride(available_layers, configuration, expected_layers);
+
+    // Settings commented out are ignored by the layers
+    for (std::size_t i = 0, n = expected_layers.size(); i < n; ++i) {
+        const LayerSettingsFileLayer& layer = expected_layers[i];
+
+        for (std::size_t j = 0, o = layer.settings.size(); j < o; ++j) {
+            const LayerSettingsFileSetting& expected = layer.settings[j];
+            const LayerSettingsFileSetting* applied = FindLayerSetting(applied_layers, layer.prefix, expected.key);
+
+            const std::string name = layer.prefix + expected.key;
+            const bool is_applied = applied != nullptr && !applied->commented;
+
+            if (expected.commented && is_applied) {
+                differences.push_back(format("%s = %s is applied but its dependences are not met in '%s'", name.c_str(),
+                                             applied->value.c_str(), configuration.key.c_str()));
+            } else if (!expected.commented && !is_applied) {
+                differences.push_back(format("%s = %s is not applied", name.c_str(), expected.value.c_str()));
+            } else if (!expected.commented && applied->value != expected.value) {
+                differences.push_back(format("%s = %s is applied instead of %s", name.c_str(), applied->value.c_str(),
+                                             expected.value.c_str()));
             }
+        }
+    }
 
-            stream << lc_layer_name.c_str() << setting_data->key.c_str() << " = ";
-            stream << setting_data->Export(EXPORT_MODE_OVERRIDE).c_str();
-            stream << "\n\n";
+    for (std::size_t i = 0, n = applied_layers.size(); i < n; ++i) {
+        const LayerSettingsFileLayer& layer = applied_layers[i];
+
+        for (std::size_t j = 0, o = layer.settings.size(); j < o; ++j) {
+            const LayerSettingsFileSetting& applied = layer.settings[j];
+            if (applied.commented) continue;
+
+            if (FindLayerSetting(expected_layers, layer.prefix, applied.key) == nullptr) {
+                differences.push_back(format("%s%s = %s is applied but not part of '%s'", layer.prefix.c_str(),
+                                             applied.key.c_str(), applied.value.c_str(), configuration.key.c_str()));
+            }
         }
     }
-    file.close();
 
-    return result_settings_file && !has_missing_layers;
+    return differences;
 }
 
 bool OverrideConfiguration(const Environment& environment, const std::vector<Layer>& available_layers,
@@ -281,8 +344,8 @@ bool OverrideConfiguration(const Environment& environment, const std::vector<Lay
     const std::string layers_path = GetPath(BUILTIN_PATH_OVERRIDE_LAYERS);
     const std::string settings_path = GetPath(BUILTIN_PATH_OVERRIDE_SETTINGS);
 
-    // Clean up
-    SurrenderConfiguration(environment);
+    // The files are replaced in place and only when their content changed, they are never removed in between so that running
+    // applications don't see the override vanishing.
 
     // VkLayer_override.json
     const bool result_layers = WriteLayersOverride(environment, available_layers, configuration, layers_path);
@@ -23,6 +23,7 @@
 #include "configuration.h"
 #include "environment.h"
 #include "application.h"
+#include "layer_settings_file.h"
 
 // Create the VkLayer_override.json and vk_layer_settings.txt files to take over Vulkan layers from Vulkan applications
 bool OverrideConfiguration(const Environment& environment, const std::vector<Layer>& available_layers,
@@ -37,3 +38,12 @@ bool HasOverride();
 // Write the settings file for override layer
 bool WriteSettingsOverride(const std::vector<Layer>& available_layers,
                            const Configuration& configuration, const std::string& settings_path);
+
+// Generate the settings of the override layer settings file, returns false when some layers of the configuration are missing
+bool GenerateSettingsOverride(const std::vector<Layer>& available_layers, const Configuration& configuration,
+                              std::vector<LayerSettingsFileLayer>& layers);
+
+// Compare the settings applied by the override layer settings file to the settings of the configuration.
+// Returns a description of each difference, empty when the file is up to date.
+std::vector<std::string> CompareSettingsOverride(const std::vector<Layer>& available_layers, const Configuration& configuration,
+                                                 const std::string& settings_path);
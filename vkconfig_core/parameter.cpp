@@ -50,10 +50,9 @@ bool Parameter::ApplyPresetSettings(const LayerPreset& preset) {
     return true;
 }
 
-ParameterRank GetParameterOrdering(const std::vector<Layer>& available_layers, const Parameter& parameter) {
+static ParameterRank GetParameterOrdering(const Layer* layer, const Parameter& parameter) {
     assert(!parameter.key.empty());
 
-    const Layer* layer = FindByKey(available_layers, parameter.key.c_str());
     if (layer == nullptr) {
         return PARAMETER_RANK_MISSING;
     } else if (parameter.state == LAYER_STATE_EXCLUDED) {
@@ -72,6 +71,12 @@ ParameterRank GetParameterOrdering(const std::vector<Layer>& available_layers, c
     }
 }
 
+ParameterRank GetParameterOrdering(const std::vector<Layer>& available_layers, const Parameter& parameter) {
+    assert(!parameter.key.empty());
+
+    return GetParameterOrdering(FindByKey(available_layers, parameter.key.c_str()), parameter);
+}
+
 Version ComputeMinApiVersion(const Version api_version, const std::vector<Parameter>& parameters,
                              const std::vector<Layer>& layers) {
     if (parameters.empty()) return Version::VERSION_NULL;
@@ -82,7 +87,7 @@ Version ComputeMinApiVersion(const Version api_version, const std::vector<Parame
         const Layer* layer = FindByKey(layers, parameters[i].key.c_str());
         if (layer == nullptr) continue;
 
-        const ParameterRank state = GetParameterOrdering(layers, parameters[i]);
+        const ParameterRank state = GetParameterOrdering(layer, parameters[i]);
 
         if (state == PARAMETER_RANK_EXCLUDED) continue;
         if (state == PARAMETER_RANK_MISSING) continue;
@@ -94,12 +99,18 @@ Version ComputeMinApiVersion(const Version api_version, const std::vector<Parame
 }
 
 void OrderParameter(std::vector<Parameter>& parameters, const std::vector<Layer>& layers) {
-    struct ParameterCompare {
-        ParameterCompare(const std::vector<Layer>& layers) : layers(layers) {}
+    // The rank of each parameter is computed once, the comparator must not search the layers
+    struct RankedParameter {
+        ParameterRank rank;
+        Parameter* parameter;
+    };
 
-        bool operator()(const Parameter& a, const Parameter& b) const {
-            const ParameterRank rankA = GetParameterOrdering(layers, a);
-            const ParameterRank rankB = GetParameterOrdering(layers, b);
+    struct ParameterCompare {
+        bool operator()(const RankedParameter& ranked_a, const RankedParameter& ranked_b) const {
+            const ParameterRank rankA = ranked_a.rank;
+            const ParameterRank rankB = ranked_b.rank;
+            const Parameter& a = *ranked_a.parameter;
+            const Parameter& b = *ranked_b.parameter;
             if (rankA == rankB && a.state == LAYER_STATE_OVERRIDDEN) {
                 if (a.overridden_rank != Parameter::NO_RANK && b.overridden_rank != Parameter::NO_RANK)
                     return a.overridden_rank < b.overridden_rank;
@@ -118,11 +129,22 @@ void OrderParameter(std::vector<Parameter>& parameters, const std::vector<Layer>
             else
                 return rankA < rankB;
         }
-
-        const std::vector<Layer>& layers;
     };
 
-    std::sort(parameters.begin(), parameters.end(), ParameterCompare(layers));
+    std::vector<RankedParameter> ranked_parameters(parameters.size());
+    for (std::size_t i = 0, n = parameters.size(); i < n; ++i) {
+        ranked_parameters[i].rank = GetParameterOrdering(FindByKey(layers, parameters[i].key.c_str()), parameters[i]);
+        ranked_parameters[i].parameter = &parameters[i];
+    }
+
+    std::sort(ranked_parameters.begin(), ranked_parameters.end(), ParameterCompare());
+
+    std::vector<Parameter> sorted_parameters;
+    sorted_parameters.reserve(parameters.size());
+    for (std::size_t i = 0, n = ranked_parameters.size(); i < n; ++i) {
+        sorted_parameters.push_back(std::move(*ranked_parameters[i].parameter));
+    }
+    std::swap(parameters, sorted_parameters);
 
     for (std::size_t i = 0, n = parameters.size(); i < n; ++i) {
         if (parameters[i].state == LAYER_STATE_OVERRIDDEN)
@@ -123,7 +123,7 @@ struct SettingMeta : public Header {
     virtual bool Load(const QJsonObject& json_setting) = 0;
     virtual std::string Export(ExportMode export_mode) const = 0;
 
-    const std::string key;
+    const InternedString key;
     const SettingType type;
     std::string env;
     SettingMetaSet children;
@@ -151,7 +151,7 @@ struct SettingData {
 
     virtual bool IsValid() const { return true; };
 
-    const std::string key;
+    const InternedString key;  // Shared with the setting meta
     const SettingType type;
 
    protected:
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2020-2024 Valve Corporation
+ * Copyright (c) 2020-2024 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ * - Christophe Riccio <christophe@lunarg.com>
+ */
+
+#include "string_pool.h"
+
+#include <cassert>
+#include <tuple>
+#include <utility>
+
+StringPool::StringPool() : size(0) {}
+
+StringPool::Entry& StringPool::Intern(const std::string& value) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    const auto result = this->strings.emplace(std::piecewise_construct, std::forward_as_tuple(value), std::forward_as_tuple());
+    Entry& entry = result.first->second;
+    if (result.second) {
+        entry.value = &result.first->first;
+        this->size += value.size();
+    }
+    entry.references.fetch_add(1, std::memory_order_relaxed);
+
+    return entry;
+}
+
+void StringPool::AddReference(Entry& entry) {
+    assert(entry.references.load(std::memory_order_relaxed) > 0);
+    entry.references.fetch_add(1, std::memory_order_relaxed);
+}
+
+void StringPool::Release(Entry& entry) {
+    // The pool is only locked to release the last reference: Intern adds references while holding the lock and the other
+    // references are only added by their owners, so a reference count above one can't drop to zero concurrently
+    std::size_t references = entry.references.load(std::memory_order_relaxed);
+    while (references > 1) {
+        if (entry.references.compare_exchange_weak(references, references - 1, std::memory_order_acq_rel,
+                                                   std::memory_order_relaxed)) {
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    assert(entry.references.load(std::memory_order_relaxed) > 0);
+    if (entry.references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        auto it = this->strings.find(*entry.value);
+        assert(it != this->strings.end() && &it->second == &entry);
+        this->size -= it->first.size();
+        this->strings.erase(it);
+    }
+}
+
+std::size_t StringPool::GetCount() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->strings.size();
+}
+
+std::size_t StringPool::GetSize() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->size;
+}
+
+StringPool& GetStringPool() {
+    // Never destroyed, interned strings may be released by the destructors of other static objects
+    static StringPool* pool = new StringPool;
+    return *pool;
+}
+
+// Default constructed and moved from strings don't access the pool, Header objects are created in large numbers
+static StringPool::Entry* CreateEmptyEntry() {
+    static const std::string empty;
+
+    StringPool::Entry* entry = new StringPool::Entry;  // Never destroyed, like the pool
+    entry->value = &empty;
+    return entry;
+}
+
+static StringPool::Entry* GetEmptyEntry() {
+    static StringPool::Entry* entry = CreateEmptyEntry();
+    return entry;
+}
+
+static StringPool::Entry* InternValue(const std::string& value) {
+    return value.empty() ? GetEmptyEntry() : &GetStringPool().Intern(value);
+}
+
+InternedString::InternedString() : entry(GetEmptyEntry()) {}
+
+InternedString::InternedString(const std::string& value) : entry(InternValue(value)) {}
+
+InternedString::InternedString(const InternedString& other) : entry(other.entry) {
+    if (!this->entry->value->empty()) {
+        StringPool::AddReference(*this->entry);
+    }
+}
+
+InternedString::InternedString(InternedString&& other) noexcept : entry(other.entry) { other.entry = GetEmptyEntry(); }
+
+InternedString::~InternedString() {
+    if (!this->entry->value->empty()) {
+        GetStringPool().Release(*this->entry);
+    }
+}
+
+InternedString& InternedString::operator=(const InternedString& other) {
+    if (this->entry != other.entry) {
+        InternedString copy(other);
+        std::swap(this->entry, copy.entry);
+    }
+    return *this;
+}
+
+InternedString& InternedString::operator=(InternedString&& other) noexcept {
+    // The previous string is released with other
+    std::swap(this->entry, other.entry);
+    return *this;
+}
+
+InternedString& InternedString::operator=(const std::string& value) {
+    InternedString interned(value);
+    std::swap(this->entry, interned.entry);
+    return *this;
+}
+
+bool operator==(const InternedString& a, const std::string& b) { return a.str() == b; }
+
+bool operator==(const std::string& a, const InternedString& b) { return a == b.str(); }
+
+bool operator==(const InternedString& a, const char* b) { return a.str() == b; }
+
+bool operator!=(const InternedString& a, const std::string& b) { return a.str() != b; }
+
+bool operator!=(const std::string& a, const InternedString& b) { return a != b.str(); }
+
+bool operator!=(const InternedString& a, const char* b) { return a.str() != b; }
+
+std::string operator+(const InternedString& a, const InternedString& b) { return a.str() + b.str(); }
+
+std::string operator+(const InternedString& a, const std::string& b) { return a.str() + b; }
+
+std::string operator+(const std::string& a, const InternedString& b) { return a + b.str(); }
+
+std::string operator+(const InternedString& a, const char* b) { return a.str() + b; }
+
+std::string operator+(const char* a, const InternedString& b) { return a + b.str(); }
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2020-2024 Valve Corporation
+ * Copyright (c) 2020-2024 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ * - Christophe Riccio <christophe@lunarg.com>
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <mutex>
+
+// Store each distinct string once. Each string is referenced by the InternedString objects using it and it's removed with its last
+// reference, so the pool shrinks when the layers are unloaded or reloaded. The strings don't move while they are referenced.
+class StringPool {
+   public:
+    // A distinct string and its number of references, stored next to it so that copies don't look the string up
+    struct Entry {
+        Entry() : value(nullptr), references(0) {}
+
+        const std::string* value;
+        std::atomic<std::size_t> references;
+    };
+
+    StringPool();
+
+    Entry& Intern(const std::string& value);  // Add a reference to the string
+    static void AddReference(Entry& entry);   // Only called by the owner of a reference, doesn't lock the pool
+    void Release(Entry& entry);               // Remove a reference, the string is removed with its last reference
+
+    std::size_t GetCount() const;  // Number of distinct strings
+    std::size_t GetSize() const;   // Number of characters of the distinct strings
+
+   private:
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> strings;  // Node based, rehashing doesn't move the strings and their entries
+    std::size_t size;
+};
+
+// Pool of the layer manifests strings: setting keys, labels, descriptions and urls are largely repeated between the versions of
+// a layer and between the reloads of a layer manifest.
+StringPool& GetStringPool();
+
+// Immutable string stored in the layer manifests pool, copying it copies a pointer and counts a reference, moving it only copies
+// a pointer.
+class InternedString {
+   public:
+    InternedString();
+    explicit InternedString(const std::string& value);
+    InternedString(const InternedString& other);
+    InternedString(InternedString&& other) noexcept;
+    ~InternedString();
+
+    InternedString& operator=(const InternedString& other);
+    InternedString& operator=(InternedString&& other) noexcept;
+    InternedString& operator=(const std::string& value);
+
+    operator const std::string&() const { return *this->entry->value; }
+
+    const std::string& str() const { return *this->entry->value; }
+    const char* c_str() const { return this->entry->value->c_str(); }
+    bool empty() const { return this->entry->value->empty(); }
+    std::size_t size() const { return this->entry->value->size(); }
+
+    // Interned strings are equal when they share the same storage
+    bool operator==(const InternedString& other) const { return this->entry == other.entry; }
+    bool operator!=(const InternedString& other) const { return this->entry != other.entry; }
+
+   private:
+    StringPool::Entry* entry;
+};
+
+bool operator==(const InternedString& a, const std::string& b);
+bool operator==(const std::string& a, const InternedString& b);
+bool operator==(const InternedString& a, const char* b);
+bool operator!=(const InternedString& a, const std::string& b);
+bool operator!=(const std::string& a, const InternedString& b);
+bool operator!=(const InternedString& a, const char* b);
+
+std::string operator+(const InternedString& a, const InternedString& b);
+std::string operator+(const InternedString& a, const std::string& b);
+std::string operator+(const std::string& a, const InternedString& b);
+std::string operator+(const InternedString& a, const char* b);
+std::string operator+(const char* a, const InternedString& b);
@@ -164,6 +164,45 @@ TEST(test_command_line, usage_mode_layers_surrender_invalid) {
     EXPECT_TRUE(command_line.layers_configuration_path.empty());
 }
 
+TEST(test_command_line, usage_mode_layers_batch) {
+    static char* argv[] = {"vkconfig", "layers", "--batch"};
+    int argc = static_cast<int>(countof(argv));
+
+    CommandLine command_line(argc, argv);
+
+    EXPECT_EQ(ERROR_NONE, command_line.error);
+    EXPECT_TRUE(command_line.error_args.empty());
+    EXPECT_EQ(COMMAND_LAYERS, command_line.command);
+    EXPECT_EQ(COMMAND_LAYERS_BATCH, command_line.command_layers_arg);
+    EXPECT_TRUE(command_line.layers_server_name.empty());
+}
+
+TEST(test_command_line, usage_mode_layers_server) {
+    static char* argv[] = {"vkconfig", "layers", "--server", "vkconfig_test"};
+    int argc = static_cast<int>(countof(argv));
+
+    CommandLine command_line(argc, argv);
+
+    EXPECT_EQ(ERROR_NONE, command_line.error);
+    EXPECT_TRUE(command_line.error_args.empty());
+    EXPECT_EQ(COMMAND_LAYERS, command_line.command);
+    EXPECT_EQ(COMMAND_LAYERS_SERVER, command_line.command_layers_arg);
+    EXPECT_STREQ("vkconfig_test", command_line.layers_server_name.c_str());
+}
+
+TEST(test_command_line, usage_mode_layers_server_invalid) {
+    static char* argv[] = {"vkconfig", "layers", "--server"};
+    int argc = static_cast<int>(countof(argv));
+
+    CommandLine command_line(argc, argv);
+
+    EXPECT_EQ(ERROR_MISSING_COMMAND_ARGUMENT, command_line.error);
+    EXPECT_EQ(1, command_line.error_args.size());
+    EXPECT_EQ(COMMAND_LAYERS, command_line.command);
+    EXPECT_EQ(COMMAND_LAYERS_SERVER, command_line.command_layers_arg);
+    EXPECT_TRUE(command_line.layers_server_name.empty());
+}
+
 TEST(test_command_line, usage_mode_layers_override) {
     static char* argv[] = {"vkconfig", "layers", "--override", ":/Configuration 2.2.2.json"};
     int argc = static_cast<int>(countof(argv));
@@ -208,3 +247,40 @@ TEST(test_command_line, usage_mode_layers_override_invalid_args) {
 #elif VKC_PLATFORM == VKC_PLATFORM_MACOS
 #pragma clang diagnostic pop
 #endif
+
+TEST(test_command_line, usage_mode_doc_all) {
+    static char* argv[] = {"vkconfig", "doc", "--all", "./doc"};
+    int argc = static_cast<int>(countof(argv));
+
+    CommandLine command_line(argc, argv);
+
+    EXPECT_EQ(ERROR_NONE, command_line.error);
+    EXPECT_TRUE(command_line.error_args.empty());
+    EXPECT_EQ(COMMAND_DOC, command_line.command);
+    EXPECT_EQ(COMMAND_DOC_ALL, command_line.command_doc_arg);
+    EXPECT_TRUE(command_line.doc_layer_name.empty());
+    EXPECT_STREQ("./doc", command_line.doc_out_dir.c_str());
+}
+
+TEST(test_command_line, usage_mode_doc_all_default_dir) {
+    static char* argv[] = {"vkconfig", "doc", "--all"};
+    int argc = static_cast<int>(countof(argv));
+
+    CommandLine command_line(argc, argv);
+
+    EXPECT_EQ(ERROR_NONE, command_line.error);
+    EXPECT_EQ(COMMAND_DOC_ALL, command_line.command_doc_arg);
+    EXPECT_STREQ(".", command_line.doc_out_dir.c_str());
+}
+
+TEST(test_command_line, usage_mode_doc_all_invalid_args) {
+    static char* argv[] = {"vkconfig", "doc", "--all", "./doc", "bla"};
+    int argc = static_cast<int>(countof(argv));
+
+    CommandLine command_line(argc, argv);
+
+    EXPECT_EQ(ERROR_TOO_MANY_COMMAND_ARGUMENTS, command_line.error);
+    EXPECT_EQ(1, command_line.error_args.size());
+    EXPECT_EQ(COMMAND_DOC, command_line.command);
+    EXPECT_EQ(COMMAND_DOC_ALL, command_line.command_doc_arg);
+}
@@ -19,6 +19,9 @@
  */
 
 #include "../configuration_manager.h"
+#include "../layer_manager.h"
+#include "../setting_bool.h"
+#include "../path.h"
 
 #include <gtest/gtest.h>
 
@@ -72,3 +75,84 @@ TEST(test_configuration_manager, create_remove) {
 
     environment.Reset(Environment::SYSTEM);  // Don't change the system settings on exit
 }
+
+TEST(test_configuration_manager, save_dirty) {
+    PathManager path_manager("", SUPPORTED_CONFIG_FILES);
+    Environment environment(path_manager);
+    environment.Reset(Environment::DEFAULT);
+
+    std::vector<Layer> available_layers;
+
+    ConfigurationManager configuration_manager(environment);
+
+    Configuration &configuration = configuration_manager.CreateConfiguration(available_layers, "Configuration Dirty");
+    const std::string key = configuration.key;
+    const std::string path = GetPath(BUILTIN_PATH_CONFIG_LAST) + "/" + key + ".json";
+    EXPECT_EQ(false, configuration.dirty);
+
+    // Clean configurations are not saved
+    configuration.description = "Description A";
+    configuration_manager.SaveAllConfigurations(available_layers);
+
+    Configuration configuration_loaded_a;
+    EXPECT_EQ(true, configuration_loaded_a.Load(available_layers, path));
+    EXPECT_STRNE("Description A", configuration_loaded_a.description.c_str());
+
+    // Dirty configurations are saved
+    configuration_manager.SetDirty(key);
+    EXPECT_EQ(true, configuration.dirty);
+    configuration_manager.SaveAllConfigurations(available_layers);
+    EXPECT_EQ(false, configuration.dirty);
+
+    Configuration configuration_loaded_b;
+    EXPECT_EQ(true, configuration_loaded_b.Load(available_layers, path));
+    EXPECT_STREQ("Description A", configuration_loaded_b.description.c_str());
+
+    configuration_manager.RemoveConfiguration(available_layers, key);
+    EXPECT_EQ(true, configuration_manager.Empty());
+
+    environment.Reset(Environment::SYSTEM);  // Don't change the system settings on exit
+}
+
+TEST(test_configuration_manager, update_layer_settings) {
+    PathManager path_manager("", SUPPORTED_CONFIG_FILES);
+    Environment environment(path_manager);
+    environment.Reset(Environment::DEFAULT);
+
+    LayerManager layer_manager(environment);
+    layer_manager.LoadLayersFromPath(":/");
+
+    const Layer *layer = layer_manager.FindLayer("VK_LAYER_LUNARG_reference_1_2_1");
+    ASSERT_TRUE(layer != nullptr);
+
+    Parameter parameter("VK_LAYER_LUNARG_reference_1_2_1", LAYER_STATE_OVERRIDDEN);
+    CollectDefaultSettingData(layer->settings, parameter.settings);
+    SettingDataBool *setting = FindSetting<SettingDataBool>(parameter.settings, "bool_required_only");
+    ASSERT_TRUE(setting != nullptr);
+    setting->value = false;
+
+    Configuration configuration;
+    configuration.key = "Configuration Layer Update";
+    configuration.parameters.push_back(parameter);
+
+    ConfigurationManager configuration_manager(environment);
+    configuration_manager.available_configurations.push_back(configuration);
+
+    // The previous layers own the settings of the configuration until they are moved to the reloaded layer
+    const std::vector<Layer> previous_layers = layer_manager.available_layers;
+    const std::vector<std::string> &updated = layer_manager.UpdateLayerFromFile(":/VK_LAYER_LUNARG_reference_1_2_1.json");
+    ASSERT_EQ(1, updated.size());
+
+    EXPECT_TRUE(configuration_manager.UpdateLayerSettings(layer_manager.available_layers, updated));
+    EXPECT_FALSE(configuration_manager.UpdateLayerSettings(layer_manager.available_layers, {"VK_LAYER_LUNARG_not_used"}));
+
+    // The value edited by the user is kept, without saving and reloading the configuration
+    const SettingDataSet &updated_settings = configuration_manager.available_configurations[0].parameters[0].settings;
+    const SettingDataBool *updated_setting = FindSetting<SettingDataBool>(updated_settings, "bool_required_only");
+    ASSERT_TRUE(updated_setting != nullptr);
+    EXPECT_NE(setting, updated_setting);
+    EXPECT_EQ(false, updated_setting->value);
+    EXPECT_EQ(parameter.settings.size(), updated_settings.size());
+
+    environment.Reset(Environment::SYSTEM);  // Don't change the system settings on exit
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2020-2024 Valve Corporation
+ * Copyright (c) 2020-2024 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ * - Christophe Riccio <christophe@lunarg.com>
+ */
+
+#include "../doc.h"
+#include "../layer_manager.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include <gtest/gtest.h>
+
+static const std::vector<std::string> SUPPORTED_CONFIG_FILES = {"_1_0_0"};
+
+TEST(test_doc, export_all) {
+    PathManager paths("", SUPPORTED_CONFIG_FILES);
+    Environment environment(paths);
+    environment.Reset(Environment::DEFAULT);
+
+    LayerManager layer_manager(environment);
+    layer_manager.LoadLayersFromPath(":/");
+    ASSERT_FALSE(layer_manager.available_layers.empty());
+
+    const QString output_dir = QDir::tempPath() + "/vkconfig_test_doc_export_all";
+    QDir(output_dir).removeRecursively();
+
+    const std::vector<std::string>& failed_files = ExportAllDoc(layer_manager.available_layers, output_dir.toStdString());
+    EXPECT_TRUE(failed_files.empty());
+
+    for (std::size_t i = 0, n = layer_manager.available_layers.size(); i < n; ++i) {
+        const QString key = layer_manager.available_layers[i].key.c_str();
+        EXPECT_TRUE(QFileInfo(output_dir + "/" + key + ".html").exists());
+        EXPECT_TRUE(QFileInfo(output_dir + "/" + key + ".md").exists());
+        EXPECT_TRUE(QFileInfo(output_dir + "/" + key + "_vk_layer_settings.txt").exists());
+    }
+
+    QFile file(output_dir + "/layers_settings.json");
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly | QIODevice::Text));
+
+    QJsonParseError json_parse_error;
+    const QJsonDocument& json_document = QJsonDocument::fromJson(file.readAll(), &json_parse_error);
+    ASSERT_EQ(QJsonParseError::NoError, json_parse_error.error);
+
+    const QJsonArray& json_layers = json_document.object().value("layers").toArray();
+    ASSERT_EQ(layer_manager.available_layers.size(), json_layers.size());
+    for (int i = 0, n = json_layers.size(); i < n; ++i) {
+        EXPECT_STREQ(layer_manager.available_layers[i].key.c_str(),
+                     json_layers[i].toObject().value("key").toString().toStdString().c_str());
+    }
+
+    QDir(output_dir).removeRecursively();
+
+    environment.Reset(Environment::SYSTEM);  // Don't change the system settings on exit
+}
+
+TEST(test_doc, export_all_failed_file) {
+    PathManager paths("", SUPPORTED_CONFIG_FILES);
+    Environment environment(paths);
+    environment.Reset(Environment::DEFAULT);
+
+    LayerManager layer_manager(environment);
+    layer_manager.LoadLayersFromPath(":/");
+    ASSERT_FALSE(layer_manager.available_layers.empty());
+
+    const QString output_dir = QDir::tempPath() + "/vkconfig_test_doc_export_all_failed_file";
+    QDir(output_dir).removeRecursively();
+
+    // A directory in place of the layer settings file of the first layer, the file can't be written
+    const std::string& settings_path =
+        output_dir.toStdString() + "/" + layer_manager.available_layers[0].key + "_vk_layer_settings.txt";
+    ASSERT_TRUE(QDir().mkpath(settings_path.c_str()));
+
+    // The failure is reported and the documentation of the other layers is still generated
+    const std::vector<std::string>& failed_files = ExportAllDoc(layer_manager.available_layers, output_dir.toStdString());
+    ASSERT_EQ(1, failed_files.size());
+    EXPECT_STREQ(settings_path.c_str(), failed_files[0].c_str());
+
+    for (std::size_t i = 1, n = layer_manager.available_layers.size(); i < n; ++i) {
+        const QString key = layer_manager.available_layers[i].key.c_str();
+        EXPECT_TRUE(QFileInfo(output_dir + "/" + key + "_vk_layer_settings.txt").isFile());
+    }
+    EXPECT_TRUE(QFileInfo(output_dir + "/layers_settings.json").exists());
+
+    QDir(output_dir).removeRecursively();
+
+    environment.Reset(Environment::SYSTEM);  // Don't change the system settings on exit
+}
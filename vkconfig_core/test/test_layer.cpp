@@ -56,6 +56,30 @@ TEST(test_layer, collect_settings) {
     EXPECT_STREQ("value0", data_string->value.c_str());
 }
 
+TEST(test_layer, find_setting) {
+    Layer layer;
+
+    SettingMetaString* meta0 = InstantiateString(layer, "key0");
+    SettingMetaString* meta1 = static_cast<SettingMetaString*>(layer.Instantiate(meta0->children, "key1", SETTING_STRING));
+
+    EXPECT_EQ(meta0, layer.FindSetting("key0"));
+    EXPECT_EQ(meta1, layer.FindSetting("key1"));
+    EXPECT_EQ(nullptr, layer.FindSetting("key2"));
+
+    EXPECT_EQ(FindSetting(layer.settings, "key1"), layer.FindSetting("key1"));
+}
+
+TEST(test_layer, load_setting_find) {
+    Layer layer;
+    const bool load_loaded = layer.Load(std::vector<Layer>(), ":/VK_LAYER_LUNARG_test_06.json", LAYER_TYPE_EXPLICIT);
+    ASSERT_TRUE(load_loaded);
+
+    for (std::size_t i = 0, n = layer.settings.size(); i < n; ++i) {
+        const char* key = layer.settings[i]->key.c_str();
+        EXPECT_EQ(FindSetting(layer.settings, key), layer.FindSetting(key));
+    }
+}
+
 TEST(test_layer, load_header_overridden) {
     Layer layer;
     const bool load_loaded = layer.Load(std::vector<Layer>(), ":/VK_LAYER_LUNARG_test_00.json", LAYER_TYPE_EXPLICIT);
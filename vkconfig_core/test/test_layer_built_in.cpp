@@ -278,3 +278,34 @@ TEST(test_layer_built_in, layer_170_screenshot) {
     EXPECT_EQ(3, CountSettings(layer.settings));
     EXPECT_EQ(0, layer.presets.size());
 }
+
+// Layers manifests strings
+
+TEST(test_layer_built_in, layer_strings_shared) {
+    Layer layer_162;
+    EXPECT_TRUE(layer_162.Load(std::vector<Layer>(), ":/layers/162/VK_LAYER_KHRONOS_validation.json", LAYER_TYPE_EXPLICIT));
+    Layer layer_170;
+    EXPECT_TRUE(layer_170.Load(std::vector<Layer>(), ":/layers/170/VK_LAYER_KHRONOS_validation.json", LAYER_TYPE_EXPLICIT));
+
+    const SettingMeta* setting_162 = layer_162.FindSetting("log_filename");
+    const SettingMeta* setting_170 = layer_170.FindSetting("log_filename");
+    ASSERT_TRUE(setting_162 != nullptr);
+    ASSERT_TRUE(setting_170 != nullptr);
+    EXPECT_NE(setting_162, setting_170);
+
+    // Identical strings from the two manifests are stored once
+    EXPECT_EQ(setting_162->key.c_str(), setting_170->key.c_str());
+    EXPECT_EQ(setting_162->label.c_str(), setting_170->label.c_str());
+    EXPECT_EQ(setting_162->description.c_str(), setting_170->description.c_str());
+}
+
+TEST(test_layer_built_in, layer_copy_shared) {
+    Layer layer;
+    EXPECT_TRUE(layer.Load(std::vector<Layer>(), ":/layers/170/VK_LAYER_KHRONOS_validation.json", LAYER_TYPE_EXPLICIT));
+
+    const Layer layer_copy(layer);
+    EXPECT_EQ(layer.FindSetting("log_filename"), layer_copy.FindSetting("log_filename"));
+
+    SettingData* data = layer.FindSetting("log_filename")->Instantiate();
+    EXPECT_EQ(layer.FindSetting("log_filename")->key.c_str(), data->key.c_str());
+}
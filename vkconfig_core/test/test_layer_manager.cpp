@@ -20,6 +20,9 @@
 
 #include "../layer_manager.h"
 
+#include <QDir>
+#include <QFile>
+
 #include <gtest/gtest.h>
 
 static const std::vector<std::string> SUPPORTED_CONFIG_FILES = {"_1_0_0"};
@@ -36,3 +39,81 @@ TEST(test_layer_manager, load_only_layer_json) {
 
     environment.Reset(Environment::SYSTEM);  // Don't change the system settings on exit
 }
+
+TEST(test_layer_manager, find_layer) {
+    PathManager paths("", SUPPORTED_CONFIG_FILES);
+    Environment environment(paths);
+    environment.Reset(Environment::DEFAULT);
+
+    LayerManager layer_manager(environment);
+    layer_manager.LoadLayersFromPath(":/");
+
+    for (std::size_t i = 0, n = layer_manager.available_layers.size(); i < n; ++i) {
+        const Layer& layer = layer_manager.available_layers[i];
+        EXPECT_EQ(&layer, layer_manager.FindLayer(layer.key));
+    }
+
+    EXPECT_EQ(nullptr, layer_manager.FindLayer("VK_LAYER_LUNARG_not_found"));
+
+    layer_manager.Clear();
+    EXPECT_EQ(nullptr, layer_manager.FindLayer("VK_LAYER_LUNARG_reference_1_2_1"));
+
+    environment.Reset(Environment::SYSTEM);  // Don't change the system settings on exit
+}
+
+TEST(test_layer_manager, update_layer_from_file) {
+    PathManager paths("", SUPPORTED_CONFIG_FILES);
+    Environment environment(paths);
+    environment.Reset(Environment::DEFAULT);
+
+    LayerManager layer_manager(environment);
+    layer_manager.LoadLayersFromPath(":/");
+
+    const std::size_t count = layer_manager.available_layers.size();
+    const std::size_t position = layer_manager.FindLayer("VK_LAYER_LUNARG_reference_1_2_1") - &layer_manager.available_layers[0];
+
+    // Modified manifest: the layer is reloaded at the same position
+    std::vector<std::string> updated = layer_manager.UpdateLayerFromFile(":/VK_LAYER_LUNARG_reference_1_2_1.json");
+    ASSERT_EQ(1, updated.size());
+    EXPECT_STREQ("VK_LAYER_LUNARG_reference_1_2_1", updated[0].c_str());
+    EXPECT_EQ(count, layer_manager.available_layers.size());
+    EXPECT_STREQ("VK_LAYER_LUNARG_reference_1_2_1", layer_manager.available_layers[position].key.c_str());
+    EXPECT_EQ(&layer_manager.available_layers[position], layer_manager.FindLayer("VK_LAYER_LUNARG_reference_1_2_1"));
+
+    // Not a manifest of a known layer and not a layer manifest
+    EXPECT_TRUE(layer_manager.UpdateLayerFromFile(":/override_settings_2_2_2_schema_1_2_1.txt").empty());
+    EXPECT_EQ(count, layer_manager.available_layers.size());
+
+    environment.Reset(Environment::SYSTEM);  // Don't change the system settings on exit
+}
+
+TEST(test_layer_manager, update_layer_from_file_added_removed) {
+    PathManager paths("", SUPPORTED_CONFIG_FILES);
+    Environment environment(paths);
+    environment.Reset(Environment::DEFAULT);
+
+    const QString path = QDir::tempPath() + "/vkconfig_test_update_layer_from_file.json";
+    QFile::remove(path);
+
+    LayerManager layer_manager(environment);
+    EXPECT_TRUE(layer_manager.UpdateLayerFromFile(path.toStdString()).empty());
+
+    // Added manifest
+    ASSERT_TRUE(QFile::copy(":/VK_LAYER_LUNARG_test_00.json", path));
+    QFile::setPermissions(path, QFile::ReadOwner | QFile::WriteOwner);
+
+    std::vector<std::string> added = layer_manager.UpdateLayerFromFile(path.toStdString());
+    ASSERT_EQ(1, added.size());
+    EXPECT_EQ(1, layer_manager.available_layers.size());
+    EXPECT_TRUE(layer_manager.FindLayer(added[0]) != nullptr);
+
+    // Removed manifest
+    ASSERT_TRUE(QFile::remove(path));
+
+    std::vector<std::string> removed = layer_manager.UpdateLayerFromFile(path.toStdString());
+    EXPECT_EQ(added, removed);
+    EXPECT_TRUE(layer_manager.available_layers.empty());
+    EXPECT_EQ(nullptr, layer_manager.FindLayer(added[0]));
+
+    environment.Reset(Environment::SYSTEM);  // Don't change the system settings on exit
+}
@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2020-2024 Valve Corporation
+ * Copyright (c) 2020-2024 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ * - Christophe Riccio <christophe@lunarg.com>
+ */
+
+#include "../layer_settings_file.h"
+
+#include <QFile>
+
+#include <cstring>
+#include <random>
+
+#include <gtest/gtest.h>
+
+static std::string GenerateString(std::mt19937& generator, const char* alphabet, std::size_t min_size, std::size_t max_size) {
+    const std::size_t alphabet_size = std::strlen(alphabet);
+    const std::size_t size = std::uniform_int_distribution<std::size_t>(min_size, max_size)(generator);
+
+    std::string result;
+    for (std::size_t i = 0; i < size; ++i) {
+        result += alphabet[std::uniform_int_distribution<std::size_t>(0, alphabet_size - 1)(generator)];
+    }
+    return result;
+}
+
+// Descriptions are written as words separated by single spaces, a trailing space is not preserved
+static std::string GenerateDescription(std::mt19937& generator) {
+    std::string result = GenerateString(generator, "abcdefgh ,.:;=#()'\"ABC ", 0, 400);
+    while (!result.empty() && result.back() == ' ') {
+        result.pop_back();
+    }
+    return result;
+}
+
+// Values are trimmed by the parser, like the layers do
+static std::string GenerateValue(std::mt19937& generator) {
+    std::string result = GenerateString(generator, "abcXYZ019_ ,.:;=#/\\", 0, 40);
+    while (!result.empty() && result.back() == ' ') {
+        result.pop_back();
+    }
+    while (!result.empty() && result.front() == ' ') {
+        result.erase(0, 1);
+    }
+    return result;
+}
+
+static std::vector<LayerSettingsFileLayer> GenerateLayers(std::mt19937& generator) {
+    std::vector<LayerSettingsFileLayer> layers;
+
+    const std::size_t layer_count = std::uniform_int_distribution<std::size_t>(0, 5)(generator);
+    for (std::size_t i = 0; i < layer_count; ++i) {
+        LayerSettingsFileLayer layer;
+        layer.key = "VK_LAYER_" + GenerateString(generator, "ABCDEFGHIJKLMNOPQRSTUVWXYZ_", 1, 24) + std::to_string(i);
+        layer.prefix = GenerateString(generator, "abcdefghijklmnopqrstuvwxyz_", 1, 24) + std::to_string(i) + ".";
+
+        const std::size_t setting_count = std::uniform_int_distribution<std::size_t>(1, 20)(generator);
+        for (std::size_t j = 0; j < setting_count; ++j) {
+            LayerSettingsFileSetting setting;
+            setting.key = GenerateString(generator, "abcdefghijklmnopqrstuvwxyz_0123456789", 1, 32);
+            setting.label = GenerateString(generator, "abcdefgh ABC()=.#", 0, 40);
+            setting.description = GenerateDescription(generator);
+            setting.value = GenerateValue(generator);
+            setting.commented = std::uniform_int_distribution<int>(0, 3)(generator) == 0;
+            layer.settings.push_back(setting);
+        }
+
+        layers.push_back(layer);
+    }
+
+    return layers;
+}
+
+static void ExpectEqual(const std::vector<LayerSettingsFileLayer>& a, const std::vector<LayerSettingsFileLayer>& b) {
+    ASSERT_EQ(a.size(), b.size());
+
+    for (std::size_t i = 0, n = a.size(); i < n; ++i) {
+        EXPECT_STREQ(a[i].key.c_str(), b[i].key.c_str());
+        EXPECT_STREQ(a[i].prefix.c_str(), b[i].prefix.c_str());
+        ASSERT_EQ(a[i].settings.size(), b[i].settings.size());
+
+        for (std::size_t j = 0, o = a[i].settings.size(); j < o; ++j) {
+            EXPECT_STREQ(a[i].settings[j].key.c_str(), b[i].settings[j].key.c_str());
+            EXPECT_STREQ(a[i].settings[j].value.c_str(), b[i].settings[j].value.c_str());
+            EXPECT_STREQ(a[i].settings[j].label.c_str(), b[i].settings[j].label.c_str());
+            EXPECT_STREQ(a[i].settings[j].description.c_str(), b[i].settings[j].description.c_str());
+            EXPECT_EQ(a[i].settings[j].commented, b[i].settings[j].commented);
+        }
+    }
+}
+
+TEST(test_layer_settings_file, write) {
+    LayerSettingsFileSetting setting;
+    setting.key = "debug_action";
+    setting.value = "VK_DBG_LAYER_ACTION_LOG_MSG";
+    setting.label = "Debug Action";
+    setting.description = "This indicates what action is to be taken when a layer wants to report information";
+
+    LayerSettingsFileLayer layer;
+    layer.key = "VK_LAYER_KHRONOS_validation";
+    layer.prefix = "khronos_validation.";
+    layer.settings.push_back(setting);
+
+    setting.key = "log_filename";
+    setting.value = "stdout";
+    setting.label = "Log Filename";
+    setting.description = "";
+    setting.commented = true;
+    layer.settings.push_back(setting);
+
+    const std::string& content = WriteLayerSettingsFile(std::vector<LayerSettingsFileLayer>(1, layer));
+
+    EXPECT_STREQ(
+        "\n# VK_LAYER_KHRONOS_validation\n\n"
+        "# Debug Action\n# =====================\n# <LayerIdentifier>.debug_action\n"
+        "# This indicates what action is to be taken when a layer wants to report\n# information\n"
+        "khronos_validation.debug_action = VK_DBG_LAYER_ACTION_LOG_MSG\n\n"
+        "# Log Filename\n# =====================\n# <LayerIdentifier>.log_filename\n\n"
+        "#khronos_validation.log_filename = stdout\n\n",
+        content.c_str());
+}
+
+TEST(test_layer_settings_file, parse) {
+    const char* content =
+        "# Comment\r\n"
+        "khronos_validation.debug_action = VK_DBG_LAYER_ACTION_LOG_MSG\r\n"
+        "  khronos_validation.report_flags=error,warn  \r\n"
+        "#khronos_validation.log_filename = stdout\r\n"
+        "lunarg_api_dump.output_format = html\r\n"
+        "not a setting\r\n";
+
+    const std::vector<LayerSettingsFileLayer>& layers = ParseLayerSettingsFile(content, std::strlen(content));
+    ASSERT_EQ(2, layers.size());
+
+    EXPECT_STREQ("", layers[0].key.c_str());
+    EXPECT_STREQ("khronos_validation.", layers[0].prefix.c_str());
+    ASSERT_EQ(3, layers[0].settings.size());
+    EXPECT_STREQ("debug_action", layers[0].settings[0].key.c_str());
+    EXPECT_STREQ("VK_DBG_LAYER_ACTION_LOG_MSG", layers[0].settings[0].value.c_str());
+    EXPECT_STREQ("report_flags", layers[0].settings[1].key.c_str());
+    EXPECT_STREQ("error,warn", layers[0].settings[1].value.c_str());
+    EXPECT_FALSE(layers[0].settings[1].commented);
+    EXPECT_STREQ("log_filename", layers[0].settings[2].key.c_str());
+    EXPECT_TRUE(layers[0].settings[2].commented);
+
+    EXPECT_STREQ("lunarg_api_dump.", layers[1].prefix.c_str());
+    ASSERT_EQ(1, layers[1].settings.size());
+
+    const LayerSettingsFileSetting* setting = FindLayerSetting(layers, "lunarg_api_dump.", "output_format");
+    ASSERT_TRUE(setting != nullptr);
+    EXPECT_STREQ("html", setting->value.c_str());
+    EXPECT_EQ(nullptr, FindLayerSetting(layers, "lunarg_api_dump.", "debug_action"));
+}
+
+TEST(test_layer_settings_file, parse_empty) {
+    EXPECT_TRUE(ParseLayerSettingsFile("", 0).empty());
+    EXPECT_TRUE(ParseLayerSettingsFile("\n\n# Comment\n", std::strlen("\n\n# Comment\n")).empty());
+    EXPECT_TRUE(ParseLayerSettingsFile("# Comment\n\n", std::strlen("# Comment\n\n")).size() == 1);
+}
+
+TEST(test_layer_settings_file, round_trip_reference) {
+    QFile file(":/override_settings_2_2_2_schema_1_2_1.txt");
+    const bool result = file.open(QFile::ReadOnly);
+    ASSERT_TRUE(result);
+    QByteArray content = file.readAll();
+    file.close();
+
+    content.replace("\r\n", "\n");  // Using UNIX EOL
+
+    const std::vector<LayerSettingsFileLayer>& layers = ParseLayerSettingsFile(content.constData(), content.size());
+    ASSERT_EQ(1, layers.size());
+    EXPECT_STREQ("VK_LAYER_LUNARG_reference_1_2_1", layers[0].key.c_str());
+    EXPECT_STREQ("lunarg_reference_1_2_1.", layers[0].prefix.c_str());
+    EXPECT_FALSE(layers[0].settings.empty());
+
+    EXPECT_STREQ(content.constData(), WriteLayerSettingsFile(layers).c_str());
+}
+
+TEST(test_layer_settings_file, round_trip_fuzz) {
+    std::mt19937 generator(20240101);
+
+    for (int i = 0; i < 500; ++i) {
+        const std::vector<LayerSettingsFileLayer>& layers = GenerateLayers(generator);
+        const std::string& content = WriteLayerSettingsFile(layers);
+
+        const std::vector<LayerSettingsFileLayer>& parsed_layers = ParseLayerSettingsFile(content.data(), content.size());
+        ExpectEqual(layers, parsed_layers);
+        EXPECT_STREQ(content.c_str(), WriteLayerSettingsFile(parsed_layers).c_str());
+
+        if (::testing::Test::HasFailure()) {
+            break;
+        }
+    }
+}
+
+TEST(test_layer_settings_file, parse_truncated_fuzz) {
+    std::mt19937 generator(20240102);
+
+    for (int i = 0; i < 100; ++i) {
+        const std::string& content = WriteLayerSettingsFile(GenerateLayers(generator));
+
+        // Parsing any prefix of a valid file, or a file with random bytes, must not crash
+        const std::size_t size = std::uniform_int_distribution<std::size_t>(0, content.size())(generator);
+        ParseLayerSettingsFile(content.data(), size);
+
+        std::string noise = content;
+        for (std::size_t j = 0, n = noise.size() / 16; j < n; ++j) {
+            noise[std::uniform_int_distribution<std::size_t>(0, noise.size() - 1)(generator)] =
+                static_cast<char>(std::uniform_int_distribution<int>(0, 255)(generator));
+        }
+        ParseLayerSettingsFile(noise.data(), noise.size());
+    }
+}
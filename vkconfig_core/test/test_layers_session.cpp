@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2020-2024 Valve Corporation
+ * Copyright (c) 2020-2024 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ * - Christophe Riccio <christophe@lunarg.com>
+ */
+
+#include "../layers_session.h"
+
+#include <QJsonArray>
+#include <QFile>
+
+#include <gtest/gtest.h>
+
+static const std::vector<std::string> SUPPORTED_CONFIG_FILES = {"_1_0_0"};
+
+static std::string GetResult(const QJsonObject& reply) { return reply.value("result").toString().toStdString(); }
+
+TEST(test_layers_session, split_command) {
+    EXPECT_TRUE(SplitCommand("").empty());
+    EXPECT_TRUE(SplitCommand(" \t\r\n").empty());
+
+    const std::vector<std::string>& list = SplitCommand("list\n");
+    ASSERT_EQ(1, list.size());
+    EXPECT_STREQ("list", list[0].c_str());
+
+    const std::vector<std::string>& doc = SplitCommand("  doc   settings\tVK_LAYER_LUNARG_test  ");
+    ASSERT_EQ(3, doc.size());
+    EXPECT_STREQ("doc", doc[0].c_str());
+    EXPECT_STREQ("settings", doc[1].c_str());
+    EXPECT_STREQ("VK_LAYER_LUNARG_test", doc[2].c_str());
+
+    const std::vector<std::string>& quoted = SplitCommand("override \"My Configurations/Validation.json\" \"\"");
+    ASSERT_EQ(3, quoted.size());
+    EXPECT_STREQ("override", quoted[0].c_str());
+    EXPECT_STREQ("My Configurations/Validation.json", quoted[1].c_str());
+    EXPECT_STREQ("", quoted[2].c_str());
+}
+
+TEST(test_layers_session, execute_invalid) {
+    LayersSession session("", SUPPORTED_CONFIG_FILES);
+
+    bool quit = false;
+
+    const QJsonObject& empty = session.Execute("", quit);
+    EXPECT_STREQ("failure", GetResult(empty).c_str());
+    EXPECT_FALSE(quit);
+
+    const QJsonObject& unknown = session.Execute("unknown", quit);
+    EXPECT_STREQ("failure", GetResult(unknown).c_str());
+    EXPECT_STREQ("unknown", unknown.value("command").toString().toStdString().c_str());
+    EXPECT_STREQ("Unknown command: 'unknown'", unknown.value("message").toString().toStdString().c_str());
+    EXPECT_FALSE(quit);
+
+    EXPECT_STREQ("failure", GetResult(session.Execute("list extra", quit)).c_str());
+    EXPECT_STREQ("failure", GetResult(session.Execute("surrender extra", quit)).c_str());
+    EXPECT_STREQ("failure", GetResult(session.Execute("override", quit)).c_str());
+    EXPECT_STREQ("failure", GetResult(session.Execute("override ./missing_configuration.json", quit)).c_str());
+    EXPECT_STREQ("failure", GetResult(session.Execute("doc", quit)).c_str());
+    EXPECT_STREQ("failure", GetResult(session.Execute("doc pdf VK_LAYER_LUNARG_test", quit)).c_str());
+    EXPECT_STREQ("failure", GetResult(session.Execute("doc html VK_LAYER_LUNARG_not_found", quit)).c_str());
+    EXPECT_FALSE(quit);
+}
+
+TEST(test_layers_session, execute_quit) {
+    LayersSession session("", SUPPORTED_CONFIG_FILES);
+
+    bool quit = false;
+    const QJsonObject& reply = session.Execute("quit", quit);
+    EXPECT_STREQ("success", GetResult(reply).c_str());
+    EXPECT_TRUE(reply.contains("elapsed_ms"));
+    EXPECT_TRUE(quit);
+
+    quit = false;
+    EXPECT_STREQ("success", GetResult(session.Execute("exit\r\n", quit)).c_str());
+    EXPECT_TRUE(quit);
+}
+
+TEST(test_layers_session, execute_list) {
+    qputenv("VK_LAYER_PATH", ":/");
+
+    LayersSession session("", SUPPORTED_CONFIG_FILES);
+
+    bool quit = false;
+
+    const QJsonObject& list = session.Execute("list", quit);
+    EXPECT_STREQ("success", GetResult(list).c_str());
+    const QJsonArray& layers = list.value("layers").toArray();
+    EXPECT_TRUE(layers.contains(QJsonValue("VK_LAYER_LUNARG_reference_1_2_1")));
+
+    const QJsonObject& verbose = session.Execute("verbose", quit);
+    EXPECT_STREQ("success", GetResult(verbose).c_str());
+    EXPECT_EQ(layers.size(), verbose.value("layers").toArray().size());
+    EXPECT_TRUE(verbose.value("layers").toArray()[0].toObject().contains("manifest_path"));
+
+    EXPECT_FALSE(quit);
+
+    qunsetenv("VK_LAYER_PATH");
+}
+
+TEST(test_layers_session, execute_doc_settings) {
+    qputenv("VK_LAYER_PATH", ":/");
+
+    LayersSession session("", SUPPORTED_CONFIG_FILES);
+
+    bool quit = false;
+
+    // The failure is reported in the reply, the session keeps executing commands
+    const QJsonObject& failure = session.Execute("doc settings VK_LAYER_LUNARG_reference_1_2_1 ./missing_directory", quit);
+    EXPECT_STREQ("failure", GetResult(failure).c_str());
+    EXPECT_STREQ("Could not write ./missing_directory/vk_layer_settings.txt",
+                 failure.value("message").toString().toStdString().c_str());
+
+    const QJsonObject& success = session.Execute("doc settings VK_LAYER_LUNARG_reference_1_2_1 .", quit);
+    EXPECT_STREQ("success", GetResult(success).c_str());
+    EXPECT_STREQ("./vk_layer_settings.txt", success.value("path").toString().toStdString().c_str());
+    EXPECT_TRUE(QFile::exists("./vk_layer_settings.txt"));
+    EXPECT_TRUE(QFile::remove("./vk_layer_settings.txt"));
+
+    EXPECT_FALSE(quit);
+
+    qunsetenv("VK_LAYER_PATH");
+}
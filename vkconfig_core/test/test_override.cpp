@@ -22,12 +22,17 @@
 #include "../environment.h"
 #include "../layer.h"
 #include "../layer_manager.h"
+#include "../setting_bool.h"
 #include <vulkan/layer/vk_layer_settings.hpp>
 
 #include <gtest/gtest.h>
 
 #include <QtGlobal>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
 
+#include <algorithm>
 #include <cstdlib>
 
 static const std::vector<std::string> SUPPORTED_CONFIG_FILES = {"_2_2_3", "_2_2_2", "_2_2_1"};
@@ -100,6 +105,43 @@ TEST(test_override, write_erase_2_2_2) {
     env.Reset(Environment::SYSTEM);  // Don't change the system settings on exit
 }
 
+TEST(test_override, compare_settings) {
+    const std::string SETTINGS("./override_settings_compare.txt");
+
+    PathManager paths("", SUPPORTED_CONFIG_FILES);
+    Environment env(paths, Version(1, 2, 170));
+    env.Reset(Environment::DEFAULT);
+
+    LayerManager layer_manager(env);
+    layer_manager.LoadLayersFromPath(":/");
+
+    Configuration configuration;
+    const bool load = configuration.Load(layer_manager.available_layers, ":/Configuration 2.2.2.json");
+    EXPECT_TRUE(load);
+
+    EXPECT_EQ(1, CompareSettingsOverride(layer_manager.available_layers, configuration, SETTINGS).size());  // Missing file
+
+    EXPECT_EQ(true, WriteSettingsOverride(layer_manager.available_layers, configuration, SETTINGS));
+    EXPECT_TRUE(CompareSettingsOverride(layer_manager.available_layers, configuration, SETTINGS).empty());
+
+    Parameter* parameter = FindByKey(configuration.parameters, "VK_LAYER_LUNARG_reference_1_2_1");
+    ASSERT_TRUE(parameter != nullptr);
+    SettingDataBool* setting = FindSetting<SettingDataBool>(parameter->settings, "toogle");
+    ASSERT_TRUE(setting != nullptr);
+    setting->value = false;
+
+    // The settings depending on "toogle" are also reported
+    const std::vector<std::string>& differences =
+        CompareSettingsOverride(layer_manager.available_layers, configuration, SETTINGS);
+    EXPECT_FALSE(differences.empty());
+    EXPECT_TRUE(std::find(differences.begin(), differences.end(),
+                          "lunarg_reference_1_2_1.toogle = true is applied instead of false") != differences.end());
+
+    EXPECT_EQ(true, EraseSettingsOverride(SETTINGS));
+
+    env.Reset(Environment::SYSTEM);  // Don't change the system settings on exit
+}
+
 TEST(test_override, vk_layer_settings_txt) {
     const char* LAYER = "VK_LAYER_LUNARG_reference_1_2_1";
 
@@ -305,3 +347,161 @@ TEST(test_override, env_var) {
 
     env.Reset(Environment::SYSTEM);  // Don't change the system settings on exit
 }
+
+static QByteArray ReadFile(const std::string& path) {
+    QFile file(path.c_str());
+    const bool result = file.open(QIODevice::ReadOnly | QIODevice::Text);
+    assert(result);
+    const QByteArray content = file.readAll();
+    file.close();
+    return content;
+}
+
+// Date the file in the past, so that any rewrite of the file can be detected
+static void AgeFile(const std::string& path) {
+    QFile file(path.c_str());
+    const bool result = file.open(QIODevice::ReadWrite);
+    assert(result);
+    file.setFileTime(QDateTime::fromSecsSinceEpoch(0), QFileDevice::FileModificationTime);
+    file.close();
+}
+
+static bool IsFileAged(const std::string& path) {
+    return QFileInfo(path.c_str()).lastModified() == QDateTime::fromSecsSinceEpoch(0);
+}
+
+TEST(test_override, write_no_change) {
+    const std::string LAYERS = GetPath(BUILTIN_PATH_OVERRIDE_LAYERS);
+    const std::string SETTINGS = GetPath(BUILTIN_PATH_OVERRIDE_SETTINGS);
+
+    PathManager paths("", SUPPORTED_CONFIG_FILES);
+    Environment env(paths, Version(1, 2, 162));
+    env.Reset(Environment::DEFAULT);
+
+    LayerManager layer_manager(env);
+    layer_manager.LoadLayersFromPath(":/");
+
+    Configuration configuration;
+    const bool load = configuration.Load(layer_manager.available_layers, ":/Configuration 2.2.2.json");
+    EXPECT_TRUE(load);
+
+    EXPECT_EQ(true, OverrideConfiguration(env, layer_manager.available_layers, configuration));
+    const QByteArray layers_content = ReadFile(LAYERS);
+    const QByteArray settings_content = ReadFile(SETTINGS);
+
+    AgeFile(LAYERS);
+    AgeFile(SETTINGS);
+
+    // Overriding the same configuration again must leave the files untouched
+    EXPECT_EQ(true, OverrideConfiguration(env, layer_manager.available_layers, configuration));
+    EXPECT_TRUE(IsFileAged(LAYERS));
+    EXPECT_TRUE(IsFileAged(SETTINGS));
+    EXPECT_EQ(layers_content, ReadFile(LAYERS));
+    EXPECT_EQ(settings_content, ReadFile(SETTINGS));
+
+    EXPECT_EQ(true, SurrenderConfiguration(env));
+
+    env.Reset(Environment::SYSTEM);  // Don't change the system settings on exit
+}
+
+TEST(test_override, write_single_setting_change) {
+    const std::string LAYERS = GetPath(BUILTIN_PATH_OVERRIDE_LAYERS);
+    const std::string SETTINGS = GetPath(BUILTIN_PATH_OVERRIDE_SETTINGS);
+
+    PathManager paths("", SUPPORTED_CONFIG_FILES);
+    Environment env(paths, Version(1, 2, 162));
+    env.Reset(Environment::DEFAULT);
+
+    LayerManager layer_manager(env);
+    layer_manager.LoadLayersFromPath(":/");
+
+    Configuration configuration;
+    const bool load = configuration.Load(layer_manager.available_layers, ":/Configuration 2.2.2.json");
+    EXPECT_TRUE(load);
+
+    EXPECT_EQ(true, OverrideConfiguration(env, layer_manager.available_layers, configuration));
+    EXPECT_TRUE(ReadFile(SETTINGS).contains("lunarg_reference_1_2_1.toogle = true"));
+
+    AgeFile(LAYERS);
+    AgeFile(SETTINGS);
+
+    Parameter* parameter = FindByKey(configuration.parameters, "VK_LAYER_LUNARG_reference_1_2_1");
+    ASSERT_TRUE(parameter != nullptr);
+    SettingDataBool* setting = FindSetting<SettingDataBool>(parameter->settings, "toogle");
+    ASSERT_TRUE(setting != nullptr);
+    setting->value = false;
+
+    // Only the settings file depends on the setting value
+    EXPECT_EQ(true, OverrideConfiguration(env, layer_manager.available_layers, configuration));
+    EXPECT_TRUE(IsFileAged(LAYERS));
+    EXPECT_FALSE(IsFileAged(SETTINGS));
+
+    const QByteArray settings_content = ReadFile(SETTINGS);
+    EXPECT_TRUE(settings_content.contains("lunarg_reference_1_2_1.toogle = false"));
+    EXPECT_FALSE(settings_content.contains("lunarg_reference_1_2_1.toogle = true"));
+
+    EXPECT_EQ(true, SurrenderConfiguration(env));
+
+    env.Reset(Environment::SYSTEM);  // Don't change the system settings on exit
+}
+
+TEST(test_override, generate_50_layers_200_settings) {
+    const std::size_t LAYER_COUNT = 50;
+    const std::size_t SETTING_COUNT = 200;
+
+    std::vector<Layer> layers;
+    layers.reserve(LAYER_COUNT);  // The settings meta reference their layer, it must not be moved after instantiation
+
+    Configuration configuration;
+    configuration.key = "Large";
+
+    // Reversed so that the ordering of the parameters is checked
+    for (std::size_t i = LAYER_COUNT; i > 0; --i) {
+        layers.push_back(Layer(format("VK_LAYER_LUNARG_large_%d", static_cast<int>(i - 1)), LAYER_TYPE_EXPLICIT));
+        Layer& layer = layers.back();
+        layer.api_version = Version(1, 3, 0);
+
+        for (std::size_t j = 0; j < SETTING_COUNT; ++j) {
+            SettingMetaBool* meta = static_cast<SettingMetaBool*>(
+                layer.Instantiate(layer.settings, format("setting_%d", static_cast<int>(j)), SETTING_BOOL));
+            meta->label = format("Setting %d", static_cast<int>(j));
+            meta->default_value = (j % 2) == 0;
+        }
+
+        Parameter parameter(layer.key, LAYER_STATE_OVERRIDDEN);
+        parameter.overridden_rank = static_cast<int>(i - 1);
+        CollectDefaultSettingData(layer.settings, parameter.settings);
+        configuration.parameters.push_back(parameter);
+    }
+
+    OrderParameter(configuration.parameters, layers);
+    ASSERT_EQ(LAYER_COUNT, configuration.parameters.size());
+
+    std::string missing_layer;
+    EXPECT_FALSE(HasMissingLayer(configuration.parameters, layers, missing_layer));
+
+    std::vector<LayerSettingsFileLayer> file_layers;
+    EXPECT_TRUE(GenerateSettingsOverride(layers, configuration, file_layers));
+    ASSERT_EQ(LAYER_COUNT, file_layers.size());
+
+    for (std::size_t i = 0; i < LAYER_COUNT; ++i) {
+        const std::string& layer_key = format("VK_LAYER_LUNARG_large_%d", static_cast<int>(i));
+        EXPECT_STREQ(layer_key.c_str(), configuration.parameters[i].key.c_str());
+        EXPECT_STREQ(layer_key.c_str(), file_layers[i].key.c_str());
+
+        const Layer* layer = FindByKey(layers, layer_key.c_str());
+        ASSERT_TRUE(layer != nullptr);
+        EXPECT_EQ(nullptr, layer->FindSetting("setting_missing"));
+
+        ASSERT_EQ(SETTING_COUNT, file_layers[i].settings.size());
+        for (std::size_t j = 0; j < SETTING_COUNT; ++j) {
+            const LayerSettingsFileSetting& file_setting = file_layers[i].settings[j];
+
+            const SettingMetaBool* meta = static_cast<const SettingMetaBool*>(layer->FindSetting(file_setting.key.c_str()));
+            ASSERT_TRUE(meta != nullptr);
+            EXPECT_STREQ(format("setting_%d", static_cast<int>(j)).c_str(), meta->key.c_str());
+            EXPECT_STREQ(meta->label.c_str(), file_setting.label.c_str());
+            EXPECT_STREQ(meta->default_value ? "true" : "false", file_setting.value.c_str());
+        }
+    }
+}
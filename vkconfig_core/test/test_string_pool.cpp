@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2020-2024 Valve Corporation
+ * Copyright (c) 2020-2024 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ * - Christophe Riccio <christophe@lunarg.com>
+ */
+
+#include "../string_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <utility>
+
+TEST(test_string_pool, intern) {
+    StringPool pool;
+
+    const StringPool::Entry& a = pool.Intern("string");
+    const StringPool::Entry& b = pool.Intern(std::string("str") + "ing");
+    const StringPool::Entry& c = pool.Intern("other string");
+
+    EXPECT_EQ(&a, &b);
+    EXPECT_NE(&a, &c);
+    EXPECT_STREQ("string", a.value->c_str());
+    EXPECT_EQ(2, a.references.load());
+    EXPECT_EQ(2, pool.GetCount());
+    EXPECT_EQ(18, pool.GetSize());
+}
+
+TEST(test_string_pool, intern_stable) {
+    StringPool pool;
+
+    const StringPool::Entry& a = pool.Intern("string");
+    for (int i = 0; i < 1000; ++i) {
+        pool.Intern(std::to_string(i));
+    }
+
+    EXPECT_EQ(&a, &pool.Intern("string"));
+    EXPECT_STREQ("string", a.value->c_str());
+}
+
+TEST(test_string_pool, release) {
+    StringPool pool;
+
+    StringPool::Entry& a = pool.Intern("string");
+    pool.Intern("string");
+    StringPool::AddReference(a);
+    pool.Intern("other string");
+    EXPECT_EQ(2, pool.GetCount());
+
+    pool.Release(a);
+    pool.Release(a);
+    EXPECT_EQ(2, pool.GetCount());
+
+    // The string is removed with its last reference
+    pool.Release(a);
+    EXPECT_EQ(1, pool.GetCount());
+    EXPECT_EQ(12, pool.GetSize());
+}
+
+TEST(test_string_pool, interned_string_default) {
+    InternedString a;
+    InternedString b(std::string(""));
+
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(0, a.size());
+    EXPECT_STREQ("", a.c_str());
+    EXPECT_TRUE(a == b);
+}
+
+TEST(test_string_pool, interned_string_shared) {
+    InternedString a(std::string("My label"));
+    InternedString b;
+    b = std::string("My ") + "label";
+
+    EXPECT_TRUE(a == b);
+    EXPECT_EQ(a.c_str(), b.c_str());
+
+    b = "Other label";
+    EXPECT_TRUE(a != b);
+}
+
+TEST(test_string_pool, interned_string_compare) {
+    InternedString a(std::string("label"));
+
+    EXPECT_TRUE(a == "label");
+    EXPECT_TRUE(a == std::string("label"));
+    EXPECT_TRUE(std::string("label") == a);
+    EXPECT_TRUE(a != "value");
+    EXPECT_TRUE(a != std::string("value"));
+    EXPECT_TRUE(std::string("value") != a);
+}
+
+TEST(test_string_pool, interned_string_concatenate) {
+    InternedString a(std::string("label"));
+    const std::string b = a;
+
+    EXPECT_STREQ("label", b.c_str());
+    EXPECT_STREQ("label!", (a + "!").c_str());
+    EXPECT_STREQ("!label", ("!" + a).c_str());
+    EXPECT_STREQ("label!", (a + std::string("!")).c_str());
+    EXPECT_STREQ("!label", (std::string("!") + a).c_str());
+    EXPECT_STREQ("labellabel", (a + a).c_str());
+}
+
+TEST(test_string_pool, interned_string_moved) {
+    const std::size_t count = GetStringPool().GetCount();
+
+    {
+        InternedString a(std::string("Moved label"));
+        const char* storage = a.c_str();
+
+        InternedString b(std::move(a));
+        EXPECT_EQ(storage, b.c_str());
+        EXPECT_TRUE(a.empty());
+
+        InternedString c;
+        c = std::move(b);
+        EXPECT_EQ(storage, c.c_str());
+        EXPECT_EQ(count + 1, GetStringPool().GetCount());
+    }
+
+    EXPECT_EQ(count, GetStringPool().GetCount());
+}
+
+TEST(test_string_pool, interned_string_released) {
+    const std::size_t count = GetStringPool().GetCount();
+
+    {
+        InternedString a(std::string("Released label"));
+        InternedString b(a);
+        InternedString c;
+        c = b;
+        EXPECT_EQ(count + 1, GetStringPool().GetCount());
+
+        a = "Other released label";
+        EXPECT_EQ(count + 2, GetStringPool().GetCount());
+    }
+
+    EXPECT_EQ(count, GetStringPool().GetCount());
+}
@@ -255,6 +255,89 @@ TEST(test_util, format_find) {
     EXPECT_EQ(false, IsFound(container, "D"));
 }
 
+TEST(test_util, key_index_find) {
+    struct Element {
+        std::string key;
+    };
+
+    KeyIndex<Element> index;
+
+    std::vector<Element> container;
+    EXPECT_EQ(nullptr, index.Find(container, "D"));
+
+    Element elementA;
+    elementA.key = "A";
+    Element elementB;
+    elementB.key = "B";
+    Element elementC;
+    elementC.key = "C";
+
+    container.push_back(elementA);
+    container.push_back(elementB);
+    index.Append(container);
+
+    EXPECT_STREQ("A", index.Find(container, "A")->key.c_str());
+    EXPECT_STREQ("B", index.Find(container, "B")->key.c_str());
+    EXPECT_EQ(nullptr, index.Find(container, "C"));
+
+    // Appended element
+    container.push_back(elementC);
+    index.Append(container);
+    EXPECT_STREQ("C", index.Find(container, "C")->key.c_str());
+    EXPECT_EQ(&container[2], index.Find(container, "C"));
+
+    // Reordered elements
+    std::swap(container[0], container[2]);
+    index.Rebuild(container);
+    EXPECT_EQ(&container[0], index.Find(container, "C"));
+    EXPECT_EQ(&container[2], index.Find(container, "A"));
+
+    // Renamed element
+    container[1].key = "D";
+    index.Rebuild(container);
+    EXPECT_EQ(nullptr, index.Find(container, "B"));
+    EXPECT_EQ(&container[1], index.Find(container, "D"));
+
+    // Removed elements
+    container.pop_back();
+    index.Append(container);
+    EXPECT_EQ(nullptr, index.Find(container, "A"));
+    EXPECT_STREQ("C", index.Find(container, "C")->key.c_str());
+
+    const std::vector<Element>& const_container = container;
+    EXPECT_EQ(&const_container[1], index.Find(const_container, "D"));
+
+    index.Clear();
+    EXPECT_EQ(&container[1], index.Find(container, "D"));
+}
+
+TEST(test_util, key_index_find_not_updated) {
+    struct Element {
+        std::string key;
+    };
+
+    Element elementA;
+    elementA.key = "A";
+    Element elementB;
+    elementB.key = "B";
+
+    std::vector<Element> container;
+    container.push_back(elementA);
+    container.push_back(elementB);
+
+    KeyIndex<Element> index;
+    index.Rebuild(container);
+
+    // Elements modified without updating the index are still found, but not the new keys of renamed elements
+    std::swap(container[0], container[1]);
+    EXPECT_EQ(&container[1], index.Find(container, "A"));
+    EXPECT_EQ(&container[0], index.Find(container, "B"));
+
+    container.pop_back();
+    EXPECT_EQ(&container[0], index.Find(container, "B"));
+    EXPECT_EQ(nullptr, index.Find(container, "A"));
+}
+
 TEST(test_util, to_lower_case) {
     EXPECT_STREQ("string", ToLowerCase("string").c_str());
     EXPECT_STREQ(" string", ToLowerCase(" string").c_str());
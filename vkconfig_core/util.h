@@ -34,6 +34,7 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <unordered_map>
 
 // Based on https://www.g-truc.net/post-0708.html#menu
 template <typename T, std::size_t N>
@@ -89,6 +90,83 @@ bool IsFound(const std::vector<T>& container, const char* key) {
     return FindByKey(container, key) != nullptr;
 }
 
+// Hash index from the key of the elements of a container to their position in the container.
+// The owner of the container updates the index when it modifies the container: Append after adding elements at the end of the
+// container, Rebuild after any other modification, including renaming an element. Lookups don't modify the index so that
+// concurrent lookups are safe. A key missing from an up to date index is not searched in the container.
+template <typename T>
+class KeyIndex {
+   public:
+    KeyIndex() : indexed_size(0) {}
+
+    void Clear() {
+        this->positions.clear();
+        this->indexed_size = 0;
+    }
+
+    void Rebuild(const std::vector<T>& container) {
+        this->positions.clear();
+        this->positions.reserve(container.size());
+        this->indexed_size = 0;
+
+        this->Append(container);
+    }
+
+    void Append(const std::vector<T>& container) {
+        if (this->indexed_size > container.size()) {
+            this->Rebuild(container);
+            return;
+        }
+
+        for (std::size_t i = this->indexed_size, n = container.size(); i < n; ++i) {
+            this->positions.insert(std::make_pair(container[i].key, i));  // Keep the first element like FindByKey
+        }
+
+        this->indexed_size = container.size();
+    }
+
+    T* Find(std::vector<T>& container, const char* key) const {
+        const std::size_t position = this->FindPosition(container, key);
+        return position < container.size() ? &container[position] : nullptr;
+    }
+
+    const T* Find(const std::vector<T>& container, const char* key) const {
+        const std::size_t position = this->FindPosition(container, key);
+        return position < container.size() ? &container[position] : nullptr;
+    }
+
+   private:
+    std::size_t FindPosition(const std::vector<T>& container, const char* key) const {
+        assert(key != nullptr);
+        assert(std::strcmp(key, "") != 0);
+
+        // The container was modified without updating the index
+        if (this->indexed_size != container.size()) {
+            return this->SearchPosition(container, key);
+        }
+
+        auto it = this->positions.find(key);
+        if (it == this->positions.end()) {
+            return container.size();
+        }
+
+        // The container was modified in place without rebuilding the index
+        if (container[it->second].key != key) {
+            return this->SearchPosition(container, key);
+        }
+
+        return it->second;
+    }
+
+    std::size_t SearchPosition(const std::vector<T>& container, const char* key) const {
+        const T* element = FindByKey(container, key);
+        return element != nullptr ? static_cast<std::size_t>(element - container.data()) : container.size();
+    }
+
+    std::unordered_map<std::string, std::size_t> positions;
+    std::size_t indexed_size;
+};
+
 // Remove a value if it's present
 void RemoveString(std::vector<std::string>& list, const std::string& value);
 
@@ -0,0 +1,469 @@
+/*
+ * Copyright (c) 2020-2024 Valve Corporation
+ * Copyright (c) 2020-2024 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ * - Christophe Riccio <christophe@lunarg.com>
+ */
+
+#include "vulkan_status_probe.h"
+#include "util.h"
+#include "path.h"
+#include "platform.h"
+
+#include <vulkan/vulkan.h>
+
+#include <QLibrary>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QProcessEnvironment>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QFileInfo>
+
+#if VKC_PLATFORM == VKC_PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#include <cassert>
+#include <cstdio>
+
+static const char *GetVulkanLibrary() {
+    static const char *TABLE[] = {
+        "vulkan-1.dll",              // PLATFORM_WINDOWS
+        "libvulkan",                 // PLATFORM_LINUX
+        "/usr/local/lib/libvulkan",  // PLATFORM_MACOS
+        "N/A",                       // PLATFORM_ANDROID
+    };
+    static_assert(countof(TABLE) == PLATFORM_COUNT, "The tranlation table size doesn't match the enum number of elements");
+
+    return TABLE[VKC_PLATFORM];
+}
+
+static std::string GetUUIDString(const uint8_t deviceUUID[VK_UUID_SIZE]) {
+    std::string result;
+
+    for (std::size_t i = 0, n = VK_UUID_SIZE; i < n; ++i) {
+        result += format("%02X", deviceUUID[i]);
+    }
+
+    return result;
+}
+
+Version GetVulkanLoaderVersion() {
+    // Check loader version
+    QLibrary library(GetVulkanLibrary());
+
+    if (!library.load()) return Version::VERSION_NULL;
+
+    PFN_vkEnumerateInstanceVersion vkEnumerateInstanceVersion;
+    vkEnumerateInstanceVersion = (PFN_vkEnumerateInstanceVersion)library.resolve("vkEnumerateInstanceVersion");
+    assert(vkEnumerateInstanceVersion);
+
+    uint32_t version = 0;
+    const VkResult result = vkEnumerateInstanceVersion(&version);
+    assert(result == VK_SUCCESS);
+
+    return Version(version);
+}
+
+// Path of the Vulkan Loader found by the dynamic linker, empty when no loader is found
+static std::string GetVulkanLibraryPath() {
+    QLibrary library(GetVulkanLibrary());
+    if (!library.load()) return "";
+
+    QFunctionPointer symbol = library.resolve("vkGetInstanceProcAddr");
+    if (symbol == nullptr) return "";
+
+#if VKC_PLATFORM == VKC_PLATFORM_WINDOWS
+    HMODULE module = nullptr;
+    if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                            reinterpret_cast<LPCSTR>(symbol), &module)) {
+        return "";
+    }
+
+    char path[MAX_PATH] = {};
+    if (GetModuleFileNameA(module, path, MAX_PATH) == 0) return "";
+    return path;
+#else
+    Dl_info info = {};
+    if (dladdr(reinterpret_cast<void *>(symbol), &info) == 0 || info.dli_fname == nullptr) return "";
+    return info.dli_fname;
+#endif
+}
+
+static VkResult CreateInstance(QLibrary &library, VkInstance &instance, bool enumerate_portability) {
+    if (!enumerate_portability) return VK_ERROR_INCOMPATIBLE_DRIVER;
+
+    PFN_vkEnumerateInstanceExtensionProperties vkEnumerateInstanceExtensionProperties =
+        (PFN_vkEnumerateInstanceExtensionProperties)library.resolve("vkEnumerateInstanceExtensionProperties");
+    assert(vkEnumerateInstanceExtensionProperties);
+
+    uint32_t property_count = 0;
+    VkResult err = vkEnumerateInstanceExtensionProperties(nullptr, &property_count, nullptr);
+    assert(err == VK_SUCCESS);
+
+    std::vector<VkExtensionProperties> instance_properties(property_count);
+    err = vkEnumerateInstanceExtensionProperties(nullptr, &property_count, &instance_properties[0]);
+    assert(err == VK_SUCCESS);
+
+    // Handle Portability Enumeration requirements
+    std::vector<const char *> instance_extensions;
+
+    for (std::size_t i = 0, n = instance_properties.size(); i < n && enumerate_portability; ++i) {
+        if (instance_properties[i].extensionName == std::string(VK_KHR_EXTERNAL_MEMORY_CAPABILITIES_EXTENSION_NAME)) {
+            instance_extensions.push_back(VK_KHR_EXTERNAL_MEMORY_CAPABILITIES_EXTENSION_NAME);
+        }
+#if VK_KHR_portability_enumeration
+        else if (instance_properties[i].extensionName == std::string(VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME)) {
+            instance_extensions.push_back(VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME);
+        }
+#endif
+    }
+
+    // Check Vulkan Devices
+
+    VkApplicationInfo app = {};
+    app.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+    app.pNext = nullptr;
+    app.pApplicationName = VKCONFIG_SHORT_NAME;
+    app.applicationVersion = 0;
+    app.pEngineName = VKCONFIG_SHORT_NAME;
+    app.engineVersion = 0;
+    app.apiVersion = VK_API_VERSION_1_1;
+
+    VkInstanceCreateInfo inst_info = {};
+    inst_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+#if VK_KHR_portability_enumeration
+    if (!instance_extensions.empty()) {
+        inst_info.flags = VK_INSTANCE_CREATE_ENUMERATE_PORTABILITY_BIT_KHR;
+    }
+#endif
+    inst_info.pNext = nullptr;
+    inst_info.pApplicationInfo = &app;
+    inst_info.enabledLayerCount = 0;
+    inst_info.ppEnabledLayerNames = nullptr;
+    inst_info.enabledExtensionCount = static_cast<uint32_t>(instance_extensions.size());
+    inst_info.ppEnabledExtensionNames = instance_extensions.empty() ? nullptr : &instance_extensions[0];
+
+    PFN_vkCreateInstance vkCreateInstance = (PFN_vkCreateInstance)library.resolve("vkCreateInstance");
+    assert(vkCreateInstance);
+
+    return vkCreateInstance(&inst_info, nullptr, &instance);
+}
+
+// Drivers may take a while to load, but a hung driver must not leave the status pending forever
+static const int VULKAN_STATUS_PROBE_TIMEOUT_MS = 30000;
+
+VulkanStatusProbe::VulkanStatusProbe(QObject *parent) : QObject(parent), process(nullptr) {
+    this->timer.setSingleShot(true);
+    this->timer.setInterval(VULKAN_STATUS_PROBE_TIMEOUT_MS);
+
+    connect(&this->timer, SIGNAL(timeout()), this, SLOT(OnTimeout()));
+}
+
+VulkanStatusProbe::~VulkanStatusProbe() { this->StopProcess(); }
+
+// The variables that configure the Vulkan Loader, the drivers and the layers, or where the dynamic linker finds the loader
+static bool IsVulkanEnvironmentVariable(const QString &name) {
+    return name.startsWith("VK_") || name.startsWith("VULKAN_") || name.startsWith("DISABLE_VK") || name.startsWith("DYLD_") ||
+           name == "LD_LIBRARY_PATH" || name == "PATH";
+}
+
+// Computed on the UI thread for each request: neither the loader is loaded nor the layers settings file is read
+std::string VulkanStatusProbe::ComputeKey() {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    const QProcessEnvironment &environment = QProcessEnvironment::systemEnvironment();
+    QStringList names = environment.keys();
+    names.sort();
+    for (int i = 0, n = names.size(); i < n; ++i) {
+        if (IsVulkanEnvironmentVariable(names[i])) {
+            hash.addData((names[i] + "=" + environment.value(names[i]) + "\n").toUtf8());
+        }
+    }
+
+    const QFileInfo layer_settings(GetPath(BUILTIN_PATH_OVERRIDE_SETTINGS).c_str());
+    hash.addData(QByteArray::number(layer_settings.lastModified().toMSecsSinceEpoch()));
+    hash.addData(QByteArray::number(layer_settings.size()));
+
+    return hash.result().toHex().toStdString();
+}
+
+// The loader found by the probe is only checked when the status is cached, it's not loaded again
+bool VulkanStatusProbe::IsCached(const std::string &key) const {
+    auto it = this->cache.find(key);
+    if (it == this->cache.end()) {
+        return false;
+    }
+
+    const QFileInfo loader_info(it->second.json_probe.value("loader_path").toString());
+    return loader_info.lastModified() == it->second.loader_last_modified && loader_info.size() == it->second.loader_size;
+}
+
+void VulkanStatusProbe::Request(bool use_cache) {
+    const std::string &key = ComputeKey();
+
+    if (this->process != nullptr) {
+        if (key == this->key) {
+            return;  // Already probing this system state
+        }
+        this->StopProcess();
+    }
+
+    this->key = key;
+
+    if (use_cache && this->IsCached(key)) {
+        return;
+    }
+
+    this->cache.erase(key);
+
+    // The layers override is disabled so that the status reflects the system as seen by Vulkan applications on their own
+    QStringList environment = QProcess::systemEnvironment();
+    environment.append("DISABLE_VK_LAYER_LUNARG_override=1");
+
+    this->process = new QProcess(this);
+    this->process->setProgram(QCoreApplication::applicationFilePath());
+    this->process->setArguments(QStringList() << VULKAN_STATUS_PROBE_ARG);
+    this->process->setEnvironment(environment);
+
+    connect(this->process, SIGNAL(started()), this, SLOT(OnStarted()));
+    connect(this->process, SIGNAL(errorOccurred(QProcess::ProcessError)), this, SLOT(OnErrorOccurred(QProcess::ProcessError)));
+    connect(this->process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(OnFinished(int, QProcess::ExitStatus)));
+
+    this->process->start(QIODevice::ReadOnly);
+}
+
+const QJsonObject *VulkanStatusProbe::GetResult() const {
+    auto it = this->cache.find(this->key);
+    return it == this->cache.end() ? nullptr : &it->second.json_probe;
+}
+
+void VulkanStatusProbe::OnStarted() { this->timer.start(); }
+
+void VulkanStatusProbe::OnErrorOccurred(QProcess::ProcessError error) {
+    // The other errors are followed by the finished signal
+    if (error != QProcess::FailedToStart) {
+        return;
+    }
+
+    QJsonObject json_probe;
+    json_probe.insert("error", "process");
+    json_probe.insert("message",
+                      format("the probe process failed to start: %s", this->process->errorString().toStdString().c_str()).c_str());
+
+    this->Finish(json_probe);
+}
+
+void VulkanStatusProbe::OnFinished(int exit_code, QProcess::ExitStatus exit_status) {
+    const QJsonDocument &doc = QJsonDocument::fromJson(this->process->readAllStandardOutput());
+
+    QJsonObject json_probe;
+    if (exit_status == QProcess::NormalExit && exit_code == 0 && doc.isObject()) {
+        json_probe = doc.object();
+    } else {
+        json_probe.insert("error", "process");
+        if (exit_status == QProcess::CrashExit) {
+            json_probe.insert("message", "the probe process crashed");
+        } else {
+            json_probe.insert("message", format("the probe process exited with code %d", exit_code).c_str());
+        }
+    }
+
+    this->Finish(json_probe);
+}
+
+void VulkanStatusProbe::OnTimeout() {
+    QJsonObject json_probe;
+    json_probe.insert("error", "process");
+    json_probe.insert("message",
+                      format("the probe process timed out after %d seconds", VULKAN_STATUS_PROBE_TIMEOUT_MS / 1000).c_str());
+
+    this->Finish(json_probe);
+}
+
+void VulkanStatusProbe::StopProcess() {
+    this->timer.stop();
+
+    if (this->process == nullptr) {
+        return;
+    }
+
+    this->process->disconnect(this);
+    if (this->process->state() != QProcess::NotRunning) {
+        this->process->kill();
+        this->process->waitForFinished();
+    }
+
+    // The process may be the sender of the signal being handled
+    this->process->deleteLater();
+    this->process = nullptr;
+}
+
+void VulkanStatusProbe::Finish(const QJsonObject &json_probe) {
+    this->StopProcess();
+
+    const QFileInfo loader_info(json_probe.value("loader_path").toString());
+
+    Status &status = this->cache[this->key];
+    status.json_probe = json_probe;
+    status.loader_last_modified = loader_info.lastModified();
+    status.loader_size = loader_info.size();
+
+    emit ResultReady();
+}
+
+static int PrintVulkanStatusProbe(const QJsonObject &json_probe) {
+    const QByteArray &data = QJsonDocument(json_probe).toJson(QJsonDocument::Compact);
+    fwrite(data.constData(), 1, data.size(), stdout);
+    fflush(stdout);
+    return 0;
+}
+
+int RunVulkanStatusProbe() {
+    QJsonObject json_probe;
+
+    const Version loader_version = GetVulkanLoaderVersion();
+    if (loader_version == Version::VERSION_NULL) {
+        json_probe.insert("error", "loader");
+        return PrintVulkanStatusProbe(json_probe);
+    }
+
+    json_probe.insert("loader_version", loader_version.str().c_str());
+    json_probe.insert("loader_path", GetVulkanLibraryPath().c_str());
+
+    QLibrary library(GetVulkanLibrary());
+    PFN_vkEnumerateInstanceLayerProperties vkEnumerateInstanceLayerProperties =
+        (PFN_vkEnumerateInstanceLayerProperties)library.resolve("vkEnumerateInstanceLayerProperties");
+    assert(vkEnumerateInstanceLayerProperties);
+
+    std::uint32_t instance_layer_count = 0;
+    VkResult err = vkEnumerateInstanceLayerProperties(&instance_layer_count, NULL);
+    assert(!err);
+
+    std::vector<VkLayerProperties> layers_properties;
+    layers_properties.resize(instance_layer_count);
+
+    err = vkEnumerateInstanceLayerProperties(&instance_layer_count, layers_properties.data());
+    assert(!err);
+
+    QJsonArray json_layers;
+    for (std::size_t i = 0, n = layers_properties.size(); i < n; ++i) {
+        json_layers.append(layers_properties[i].layerName);
+    }
+    json_probe.insert("layers", json_layers);
+
+    VkInstance inst = VK_NULL_HANDLE;
+    err = CreateInstance(library, inst, false);
+    if (err == VK_ERROR_INCOMPATIBLE_DRIVER) {
+        // If no compatible driver were found, trying with portability enumeration
+        err = CreateInstance(library, inst, true);
+        if (err == VK_ERROR_INCOMPATIBLE_DRIVER) {
+            json_probe.insert("error", "instance");
+            return PrintVulkanStatusProbe(json_probe);
+        }
+    }
+    assert(err == VK_SUCCESS);
+
+    PFN_vkEnumeratePhysicalDevices vkEnumeratePhysicalDevices =
+        (PFN_vkEnumeratePhysicalDevices)library.resolve("vkEnumeratePhysicalDevices");
+    assert(vkEnumeratePhysicalDevices);
+
+    PFN_vkEnumerateInstanceExtensionProperties vkEnumerateInstanceExtensionProperties =
+        (PFN_vkEnumerateInstanceExtensionProperties)library.resolve("vkEnumerateInstanceExtensionProperties");
+    assert(vkEnumerateInstanceExtensionProperties);
+
+    VkResult result = VK_SUCCESS;
+
+    uint32_t instance_extension_count = 0;
+    result = vkEnumerateInstanceExtensionProperties(nullptr, &instance_extension_count, nullptr);
+
+    std::vector<VkExtensionProperties> instance_extensions;
+    if (instance_extension_count > 0) {
+        instance_extensions.resize(instance_extension_count);
+    }
+    result = vkEnumerateInstanceExtensionProperties(nullptr, &instance_extension_count, instance_extensions.data());
+
+    bool has_device_id = false;
+    if (result == VK_SUCCESS) {
+        for (std::size_t i = 0, n = instance_extensions.size(); i < n; ++i) {
+            if (instance_extensions[i].extensionName == std::string(VK_KHR_EXTERNAL_MEMORY_CAPABILITIES_EXTENSION_NAME)) {
+                has_device_id = true;
+                break;
+            }
+        }
+    }
+
+    uint32_t gpu_count = 0;
+    err = vkEnumeratePhysicalDevices(inst, &gpu_count, NULL);
+
+    PFN_vkDestroyInstance vkDestroyInstance = (PFN_vkDestroyInstance)library.resolve("vkDestroyInstance");
+    assert(vkDestroyInstance);
+
+    // This can fail on a new Linux setup. Check and fail gracefully rather than crash.
+    if (err != VK_SUCCESS) {
+        vkDestroyInstance(inst, NULL);
+
+        json_probe.insert("error", "physical_device");
+        return PrintVulkanStatusProbe(json_probe);
+    }
+
+    std::vector<VkPhysicalDevice> devices;
+    devices.resize(gpu_count);
+
+    err = vkEnumeratePhysicalDevices(inst, &gpu_count, devices.data());
+    assert(!err);
+
+    PFN_vkGetPhysicalDeviceProperties pfnGetPhysicalDeviceProperties =
+        (PFN_vkGetPhysicalDeviceProperties)library.resolve("vkGetPhysicalDeviceProperties");
+    assert(pfnGetPhysicalDeviceProperties);
+
+    QJsonArray json_devices;
+    for (std::size_t i = 0, n = devices.size(); i < n; ++i) {
+        VkPhysicalDeviceProperties properties;
+        pfnGetPhysicalDeviceProperties(devices[i], &properties);
+
+        const std::string vk_version = format("%d.%d.%d", VK_VERSION_MAJOR(properties.apiVersion),
+                                              VK_VERSION_MINOR(properties.apiVersion), VK_VERSION_PATCH(properties.apiVersion));
+
+        QJsonObject json_device;
+        json_device.insert("name", properties.deviceName);
+        json_device.insert("api_version", vk_version.c_str());
+
+        if (has_device_id) {
+            PFN_vkGetPhysicalDeviceProperties2 pfnGetPhysicalDeviceProperties2 =
+                (PFN_vkGetPhysicalDeviceProperties2)library.resolve("vkGetPhysicalDeviceProperties2");
+            assert(pfnGetPhysicalDeviceProperties2);
+
+            VkPhysicalDeviceIDPropertiesKHR properties_deviceid{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES_KHR, nullptr};
+            VkPhysicalDeviceProperties2 properties2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, &properties_deviceid};
+
+            pfnGetPhysicalDeviceProperties2(devices[i], &properties2);
+
+            json_device.insert("device_uuid", GetUUIDString(properties_deviceid.deviceUUID).c_str());
+            json_device.insert("driver_uuid", GetUUIDString(properties_deviceid.driverUUID).c_str());
+        }
+
+        json_devices.append(json_device);
+    }
+    json_probe.insert("devices", json_devices);
+
+    vkDestroyInstance(inst, NULL);
+
+    return PrintVulkanStatusProbe(json_probe);
+}
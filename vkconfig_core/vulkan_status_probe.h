@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020-2024 Valve Corporation
+ * Copyright (c) 2020-2024 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ * - Christophe Riccio <christophe@lunarg.com>
+ */
+
+#pragma once
+
+#include "version.h"
+
+#include <QObject>
+#include <QProcess>
+#include <QTimer>
+#include <QDateTime>
+#include <QJsonObject>
+
+#include <string>
+#include <map>
+
+// Hidden command line argument: the process only probes the Vulkan status and prints it as JSON on the standard output
+#define VULKAN_STATUS_PROBE_ARG "--vulkan-status-probe"
+
+// Probe the Vulkan Loader, the layers and the physical devices in a child process so that loading the drivers neither
+// blocks the UI nor crashes Vulkan Configurator. Results are cached until the Vulkan environment variables, the layers
+// settings file or the Vulkan Loader found by the last probe change.
+class VulkanStatusProbe : public QObject {
+    Q_OBJECT
+   public:
+    VulkanStatusProbe(QObject *parent = nullptr);
+    ~VulkanStatusProbe();
+
+    // Start probing unless the status of the current system state is already cached or being probed
+    void Request(bool use_cache = true);
+
+    // The status of the current system state, nullptr while it's being probed
+    const QJsonObject *GetResult() const;
+
+   Q_SIGNALS:
+    void ResultReady();
+
+   private Q_SLOTS:
+    void OnStarted();
+    void OnErrorOccurred(QProcess::ProcessError error);
+    void OnFinished(int exit_code, QProcess::ExitStatus exit_status);
+    void OnTimeout();
+
+   private:
+    VulkanStatusProbe(const VulkanStatusProbe &) = delete;
+    VulkanStatusProbe &operator=(const VulkanStatusProbe &) = delete;
+
+    struct Status {
+        QJsonObject json_probe;
+        QDateTime loader_last_modified;  // The loader may be updated in place, without changing the key
+        qint64 loader_size;
+    };
+
+    static std::string ComputeKey();
+    bool IsCached(const std::string &key) const;
+    void StopProcess();
+    void Finish(const QJsonObject &json_probe);
+
+    QProcess *process;
+    QTimer timer;
+
+    std::string key;                      // Key of the system state of the last request
+    std::map<std::string, Status> cache;  // Indexed by system state key
+};
+
+Version GetVulkanLoaderVersion();
+
+// Entry point of the child process started by VulkanStatusProbe
+int RunVulkanStatusProbe();